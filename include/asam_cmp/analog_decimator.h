@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/sample_converter.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Keeps a pyramid of min/max/mean summaries of one analog interface for fast plotting.
+// A bucket of level 0 summarizes factor samples, a bucket of level N summarizes factor buckets of level N - 1.
+// Buckets are closed early when the signal is not continuous (gap, interval or unit change),
+// so a bucket never spans a discontinuity. Packets that start before the end of the previous one are rejected,
+// which keeps the buckets of every level sorted by time. A packet that starts earlier than its own duration before
+// that end is a timestamp reset, e.g. after a device restart: all summaries are dropped and the decimator starts over.
+class AnalogDecimator final
+{
+public:
+    struct Summary
+    {
+        uint64_t timestamp{0};
+        // Timestamp of the sample following the last one
+        uint64_t endTimestamp{0};
+        double min{0.};
+        double max{0.};
+        double sum{0.};
+        uint64_t count{0};
+
+        double getMean() const;
+        void merge(const Summary& other);
+    };
+
+public:
+    // If maxBucketsPerLevel is not 0, the oldest buckets of a level are removed when the limit is reached
+    explicit AnalogDecimator(const size_t factor = defaultFactor,
+                             const size_t levelsCount = defaultLevelsCount,
+                             const size_t maxBucketsPerLevel = 0);
+
+    // Returns false if the packet does not carry a valid Analog payload or overlaps with the samples added before
+    bool addPacket(const Packet& packet);
+    void clear();
+    // Number of timestamp resets since the construction or the last clear()
+    uint64_t getTimestampResets() const;
+
+    size_t getFactor() const;
+    size_t getLevelsCount() const;
+    // Duration of a full bucket of the level for the current sample interval
+    uint64_t getBucketDuration(const size_t level) const;
+
+    // Random access to closed buckets, from the oldest to the newest
+    size_t getBucketsCount(const size_t level) const;
+    const Summary& getBucket(const size_t level, const size_t index) const;
+
+    // Returns the coarsest level whose buckets are not longer than one of width pixels of [begin, end)
+    size_t selectLevel(const uint64_t begin, const uint64_t end, const size_t width) const;
+    // Returns width summaries of [begin, end) from the selected level, pixels without data have count 0.
+    // Samples that are not yet summarized in a closed bucket are included as well.
+    std::vector<Summary> query(const uint64_t begin, const uint64_t end, const size_t width) const;
+
+public:
+    static constexpr size_t defaultFactor = 16;
+    static constexpr size_t defaultLevelsCount = 6;
+
+private:
+    struct Level
+    {
+        std::deque<Summary> buckets;
+        Summary open;
+        size_t openChildren{0};
+    };
+
+    void addSamples(const AnalogPayload& payload, const uint64_t timestamp);
+    void resetLevels();
+    void closeBucket(const size_t level);
+    void closeAllBuckets();
+    Summary getTail(const size_t level) const;
+
+private:
+    size_t factor;
+    std::vector<Level> levels;
+    size_t maxBucketsPerLevel;
+
+    uint64_t nextTimestamp{0};
+    float sampleInterval{0.f};
+    double sampleIntervalNs{0.};
+    AnalogPayload::Unit unit{AnalogPayload::Unit::undefined};
+    uint64_t timestampResets{0};
+    // Raw summaries of the level 0 buckets of the current packet
+    std::vector<SampleConverter::MinMaxSum> rawBuckets;
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -16,11 +16,15 @@
  
 #pragma once
 
+#include <memory>
+
 #include <asam_cmp/common.h>
 #include <asam_cmp/payload.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
+class Packet;
+
 class AnalogPayload : public Payload
 {
 public:
@@ -192,12 +196,32 @@ public:
     size_t getSamplesCount() const;
     const uint8_t* getData() const;
     void setData(const uint8_t* data, const size_t size);
+    // Stores native-endian samples in the payload and sets the corresponding sample data type
+    void setSamples(const int16_t* samples, const size_t count);
+    void setSamples(const int32_t* samples, const size_t count);
+
+    // Converts samples to physical values (sample * scalar + offset), dst must hold getSamplesCount() values
+    void toFloat(float* dst) const;
+    void toDouble(double* dst) const;
+
+    // Batch versions over AnalogPayload or std::shared_ptr<Packet> ranges, packets with other payloads are skipped.
+    // Samples of all payloads are written one after another, the number of written samples is returned.
+    template <typename ForwardIterator>
+    static size_t getSamplesCount(ForwardIterator begin, ForwardIterator end);
+    template <typename ForwardIterator>
+    static size_t toFloat(ForwardIterator begin, ForwardIterator end, float* dst);
+    template <typename ForwardIterator>
+    static size_t toDouble(ForwardIterator begin, ForwardIterator end, double* dst);
 
     static bool isValidPayload(const uint8_t* data, const size_t size);
 
 protected:
     const Header* getHeader() const;
     Header* getHeader();
+
+private:
+    static const AnalogPayload* asAnalogPayload(const AnalogPayload& payload);
+    static const AnalogPayload* asAnalogPayload(const std::shared_ptr<Packet>& packet);
 };
 
 template <>
@@ -224,4 +248,46 @@ struct AnalogPayload::SampleDtFromType<int32_t> : public SampleDtToType<SampleDt
 {
 };
 
+template <typename ForwardIterator>
+size_t AnalogPayload::getSamplesCount(ForwardIterator begin, ForwardIterator end)
+{
+    size_t count = 0;
+    for (auto it = begin; it != end; ++it)
+    {
+        if (auto payload = asAnalogPayload(*it))
+            count += payload->getSamplesCount();
+    }
+    return count;
+}
+
+template <typename ForwardIterator>
+size_t AnalogPayload::toFloat(ForwardIterator begin, ForwardIterator end, float* dst)
+{
+    size_t count = 0;
+    for (auto it = begin; it != end; ++it)
+    {
+        if (auto payload = asAnalogPayload(*it))
+        {
+            payload->toFloat(dst + count);
+            count += payload->getSamplesCount();
+        }
+    }
+    return count;
+}
+
+template <typename ForwardIterator>
+size_t AnalogPayload::toDouble(ForwardIterator begin, ForwardIterator end, double* dst)
+{
+    size_t count = 0;
+    for (auto it = begin; it != end; ++it)
+    {
+        if (auto payload = asAnalogPayload(*it))
+        {
+            payload->toDouble(dst + count);
+            count += payload->getSamplesCount();
+        }
+    }
+    return count;
+}
+
 END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Reconstructs the signal of one analog interface from consecutive Analog packets.
+// Physical sample values are stored in blocks of up to blockSize contiguous samples. A block never reallocates,
+// so pointers returned by Block::getData() stay valid until the block is removed.
+// A packet that starts within half a sample interval of the expected timestamp continues the signal,
+// otherwise a gap (new block) or an overlap (already received samples are dropped) is detected.
+// A packet that starts before the last packet is a backward timestamp jump and starts a new block.
+class AnalogStream final
+{
+public:
+    class Block final
+    {
+    public:
+        uint64_t getTimestamp() const;
+        // Timestamp of the sample following the last one
+        uint64_t getEndTimestamp() const;
+        uint64_t getSampleTimestamp(const size_t index) const;
+        float getSampleInterval() const;
+        AnalogPayload::Unit getUnit() const;
+        // True if the block continues the previous one without a gap
+        bool isContinuous() const;
+
+        const float* getData() const;
+        size_t getSize() const;
+        size_t getCapacity() const;
+
+    private:
+        friend class AnalogStream;
+
+        std::unique_ptr<float[]> samples;
+        size_t capacity{0};
+        size_t size{0};
+
+        uint64_t timestamp{0};
+        float sampleInterval{0.f};
+        double sampleIntervalNs{0.};
+        AnalogPayload::Unit unit{AnalogPayload::Unit::undefined};
+        bool continuous{false};
+    };
+
+    struct Stats
+    {
+        uint64_t packets{0};
+        uint64_t samples{0};
+        uint64_t gaps{0};
+        uint64_t overlaps{0};
+        // Estimated from the gap durations
+        uint64_t missingSamples{0};
+        // Samples dropped because of overlaps
+        uint64_t droppedSamples{0};
+        // Packets starting before the previous packet, e.g. after a clock reset of the device
+        uint64_t timestampJumps{0};
+    };
+
+public:
+    // If maxBlocksCount is not 0, the oldest block is removed when a new one is needed and the limit is reached
+    explicit AnalogStream(const uint16_t deviceId = 0,
+                          const uint32_t interfaceId = 0,
+                          const size_t blockSize = defaultBlockSize,
+                          const size_t maxBlocksCount = defaultMaxBlocksCount);
+
+    // Returns false if the packet does not carry a valid Analog payload
+    bool addPacket(const Packet& packet);
+    void clear();
+
+    uint16_t getDeviceId() const;
+    uint32_t getInterfaceId() const;
+    size_t getBlockSize() const;
+    size_t getMaxBlocksCount() const;
+    const Stats& getStats() const;
+
+    // Random access to blocks, from the oldest to the newest
+    size_t getBlocksCount() const;
+    const Block& getBlock(const size_t index) const;
+    // Returns the index of the block containing the timestamp or getBlocksCount() if there is no such block
+    size_t getIndexByTimestamp(const uint64_t timestamp) const;
+    // Removes the oldest blocks, e.g. after they have been processed
+    void removeBlocks(size_t count);
+
+public:
+    static constexpr size_t defaultBlockSize = 65536;
+    static constexpr size_t defaultMaxBlocksCount = 64;
+
+private:
+    Block& addBlock(const uint64_t timestamp, const AnalogPayload& payload, const bool continuous);
+    void appendSamples(const AnalogPayload& payload, size_t firstSample);
+
+private:
+    uint16_t deviceId;
+    uint32_t interfaceId;
+    size_t blockSize;
+    size_t maxBlocksCount;
+
+    std::vector<Block> blocks;
+    Stats stats;
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <asam_cmp/analog_stream.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Routes Analog packets to one AnalogStream per device and interface
+class AnalogStreamAssembler final
+{
+public:
+    explicit AnalogStreamAssembler(const size_t blockSize = AnalogStream::defaultBlockSize,
+                                   const size_t maxBlocksCount = AnalogStream::defaultMaxBlocksCount);
+
+    // Returns false if the packet does not carry a valid Analog payload
+    bool addPacket(const Packet& packet);
+    void clear();
+
+    // Random access to streams
+    size_t getStreamsCount() const;
+    size_t getIndexByInterface(const uint16_t deviceId, const uint32_t interfaceId) const;
+    AnalogStream& getStream(const size_t index);
+    const AnalogStream& getStream(const size_t index) const;
+
+    void removeStream(const uint16_t deviceId, const uint32_t interfaceId);
+
+private:
+    static uint64_t getKey(const uint16_t deviceId, const uint32_t interfaceId);
+
+private:
+    size_t blockSize;
+    size_t maxBlocksCount;
+    std::vector<AnalogStream> streams;
+    // (deviceId << 32) | interfaceId to the position in streams
+    FlatIndexMap<uint64_t> streamIndexes;
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Packs native-endian sample blocks (e.g. from an ADC callback) into Analog packets.
+// Every packet carries as many samples as fit into one CMP message of DataContext::maxBytesPerMessage bytes,
+// so the Encoder never has to segment them. Packet timestamps are derived from the sample interval
+// and stay continuous across calls.
+class AnalogStreamWriter final
+{
+public:
+    using PacketPtr = std::shared_ptr<Packet>;
+
+public:
+    // Unit, sample data type, interval, offset and scalar of the produced payloads are taken from format
+    explicit AnalogStreamWriter(const AnalogPayload& format, const DataContext& dataContext = DataContext{});
+
+    void setDeviceId(const uint16_t id);
+    uint16_t getDeviceId() const;
+    void setStreamId(const uint8_t id);
+    uint8_t getStreamId() const;
+    void setInterfaceId(const uint32_t id);
+    uint32_t getInterfaceId() const;
+
+    // Sets the timestamp of the next sample, pending samples are discarded
+    void setTimestamp(const uint64_t timestamp);
+    // Returns the timestamp of the next packet
+    uint64_t getTimestamp() const;
+
+    size_t getSamplesPerPacket() const;
+    size_t getPendingSamplesCount() const;
+
+    // Returns completed packets, the rest of the samples is kept until the next write or flush.
+    // Throws std::invalid_argument if the sample type does not match the sample data type of the format.
+    std::vector<PacketPtr> write(const int16_t* samples, const size_t count);
+    std::vector<PacketPtr> write(const int32_t* samples, const size_t count);
+    // Returns a packet with the pending samples if there are any
+    std::vector<PacketPtr> flush();
+
+private:
+    template <typename SampleType>
+    std::vector<PacketPtr> writeSamples(const SampleType* samples, const size_t count, std::vector<SampleType>& pendingSamples);
+    template <typename SampleType>
+    PacketPtr createPacket(const SampleType* samples, const size_t count);
+
+    uint64_t getSampleTimestamp(const uint64_t sampleIndex) const;
+
+private:
+    AnalogPayload format;
+    size_t samplesPerPacket{0};
+    size_t sampleSize{0};
+
+    uint16_t deviceId{0};
+    uint8_t streamId{0};
+    uint32_t interfaceId{0};
+
+    uint64_t startTimestamp{0};
+    double sampleIntervalNs{0.};
+    uint64_t samplesWritten{0};
+
+    std::vector<int16_t> pendingSamples16;
+    std::vector<int32_t> pendingSamples32;
+};
+
+END_NAMESPACE_ASAM_CMP
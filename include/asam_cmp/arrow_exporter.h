@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <asam_cmp/arrow_writer.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/packet_batch.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Exports decoded CMP data to Arrow IPC files, one file with its own schema per payload family.
+// Rows are built from the columns and payload bytes of a PacketBatch, so no Packet objects are created.
+// All files start with the columns timestamp, device_id, stream_id and interface_id, followed by:
+//   can:      can_id, ide, fd, dlc, flags, data
+//   lin:      lin_id, pid, checksum, flags, data
+//   ethernet: flags, data
+//   analog:   unit, sample_interval, values (samples converted to physical values)
+//   status:   payload_type, interface_status, interface_type, msg_total_rx/tx, msg_dropped_rx/tx, errors_total_rx/tx,
+//             uptime, gm_identity, device_description, serial_number, hardware_version, software_version
+class ArrowExporter final
+{
+public:
+    enum class Family
+    {
+        can,
+        lin,
+        ethernet,
+        analog,
+        status
+    };
+
+    struct Options
+    {
+        // Files are named <basePath>_<family>.arrow, e.g. capture_can.arrow
+        std::string basePath;
+        size_t batchRows{64 * 1024};
+    };
+
+public:
+    explicit ArrowExporter(Options newOptions);
+    ArrowExporter(const ArrowExporter& other) = delete;
+    ArrowExporter& operator=(const ArrowExporter& other) = delete;
+    ~ArrowExporter();
+
+    // Adds the packets of the batch, returns the number of exported rows. Packets of other payload types and payloads
+    // that are too short for their header are skipped. Files are created with the first row of their family.
+    size_t write(const PacketBatch& batch);
+    // Writes the pending rows and the footers of all files
+    void close();
+
+    std::string getPath(const Family family) const;
+    uint64_t getRowCount(const Family family) const;
+
+private:
+    static constexpr size_t familyCount = 5;
+
+    ArrowWriter& getWriter(const Family family);
+    void appendCommon(ArrowWriter& writer, const PacketBatch& batch, const size_t index);
+    bool writeCan(const PacketBatch& batch, const size_t index);
+    bool writeLin(const PacketBatch& batch, const size_t index);
+    bool writeEthernet(const PacketBatch& batch, const size_t index);
+    bool writeAnalog(const PacketBatch& batch, const size_t index);
+    bool writeStatus(const PacketBatch& batch, const size_t index);
+
+private:
+    Options options;
+    std::array<std::unique_ptr<ArrowWriter>, familyCount> writers;
+    std::vector<float> samples;
+};
+
+END_NAMESPACE_ASAM_CMP
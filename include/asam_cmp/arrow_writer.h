@@ -0,0 +1,122 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Writes a table to an Apache Arrow IPC file (Feather v2) without depending on the Arrow libraries.
+// Rows are collected column by column and written as a record batch every batchRows rows, so memory use is bounded
+// by one batch. Columns are not nullable. Metadata and values are written in host byte order, so the writer supports
+// little-endian hosts only.
+class ArrowWriter final
+{
+public:
+    enum class Type
+    {
+        uint8,
+        uint16,
+        uint32,
+        uint64,
+        float32,
+        boolean,
+        // Nanoseconds since the epoch without time zone
+        timestampNs,
+        binary,
+        utf8,
+        // List of 32-bit floats, e.g. the samples of an analog message
+        float32List
+    };
+
+    struct Column
+    {
+        std::string name;
+        Type type{Type::uint8};
+    };
+
+public:
+    // Throws std::runtime_error if the file cannot be created
+    ArrowWriter(const std::string& path, std::vector<Column> newColumns, const size_t newBatchRows = 64 * 1024);
+    ArrowWriter(const ArrowWriter& other) = delete;
+    ArrowWriter& operator=(const ArrowWriter& other) = delete;
+    ~ArrowWriter();
+
+    // Every column gets exactly one value per row: integers, timestamps and booleans with append(column, uint64_t),
+    // floats with appendFloat and the variable length types with their own method
+    void append(const size_t column, const uint64_t value);
+    void appendFloat(const size_t column, const float value);
+    void appendBinary(const size_t column, const void* data, const size_t size);
+    void appendString(const size_t column, const std::string_view value);
+    void appendList(const size_t column, const float* values, const size_t count);
+    void endRow();
+
+    // Writes the pending rows as a record batch
+    void flush();
+    // Writes the footer and closes the file
+    void close();
+
+    const std::vector<Column>& getColumns() const;
+    uint64_t getRowCount() const;
+    size_t getBatchCount() const;
+
+private:
+    struct ColumnData
+    {
+        // Values, bits of booleans, bytes of variable length types or floats of lists
+        std::vector<uint8_t> values;
+        // Start of every row in values (in list elements for lists), for variable length types
+        std::vector<int32_t> offsets;
+    };
+
+    struct Block
+    {
+        int64_t offset{0};
+        int32_t metadataLength{0};
+        int64_t bodyLength{0};
+    };
+
+    struct BodyBuffer
+    {
+        const void* data{nullptr};
+        size_t size{0};
+    };
+
+    Block writeMessage(const std::vector<uint8_t>& metadata, const std::vector<BodyBuffer>& body, const int64_t bodyLength);
+    void write(const void* data, const size_t size);
+    void checkStream() const;
+
+private:
+    std::string path;
+    std::vector<Column> columns;
+    size_t batchRows;
+
+    std::ofstream stream;
+    int64_t fileOffset{0};
+    std::vector<ColumnData> columnData;
+    size_t batchRowCount{0};
+    uint64_t rowCount{0};
+    std::vector<Block> blocks;
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,186 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+enum class AsyncIoBackend : uint8_t
+{
+    // io_uring where the kernel supports it, the thread pool otherwise
+    automatic,
+    // io_uring with registered buffers and a registered file, Linux only
+    ioUring,
+    // pread/pwrite on worker threads
+    threadPool
+};
+
+// True if io_uring can be used in this process, it may be missing from the kernel or disabled by the system
+bool isIoUringSupported();
+
+class AsyncIo;
+
+// Reads a file sequentially in blocks. Reads of the following blocks are in flight while the caller processes the
+// current one, so decoding of block N overlaps with reading blocks N + 1 .. N + queueDepth.
+class AsyncFileSource final
+{
+public:
+    struct Options
+    {
+        std::string path;
+        std::size_t blockSize{1024 * 1024};
+        std::size_t queueDepth{8};
+        // Space in front of every block for the prefix of next(), larger prefixes are copied together with the block
+        std::size_t headroom{256 * 1024};
+        AsyncIoBackend backend{AsyncIoBackend::automatic};
+    };
+
+    struct Block
+    {
+        const uint8_t* data{nullptr};
+        std::size_t size{0};
+        // File offset of data[0]
+        uint64_t offset{0};
+    };
+
+public:
+    // Throws std::runtime_error if the file cannot be opened or the requested backend is not available
+    explicit AsyncFileSource(Options newOptions);
+    AsyncFileSource(const AsyncFileSource& other) = delete;
+    AsyncFileSource& operator=(const AsyncFileSource& other) = delete;
+    ~AsyncFileSource();
+
+    // Waits for the next block, returns false at the end of the file. The previous block is reused for reading ahead
+    // and is invalid after the call. The prefix, usually the unprocessed end of the previous block, is placed in front
+    // of the new block, so records across block borders are contiguous. Throws std::runtime_error on read errors.
+    bool next(Block& block, const uint8_t* prefix = nullptr, const std::size_t prefixSize = 0);
+    // Starts again at the beginning of the file
+    void rewind();
+
+    uint64_t getFileSize() const;
+    // ioUring or threadPool
+    AsyncIoBackend getBackend() const;
+
+private:
+    struct Buffer
+    {
+        std::vector<uint8_t> storage;
+        uint8_t* data{nullptr};
+        uint64_t offset{0};
+        std::size_t size{0};
+        std::size_t done{0};
+        bool complete{false};
+        std::string error;
+    };
+
+    void submitReads();
+    void waitForCompletion(Buffer& buffer);
+    void complete(const std::size_t index, const int64_t result);
+
+private:
+    Options options;
+    int fd{-1};
+    uint64_t fileSize{0};
+    uint64_t readOffset{0};
+    std::vector<Buffer> buffers;
+    std::vector<std::size_t> freeBuffers;
+    // Buffers in file order
+    std::deque<std::size_t> pendingBuffers;
+    // The buffer of the block returned by next, SIZE_MAX before the first block
+    std::size_t currentBuffer{SIZE_MAX};
+    std::vector<uint8_t> staging;
+    std::unique_ptr<AsyncIo> io;
+};
+
+// Writes a file sequentially. Data is collected in blocks, full blocks are written while the caller continues.
+class AsyncFileSink final
+{
+public:
+    struct Options
+    {
+        std::string path;
+        // Rounded up to a multiple of the 4096 byte I/O alignment
+        std::size_t blockSize{1024 * 1024};
+        std::size_t queueDepth{8};
+        // Bypasses the page cache where supported, falls back to buffered I/O if the file system does not support it
+        bool directIo{false};
+        AsyncIoBackend backend{AsyncIoBackend::automatic};
+    };
+
+    struct Stats
+    {
+        uint64_t bytes{0};
+        uint64_t writes{0};
+        // Number of times all blocks were in flight and write had to wait
+        uint64_t bufferWaits{0};
+    };
+
+public:
+    // Creates or truncates the file. Throws std::runtime_error if it cannot be created or the backend is not available.
+    explicit AsyncFileSink(Options newOptions);
+    AsyncFileSink(const AsyncFileSink& other) = delete;
+    AsyncFileSink& operator=(const AsyncFileSink& other) = delete;
+    ~AsyncFileSink();
+
+    // Write errors of earlier blocks are thrown by the following calls as std::runtime_error
+    void write(const void* data, const std::size_t size);
+    // Waits until everything written so far is in the file. With direct I/O up to 4095 bytes stay buffered until close.
+    void flush();
+    void close();
+    bool isOpen() const;
+
+    const Stats& getStats() const;
+    AsyncIoBackend getBackend() const;
+
+private:
+    struct Buffer
+    {
+        std::vector<uint8_t> storage;
+        uint8_t* data{nullptr};
+        std::size_t used{0};
+        uint64_t offset{0};
+        std::size_t size{0};
+        std::size_t done{0};
+    };
+
+    void submitCurrent(const std::size_t size);
+    void submitWrite(const std::size_t index);
+    void reap(const std::size_t minCompletions);
+
+private:
+    Options options;
+    int fd{-1};
+    bool direct{false};
+    uint64_t fileOffset{0};
+    std::vector<Buffer> buffers;
+    std::vector<std::size_t> freeBuffers;
+    // The block that is filled, SIZE_MAX after a full block until more data arrives
+    std::size_t currentBuffer{SIZE_MAX};
+    std::size_t writesInFlight{0};
+    Stats stats;
+    std::unique_ptr<AsyncIo> io;
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Bounded multi-producer multi-consumer queue without locks (D. Vyukov's array queue). Every slot carries a sequence
+// number that tells a producer or consumer whether the slot is ready for its turn, so a push or pop is one
+// compare-and-swap on the shared position and a release store on the slot. Slots and positions are kept on separate
+// cache lines. The capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue final
+{
+public:
+    explicit BoundedQueue(const size_t capacity);
+    BoundedQueue(const BoundedQueue& other) = delete;
+    BoundedQueue& operator=(const BoundedQueue& other) = delete;
+
+    // Moves the value into the queue, leaves it unchanged and returns false if the queue is full
+    bool tryPush(T& value);
+    // Moves the oldest value out, returns false if the queue is empty
+    bool tryPop(T& value);
+
+    // Exact only while no other thread pushes or pops
+    size_t size() const;
+    size_t capacity() const;
+
+private:
+    static constexpr size_t cacheLineSize = 64;
+
+    struct alignas(cacheLineSize) Slot
+    {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+private:
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(cacheLineSize) std::atomic<size_t> pushPosition{0};
+    alignas(cacheLineSize) std::atomic<size_t> popPosition{0};
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(const size_t capacity)
+{
+    size_t slotCount = 2;
+    while (slotCount < capacity)
+        slotCount *= 2;
+    mask = slotCount - 1;
+    slots = std::make_unique<Slot[]>(slotCount);
+    for (size_t index = 0; index < slotCount; ++index)
+        slots[index].sequence.store(index, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool BoundedQueue<T>::tryPush(T& value)
+{
+    size_t position = pushPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[position & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+        if (difference == 0)
+        {
+            // The slot is free for this position, claim the position
+            if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.value = std::move(value);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The slot still holds the value of the previous round
+            return false;
+        }
+        else
+        {
+            position = pushPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool BoundedQueue<T>::tryPop(T& value)
+{
+    size_t position = popPosition.load(std::memory_order_relaxed);
+    while (true)
+    {
+        Slot& slot = slots[position & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+        if (difference == 0)
+        {
+            if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                value = std::move(slot.value);
+                // Frees the slot for the push one round later
+                slot.sequence.store(position + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Nothing was pushed for this position yet
+            return false;
+        }
+        else
+        {
+            position = popPosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+size_t BoundedQueue<T>::size() const
+{
+    const size_t popped = popPosition.load(std::memory_order_acquire);
+    const size_t pushed = pushPosition.load(std::memory_order_acquire);
+    return pushed > popped ? pushed - popped : 0;
+}
+
+template <typename T>
+size_t BoundedQueue<T>::capacity() const
+{
+    return mask + 1;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <asam_cmp/async_file.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/mapped_file.h>
+#include <asam_cmp/protocol_decoder.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Reads CMP (and TECMP) frames from PCAP and PCAPNG capture files. The file is memory mapped and records, Ethernet,
+// VLAN, IPv4/IPv6 and UDP headers are parsed in place, the returned frames point into the mapping. Alternatively the file
+// is streamed through an AsyncFileSource, which reads the following blocks while the current one is parsed.
+class CaptureFileReader final
+{
+public:
+    enum class Format : uint8_t
+    {
+        unknown,
+        pcap,
+        pcapng
+    };
+
+    // CMP payload of one captured frame
+    struct Frame
+    {
+        const uint8_t* data{nullptr};
+        std::size_t size{0};
+        // Capture time in nanoseconds since the epoch
+        uint64_t timestamp{0};
+        // PCAPNG interface of the record, 0 for PCAP
+        uint32_t interfaceIndex{0};
+    };
+
+    struct Stats
+    {
+        uint64_t records{0};
+        uint64_t frames{0};
+        // Records that are not CMP over Ethernet or UDP
+        uint64_t skippedRecords{0};
+    };
+
+    static constexpr uint16_t cmpEtherType = 0x99FE;
+
+    static constexpr uint32_t linkTypeEthernet = 1;
+    static constexpr uint32_t linkTypeRaw = 101;
+    static constexpr uint32_t linkTypeIpv4 = 228;
+    static constexpr uint32_t linkTypeIpv6 = 229;
+
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is neither PCAP nor PCAPNG
+    explicit CaptureFileReader(const std::string& path);
+    // Streams the file instead of mapping it. A returned frame is valid until the next call of next, a record that does
+    // not fit into the blocks is copied together with the following block.
+    explicit CaptureFileReader(const AsyncFileSource::Options& sourceOptions);
+
+    Format getFormat() const;
+    // Only UDP datagrams to this destination port are read, any port if 0 (default)
+    void setUdpPort(const uint16_t port);
+    uint16_t getUdpPort() const;
+
+    // Fills the next CMP frame, returns false at the end of the file. A record that does not fit into the file ends the walk.
+    bool next(Frame& frame);
+    void rewind();
+    bool isTruncated() const;
+    const Stats& getStats() const;
+
+    // Decodes all remaining frames, calls visitor(const Packet&) for every packet and returns the number of packets
+    template <typename Visitor>
+    std::size_t decode(ProtocolDecoder& decoder, Visitor&& visitor);
+
+    // Finds the CMP payload of a link layer frame: EtherType 0x99FE, or UDP over IPv4/IPv6, optionally VLAN tagged
+    static bool extractPayload(const uint8_t* data,
+                               const std::size_t size,
+                               const uint32_t linkType,
+                               const uint16_t udpPort,
+                               const uint8_t*& payload,
+                               std::size_t& payloadSize);
+
+private:
+    struct Interface
+    {
+        uint32_t linkType{0};
+        // if_tsresol option, microseconds by default
+        uint8_t timestampResolution{6};
+    };
+
+    bool readHeader();
+    bool nextRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp, uint32_t& interfaceIndex);
+    bool nextPcapRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp);
+    bool nextPcapngRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp, uint32_t& interfaceIndex);
+    bool readSectionHeader(const std::size_t blockOffset);
+    void readInterface(const uint8_t* block, const std::size_t blockLength);
+    uint16_t read16(const uint8_t* data) const;
+    uint32_t read32(const uint8_t* data) const;
+    // Returns the file bytes [position, position + length), nullptr if the file ended meanwhile. Pointers returned
+    // earlier become invalid when streaming.
+    const uint8_t* load(const std::size_t position, const std::size_t length);
+    std::size_t getFileSize() const;
+    void releaseConsumed();
+
+private:
+    MappedFile file;
+    std::unique_ptr<AsyncFileSource> source;
+    // Streaming: the file bytes from windowOffset on are at windowData
+    const uint8_t* windowData{nullptr};
+    std::size_t windowOffset{0};
+    std::size_t windowSize{0};
+    Format format{Format::unknown};
+    uint16_t udpPort{0};
+
+    std::size_t offset{0};
+    std::size_t releasedOffset{0};
+    bool swapped{false};
+    bool truncated{false};
+
+    // PCAP
+    uint32_t pcapLinkType{0};
+    uint32_t pcapNanosecondsPerFraction{1000};
+    // PCAPNG interfaces of the current section
+    std::vector<Interface> interfaces;
+
+    Stats stats;
+};
+
+template <typename Visitor>
+std::size_t CaptureFileReader::decode(ProtocolDecoder& decoder, Visitor&& visitor)
+{
+    std::size_t count = 0;
+    Frame frame;
+    while (next(frame))
+        count += decoder.decode(frame.data, frame.size, visitor);
+    return count;
+}
+
+END_NAMESPACE_ASAM_CMP
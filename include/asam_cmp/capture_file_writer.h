@@ -0,0 +1,162 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/async_file.h>
+#include <asam_cmp/capture_file_reader.h>
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Writes frames to PCAPNG files with nanosecond timestamps. Blocks are collected in large aligned buffers that are
+// written by a background thread (or by the caller), optionally with O_DIRECT, and files are rotated by size or time.
+// With asyncIo the blocks are written by an AsyncFileSink instead, io_uring where available.
+class CaptureFileWriter final
+{
+public:
+    struct Options
+    {
+        // Rotated files get an index before the extension: capture.pcapng, capture_1.pcapng, ...
+        std::string path;
+        // Rounded up to a multiple of the 4096 byte I/O alignment
+        std::size_t bufferSize{4 * 1024 * 1024};
+        std::size_t bufferCount{4};
+        // Bypasses the page cache where supported, falls back to buffered I/O if the file system does not support it
+        bool directIo{false};
+        // Writes buffers from a background thread, otherwise the writing call blocks
+        bool backgroundFlush{true};
+        // Writes through AsyncFileSink with bufferCount blocks of bufferSize in flight, backgroundFlush is ignored
+        bool asyncIo{false};
+        AsyncIoBackend asyncIoBackend{AsyncIoBackend::automatic};
+        // Starts a new file before it would exceed this size in bytes, 0 for no limit
+        uint64_t rotateSize{0};
+        // Starts a new file for frames later than this many nanoseconds after the first frame of the file, 0 for no limit
+        uint64_t rotateInterval{0};
+        // Ethernet header of CMP frames written with writeCmpFrame
+        std::array<uint8_t, 6> destinationMac{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        std::array<uint8_t, 6> sourceMac{};
+    };
+
+    struct Stats
+    {
+        uint64_t frames{0};
+        uint64_t bytes{0};
+        uint64_t files{0};
+        // Times the caller had to wait for a free buffer
+        uint64_t bufferWaits{0};
+    };
+
+public:
+    // Throws std::runtime_error if the first file cannot be created
+    explicit CaptureFileWriter(Options newOptions);
+    CaptureFileWriter(const CaptureFileWriter& other) = delete;
+    CaptureFileWriter& operator=(const CaptureFileWriter& other) = delete;
+    ~CaptureFileWriter();
+
+    // Adds an Interface Description Block to the current and every following file, returns the interface index
+    uint32_t addInterface(const std::string& name, const uint32_t linkType = CaptureFileReader::linkTypeEthernet);
+
+    // Writes a link layer frame, the timestamp is in nanoseconds like Packet::getTimestamp()
+    void writeFrame(const uint32_t interfaceIndex, const uint64_t timestamp, const uint8_t* data, const std::size_t size);
+    // Writes a CMP frame, on Ethernet interfaces an Ethernet header with EtherType 0x99FE is added
+    void writeCmpFrame(const uint32_t interfaceIndex, const uint64_t timestamp, const uint8_t* data, const std::size_t size);
+    // Writes the output of Encoder::encode
+    void writeCmpFrames(const uint32_t interfaceIndex, const uint64_t timestamp, const std::vector<std::vector<uint8_t>>& frames);
+
+    // Waits until everything written so far is in the file. With direct I/O up to 4095 bytes stay buffered until close.
+    void flush();
+    // Writes the remaining data and closes the file. Write errors of the background thread are thrown by the next call.
+    void close();
+
+    const Stats& getStats() const;
+    const std::string& getCurrentPath() const;
+
+private:
+    struct Buffer
+    {
+        std::vector<uint8_t> storage;
+        uint8_t* data{nullptr};
+        std::size_t used{0};
+        int fd{-1};
+        bool direct{false};
+        bool closeFile{false};
+    };
+
+    struct Interface
+    {
+        std::string name;
+        uint32_t linkType{0};
+    };
+
+    void openFile();
+    bool isFileOpen() const;
+    void writeFileHeader();
+    void writeInterfaceBlock(const Interface& newInterface);
+    void writePacketBlock(const uint32_t interfaceIndex,
+                          const uint64_t timestamp,
+                          const uint8_t* header,
+                          const std::size_t headerSize,
+                          const uint8_t* data,
+                          const std::size_t size);
+    void append(const void* data, const std::size_t size);
+    void submitBuffer(const bool lastOfFile);
+    Buffer* acquireBuffer();
+    void writeBuffer(Buffer& buffer);
+    void flushThread();
+    void checkError();
+
+private:
+    Options options;
+    std::vector<Interface> interfaces;
+    Stats stats;
+
+    std::string currentPath;
+    std::size_t fileIndex{0};
+    int fd{-1};
+    bool fileDirect{false};
+    std::unique_ptr<AsyncFileSink> sink;
+    uint64_t fileSize{0};
+    bool fileHasFrames{false};
+    uint64_t fileStartTime{0};
+
+    std::vector<Buffer> buffers;
+    Buffer* current{nullptr};
+    std::vector<Buffer*> freeBuffers;
+    std::deque<Buffer*> fullBuffers;
+    std::size_t buffersInFlight{0};
+
+    std::mutex mutex;
+    std::condition_variable bufferReady;
+    std::condition_variable bufferDone;
+    std::atomic<bool> failed{false};
+    std::string error;
+    bool stopping{false};
+    std::thread thread;
+};
+
+END_NAMESPACE_ASAM_CMP
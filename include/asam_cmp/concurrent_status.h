@@ -0,0 +1,125 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
+#include <asam_cmp/interface_status.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/shared_chunk_vector.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Thread-safe variant of Status for one writer (usually the decoding thread) and many readers.
+// Every update publishes a new immutable Snapshot by swapping a pointer; unchanged devices and interfaces are shared
+// between snapshots. Devices, interfaces and their indexes are stored in shared chunks, so an update copies a few
+// pointers instead of all devices. Readers keep using the snapshot they got, so iterating over all devices and interfaces
+// always sees one consistent state (epoch).
+// getSnapshot takes no lock: the reader protects the published pointer with a hazard slot while it copies the
+// shared pointer, and the writer frees replaced pointers only when no slot refers to them.
+class ConcurrentStatus final
+{
+public:
+    class DeviceSnapshot final
+    {
+    public:
+        const Packet& getPacket() const;
+        // Epoch of the last change of the device or one of its interfaces
+        uint64_t getEpoch() const;
+
+        // Random access to interface status
+        size_t getInterfaceStatusCount() const;
+        size_t getIndexByInterfaceId(const uint32_t interfaceId) const;
+        const InterfaceStatus& getInterfaceStatus(const size_t index) const;
+
+    private:
+        friend class ConcurrentStatus;
+
+        std::shared_ptr<const Packet> devicePacket;
+        SharedChunkVector<std::shared_ptr<const InterfaceStatus>> interfaces;
+        // Replaced only when an interface is added
+        std::shared_ptr<const FlatIndexMap<uint32_t>> interfaceIndexes;
+        uint64_t epoch{0};
+    };
+
+    class Snapshot final
+    {
+    public:
+        uint64_t getEpoch() const;
+
+        // Random access to device status
+        size_t getDeviceStatusCount() const;
+        size_t getIndexByDeviceId(const uint16_t deviceId) const;
+        const DeviceSnapshot& getDeviceStatus(const size_t index) const;
+        // Keeps the device snapshot alive independently of this snapshot
+        std::shared_ptr<const DeviceSnapshot> getDeviceStatusPtr(const size_t index) const;
+
+    private:
+        friend class ConcurrentStatus;
+
+        SharedChunkVector<std::shared_ptr<const DeviceSnapshot>> devices;
+        // Replaced only when a device is added or removed
+        std::shared_ptr<const FlatIndexMap<uint16_t>> deviceIndexes;
+        uint64_t epoch{0};
+    };
+
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+public:
+    ConcurrentStatus();
+    ConcurrentStatus(const ConcurrentStatus& other) = delete;
+    ConcurrentStatus& operator=(const ConcurrentStatus& other) = delete;
+    ~ConcurrentStatus();
+
+    // Writers are serialized, readers are never blocked by them
+    void update(const Packet& packet);
+    void update(Packet&& packet);
+    void clear();
+    void removeDeviceById(const uint16_t deviceId);
+
+    // Lock-free, waits only if more than readerSlotCount readers take a snapshot at the same time
+    SnapshotPtr getSnapshot() const;
+    uint64_t getEpoch() const;
+
+public:
+    static constexpr size_t readerSlotCount = 64;
+
+private:
+    template <typename PacketType>
+    void updateDevice(PacketType&& packet);
+    void publish(std::shared_ptr<Snapshot> snapshot);
+    // Frees the retired pointers that are not protected by a reader slot
+    void reclaim();
+
+private:
+    // Owned by the writer, only changed under writerMutex
+    SnapshotPtr current;
+    // A heap copy of current for the readers, replaced copies wait in retired until no reader slot protects them
+    std::atomic<const SnapshotPtr*> published{nullptr};
+    std::vector<const SnapshotPtr*> retired;
+    mutable std::array<std::atomic<const SnapshotPtr*>, readerSlotCount> readerSlots;
+    std::atomic<uint64_t> epoch{0};
+    std::mutex writerMutex;
+};
+
+END_NAMESPACE_ASAM_CMP
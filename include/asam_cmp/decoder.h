@@ -22,6 +22,7 @@
 
 #include <asam_cmp/common.h>
 #include <asam_cmp/packet.h>
+#include <asam_cmp/packet_batch.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
@@ -29,8 +30,15 @@ class Decoder final
 {
 public:
     std::vector<std::shared_ptr<Packet>> decode(const void* data, const std::size_t size);
+    // Appends the decoded packets to the batch and returns their number. Unsegmented CMP messages are copied to the
+    // columns directly, without creating Packet objects.
+    size_t decode(const void* data, const std::size_t size, PacketBatch& batch);
+    // Appends the decoded packets to packets and returns their number, without a shared pointer per message
+    size_t decode(const void* data, const std::size_t size, std::vector<Packet>& packets);
 
 private:
+    template <typename MessageHandler, typename PacketHandler>
+    void decodeCmp(const uint8_t* data, const std::size_t size, MessageHandler&& onMessage, PacketHandler&& onPacket);
     static bool isSegmentedPacket(const uint8_t* data, const size_t);
     static bool isFirstSegment(const uint8_t* data, const size_t);
 
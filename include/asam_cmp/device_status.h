@@ -17,7 +17,9 @@
 #pragma once
 
 #include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
 #include <asam_cmp/interface_status.h>
+#include <asam_cmp/status_change.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
@@ -25,6 +27,7 @@ class DeviceStatus final
 {
 public:
     void update(const Packet& packet);
+    void update(Packet&& packet);
     Packet& getPacket();
     const Packet& getPacket() const;
 
@@ -36,12 +39,35 @@ public:
 
     void removeInterfaceById(uint32_t interfaceId);
 
+    // Time of the last update on the Status aging clock
+    uint64_t getLastSeen() const;
+
+    // Notifies about changes of the device and its interfaces. Changes are only computed while there are subscribers.
+    size_t subscribe(StatusCallback callback);
+    void unsubscribe(const size_t id);
+
 private:
-    void updateInterfaces(const Packet& packet);
+    friend class Status;
+
+    // Status passes its aging clock and its subscribers to notify them about changes of the device as well
+    void update(const Packet& packet, const uint64_t time, const StatusSubscribers* statusSubscribers);
+    void update(Packet&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers);
+    template <typename PacketType>
+    void updateDevice(PacketType&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers);
+    template <typename PacketType>
+    void updateInterfaces(PacketType&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers);
+    void removeInterface(const size_t index, const StatusChange::Type changeType, const StatusSubscribers* statusSubscribers);
+    void detectRestart(const Packet& packet);
+    bool hasSubscribers(const StatusSubscribers* statusSubscribers) const;
+    void notify(const StatusChange& change, const StatusSubscribers* statusSubscribers) const;
 
 private:
     std::vector<InterfaceStatus> interfaces;
+    FlatIndexMap<uint32_t> interfaceIndexes;
     Packet devicePacket;
+    StatusSubscribers subscribers;
+    uint64_t lastSeen{0};
+    uint64_t agingTicket{0};
 };
 
 END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Open-addressing hash map from an integer id to a position in a vector.
+// Uses linear probing in a single flat array and backward-shift deletion, so lookups touch one or two cache lines
+// and no tombstones accumulate.
+template <typename Key>
+class FlatIndexMap final
+{
+    static_assert(std::is_integral_v<Key>, "Key must be an integral type.");
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+public:
+    // Returns npos if the key is not in the map
+    size_t find(const Key key) const;
+    // Inserts the key or replaces its index
+    void insert(const Key key, const size_t index);
+    void erase(const Key key);
+    void clear();
+    void reserve(const size_t count);
+    size_t size() const;
+
+private:
+    struct Slot
+    {
+        Key key{};
+        size_t index{npos};
+    };
+
+    size_t getHomeSlot(const Key key) const;
+    void rehash(const size_t newCapacity);
+
+private:
+    static constexpr size_t minCapacity = 8;
+
+    std::vector<Slot> slots;
+    size_t count{0};
+    unsigned shift{64};
+};
+
+template <typename Key>
+size_t FlatIndexMap<Key>::find(const Key key) const
+{
+    if (count == 0)
+        return npos;
+
+    const size_t mask = slots.size() - 1;
+    for (size_t pos = getHomeSlot(key);; pos = (pos + 1) & mask)
+    {
+        const Slot& slot = slots[pos];
+        if (slot.index == npos)
+            return npos;
+        if (slot.key == key)
+            return slot.index;
+    }
+}
+
+template <typename Key>
+void FlatIndexMap<Key>::insert(const Key key, const size_t index)
+{
+    // Keep the load factor at or below one half
+    if ((count + 1) * 2 > slots.size())
+        rehash(slots.empty() ? minCapacity : slots.size() * 2);
+
+    const size_t mask = slots.size() - 1;
+    for (size_t pos = getHomeSlot(key);; pos = (pos + 1) & mask)
+    {
+        Slot& slot = slots[pos];
+        if (slot.index == npos)
+        {
+            slot.key = key;
+            slot.index = index;
+            ++count;
+            return;
+        }
+        if (slot.key == key)
+        {
+            slot.index = index;
+            return;
+        }
+    }
+}
+
+template <typename Key>
+void FlatIndexMap<Key>::erase(const Key key)
+{
+    if (count == 0)
+        return;
+
+    const size_t mask = slots.size() - 1;
+    size_t hole = getHomeSlot(key);
+    for (;; hole = (hole + 1) & mask)
+    {
+        if (slots[hole].index == npos)
+            return;
+        if (slots[hole].key == key)
+            break;
+    }
+
+    // Move back the following entries of the probe sequence that may not be placed after the hole
+    for (size_t pos = (hole + 1) & mask; slots[pos].index != npos; pos = (pos + 1) & mask)
+    {
+        const size_t home = getHomeSlot(slots[pos].key);
+        const size_t distanceToHome = (pos - home) & mask;
+        const size_t distanceToHole = (pos - hole) & mask;
+        if (distanceToHome >= distanceToHole)
+        {
+            slots[hole] = slots[pos];
+            hole = pos;
+        }
+    }
+
+    slots[hole] = Slot{};
+    --count;
+}
+
+template <typename Key>
+void FlatIndexMap<Key>::clear()
+{
+    slots.clear();
+    count = 0;
+    shift = 64;
+}
+
+template <typename Key>
+void FlatIndexMap<Key>::reserve(const size_t newCount)
+{
+    size_t capacity = slots.empty() ? minCapacity : slots.size();
+    while (newCount * 2 > capacity)
+        capacity *= 2;
+
+    if (capacity != slots.size())
+        rehash(capacity);
+}
+
+template <typename Key>
+size_t FlatIndexMap<Key>::size() const
+{
+    return count;
+}
+
+template <typename Key>
+size_t FlatIndexMap<Key>::getHomeSlot(const Key key) const
+{
+    // Fibonacci hashing spreads sequential ids over the whole table
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+template <typename Key>
+void FlatIndexMap<Key>::rehash(const size_t newCapacity)
+{
+    std::vector<Slot> oldSlots(newCapacity);
+    oldSlots.swap(slots);
+
+    shift = 64;
+    for (size_t capacity = newCapacity; capacity > 1; capacity >>= 1)
+        --shift;
+
+    count = 0;
+    for (const auto& slot : oldSlots)
+    {
+        if (slot.index != npos)
+            insert(slot.key, slot.index);
+    }
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/payload.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+class FlexRayPayload : public Payload
+{
+public:
+    enum class Flags : uint16_t
+    {
+        crcFrameErr = 0x0001,
+        crcHeaderErr = 0x0002,
+        nullFrame = 0x0004,
+        startupFrame = 0x0008,
+        syncFrame = 0x0010,
+        wus = 0x0020,
+        ppi = 0x0040,
+        cas = 0x0080
+    };
+
+#pragma pack(push, 1)
+    class Header
+    {
+        uint16_t flags{0};
+        uint8_t reserved1{0};
+        uint16_t headerCrc{0};
+        uint16_t frameId{0};
+        uint8_t cycle{0};
+        uint8_t frameCrc[3]{};
+        uint8_t reserved2{0};
+        uint8_t payloadLength{0};
+
+    public:
+        uint16_t getFlags() const;
+        void setFlags(const uint16_t newFlags);
+        bool getFlag(const Flags mask) const;
+        void setFlag(const Flags mask, const bool value);
+        uint16_t getHeaderCrc() const;
+        void setHeaderCrc(const uint16_t crc);
+        uint16_t getFrameId() const;
+        void setFrameId(const uint16_t id);
+        uint8_t getCycle() const;
+        void setCycle(const uint8_t newCycle);
+        uint32_t getFrameCrc() const;
+        void setFrameCrc(const uint32_t crc);
+        uint8_t getPayloadLength() const;
+        void setPayloadLength(const uint8_t length);
+    };
+#pragma pack(pop)
+
+public:
+    FlexRayPayload();
+    FlexRayPayload(const uint8_t* data, const size_t size);
+
+    uint16_t getFlags() const;
+    void setFlags(const uint16_t newFlags);
+    bool getFlag(const Flags mask) const;
+    void setFlag(const Flags mask, const bool value);
+
+    uint16_t getHeaderCrc() const;
+    void setHeaderCrc(const uint16_t crc);
+    uint16_t getFrameId() const;
+    void setFrameId(const uint16_t id);
+    uint8_t getCycle() const;
+    void setCycle(const uint8_t cycle);
+    // 24-bit frame CRC
+    uint32_t getFrameCrc() const;
+    void setFrameCrc(const uint32_t crc);
+
+    uint8_t getPayloadLength() const;
+    const uint8_t* getData() const;
+    void setData(const uint8_t* data, const uint8_t dataLength);
+
+    static bool isValidPayload(const uint8_t* data, const size_t size);
+
+protected:
+    const Header* getHeader() const;
+    Header* getHeader();
+
+private:
+    static constexpr uint16_t errorMask = 0x0003;
+};
+
+END_NAMESPACE_ASAM_CMP
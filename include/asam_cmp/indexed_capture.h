@@ -0,0 +1,264 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
+#include <asam_cmp/mapped_file.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Block structured capture container for CMP packets:
+//   FileHeader, then Blocks of BlockHeader, IndexEntry[keyCount] and Records, then the footer of
+//   BlockEntry[blockCount], IndexEntry[entryCount] sorted by key and Trailer.
+// Every block carries the index entries of its own keys, so a file that is still written (or was not closed)
+// is indexed by walking the block headers; the footer only saves that walk. All values are in host byte order.
+struct IndexedCaptureFormat
+{
+    static constexpr uint32_t fileMagic = 0x58444943;  // "CIDX"
+    static constexpr uint32_t blockMagic = 0x4B4C4243;  // "CBLK"
+    static constexpr uint32_t trailerMagic = 0x444E4543;  // "CEND"
+    static constexpr uint16_t version = 1;
+
+#pragma pack(push, 1)
+    struct FileHeader
+    {
+        uint32_t magic{fileMagic};
+        uint16_t version{IndexedCaptureFormat::version};
+        uint16_t reserved{0};
+        uint64_t reserved2{0};
+    };
+
+    struct BlockHeader
+    {
+        uint32_t magic{blockMagic};
+        // Including this header, the index entries and the records
+        uint32_t blockSize{0};
+        uint32_t recordCount{0};
+        uint32_t keyCount{0};
+        uint64_t minTimestamp{0};
+        uint64_t maxTimestamp{0};
+    };
+
+    // Packets of one key in one block
+    struct IndexEntry
+    {
+        uint32_t interfaceId{0};
+        uint16_t deviceId{0};
+        uint16_t payloadType{0};
+        uint32_t blockIndex{0};
+        uint32_t recordCount{0};
+        uint64_t minTimestamp{0};
+        uint64_t maxTimestamp{0};
+    };
+
+    // Followed by the message header and the payload, padded to 4 bytes. The key fields are repeated here, so records
+    // are filtered without parsing the message header.
+    struct RecordHeader
+    {
+        uint32_t recordSize{0};
+        uint32_t interfaceId{0};
+        uint64_t timestamp{0};
+        uint16_t deviceId{0};
+        uint16_t payloadType{0};
+        uint16_t sequenceCounter{0};
+        uint8_t version{0};
+        uint8_t streamId{0};
+    };
+
+    struct BlockEntry
+    {
+        uint64_t offset{0};
+        uint64_t minTimestamp{0};
+        uint64_t maxTimestamp{0};
+        uint32_t blockSize{0};
+        uint32_t recordCount{0};
+    };
+
+    struct Trailer
+    {
+        uint64_t footerOffset{0};
+        uint32_t blockCount{0};
+        uint32_t entryCount{0};
+        uint32_t magic{trailerMagic};
+        uint32_t reserved{0};
+    };
+#pragma pack(pop)
+};
+
+// Writes packets incrementally. A block is appended to the file when it reaches blockSize or blockDuration,
+// so readers see the packets of completed blocks while capturing continues.
+class IndexedCaptureWriter final
+{
+public:
+    struct Options
+    {
+        std::string path;
+        // Target size of a block in bytes
+        std::size_t blockSize{1024 * 1024};
+        // Maximal time range of a block in nanoseconds, 0 for no limit
+        uint64_t blockDuration{0};
+    };
+
+public:
+    // Throws std::runtime_error if the file cannot be created
+    explicit IndexedCaptureWriter(Options newOptions);
+    IndexedCaptureWriter(const IndexedCaptureWriter& other) = delete;
+    IndexedCaptureWriter& operator=(const IndexedCaptureWriter& other) = delete;
+    ~IndexedCaptureWriter();
+
+    void write(const Packet& packet);
+    template <typename ForwardIterator>
+    void write(ForwardIterator begin, ForwardIterator end);
+
+    // Appends the current block to the file, so it becomes visible to readers
+    void flushBlock();
+    // Appends the current block and the footer index and closes the file
+    void close();
+
+    std::size_t getBlockCount() const;
+    uint64_t getPacketCount() const;
+
+private:
+    void checkStream() const;
+
+private:
+    using Format = IndexedCaptureFormat;
+
+    Options options;
+    std::ofstream stream;
+    uint64_t fileOffset{0};
+    uint64_t packetCount{0};
+
+    std::vector<uint8_t> records;
+    Format::BlockHeader blockHeader;
+    std::vector<Format::IndexEntry> blockKeys;
+    FlatIndexMap<uint64_t> blockKeyIndexes;
+
+    std::vector<Format::BlockEntry> blocks;
+    std::vector<Format::IndexEntry> entries;
+};
+
+template <typename ForwardIterator>
+void IndexedCaptureWriter::write(ForwardIterator begin, ForwardIterator end)
+{
+    for (; begin != end; ++begin)
+        write(*begin);
+}
+
+// Answers point and range queries by interface, device, payload type and time. Only blocks with a matching index entry
+// are read from the memory mapping, and only records of those blocks that match are decoded.
+class IndexedCaptureReader final
+{
+public:
+    struct Query
+    {
+        // Inclusive time range in nanoseconds
+        uint64_t beginTime{0};
+        uint64_t endTime{std::numeric_limits<uint64_t>::max()};
+        // Empty lists match everything
+        std::vector<uint32_t> interfaceIds;
+        std::vector<uint16_t> deviceIds;
+        std::vector<PayloadType> payloadTypes;
+    };
+
+    struct Stats
+    {
+        uint64_t blocksRead{0};
+        uint64_t recordsRead{0};
+    };
+
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not an indexed capture
+    explicit IndexedCaptureReader(const std::string& path);
+
+    // True if the file was closed by the writer and the footer index was used
+    bool isComplete() const;
+    // Maps the file again and indexes blocks appended since the last call, returns true if there are new blocks
+    bool refresh();
+
+    std::size_t getBlockCount() const;
+    uint64_t getPacketCount() const;
+    uint64_t getBeginTime() const;
+    uint64_t getEndTime() const;
+    const Stats& getStats() const;
+
+    // Calls visitor(const Packet&) for every matching packet in file order and returns the number of packets
+    template <typename Visitor>
+    std::size_t query(const Query& query, Visitor&& visitor);
+    std::vector<Packet> query(const Query& query);
+
+private:
+    using Format = IndexedCaptureFormat;
+
+    bool readFooter();
+    void readBlocks();
+    std::vector<uint32_t> findBlocks(const Query& query) const;
+    // Returns the first record of the block, throws std::runtime_error if the block header is corrupted
+    const uint8_t* getRecords(const Format::BlockEntry& block) const;
+    // Throws std::runtime_error if the record does not fit into the rest of the block
+    void checkRecord(const uint8_t* record, const uint8_t* blockEnd) const;
+    bool matches(const Query& query, const uint8_t* record) const;
+    Packet createPacket(const uint8_t* record) const;
+
+private:
+    std::string path;
+    MappedFile file;
+    bool complete{false};
+    // Offset of the next block header not indexed yet
+    uint64_t nextBlockOffset{sizeof(Format::FileHeader)};
+    uint64_t packetCount{0};
+    Stats stats;
+
+    std::vector<Format::BlockEntry> blocks;
+    std::vector<Format::IndexEntry> entries;
+};
+
+template <typename Visitor>
+std::size_t IndexedCaptureReader::query(const Query& query, Visitor&& visitor)
+{
+    std::size_t count = 0;
+    for (const auto blockIndex : findBlocks(query))
+    {
+        const auto& block = blocks[blockIndex];
+        const uint8_t* record = getRecords(block);
+        const uint8_t* blockEnd = file.getData() + block.offset + block.blockSize;
+        ++stats.blocksRead;
+
+        for (uint32_t index = 0; index < block.recordCount; ++index)
+        {
+            checkRecord(record, blockEnd);
+            ++stats.recordsRead;
+            if (matches(query, record))
+            {
+                visitor(createPacket(record));
+                ++count;
+            }
+            record += reinterpret_cast<const Format::RecordHeader*>(record)->recordSize;
+        }
+    }
+    return count;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/interface_payload.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Per second rates of the cumulative Interface Status Message counters.
+// Rates are updated incrementally from consecutive status messages, no history besides a small ring of intervals is kept.
+// 32-bit counter wrap-around is handled by unsigned subtraction. A Capture Module restart resets the counters, which is
+// indistinguishable from a wrap, so the owner has to call restart() when the module uptime goes backwards.
+class InterfaceRates final
+{
+public:
+    struct Rates
+    {
+        double msgTotalRx{0};
+        double msgTotalTx{0};
+        double msgDroppedRx{0};
+        double msgDroppedTx{0};
+        double errorsTotalRx{0};
+        double errorsTotalTx{0};
+    };
+
+    static constexpr uint64_t defaultTimeConstant = 10'000'000'000;  // 10 s
+    static constexpr uint64_t defaultWindow = 60'000'000'000;        // 60 s
+    static constexpr size_t maxWindowIntervals = 64;
+
+public:
+    // Time constant of the exponentially weighted rates and duration of the windowed rates, in nanoseconds
+    void setTimeConstant(const uint64_t newTimeConstant);
+    uint64_t getTimeConstant() const;
+    void setWindow(const uint64_t newWindow);
+    uint64_t getWindow() const;
+
+    // timestamp is the message timestamp in nanoseconds
+    void update(const InterfacePayload& payload, const uint64_t timestamp);
+    // The next update starts from new counter values, computed rates are kept
+    void restart();
+    void reset();
+
+    // True after two updates with increasing timestamps
+    bool isValid() const;
+    const Rates& getEwmaRates() const;
+    Rates getWindowedRates() const;
+    // Time span covered by the windowed rates in nanoseconds
+    uint64_t getWindowedDuration() const;
+    uint32_t getRestartCount() const;
+
+private:
+    static constexpr size_t counterCount = 6;
+    using Counters = std::array<uint32_t, counterCount>;
+
+    struct Interval
+    {
+        uint64_t duration{0};
+        Counters deltas{};
+    };
+
+    static Counters readCounters(const InterfacePayload& payload);
+    static Rates toRates(const std::array<double, counterCount>& values);
+    void pushInterval(const Interval& interval);
+    void popInterval();
+
+private:
+    uint64_t timeConstant{defaultTimeConstant};
+    uint64_t window{defaultWindow};
+
+    bool hasBaseline{false};
+    uint64_t lastTimestamp{0};
+    Counters lastCounters{};
+
+    bool valid{false};
+    std::array<double, counterCount> ewma{};
+    Rates ewmaRates;
+
+    std::array<Interval, maxWindowIntervals> intervals;
+    size_t intervalsBegin{0};
+    size_t intervalsCount{0};
+    uint64_t windowDuration{0};
+    std::array<uint64_t, counterCount> windowDeltas{};
+
+    uint32_t restartCount{0};
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <asam_cmp/common.h>
+#include <asam_cmp/interface_rates.h>
 #include <asam_cmp/packet.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
@@ -25,14 +26,30 @@ class InterfaceStatus final
 {
 public:
     void update(const Packet& packet);
+    void update(Packet&& packet);
     Packet& getPacket();
     const Packet& getPacket() const;
 
     uint32_t getInterfaceId() const;
 
+    // Rates of the interface counters, updated with every message
+    InterfaceRates& getRates();
+    const InterfaceRates& getRates() const;
+    // Called when the Capture Module restarted, so the reset counters are not taken as a wrap-around
+    void restart();
+
+    // Time of the last update on the Status aging clock
+    uint64_t getLastSeen() const;
+
 private:
+    friend class DeviceStatus;
+    friend class Status;
+
     Packet interfacePacket;
     uint32_t interfaceId{0};
+    InterfaceRates rates;
+    uint64_t lastSeen{0};
+    uint64_t agingTicket{0};
 };
 
 END_NAMESPACE_ASAM_CMP
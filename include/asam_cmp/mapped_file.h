@@ -0,0 +1,64 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Read-only memory mapping of a whole file. Pages are loaded on access by the OS, so files larger than RAM can be
+// mapped on 64-bit systems; release() drops pages that were already processed.
+class MappedFile final
+{
+public:
+    MappedFile() = default;
+    // Throws std::runtime_error if the file cannot be opened or mapped
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    void open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    const uint8_t* getData() const;
+    std::size_t getSize() const;
+
+    // Hints the OS to read ahead aggressively for sequential access
+    void adviseSequential() const;
+    // Hints the OS that the range is not needed anymore, the pages are read again from the file on the next access
+    void release(const std::size_t offset, const std::size_t length) const;
+
+private:
+    const uint8_t* data{nullptr};
+    std::size_t size{0};
+#ifdef _WIN32
+    void* fileHandle{nullptr};
+    void* mappingHandle{nullptr};
+#else
+    int fd{-1};
+#endif
+};
+
+END_NAMESPACE_ASAM_CMP
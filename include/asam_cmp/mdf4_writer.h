@@ -0,0 +1,209 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/packet_batch.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Writes decoded CMP data to an ASAM MDF 4.1 file following the bus logging conventions.
+// Every bus (device id and interface id) gets sorted channel groups with a float64 master channel "Timestamp" in seconds
+// since the start time of the file:
+//   CAN_DataFrame: BusChannel, ID, IDE, DLC, EDL, BRS, ESI, DataLength, DataBytes (8 bytes for CAN, 64 for CAN FD)
+//   LIN_Frame:     BusChannel, ID, DataLength, Checksum, DataBytes
+//   ETH_Frame:     BusChannel, Destination, Source, EtherType, DataLength, DataBytes (variable length signal data)
+// Analog payloads get one record per sample with the raw integer value and a linear conversion from the sample offset
+// and scalar of the payload; a new channel group is started when the sample type, scaling or unit changes.
+// Records of each group are collected in large buffers that are written as DT (or deflate compressed DZ) blocks by a
+// worker thread. The channel hierarchy is written when the file is closed.
+class Mdf4Writer final
+{
+public:
+    struct Options
+    {
+        std::string path;
+        // Records of a channel group are written as one data block when this many bytes are collected
+        size_t blockSize{4 * 1024 * 1024};
+        // Data blocks waiting for the worker thread before the writing call blocks
+        size_t maxPendingBlocks{8};
+        // Compresses data blocks with deflate, ignored if the library is built without zlib
+        bool compress{false};
+        // Nanoseconds since 1970-01-01 UTC, 0 takes the timestamp of the first logged packet
+        uint64_t startTime{0};
+    };
+
+    struct Stats
+    {
+        uint64_t frames{0};
+        uint64_t samples{0};
+        uint64_t blocks{0};
+        // Record and signal data before compression
+        uint64_t dataBytes{0};
+        // Set when the file is closed
+        uint64_t fileBytes{0};
+    };
+
+public:
+    // Throws std::runtime_error if the file cannot be created
+    explicit Mdf4Writer(Options newOptions);
+    Mdf4Writer(const Mdf4Writer& other) = delete;
+    Mdf4Writer& operator=(const Mdf4Writer& other) = delete;
+    ~Mdf4Writer();
+
+    // Logs CAN, CAN FD, LIN, Ethernet and Analog payloads. Returns false for other payload types, error frames and
+    // payloads that are too short for their header.
+    bool write(const Packet& packet);
+    // Writes the output of Decoder::decode, returns the number of logged packets
+    size_t write(const std::vector<std::shared_ptr<Packet>>& packets);
+    size_t write(const PacketBatch& batch);
+
+    // Writes the remaining data blocks and the channel hierarchy. Write errors of the worker thread are thrown by the
+    // next call.
+    void close();
+
+    size_t getChannelGroupCount() const;
+    const Stats& getStats() const;
+
+    static bool isCompressionSupported();
+
+private:
+    enum class Kind : uint8_t
+    {
+        can,
+        canFd,
+        lin,
+        ethernet,
+        analog
+    };
+
+    struct BlockRef
+    {
+        uint64_t offset{0};
+        uint64_t dataLength{0};
+    };
+
+    // Records (or variable length signal data) of one channel group, split into data blocks
+    struct Stream
+    {
+        std::vector<uint8_t> buffer;
+        std::vector<BlockRef> blocks;
+        uint64_t size{0};
+    };
+
+    struct Group
+    {
+        Kind kind{Kind::can};
+        uint16_t deviceId{0};
+        uint32_t interfaceId{0};
+        uint8_t busChannel{0};
+        size_t recordSize{0};
+        uint64_t cycleCount{0};
+        Stream records;
+        Stream signalData;
+
+        AnalogPayload::SampleDt sampleDt{AnalogPayload::SampleDt::aInt16};
+        AnalogPayload::Unit unit{AnalogPayload::Unit::undefined};
+        float sampleOffset{0.f};
+        float sampleScalar{0.f};
+    };
+
+    struct Job
+    {
+        std::vector<uint8_t> data;
+        std::vector<BlockRef>* blocks{nullptr};
+        // 0 for signal data blocks
+        size_t recordSize{0};
+    };
+
+    bool writePayload(const uint16_t deviceId,
+                      const uint32_t interfaceId,
+                      const uint64_t timestamp,
+                      const uint32_t type,
+                      const uint8_t* payload,
+                      const size_t length);
+    bool writeCan(const uint16_t deviceId,
+                  const uint32_t interfaceId,
+                  const Kind kind,
+                  const double time,
+                  const uint8_t* payload,
+                  const size_t length);
+    bool writeLin(const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length);
+    bool writeEthernet(const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length);
+    bool writeAnalog(const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length);
+
+    Group& getGroup(const Kind kind, const uint16_t deviceId, const uint32_t interfaceId);
+    Group& addGroup(const Kind kind, const uint16_t deviceId, const uint32_t interfaceId, const size_t recordSize);
+    double getTime(const uint64_t timestamp);
+    uint8_t* addRecord(Group& group);
+    void addSignalData(Group& group, const uint8_t* data, const size_t size);
+    void submit(Stream& stream, const size_t recordSize);
+
+    void writeFileHeader(const bool finished);
+    void writeChannelHierarchy();
+    void writeBlock(const Job& job);
+    void workerThread();
+    void stopWorker();
+    void checkError();
+
+private:
+    Options options;
+    Stats stats;
+    std::ofstream file;
+    bool compress{false};
+    bool closed{false};
+    bool started{false};
+    uint64_t startTime{0};
+    uint64_t firstDataGroup{0};
+    uint64_t fileHistory{0};
+
+    std::vector<std::unique_ptr<Group>> groups;
+    FlatIndexMap<uint64_t> groupIndexes;
+    FlatIndexMap<uint64_t> busChannels;
+    uint8_t busChannelCounts[4]{};
+
+    // Owned by the worker thread until it is stopped
+    uint64_t fileEnd{0};
+    std::vector<uint8_t> transposed;
+    std::vector<uint8_t> compressed;
+
+    std::deque<Job> jobs;
+    std::vector<std::vector<uint8_t>> freeBuffers;
+    std::mutex mutex;
+    std::condition_variable jobReady;
+    std::condition_variable jobDone;
+    std::atomic<bool> failed{false};
+    std::string error;
+    bool stopping{false};
+    std::thread thread;
+};
+
+END_NAMESPACE_ASAM_CMP
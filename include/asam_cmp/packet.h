@@ -76,6 +76,7 @@ public:
     void getRawMessageHeader(void* dest) const;
 
     void setPayload(const Payload& newPayload);
+    void setPayload(Payload&& newPayload);
     const Payload& getPayload() const;
     Payload& getPayload();
 
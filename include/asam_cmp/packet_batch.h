@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/message_header.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Struct-of-arrays representation of many decoded packets for scans and reductions over dense memory.
+// Every column has one value per packet and the payloads of all packets are stored back to back in one arena.
+// Type specific columns hold 0 for packets of other payload types.
+class PacketBatch final
+{
+public:
+    PacketBatch() = default;
+
+    // Removes all packets, the capacity is kept for the next batch
+    void clear();
+    void reserve(const size_t packetCount, const size_t payloadBytes);
+    size_t size() const;
+    bool empty() const;
+
+    void append(const Packet& packet);
+    // Appends a message without creating a Packet. The message must pass Packet::isValidPacket.
+    void append(const uint8_t version,
+                const uint16_t deviceId,
+                const uint8_t streamId,
+                const uint16_t sequenceCounter,
+                const CmpHeader::MessageType messageType,
+                const MessageHeader& header,
+                const uint8_t* payload);
+
+    // Creates the packet at index, equal to the packet that was decoded. Like the Decoder, it has an invalid payload if
+    // the payload does not pass validation (e.g. CAN error frames).
+    Packet getPacket(const size_t index) const;
+
+    // Columns
+    const std::vector<uint64_t>& getTimestamps() const;
+    // Interface id of data messages, 0 for other messages
+    const std::vector<uint32_t>& getInterfaceIds() const;
+    // Vendor id of status and vendor messages, 0 for other messages
+    const std::vector<uint16_t>& getVendorIds() const;
+    const std::vector<uint16_t>& getDeviceIds() const;
+    const std::vector<uint8_t>& getStreamIds() const;
+    const std::vector<uint8_t>& getVersions() const;
+    const std::vector<uint16_t>& getSequenceCounters() const;
+    // PayloadType::getType() of the message header, also for payloads that fail validation
+    const std::vector<uint16_t>& getPayloadTypes() const;
+    const std::vector<uint8_t>& getCommonFlags() const;
+    // Flags of CAN, CAN FD, LIN, FlexRay, Ethernet and Analog payloads
+    const std::vector<uint16_t>& getPayloadFlags() const;
+    // size() + 1 offsets into the payload arena, the payload of packet i ends where the payload of packet i + 1 starts
+    const std::vector<uint64_t>& getPayloadOffsets() const;
+    const std::vector<uint8_t>& getPayloadArena() const;
+
+    // Type specific columns
+    // Identifier of CAN and CAN FD frames
+    const std::vector<uint32_t>& getCanIds() const;
+    const std::vector<uint8_t>& getCanDlcs() const;
+    // Protected identifier (identifier and parity bits) of LIN frames
+    const std::vector<uint8_t>& getLinPids() const;
+    const std::vector<uint8_t>& getAnalogUnits() const;
+
+    const uint8_t* getPayload(const size_t index) const;
+    size_t getPayloadLength(const size_t index) const;
+
+private:
+    void appendRow(const uint8_t version,
+                   const uint16_t deviceId,
+                   const uint8_t streamId,
+                   const uint16_t sequenceCounter,
+                   const CmpHeader::MessageType messageType,
+                   const MessageHeader& header,
+                   const PayloadType type,
+                   const uint8_t* payload);
+
+private:
+    std::vector<uint64_t> timestamps;
+    std::vector<uint32_t> interfaceIds;
+    std::vector<uint16_t> vendorIds;
+    std::vector<uint16_t> deviceIds;
+    std::vector<uint8_t> streamIds;
+    std::vector<uint8_t> versions;
+    std::vector<uint16_t> sequenceCounters;
+    std::vector<uint16_t> payloadTypes;
+    std::vector<uint8_t> commonFlags;
+    std::vector<uint16_t> payloadFlags;
+    std::vector<uint64_t> payloadOffsets{0};
+    std::vector<uint8_t> payloadArena;
+
+    std::vector<uint32_t> canIds;
+    std::vector<uint8_t> canDlcs;
+    std::vector<uint8_t> linPids;
+    std::vector<uint8_t> analogUnits;
+};
+
+END_NAMESPACE_ASAM_CMP
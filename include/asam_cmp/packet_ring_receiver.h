@@ -0,0 +1,141 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/packet_batch.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Receives raw CMP Ethernet frames (EtherType 0x99FE) with AF_PACKET sockets and TPACKET_V3 receive rings.
+// Every thread owns one socket with its own ring and Decoder. The frames of a ring block are decoded in place from the
+// mapped memory into one PacketBatch, then the block is returned to the kernel. With more than one thread the sockets
+// join a PACKET_FANOUT group. Needs CAP_NET_RAW.
+class PacketRingReceiver final
+{
+public:
+    enum class FanoutMode : uint8_t
+    {
+        // Frames of one flow go to the same thread, which keeps segmented messages on one decoder
+        hash,
+        // Round robin, the segments of a message may be split between decoders and are then not reassembled
+        loadBalance,
+        // The thread is chosen by the CPU that received the frame
+        cpu
+    };
+
+    struct Options
+    {
+        // Empty for all interfaces
+        std::string interfaceName;
+        size_t threadCount{1};
+        FanoutMode fanoutMode{FanoutMode::hash};
+        // Fanout group id, 0 lets the kernel choose an id that is not used by any other socket (Linux 4.4 and later)
+        uint16_t fanoutGroup{0};
+        // Ring of every thread, the block size must be a multiple of the page size
+        uint32_t blockSize{1 << 20};
+        uint32_t blockCount{64};
+        // Minimum slot size of a frame in the block
+        uint32_t frameSize{2048};
+        // Milliseconds after which the kernel returns a block that is not full
+        uint32_t blockTimeout{10};
+        // Skips frames sent by this host
+        bool ignoreOutgoing{true};
+        // Milliseconds between checks for stop while no blocks arrive
+        int pollTimeout{50};
+    };
+
+    // Frames of one ring block
+    struct Batch
+    {
+        size_t threadIndex{0};
+        PacketBatch packets;
+        // Kernel receive time of the frame of every packet in nanoseconds since the Unix epoch
+        std::vector<uint64_t> receiveTimes;
+    };
+
+    struct Stats
+    {
+        uint64_t frames{0};
+        uint64_t bytes{0};
+        uint64_t packets{0};
+        uint64_t blocks{0};
+        // Frames that did not fit into the frame slot
+        uint64_t truncated{0};
+        // Frames dropped by the kernel because the ring was full
+        uint64_t drops{0};
+    };
+
+    // Called from the receiving threads, concurrently for different threads. The batch is reused after the call.
+    using BatchHandler = std::function<void(const Batch& batch)>;
+
+public:
+    // Throws std::runtime_error if a socket or ring cannot be created, e.g. without CAP_NET_RAW
+    PacketRingReceiver(Options newOptions, BatchHandler newHandler);
+    PacketRingReceiver(const PacketRingReceiver& other) = delete;
+    PacketRingReceiver& operator=(const PacketRingReceiver& other) = delete;
+    ~PacketRingReceiver();
+
+    void start();
+    // Waits for the receiving threads. Receive errors of the threads are thrown here.
+    void stop();
+
+    // Sums of all threads, can be called while receiving
+    Stats getStats() const;
+
+private:
+    struct Worker
+    {
+        int fd{-1};
+        uint8_t* ring{nullptr};
+        std::thread thread;
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> truncated{0};
+        std::atomic<uint64_t> drops{0};
+    };
+
+    void openSocket(Worker& worker, const int interfaceIndex, uint16_t& fanoutGroup, const bool assignFanoutGroup);
+    void closeSocket(Worker& worker);
+    void receiveThread(const size_t threadIndex);
+    void decodeBlock(const uint8_t* block, Decoder& decoder, Batch& batch, Worker& worker);
+    void setError(const std::string& message);
+
+private:
+    Options options;
+    BatchHandler handler;
+    size_t ringSize{0};
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{false};
+
+    std::mutex errorMutex;
+    std::string error;
+};
+
+END_NAMESPACE_ASAM_CMP
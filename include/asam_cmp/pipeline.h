@@ -0,0 +1,203 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/bounded_queue.h>
+#include <asam_cmp/common.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/packet_batch.h>
+#include <asam_cmp/payload_type.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Chain of processing stages, e.g. decode -> filter -> per payload type consumers -> sink. Batches are handed from
+// stage to stage through bounded lock-free queues, every stage runs on its own threads. A full queue either blocks the
+// stage in front of it (backpressure) or drops batches, as configured per stage. Batches are recycled after the last
+// stage, so a running pipeline does not allocate once the batches reached their working size.
+class Pipeline final
+{
+public:
+    // Unit of work passed between the stages
+    struct Batch
+    {
+        // Raw CMP frames for the decode stage, stored back to back
+        std::vector<uint8_t> frameData;
+        // End offset of every frame in frameData
+        std::vector<size_t> frameEnds;
+        PacketBatch packets;
+        // Indexes of the packets that passed the filter stages so far
+        std::vector<uint32_t> selection;
+        // Set by push, consecutive over all pushed batches
+        uint64_t sequence{0};
+        // Steady clock nanoseconds of push and of the handoff to the current stage
+        uint64_t pushTime{0};
+        uint64_t enqueueTime{0};
+
+        void addFrame(const void* data, const size_t size);
+        // Selects all packets, for batches that are pushed with packets instead of frames
+        void selectAll();
+        void clear();
+    };
+
+    using BatchPtr = std::unique_ptr<Batch>;
+    using StageHandler = std::function<void(Batch& batch)>;
+    using PacketFilter = std::function<bool(const PacketBatch& packets, const size_t index)>;
+    using PacketHandler = std::function<void(const PacketBatch& packets, const size_t index)>;
+
+    // What happens to a batch that arrives at the full queue of a stage
+    enum class DropPolicy : uint8_t
+    {
+        // The caller waits until the stage took a batch
+        block,
+        // The arriving batch is dropped
+        dropNewest,
+        // The oldest queued batch is dropped to make room
+        dropOldest
+    };
+
+    struct StageOptions
+    {
+        std::string name;
+        // Batches are processed concurrently and may overtake each other if there is more than one thread
+        size_t threadCount{1};
+        // Batches, rounded up to a power of two
+        size_t queueCapacity{64};
+        DropPolicy dropPolicy{DropPolicy::block};
+    };
+
+    struct Options
+    {
+        // An idle thread yields this many times before it sleeps
+        unsigned spinCount{100};
+        // Nanoseconds an idle thread sleeps between polls of its queue
+        uint64_t idleSleep{50000};
+        // Recycled batches that are kept for acquireBatch
+        size_t poolSize{256};
+    };
+
+    // Times are in nanoseconds, sums and maxima over all batches of the stage
+    struct StageStats
+    {
+        std::string name;
+        uint64_t batches{0};
+        // Selected packets of the processed batches
+        uint64_t packets{0};
+        // Batches dropped at the queue of the stage
+        uint64_t droppedBatches{0};
+        // Batches for which the handler threw, they are not passed on
+        uint64_t errors{0};
+        // From the handoff to the stage until a thread took the batch
+        uint64_t queueTime{0};
+        uint64_t maxQueueTime{0};
+        uint64_t processingTime{0};
+        uint64_t maxProcessingTime{0};
+        // From push until the stage finished the batch
+        uint64_t latency{0};
+        uint64_t maxLatency{0};
+        // Batches currently waiting
+        size_t queueSize{0};
+    };
+
+public:
+    Pipeline();
+    explicit Pipeline(Options newOptions);
+    Pipeline(const Pipeline& other) = delete;
+    Pipeline& operator=(const Pipeline& other) = delete;
+    ~Pipeline();
+
+    // Stages are added before start in processing order, the functions return the stage index.
+    // Throws std::runtime_error while the pipeline is running.
+    size_t addStage(const StageOptions& stageOptions, StageHandler handler);
+    // Decodes the frames of a batch into its packets and selects all of them. Every thread has its own Decoder, so
+    // segmented messages are only reassembled reliably with one thread.
+    size_t addDecodeStage(const StageOptions& stageOptions);
+    // Keeps the selected packets for which filter returns true
+    size_t addFilterStage(const StageOptions& stageOptions, PacketFilter filter);
+    // Calls handler for every selected packet of the payload type, e.g. for CAN signal decoding or analog processing
+    size_t addPayloadStage(const StageOptions& stageOptions, const PayloadType type, PacketHandler handler);
+    size_t getStageCount() const;
+
+    // Throws std::runtime_error if there are no stages
+    void start();
+    // Processes all pushed batches, stops the threads and throws the first handler error as std::runtime_error.
+    // Must not be called while another thread pushes.
+    void stop();
+    bool isRunning() const;
+
+    // Returns a recycled batch if there is one, a new batch otherwise
+    BatchPtr acquireBatch();
+    // Hands the batch to the first stage, can be called from several threads. Returns false if the batch was dropped.
+    // Throws std::runtime_error if the pipeline is not running.
+    bool push(BatchPtr batch);
+
+    std::vector<StageStats> getStats() const;
+
+private:
+    using Handler = std::function<void(Batch& batch, const size_t threadIndex)>;
+
+    struct Stage
+    {
+        Stage(const StageOptions& newOptions, Handler newHandler);
+
+        StageOptions options;
+        Handler handler;
+        BoundedQueue<BatchPtr> queue;
+        std::vector<std::thread> threads;
+        // Set when the previous stage finished, the threads exit once the queue is empty
+        std::atomic<bool> closed{false};
+        std::atomic<size_t> activeThreads{0};
+
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> droppedBatches{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> queueTime{0};
+        std::atomic<uint64_t> maxQueueTime{0};
+        std::atomic<uint64_t> processingTime{0};
+        std::atomic<uint64_t> maxProcessingTime{0};
+        std::atomic<uint64_t> latency{0};
+        std::atomic<uint64_t> maxLatency{0};
+    };
+
+    size_t addInternalStage(const StageOptions& stageOptions, Handler handler);
+    void stageThread(const size_t stageIndex, const size_t threadIndex);
+    bool enqueue(Stage& stage, BatchPtr& batch);
+    void recycle(BatchPtr& batch);
+    void idle(unsigned& attempts) const;
+    void setError(const std::string& message);
+
+private:
+    Options options;
+    std::vector<std::unique_ptr<Stage>> stages;
+    BoundedQueue<BatchPtr> freeBatches;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> nextSequence{0};
+
+    std::mutex errorMutex;
+    std::string error;
+};
+
+END_NAMESPACE_ASAM_CMP
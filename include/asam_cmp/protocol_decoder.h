@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/tecmp_decoder.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Receive front-end for links that carry both CMP and TECMP frames. Every frame is classified once and passed to the
+// decoder instance of its protocol, so segmentation and sequence counter state is kept for both protocols.
+class ProtocolDecoder final
+{
+public:
+    enum class Protocol : uint8_t
+    {
+        unknown,
+        cmp,
+        tecmp
+    };
+
+    struct Stats
+    {
+        uint64_t frames{0};
+        uint64_t bytes{0};
+        uint64_t packets{0};
+    };
+
+    // Frames of other CMP versions are classified as unknown
+    static constexpr uint8_t cmpVersion = 1;
+
+public:
+    ProtocolDecoder() = default;
+    // The options are used for the conversion of TECMP entries, e.g. the sample interval of Analog entries
+    explicit ProtocolDecoder(const TECMP::Converter::Options& tecmpOptions);
+
+    static Protocol classify(const void* data, const std::size_t size);
+
+    // Returns the packets of the frame, they stay valid until the next call
+    const std::vector<Packet>& decode(const void* data, const std::size_t size);
+    // Calls visitor(const Packet&) for every packet of the frame, returns the number of packets
+    template <typename Visitor>
+    std::size_t decode(const void* data, const std::size_t size, Visitor&& visitor);
+    void reset();
+
+    Protocol getLastProtocol() const;
+    const Stats& getStats(const Protocol protocol) const;
+    // Sequence, loss and reassembly statistics of TECMP devices
+    const TECMP::Decoder& getTecmpDecoder() const;
+
+private:
+    Decoder cmpDecoder;
+    TECMP::Decoder tecmpDecoder;
+    Protocol lastProtocol{Protocol::unknown};
+    std::array<Stats, 3> stats;
+
+    // Reused between calls for CMP and unknown frames
+    std::vector<Packet> packets;
+};
+
+template <typename Visitor>
+std::size_t ProtocolDecoder::decode(const void* data, const std::size_t size, Visitor&& visitor)
+{
+    const auto& framePackets = decode(data, size);
+    for (const auto& packet : framePackets)
+        visitor(packet);
+    return framePackets.size();
+}
+
+END_NAMESPACE_ASAM_CMP
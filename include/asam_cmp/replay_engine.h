@@ -0,0 +1,136 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Replays recorded CMP packets as CMP frames, paced by the packet timestamps.
+// Packets are encoded with one Encoder per device and stream id, so every stream keeps its own sequence counter.
+// The next batch is encoded before waiting for its due time; the wait sleeps until shortly before that time and
+// busy-waits for the rest. Packets due within the batch window are emitted together with one sink call.
+class ReplayEngine final
+{
+public:
+    // Frames of one batch, in packet order
+    using FrameSink = std::function<void(const std::vector<std::vector<uint8_t>>& frames)>;
+
+    struct Options
+    {
+        // Replay speed relative to the recording, e.g. 10 for ten times faster, 0 for as fast as possible
+        double speed{1.0};
+        // Remaining wait in nanoseconds below which the thread busy-waits instead of sleeping
+        uint64_t spinThreshold{200000};
+        // Packets due up to this many nanoseconds after the first packet of a batch are emitted with it
+        uint64_t batchWindow{20000};
+        size_t maxBatchPackets{256};
+        DataContext dataContext;
+    };
+
+    // Jitter is the emission time of a packet minus its due time, in nanoseconds. Packets emitted with an earlier
+    // packet of their batch have a negative jitter of at most the batch window.
+    struct Stats
+    {
+        uint64_t packets{0};
+        uint64_t frames{0};
+        uint64_t batches{0};
+        int64_t minJitter{0};
+        int64_t maxJitter{0};
+        double meanJitter{0};
+        double jitterStandardDeviation{0};
+        // Percentiles of the absolute jitter with 100 ns resolution, jitter above 1 ms is reported as maxJitter
+        int64_t p50Jitter{0};
+        int64_t p99Jitter{0};
+        int64_t p999Jitter{0};
+        // Wall clock time of the replay in nanoseconds
+        uint64_t duration{0};
+    };
+
+public:
+    ReplayEngine();
+    explicit ReplayEngine(Options newOptions);
+
+    // Packets can be added in any order, they are replayed sorted by timestamp
+    void addPacket(const Packet& packet);
+    void addPackets(const std::vector<std::shared_ptr<Packet>>& newPackets);
+    // Decodes the CMP and TECMP frames of a PCAP or PCAPNG file and adds the packets, returns their number.
+    // Throws std::runtime_error if the file cannot be read.
+    size_t loadCapture(const std::string& path);
+    size_t getPacketCount() const;
+    void clear();
+
+    // Replays all packets in the calling thread, returns when all are emitted or stop is called.
+    // Encoders are restarted, so every run numbers its frames from the start.
+    void run(const FrameSink& sink);
+    // Can be called from any thread
+    void stop();
+
+    // Statistics of the last run
+    const Stats& getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    class JitterHistogram final
+    {
+    public:
+        void add(const int64_t jitter);
+        void fill(Stats& stats) const;
+
+    private:
+        static constexpr int64_t resolution = 100;
+        static constexpr size_t bucketCount = 10000;
+
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(bucketCount + 1);
+        uint64_t count{0};
+        double sum{0};
+        double squareSum{0};
+        int64_t min{0};
+        int64_t max{0};
+    };
+
+    size_t getBatchEnd(const size_t begin) const;
+    void encodeBatch(const size_t begin, const size_t end);
+    Encoder& getEncoder(const Packet& packet);
+    Clock::time_point getDueTime(const Packet& packet) const;
+    void waitUntil(const Clock::time_point dueTime) const;
+
+private:
+    Options options;
+    std::vector<Packet> packets;
+    std::unordered_map<uint32_t, Encoder> encoders;
+    std::vector<std::vector<uint8_t>> frames;
+    std::atomic<bool> stopping{false};
+
+    Clock::time_point startTime;
+    uint64_t firstTimestamp{0};
+    Stats stats;
+};
+
+END_NAMESPACE_ASAM_CMP
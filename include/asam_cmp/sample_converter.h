@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Bulk conversion kernels for Analog samples. ASAM CMP transfers samples as big-endian int16/int32 values,
+// the physical value of a sample is (sample * scalar + offset).
+// The best instruction set is selected at runtime: AVX2/FMA or SSE2 on x86, NEON on ARM, scalar code otherwise.
+class SampleConverter final
+{
+public:
+    enum class InstructionSet : uint8_t
+    {
+        scalar,
+        sse2,
+        avx2,
+        neon
+    };
+
+    struct MinMaxSum
+    {
+        int32_t min{INT32_MAX};
+        int32_t max{INT32_MIN};
+        int64_t sum{0};
+    };
+
+public:
+    static void int16ToFloat(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst);
+    static void int32ToFloat(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst);
+    static void int16ToDouble(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst);
+    static void int32ToDouble(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst);
+
+    // Native-endian samples to big-endian bytes
+    static void toBigEndian(const int16_t* src, const size_t count, uint8_t* dst);
+    static void toBigEndian(const int32_t* src, const size_t count, uint8_t* dst);
+
+    // Folds big-endian samples into min, max and sum of the raw values, the outputs must be initialized by the caller
+    static void int16MinMaxSum(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum);
+    static void int32MinMaxSum(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum);
+    // Splits big-endian samples into buckets of bucketSize samples, the last one may be shorter, and writes min, max and
+    // sum of the raw values of every bucket. dst must hold (count + bucketSize - 1) / bucketSize entries.
+    static void int16MinMaxSumBuckets(const uint8_t* src, const size_t count, const size_t bucketSize, MinMaxSum* dst);
+    static void int32MinMaxSumBuckets(const uint8_t* src, const size_t count, const size_t bucketSize, MinMaxSum* dst);
+
+    static InstructionSet getInstructionSet();
+    static bool isSupported(const InstructionSet instructionSet);
+    // Forces the use of a particular instruction set, mainly for testing and benchmarking.
+    // Returns false if the instruction set is not supported by the CPU.
+    static bool setInstructionSet(const InstructionSet instructionSet);
+};
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Copy-on-write vector of immutable chunks. Copies share all chunks and every change replaces the chunk it touches
+// with a modified copy, so copying the vector and changing one element costs size() / chunkSize + chunkSize element
+// copies instead of size(). Chunks are never modified, so readers of a copy need no locking.
+template <typename T>
+class SharedChunkVector final
+{
+public:
+    static constexpr size_t chunkSize = 32;
+
+public:
+    size_t size() const;
+    bool empty() const;
+    const T& operator[](const size_t index) const;
+    const T& back() const;
+
+    void set(const size_t index, T value);
+    void pushBack(T value);
+    void popBack();
+    void clear();
+
+private:
+    using Chunk = std::vector<T>;
+
+    // Replaces the chunk with a copy that may be modified
+    Chunk& copyChunk(const size_t chunkIndex);
+
+private:
+    std::vector<std::shared_ptr<const Chunk>> chunks;
+    size_t count{0};
+};
+
+template <typename T>
+size_t SharedChunkVector<T>::size() const
+{
+    return count;
+}
+
+template <typename T>
+bool SharedChunkVector<T>::empty() const
+{
+    return count == 0;
+}
+
+template <typename T>
+const T& SharedChunkVector<T>::operator[](const size_t index) const
+{
+    return (*chunks[index / chunkSize])[index % chunkSize];
+}
+
+template <typename T>
+const T& SharedChunkVector<T>::back() const
+{
+    return (*this)[count - 1];
+}
+
+template <typename T>
+void SharedChunkVector<T>::set(const size_t index, T value)
+{
+    copyChunk(index / chunkSize)[index % chunkSize] = std::move(value);
+}
+
+template <typename T>
+void SharedChunkVector<T>::pushBack(T value)
+{
+    if (count % chunkSize == 0)
+    {
+        auto chunk = std::make_shared<Chunk>();
+        chunk->reserve(chunkSize);
+        chunk->push_back(std::move(value));
+        chunks.push_back(std::move(chunk));
+    }
+    else
+    {
+        copyChunk(count / chunkSize).push_back(std::move(value));
+    }
+    ++count;
+}
+
+template <typename T>
+void SharedChunkVector<T>::popBack()
+{
+    --count;
+    if (count % chunkSize == 0)
+        chunks.pop_back();
+    else
+        copyChunk(count / chunkSize).pop_back();
+}
+
+template <typename T>
+void SharedChunkVector<T>::clear()
+{
+    chunks.clear();
+    count = 0;
+}
+
+template <typename T>
+typename SharedChunkVector<T>::Chunk& SharedChunkVector<T>::copyChunk(const size_t chunkIndex)
+{
+    auto copy = std::make_shared<Chunk>();
+    copy->reserve(chunkSize);
+    copy->assign(chunks[chunkIndex]->begin(), chunks[chunkIndex]->end());
+    Chunk& result = *copy;
+    chunks[chunkIndex] = std::move(copy);
+    return result;
+}
+
+END_NAMESPACE_ASAM_CMP
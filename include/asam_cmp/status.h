@@ -18,7 +18,9 @@
 
 #include <asam_cmp/common.h>
 #include <asam_cmp/device_status.h>
+#include <asam_cmp/flat_index_map.h>
 #include <asam_cmp/packet.h>
+#include <asam_cmp/timer_wheel.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
@@ -26,6 +28,8 @@ class Status final
 {
 public:
     void update(const Packet& packet);
+    // Moves the packet into the status instead of copying it
+    void update(Packet&& packet);
     void clear();
 
     // Random access to device status
@@ -36,8 +40,40 @@ public:
 
     void removeDeviceById(uint16_t deviceId);
 
+    // Notifies about changes of all devices and their interfaces. Changes are only computed while there are subscribers.
+    size_t subscribe(StatusCallback callback);
+    void unsubscribe(const size_t id);
+
+    // Aging: devices and interfaces without a status message for longer than the time to live are removed by advanceTime
+    // and reported as expired. The time is any monotonic clock chosen by the caller, e.g. the receive time or the
+    // message timestamps in nanoseconds. A time to live of 0 disables aging.
+    void setTimeToLive(const uint64_t newTimeToLive);
+    uint64_t getTimeToLive() const;
+    // Sets the time used as last seen time of updated devices and interfaces and removes the expired ones
+    void advanceTime(const uint64_t now);
+    uint64_t getTime() const;
+
+private:
+    template <typename PacketType>
+    void updateDevice(PacketType&& packet);
+    void removeDevice(const size_t index, const StatusChange::Type changeType);
+    void scheduleAging(const uint16_t deviceId, const uint32_t interfaceId);
+    void scheduleAllForAging();
+    uint64_t onTimer(const TimerWheel::Timer& timer, const uint64_t now);
+
 private:
+    // Number of wheel slots per time to live, expired items are removed at most a slot later
+    static constexpr uint64_t agingSlotsPerTimeToLive = 64;
+    static constexpr uint64_t deviceTimerFlag = 1ull << 63;
+
     std::vector<DeviceStatus> devices;
+    FlatIndexMap<uint16_t> deviceIndexes;
+    StatusSubscribers subscribers;
+
+    uint64_t timeToLive{0};
+    uint64_t currentTime{0};
+    uint64_t nextAgingTicket{1};
+    TimerWheel agingWheel;
 };
 
 END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/packet.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Describes one change of Status or DeviceStatus, computed while the status is updated
+struct StatusChange
+{
+    enum class Type : uint8_t
+    {
+        deviceAdded,
+        deviceChanged,
+        deviceRemoved,
+        interfaceAdded,
+        interfaceChanged,
+        interfaceRemoved,
+        // Removed by Status aging because no status message came within the time to live
+        deviceExpired,
+        interfaceExpired
+    };
+
+    enum class Field : uint32_t
+    {
+        // Interface Status Message fields
+        interfaceStatus = 1u << 0,
+        msgTotalRx = 1u << 1,
+        msgTotalTx = 1u << 2,
+        msgDroppedRx = 1u << 3,
+        msgDroppedTx = 1u << 4,
+        errorsTotalRx = 1u << 5,
+        errorsTotalTx = 1u << 6,
+        interfaceType = 1u << 7,
+        featureSupportBitmask = 1u << 8,
+        streamIds = 1u << 9,
+        interfaceVendorData = 1u << 10,
+
+        // Capture Module Status Message fields, uptime is not reported as it changes with every message
+        gmIdentity = 1u << 16,
+        gmClockQuality = 1u << 17,
+        currentUtcOffset = 1u << 18,
+        timeSource = 1u << 19,
+        domainNumber = 1u << 20,
+        gptpFlags = 1u << 21,
+        deviceInfo = 1u << 22,
+        deviceVendorData = 1u << 23
+    };
+
+    // Differences of the interface counters to the previous message, wrap-around of the counters is taken into account
+    struct CounterDeltas
+    {
+        uint32_t msgTotalRx{0};
+        uint32_t msgTotalTx{0};
+        uint32_t msgDroppedRx{0};
+        uint32_t msgDroppedTx{0};
+        uint32_t errorsTotalRx{0};
+        uint32_t errorsTotalTx{0};
+    };
+
+    bool hasField(const Field field) const;
+
+    Type type{Type::deviceAdded};
+    uint16_t deviceId{0};
+    uint32_t interfaceId{0};
+    uint32_t fields{0};
+    CounterDeltas deltas;
+
+    // Valid only during the callback. previous is null for added items, current is null for removed items.
+    const Packet* previous{nullptr};
+    const Packet* current{nullptr};
+
+    // Fill fields and deltas from two status packets of the same kind
+    void compareInterfaces(const Packet& previousPacket, const Packet& currentPacket);
+    void compareDevices(const Packet& previousPacket, const Packet& currentPacket);
+};
+
+using StatusCallback = std::function<void(const StatusChange& change)>;
+
+// List of change callbacks. Callbacks must not modify the status that notifies them.
+class StatusSubscribers final
+{
+public:
+    // Returns an id for unsubscribe
+    size_t subscribe(StatusCallback callback);
+    void unsubscribe(const size_t id);
+    bool empty() const;
+    void notify(const StatusChange& change) const;
+
+private:
+    std::vector<std::pair<size_t, StatusCallback>> callbacks;
+    size_t nextId{1};
+};
+
+END_NAMESPACE_ASAM_CMP
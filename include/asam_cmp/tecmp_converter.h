@@ -16,11 +16,14 @@
 
 #pragma once
 
+#include <asam_cmp/analog_payload.h>
 #include <asam_cmp/common.h>
 #include <asam_cmp/packet.h>
 #include <asam_cmp/tecmp_can_payload.h>
+#include <asam_cmp/tecmp_entry.h>
 #include <asam_cmp/tecmp_header.h>
 #include <asam_cmp/tecmp_payload.h>
+#include <vector>
 
 BEGIN_NAMESPACE_TECMP
 
@@ -29,19 +32,50 @@ class Converter final
     using PacketPtr = std::shared_ptr<ASAM::CMP::Packet>;
     using TecmpPayloadPtr = std::shared_ptr<TECMP::Payload>;
 
+public:
+    struct Options
+    {
+        // TECMP Analog entries carry raw samples only. Without a sample interval AnalogStream and AnalogDecimator
+        // cannot join consecutive packets, so the interval of the capture module configuration is set here.
+        float analogSampleInterval{0.f};
+        ASAM::CMP::AnalogPayload::Unit analogUnit{ASAM::CMP::AnalogPayload::Unit::undefined};
+    };
+
 public:
     static PacketPtr ConvertPacket(CmpHeader& header, const TecmpPayloadPtr& payload);
 
+    // Single pass conversion straight from the frame bytes, without intermediate TECMP payloads.
+    // Packets are appended to packets, the return value is the number of appended packets.
+    static std::size_t ConvertFrame(const void* data, const std::size_t size, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertFrame(const void* data,
+                                    const std::size_t size,
+                                    std::vector<ASAM::CMP::Packet>& packets,
+                                    const Options& options);
+    static std::size_t ConvertEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets, const Options& options);
+
 private:
     static PacketPtr ConvertCaptureModulePayload(CmpHeader& header, const TecmpPayloadPtr& payload);
     static PacketPtr ConvertInterfacePayload(CmpHeader& header, const TecmpPayloadPtr& payload);
     static PacketPtr ConvertDataPayload(CmpHeader& header, const TecmpPayloadPtr& payload);
     static PacketPtr GetPackageFromTecmpHeader(const TECMP::CmpHeader& header);
+    static PacketPtr ConvertRawDataPayload(const CmpHeader& header, const TecmpPayloadPtr& payload);
 
 private:
     static PacketPtr ConvertCanPayload(CmpHeader& header, const TecmpPayloadPtr& payload);
     static PacketPtr ConvertCanFdPayload(TECMP::CanPayload* canPayload, PacketPtr packet);
     static PacketPtr convertLinPayload(CmpHeader& header, const TecmpPayloadPtr& payload);
+
+private:
+    static std::size_t ConvertEntryPayload(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets, const Options& options);
+    static ASAM::CMP::Packet& AddPacket(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertCaptureModuleEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertInterfaceEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertCanEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertLinEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertFlexRayEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
+    static std::size_t ConvertAnalogEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets, const Options& options);
+    static std::size_t ConvertEthernetEntry(const EntryView& entry, std::vector<ASAM::CMP::Packet>& packets);
 };
 
 END_NAMESPACE_TECMP
\ No newline at end of file
@@ -17,8 +17,11 @@
 #pragma once
 
 #include <asam_cmp/common.h>
+#include <asam_cmp/flat_index_map.h>
 #include <asam_cmp/packet.h>
-#include <asam_cmp/tecmp_capture_module_payload.h>
+#include <asam_cmp/tecmp_converter.h>
+#include <asam_cmp/tecmp_entry.h>
+#include <asam_cmp/tecmp_payload.h>
 #include <vector>
 
 BEGIN_NAMESPACE_TECMP
@@ -29,21 +32,85 @@ public:
     using PacketPtr = std::shared_ptr<ASAM::CMP::Packet>;
     using TecmpPayloadPtr = std::shared_ptr<TECMP::Payload>;
 
+    struct Stats
+    {
+        uint64_t frames{0};
+        uint64_t invalidFrames{0};
+        // Frames missing according to the sequence counter
+        uint64_t lostFrames{0};
+        // Repeated or reordered frames
+        uint64_t sequenceErrors{0};
+        // Sequence counters adopted after a backward jump, e.g. after a restart of the capture module
+        uint64_t sequenceResyncs{0};
+        uint64_t segments{0};
+        uint64_t reassembledFrames{0};
+        // Segmented frames dropped because of a missing start, a missing end or a lost segment
+        uint64_t reassemblyErrors{0};
+    };
+
 public:
+    Decoder() = default;
+    explicit Decoder(const Converter::Options& newConverterOptions);
+
     static std::vector<std::shared_ptr<ASAM::CMP::Packet>> Decode(const void* data, const std::size_t size);
 
+    // Stateful decoding: tracks the sequence counter of every device and reassembles frames segmented with the
+    // start/end of segment device flags. All entries of a frame are converted in one pass.
+    // The returned packets stay valid until the next call.
+    const std::vector<ASAM::CMP::Packet>& decode(const void* data, const std::size_t size);
+    void reset();
+
+    const Stats& getStats() const;
+
+    // Random access to device statistics
+    size_t getDeviceCount() const;
+    size_t getIndexByDeviceId(const uint8_t deviceId) const;
+    uint8_t getDeviceId(const size_t index) const;
+    const Stats& getDeviceStats(const size_t index) const;
+
 private:
-    static TECMP::CmpHeader GetHeader(const void* data, const std::size_t size, uint8_t** payloadPtr);
-    static std::vector<TecmpPayloadPtr> HandlePayload(const uint8_t* data, const std::size_t size, TECMP::CmpHeader& header);
+    enum class SegmentState : uint8_t
+    {
+        none,
+        reassembling,
+        // Segments are dropped until the next start or end of segment
+        discarding
+    };
 
-    static std::vector<PacketPtr> ConvertPacketsToAsam(std::vector<TecmpPayloadPtr> payloads, TECMP::CmpHeader& header);
+    struct DeviceState
+    {
+        uint8_t deviceId{0};
+        bool hasSequenceCounter{false};
+        uint16_t sequenceCounter{0};
+        // Consecutive frames behind the expected sequence counter, the last one of them in backwardCounter
+        uint8_t backwardFrames{0};
+        uint16_t backwardCounter{0};
+        Stats stats;
+
+        SegmentState segmentState{SegmentState::none};
+        // Entry of the first segment, its data is collected in segmentData
+        EntryView segmentEntry;
+        std::vector<uint8_t> segmentData;
+    };
+
+    DeviceState& getDeviceState(const uint8_t deviceId);
+    void count(DeviceState& device, uint64_t Stats::*counter, const uint64_t value = 1);
+    void checkSequenceCounter(DeviceState& device, const uint16_t sequenceCounter);
+    void addSegment(DeviceState& device, const EntryView& entry, const bool startOfSegment, const bool endOfSegment);
+    void dropSegments(DeviceState& device);
 
 private:
-    static std::vector<TecmpPayloadPtr> GetInterfacePayload(const uint8_t* payloadData, const std::size_t size, TECMP::CmpHeader& header);
-    static TecmpPayloadPtr GetDataPayload(const uint8_t* payloadData, const std::size_t size, TECMP::CmpHeader& header);
-    static TecmpPayloadPtr GetCaptureModulePayload(const uint8_t* payloadData, const std::size_t size);
-    static TecmpPayloadPtr GetCanPayload(const uint8_t* payloadData, const std::size_t size);
-    static TecmpPayloadPtr GetLinPayload(const uint8_t* payloadData, const std::size_t size);
+    // Number of consecutive frames behind the expected sequence counter after which their counter is adopted
+    static constexpr uint8_t sequenceResyncFrames = 3;
+
+private:
+    Converter::Options converterOptions;
+    Stats stats;
+    std::vector<DeviceState> devices;
+    ASAM::CMP::FlatIndexMap<uint8_t> deviceIndexes;
+
+    // Reused between calls
+    std::vector<ASAM::CMP::Packet> packets;
 };
 
-END_NAMESPACE_TECMP
+END_NAMESPACE_TECMP
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/tecmp_header.h>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+BEGIN_NAMESPACE_TECMP
+
+// Serializes CMP packets into TECMP frames, the counterpart of Converter.
+// Consecutive packets of the same message and data type are batched as entries of one frame. An entry that does not fit
+// into maxBytesPerMessage is split over frames marked with the start/end of segment device flags.
+// Packets of other payload types are skipped. minBytesPerMessage is not used, padding would be read as entries.
+class Encoder final
+{
+private:
+    using DataContext = ASAM::CMP::DataContext;
+    using Packet = ASAM::CMP::Packet;
+
+public:
+    Encoder() = default;
+
+    template <typename ForwardIterator,
+              std::enable_if_t<std::is_same_v<typename std::iterator_traits<ForwardIterator>::value_type, Packet>, bool> = true>
+    std::vector<std::vector<uint8_t>> encode(ForwardIterator begin, ForwardIterator end, const DataContext& dataContext);
+
+    template <typename ForwardPtrIterator,
+              std::enable_if_t<std::is_same_v<typename std::iterator_traits<ForwardPtrIterator>::value_type, std::shared_ptr<Packet>>,
+                               bool> = true>
+    std::vector<std::vector<uint8_t>> encode(ForwardPtrIterator begin, ForwardPtrIterator end, const DataContext& dataContext);
+
+    std::vector<std::vector<uint8_t>> encode(const Packet& packet, const DataContext& dataContext);
+
+    void setDeviceId(uint8_t deviceId);
+    void restart();
+
+    uint8_t getDeviceId() const;
+    uint16_t getSequenceCounter() const;
+
+private:
+    struct EntryInfo
+    {
+        CmpHeader::MessageType messageType{CmpHeader::MessageType::invalid};
+        CmpHeader::DataType dataType{CmpHeader::DataType::invalid};
+        std::size_t length{0};
+        uint16_t dataFlags{0};
+    };
+
+    void init(const DataContext& dataContext);
+    void putPacket(const Packet& packet);
+    void putSegmentedPacket(const Packet& packet, const EntryInfo& info);
+    std::vector<std::vector<uint8_t>> getEncodedData();
+
+    void addNewFrame(const EntryInfo& info, const uint16_t deviceFlags);
+    uint8_t* addEntry(const Packet& packet, const EntryInfo& info, const std::size_t length);
+    bool getEntryInfo(const Packet& packet, EntryInfo& info) const;
+    void writeEntryData(const Packet& packet, uint8_t* data) const;
+
+private:
+    std::size_t maxBytesPerMessage{0};
+    uint8_t deviceId{0};
+    uint16_t sequenceCounter{0};
+
+    CmpHeader frameHeader;
+    std::size_t frameSize{0};
+    std::vector<std::vector<uint8_t>> frames;
+    // Reused for entries that are split into segments
+    std::vector<uint8_t> segmentData;
+};
+
+template <typename ForwardIterator,
+          std::enable_if_t<std::is_same_v<typename std::iterator_traits<ForwardIterator>::value_type, ASAM::CMP::Packet>, bool>>
+std::vector<std::vector<uint8_t>> Encoder::encode(ForwardIterator begin, ForwardIterator end, const DataContext& dataContext)
+{
+    static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<ForwardIterator>::iterator_category>::value,
+                  "ForwardIterator must be a forward iterator.");
+
+    init(dataContext);
+
+    for (auto it = begin; it != end; ++it)
+        putPacket(*it);
+
+    return getEncodedData();
+}
+
+template <typename ForwardPtrIterator,
+          std::enable_if_t<std::is_same_v<typename std::iterator_traits<ForwardPtrIterator>::value_type, std::shared_ptr<ASAM::CMP::Packet>>,
+                           bool>>
+std::vector<std::vector<uint8_t>> Encoder::encode(ForwardPtrIterator begin, ForwardPtrIterator end, const DataContext& dataContext)
+{
+    static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<ForwardPtrIterator>::iterator_category>::value,
+                  "ForwardIterator must be a forward iterator.");
+
+    init(dataContext);
+
+    for (auto it = begin; it != end; ++it)
+        putPacket(*(*it));
+
+    return getEncodedData();
+}
+
+END_NAMESPACE_TECMP
\ No newline at end of file
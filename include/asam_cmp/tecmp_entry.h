@@ -0,0 +1,71 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/tecmp_header.h>
+
+BEGIN_NAMESPACE_TECMP
+
+// Non-owning view of one data entry of a TECMP frame. Frame fields are repeated in every entry of the frame.
+struct EntryView
+{
+    // Frame header
+    uint8_t deviceId{0};
+    uint16_t sequenceCounter{0};
+    CmpHeader::MessageType messageType{CmpHeader::MessageType::invalid};
+    CmpHeader::DataType dataType{CmpHeader::DataType::invalid};
+    uint16_t deviceFlags{0};
+
+    // Entry header
+    uint32_t interfaceId{0};
+    uint64_t timestamp{0};
+    uint16_t dataFlags{0};
+
+    const uint8_t* data{nullptr};
+    std::size_t length{0};
+};
+
+// Walks all data entries of a TECMP frame without copying them
+class EntryReader final
+{
+public:
+    // Size of the frame header before the first entry
+    static constexpr std::size_t frameHeaderSize = 12;
+    // Size of the header of every entry
+    static constexpr std::size_t entryHeaderSize = 16;
+
+public:
+    EntryReader(const void* data, const std::size_t size);
+
+    bool isValid() const;
+    const CmpHeader& getHeader() const;
+
+    // Fills the next entry, returns false when there is none. An entry that does not fit into the frame ends the walk.
+    bool next(EntryView& entry);
+    bool isTruncated() const;
+
+private:
+    const uint8_t* frameData;
+    std::size_t frameSize;
+    std::size_t offset{frameHeaderSize};
+    CmpHeader header;
+    bool valid{false};
+    bool truncated{false};
+};
+
+END_NAMESPACE_TECMP
\ No newline at end of file
@@ -88,6 +88,13 @@ public:
     uint16_t getDeviceFlags() const;
     void setDeviceFlags(uint16_t newFlags);
 
+    // Device flags
+    bool isEndOfSegment() const;
+    bool isStartOfSegment() const;
+    bool isSpy() const;
+    bool isMultiFrame() const;
+    bool isDeviceOverflow() const;
+
     uint32_t getInterfaceId() const;
     void setInterfaceId(uint32_t newId);
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <asam_cmp/common.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Hashed timer wheel. Timers are put into the slot of their expiry tick, so advancing the time only visits the slots
+// that passed instead of all timers. Expiries further away than one rotation stay in their slot until they are due.
+// Timers are never cancelled: the owner identifies stale ones by their ticket when they fire.
+class TimerWheel final
+{
+public:
+    struct Timer
+    {
+        uint64_t key{0};
+        uint64_t ticket{0};
+        uint64_t expiry{0};
+    };
+
+    // Returned by the advance handler to drop the timer
+    static constexpr uint64_t done = 0;
+
+public:
+    // granularity is the time covered by one slot, slotCount is rounded up to a power of two
+    explicit TimerWheel(const uint64_t granularity = 1, const size_t slotCount = 256);
+
+    void schedule(const uint64_t key, const uint64_t ticket, const uint64_t expiry);
+
+    // Calls handler(const Timer&) for every timer with expiry <= now. The handler returns a later expiry to
+    // reschedule the timer or done to drop it. The handler must not call advance.
+    template <typename Handler>
+    void advance(const uint64_t now, Handler&& handler);
+
+    void clear();
+    size_t size() const;
+    uint64_t getGranularity() const;
+    size_t getSlotCount() const;
+
+private:
+    size_t getSlot(const uint64_t tick) const;
+
+private:
+    uint64_t granularity;
+    std::vector<std::vector<Timer>> slots;
+    std::vector<Timer> firing;
+    uint64_t currentTick{0};
+    size_t count{0};
+};
+
+template <typename Handler>
+void TimerWheel::advance(const uint64_t now, Handler&& handler)
+{
+    const uint64_t nowTick = now / granularity;
+    if (nowTick < currentTick)
+        return;
+
+    // The slot of the current tick is visited again next time as it may still get timers that are due later in the tick
+    const uint64_t lastTick = nowTick - currentTick >= slots.size() ? currentTick + slots.size() - 1 : nowTick;
+    for (uint64_t tick = currentTick; tick <= lastTick; ++tick)
+    {
+        auto& slot = slots[getSlot(tick)];
+        if (slot.empty())
+            continue;
+
+        firing.swap(slot);
+        for (const Timer& timer : firing)
+        {
+            if (timer.expiry > now)
+            {
+                slots[getSlot(timer.expiry / granularity)].push_back(timer);
+                continue;
+            }
+
+            --count;
+            const uint64_t expiry = handler(timer);
+            if (expiry != done)
+                schedule(timer.key, timer.ticket, expiry);
+        }
+        firing.clear();
+    }
+    currentTick = nowTick;
+}
+
+END_NAMESPACE_ASAM_CMP
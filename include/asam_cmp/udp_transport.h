@@ -0,0 +1,172 @@
+/*
+ * Copyright 2022-2024 openDAQ d.o.o.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/common.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/packet_batch.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+// Receives CMP frames as UDP datagrams on IPv4. Every thread owns one socket bound to the same port with SO_REUSEPORT
+// and its own Decoder; the kernel spreads the senders over the sockets by their address, so the segments of one
+// sender stay on one decoder. Datagrams are read in batches with recvmmsg and decoded into one PacketBatch per call.
+class UdpReceiver final
+{
+public:
+    struct Options
+    {
+        std::string address{"0.0.0.0"};
+        // 0 binds an ephemeral port, see getPort
+        uint16_t port{0};
+        size_t threadCount{1};
+        // SO_RCVBUF in bytes, 0 keeps the system default. The kernel limits it to net.core.rmem_max.
+        int receiveBufferSize{0};
+        // Takes the receive times from SO_TIMESTAMPNS instead of reading the clock after recvmmsg
+        bool kernelTimestamps{true};
+        // Datagrams per recvmmsg call
+        size_t batchSize{64};
+        // Longer datagrams are truncated and dropped
+        size_t maxDatagramSize{65507};
+        // Milliseconds between checks for stop while no datagrams arrive
+        int pollTimeout{50};
+    };
+
+    // Datagrams received in one recvmmsg call
+    struct Batch
+    {
+        size_t threadIndex{0};
+        PacketBatch packets;
+        // Receive time of the datagram of every packet in nanoseconds since the Unix epoch
+        std::vector<uint64_t> receiveTimes;
+    };
+
+    struct Stats
+    {
+        uint64_t datagrams{0};
+        uint64_t bytes{0};
+        uint64_t packets{0};
+        uint64_t batches{0};
+        uint64_t truncated{0};
+    };
+
+    // Called from the receiving threads, concurrently for different threads. The batch is reused after the call.
+    using BatchHandler = std::function<void(const Batch& batch)>;
+
+public:
+    // Throws std::runtime_error if the sockets cannot be created or bound
+    UdpReceiver(Options newOptions, BatchHandler newHandler);
+    UdpReceiver(const UdpReceiver& other) = delete;
+    UdpReceiver& operator=(const UdpReceiver& other) = delete;
+    ~UdpReceiver();
+
+    void start();
+    // Waits for the receiving threads. Receive errors of the threads are thrown here.
+    void stop();
+
+    uint16_t getPort() const;
+    // Sums of all threads, can be called while receiving
+    Stats getStats() const;
+
+private:
+    struct Worker
+    {
+        int fd{-1};
+        std::thread thread;
+        std::atomic<uint64_t> datagrams{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> batches{0};
+        std::atomic<uint64_t> truncated{0};
+    };
+
+    int openSocket();
+    void receiveThread(const size_t threadIndex);
+    void setError(const std::string& message);
+
+private:
+    Options options;
+    BatchHandler handler;
+    uint16_t port{0};
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running{false};
+
+    std::mutex errorMutex;
+    std::string error;
+};
+
+// Sends CMP frames as UDP datagrams on IPv4, one frame per datagram, in batches with sendmmsg
+class UdpSender final
+{
+public:
+    struct Options
+    {
+        std::string address{"127.0.0.1"};
+        uint16_t port{0};
+        // SO_SNDBUF in bytes, 0 keeps the system default
+        int sendBufferSize{0};
+        // Datagrams per sendmmsg call
+        size_t batchSize{64};
+        // Frame size for encoding, the default fits an Ethernet MTU of 1500 bytes without IP fragmentation
+        DataContext dataContext{0, 1472};
+    };
+
+    struct Stats
+    {
+        uint64_t datagrams{0};
+        uint64_t bytes{0};
+        uint64_t calls{0};
+    };
+
+public:
+    // Throws std::runtime_error if the socket cannot be created or connected
+    explicit UdpSender(Options newOptions);
+    UdpSender(const UdpSender& other) = delete;
+    UdpSender& operator=(const UdpSender& other) = delete;
+    ~UdpSender();
+
+    // Sends every frame as one datagram, e.g. the output of Encoder::encode. Throws std::runtime_error on send errors.
+    void send(const std::vector<std::vector<uint8_t>>& frames);
+    // Encodes the packets with the encoder and sends the frames
+    template <typename ForwardIterator>
+    void send(Encoder& encoder, ForwardIterator begin, ForwardIterator end);
+
+    const Stats& getStats() const;
+
+private:
+    Options options;
+    int fd{-1};
+    Stats stats;
+};
+
+template <typename ForwardIterator>
+void UdpSender::send(Encoder& encoder, ForwardIterator begin, ForwardIterator end)
+{
+    send(encoder.encode(begin, end, options.dataContext));
+}
+
+END_NAMESPACE_ASAM_CMP
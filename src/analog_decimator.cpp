@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+
+#include <asam_cmp/analog_decimator.h>
+#include <asam_cmp/sample_converter.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+double AnalogDecimator::Summary::getMean() const
+{
+    return count == 0 ? 0. : sum / static_cast<double>(count);
+}
+
+void AnalogDecimator::Summary::merge(const Summary& other)
+{
+    if (other.count == 0)
+        return;
+
+    if (count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    timestamp = std::min(timestamp, other.timestamp);
+    endTimestamp = std::max(endTimestamp, other.endTimestamp);
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sum += other.sum;
+    count += other.count;
+}
+
+AnalogDecimator::AnalogDecimator(const size_t factor, const size_t levelsCount, const size_t maxBucketsPerLevel)
+    : factor(std::max<size_t>(factor, 2))
+    , levels(std::max<size_t>(levelsCount, 1))
+    , maxBucketsPerLevel(maxBucketsPerLevel)
+{
+}
+
+bool AnalogDecimator::addPacket(const Packet& packet)
+{
+    if (!packet.isValid() || packet.getPayload().getType() != PayloadType::analog)
+        return false;
+
+    const auto& payload = static_cast<const AnalogPayload&>(packet.getPayload());
+    const size_t samplesCount = payload.getSamplesCount();
+    if (samplesCount == 0)
+        return true;
+
+    const uint64_t timestamp = packet.getTimestamp();
+    const double newSampleIntervalNs = static_cast<double>(payload.getSampleInterval()) * 1e9;
+    const auto diff = static_cast<double>(static_cast<int64_t>(timestamp - nextTimestamp));
+    // Half a sample interval of jitter is tolerated, an earlier start would break the time order of the buckets
+    if (diff < -newSampleIntervalNs / 2)
+    {
+        // A packet that starts before the previous one is not a repetition but a new time base, e.g. after a
+        // device restart. The old summaries cannot be sorted with the new ones, so the decimator starts over.
+        if (-diff <= static_cast<double>(samplesCount) * newSampleIntervalNs)
+            return false;
+
+        resetLevels();
+        ++timestampResets;
+    }
+
+    const bool continuous = newSampleIntervalNs > 0. && payload.getSampleInterval() == sampleInterval && payload.getUnit() == unit &&
+                            diff <= newSampleIntervalNs / 2;
+    if (!continuous)
+        closeAllBuckets();
+
+    sampleInterval = payload.getSampleInterval();
+    sampleIntervalNs = newSampleIntervalNs;
+    unit = payload.getUnit();
+
+    addSamples(payload, timestamp);
+    nextTimestamp = timestamp + static_cast<uint64_t>(std::llround(static_cast<double>(samplesCount) * sampleIntervalNs));
+    return true;
+}
+
+void AnalogDecimator::clear()
+{
+    resetLevels();
+    timestampResets = 0;
+}
+
+uint64_t AnalogDecimator::getTimestampResets() const
+{
+    return timestampResets;
+}
+
+size_t AnalogDecimator::getFactor() const
+{
+    return factor;
+}
+
+size_t AnalogDecimator::getLevelsCount() const
+{
+    return levels.size();
+}
+
+uint64_t AnalogDecimator::getBucketDuration(const size_t level) const
+{
+    double samplesPerBucket = static_cast<double>(factor);
+    for (size_t i = 0; i < level; ++i)
+        samplesPerBucket *= static_cast<double>(factor);
+    return static_cast<uint64_t>(std::llround(samplesPerBucket * sampleIntervalNs));
+}
+
+size_t AnalogDecimator::getBucketsCount(const size_t level) const
+{
+    return levels[level].buckets.size();
+}
+
+const AnalogDecimator::Summary& AnalogDecimator::getBucket(const size_t level, const size_t index) const
+{
+    return levels[level].buckets[index];
+}
+
+size_t AnalogDecimator::selectLevel(const uint64_t begin, const uint64_t end, const size_t width) const
+{
+    if (width == 0 || end <= begin || sampleIntervalNs <= 0.)
+        return 0;
+
+    const double pixelDuration = static_cast<double>(end - begin) / static_cast<double>(width);
+    size_t level = 0;
+    while (level + 1 < levels.size() && static_cast<double>(getBucketDuration(level + 1)) <= pixelDuration)
+        ++level;
+    return level;
+}
+
+std::vector<AnalogDecimator::Summary> AnalogDecimator::query(const uint64_t begin, const uint64_t end, const size_t width) const
+{
+    std::vector<Summary> pixels(width);
+    if (width == 0 || end <= begin)
+        return pixels;
+
+    const double pixelsPerNs = static_cast<double>(width) / static_cast<double>(end - begin);
+    auto addToPixel = [&](const Summary& bucket)
+    {
+        if (bucket.count == 0 || bucket.endTimestamp <= begin || bucket.timestamp >= end)
+            return;
+
+        const uint64_t timestamp = std::max(bucket.timestamp, begin);
+        const auto pixel = static_cast<size_t>(static_cast<double>(timestamp - begin) * pixelsPerNs);
+        pixels[std::min(pixel, width - 1)].merge(bucket);
+    };
+
+    const size_t level = selectLevel(begin, end, width);
+    const auto& buckets = levels[level].buckets;
+    auto it = std::lower_bound(
+        buckets.begin(), buckets.end(), begin, [](const Summary& bucket, const uint64_t timestamp) { return bucket.endTimestamp <= timestamp; });
+    for (; it != buckets.end() && it->timestamp < end; ++it)
+        addToPixel(*it);
+
+    addToPixel(getTail(level));
+    return pixels;
+}
+
+void AnalogDecimator::addSamples(const AnalogPayload& payload, const uint64_t timestamp)
+{
+    const bool isInt16 = payload.getSampleDt() == AnalogPayload::SampleDt::aInt16;
+    const size_t sampleSize = isInt16 ? sizeof(int16_t) : sizeof(int32_t);
+    const size_t samplesCount = payload.getSamplesCount();
+    const auto scalar = static_cast<double>(payload.getSampleScalar());
+    const auto offset = static_cast<double>(payload.getSampleOffset());
+
+    Level& firstLevel = levels[0];
+
+    // The first bucket completes the open one, the following ones start at multiples of factor
+    const size_t headCount = std::min(samplesCount, factor - firstLevel.openChildren);
+    const size_t tailCount = samplesCount - headCount;
+    rawBuckets.resize(1 + (tailCount + factor - 1) / factor);
+    const auto summarize = isInt16 ? SampleConverter::int16MinMaxSumBuckets : SampleConverter::int32MinMaxSumBuckets;
+    summarize(payload.getData(), headCount, headCount, rawBuckets.data());
+    summarize(payload.getData() + headCount * sampleSize, tailCount, factor, rawBuckets.data() + 1);
+
+    size_t pos = 0;
+    for (const auto& raw : rawBuckets)
+    {
+        const size_t count = pos == 0 ? headCount : std::min(factor, samplesCount - pos);
+
+        // A negative scalar swaps minimum and maximum
+        const double scaledMin = raw.min * scalar + offset;
+        const double scaledMax = raw.max * scalar + offset;
+
+        Summary summary;
+        summary.timestamp = timestamp + static_cast<uint64_t>(std::llround(static_cast<double>(pos) * sampleIntervalNs));
+        summary.endTimestamp = timestamp + static_cast<uint64_t>(std::llround(static_cast<double>(pos + count) * sampleIntervalNs));
+        summary.min = std::min(scaledMin, scaledMax);
+        summary.max = std::max(scaledMin, scaledMax);
+        summary.sum = static_cast<double>(raw.sum) * scalar + static_cast<double>(count) * offset;
+        summary.count = count;
+
+        firstLevel.open.merge(summary);
+        firstLevel.openChildren += count;
+        if (firstLevel.openChildren == factor)
+            closeBucket(0);
+
+        pos += count;
+    }
+}
+
+void AnalogDecimator::resetLevels()
+{
+    for (auto& level : levels)
+        level = Level{};
+
+    nextTimestamp = 0;
+    sampleInterval = 0.f;
+    sampleIntervalNs = 0.;
+    unit = AnalogPayload::Unit::undefined;
+}
+
+void AnalogDecimator::closeBucket(const size_t level)
+{
+    Level& current = levels[level];
+    current.buckets.push_back(current.open);
+    if (maxBucketsPerLevel != 0 && current.buckets.size() > maxBucketsPerLevel)
+        current.buckets.pop_front();
+
+    const Summary bucket = current.open;
+    current.open = Summary{};
+    current.openChildren = 0;
+
+    if (level + 1 < levels.size())
+    {
+        Level& parent = levels[level + 1];
+        parent.open.merge(bucket);
+        if (++parent.openChildren == factor)
+            closeBucket(level + 1);
+    }
+}
+
+void AnalogDecimator::closeAllBuckets()
+{
+    for (size_t level = 0; level < levels.size(); ++level)
+    {
+        if (levels[level].openChildren != 0)
+            closeBucket(level);
+    }
+}
+
+AnalogDecimator::Summary AnalogDecimator::getTail(const size_t level) const
+{
+    // Open buckets of all levels up to the given one are contiguous and cover the newest samples
+    Summary tail = levels[level].open;
+    for (size_t i = 0; i < level; ++i)
+        tail.merge(levels[i].open);
+    return tail;
+}
+
+END_NAMESPACE_ASAM_CMP
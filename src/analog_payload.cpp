@@ -1,4 +1,6 @@
 #include <asam_cmp/analog_payload.h>
+#include <asam_cmp/packet.h>
+#include <asam_cmp/sample_converter.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
@@ -149,6 +151,44 @@ void AnalogPayload::setData(const uint8_t* data, const size_t size)
     Payload::setData<Header>(data, size);
 }
 
+void AnalogPayload::setSamples(const int16_t* samples, const size_t count)
+{
+    payloadData.resize(sizeof(Header) + count * sizeof(int16_t));
+    setSampleDt(SampleDt::aInt16);
+    SampleConverter::toBigEndian(samples, count, payloadData.data() + sizeof(Header));
+}
+
+void AnalogPayload::setSamples(const int32_t* samples, const size_t count)
+{
+    payloadData.resize(sizeof(Header) + count * sizeof(int32_t));
+    setSampleDt(SampleDt::aInt32);
+    SampleConverter::toBigEndian(samples, count, payloadData.data() + sizeof(Header));
+}
+
+void AnalogPayload::toFloat(float* dst) const
+{
+    const auto count = getSamplesCount();
+    if (count == 0)
+        return;
+
+    if (getSampleDt() == SampleDt::aInt16)
+        SampleConverter::int16ToFloat(getData(), count, getSampleScalar(), getSampleOffset(), dst);
+    else
+        SampleConverter::int32ToFloat(getData(), count, getSampleScalar(), getSampleOffset(), dst);
+}
+
+void AnalogPayload::toDouble(double* dst) const
+{
+    const auto count = getSamplesCount();
+    if (count == 0)
+        return;
+
+    if (getSampleDt() == SampleDt::aInt16)
+        SampleConverter::int16ToDouble(getData(), count, getSampleScalar(), getSampleOffset(), dst);
+    else
+        SampleConverter::int32ToDouble(getData(), count, getSampleScalar(), getSampleOffset(), dst);
+}
+
 bool AnalogPayload::isValidPayload(const uint8_t* data, const size_t size)
 {
     auto header = reinterpret_cast<const Header*>(data);
@@ -166,4 +206,17 @@ AnalogPayload::Header* AnalogPayload::getHeader()
     return reinterpret_cast<Header*>(payloadData.data());
 }
 
+const AnalogPayload* AnalogPayload::asAnalogPayload(const AnalogPayload& payload)
+{
+    return &payload;
+}
+
+const AnalogPayload* AnalogPayload::asAnalogPayload(const std::shared_ptr<Packet>& packet)
+{
+    if (!packet || !packet->isValid() || packet->getPayload().getType() != PayloadType::analog)
+        return nullptr;
+
+    return static_cast<const AnalogPayload*>(&packet->getPayload());
+}
+
 END_NAMESPACE_ASAM_CMP
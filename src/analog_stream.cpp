@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+
+#include <asam_cmp/analog_stream.h>
+#include <asam_cmp/sample_converter.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+uint64_t AnalogStream::Block::getTimestamp() const
+{
+    return timestamp;
+}
+
+uint64_t AnalogStream::Block::getEndTimestamp() const
+{
+    return getSampleTimestamp(size);
+}
+
+uint64_t AnalogStream::Block::getSampleTimestamp(const size_t index) const
+{
+    return timestamp + static_cast<uint64_t>(std::llround(static_cast<double>(index) * sampleIntervalNs));
+}
+
+float AnalogStream::Block::getSampleInterval() const
+{
+    return sampleInterval;
+}
+
+AnalogPayload::Unit AnalogStream::Block::getUnit() const
+{
+    return unit;
+}
+
+bool AnalogStream::Block::isContinuous() const
+{
+    return continuous;
+}
+
+const float* AnalogStream::Block::getData() const
+{
+    return samples.get();
+}
+
+size_t AnalogStream::Block::getSize() const
+{
+    return size;
+}
+
+size_t AnalogStream::Block::getCapacity() const
+{
+    return capacity;
+}
+
+AnalogStream::AnalogStream(const uint16_t deviceId, const uint32_t interfaceId, const size_t blockSize, const size_t maxBlocksCount)
+    : deviceId(deviceId)
+    , interfaceId(interfaceId)
+    , blockSize(std::max<size_t>(blockSize, 1))
+    , maxBlocksCount(maxBlocksCount)
+{
+}
+
+bool AnalogStream::addPacket(const Packet& packet)
+{
+    if (!packet.isValid() || packet.getPayload().getType() != PayloadType::analog)
+        return false;
+
+    const auto& payload = static_cast<const AnalogPayload&>(packet.getPayload());
+    const size_t samplesCount = payload.getSamplesCount();
+    ++stats.packets;
+    if (samplesCount == 0)
+        return true;
+
+    const uint64_t timestamp = packet.getTimestamp();
+    const double sampleIntervalNs = static_cast<double>(payload.getSampleInterval()) * 1e9;
+
+    size_t firstSample = 0;
+    bool continuous = false;
+    if (!blocks.empty() && sampleIntervalNs > 0. && blocks.back().sampleInterval == payload.getSampleInterval() &&
+        blocks.back().unit == payload.getUnit())
+    {
+        const double tolerance = sampleIntervalNs / 2;
+        const auto diff = static_cast<double>(static_cast<int64_t>(timestamp - blocks.back().getEndTimestamp()));
+        if (diff > tolerance)
+        {
+            ++stats.gaps;
+            stats.missingSamples += static_cast<uint64_t>(std::llround(diff / sampleIntervalNs));
+        }
+        else if (diff < -tolerance)
+        {
+            const auto overlapped = static_cast<uint64_t>(std::llround(-diff / sampleIntervalNs));
+            if (overlapped <= samplesCount)
+            {
+                ++stats.overlaps;
+                firstSample = static_cast<size_t>(overlapped);
+                stats.droppedSamples += firstSample;
+                continuous = true;
+            }
+            else
+            {
+                // The packet starts before the last one, e.g. after a clock reset of the device
+                ++stats.timestampJumps;
+            }
+        }
+        else
+        {
+            continuous = true;
+        }
+    }
+
+    if (firstSample == samplesCount)
+        return true;
+
+    if (!continuous)
+        addBlock(timestamp, payload, false);
+    appendSamples(payload, firstSample);
+    return true;
+}
+
+void AnalogStream::clear()
+{
+    blocks.clear();
+    stats = Stats{};
+}
+
+uint16_t AnalogStream::getDeviceId() const
+{
+    return deviceId;
+}
+
+uint32_t AnalogStream::getInterfaceId() const
+{
+    return interfaceId;
+}
+
+size_t AnalogStream::getBlockSize() const
+{
+    return blockSize;
+}
+
+size_t AnalogStream::getMaxBlocksCount() const
+{
+    return maxBlocksCount;
+}
+
+const AnalogStream::Stats& AnalogStream::getStats() const
+{
+    return stats;
+}
+
+size_t AnalogStream::getBlocksCount() const
+{
+    return blocks.size();
+}
+
+const AnalogStream::Block& AnalogStream::getBlock(const size_t index) const
+{
+    return blocks[index];
+}
+
+size_t AnalogStream::getIndexByTimestamp(const uint64_t timestamp) const
+{
+    // Blocks are ordered by time unless the stream jumped back, so the newest matching block wins
+    auto it = std::find_if(blocks.rbegin(),
+                           blocks.rend(),
+                           [timestamp](const Block& block)
+                           { return block.getTimestamp() <= timestamp && timestamp < block.getEndTimestamp(); });
+    return it == blocks.rend() ? blocks.size() : static_cast<size_t>(std::distance(it, blocks.rend()) - 1);
+}
+
+void AnalogStream::removeBlocks(size_t count)
+{
+    count = std::min(count, blocks.size());
+    blocks.erase(blocks.begin(), blocks.begin() + count);
+}
+
+AnalogStream::Block& AnalogStream::addBlock(const uint64_t timestamp, const AnalogPayload& payload, const bool continuous)
+{
+    Block block;
+    if (maxBlocksCount != 0 && blocks.size() >= maxBlocksCount)
+    {
+        // Reuse the storage of the evicted block
+        block.samples = std::move(blocks.front().samples);
+        block.capacity = blocks.front().capacity;
+        blocks.erase(blocks.begin());
+    }
+    else
+    {
+        block.samples = std::make_unique<float[]>(blockSize);
+        block.capacity = blockSize;
+    }
+
+    block.timestamp = timestamp;
+    block.sampleInterval = payload.getSampleInterval();
+    block.sampleIntervalNs = static_cast<double>(block.sampleInterval) * 1e9;
+    block.unit = payload.getUnit();
+    block.continuous = continuous;
+
+    blocks.push_back(std::move(block));
+    return blocks.back();
+}
+
+void AnalogStream::appendSamples(const AnalogPayload& payload, size_t firstSample)
+{
+    const bool isInt16 = payload.getSampleDt() == AnalogPayload::SampleDt::aInt16;
+    const size_t sampleSize = isInt16 ? sizeof(int16_t) : sizeof(int32_t);
+    const size_t samplesCount = payload.getSamplesCount();
+
+    while (firstSample < samplesCount)
+    {
+        Block* block = &blocks.back();
+        if (block->size == block->capacity)
+            block = &addBlock(block->getEndTimestamp(), payload, true);
+
+        const size_t count = std::min(samplesCount - firstSample, block->capacity - block->size);
+        const uint8_t* src = payload.getData() + firstSample * sampleSize;
+        float* dst = block->samples.get() + block->size;
+        if (isInt16)
+            SampleConverter::int16ToFloat(src, count, payload.getSampleScalar(), payload.getSampleOffset(), dst);
+        else
+            SampleConverter::int32ToFloat(src, count, payload.getSampleScalar(), payload.getSampleOffset(), dst);
+
+        block->size += count;
+        stats.samples += count;
+        firstSample += count;
+    }
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,73 @@
+#include <algorithm>
+
+#include <asam_cmp/analog_stream_assembler.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+AnalogStreamAssembler::AnalogStreamAssembler(const size_t blockSize, const size_t maxBlocksCount)
+    : blockSize(blockSize)
+    , maxBlocksCount(maxBlocksCount)
+{
+}
+
+bool AnalogStreamAssembler::addPacket(const Packet& packet)
+{
+    if (!packet.isValid() || packet.getPayload().getType() != PayloadType::analog)
+        return false;
+
+    auto index = getIndexByInterface(packet.getDeviceId(), packet.getInterfaceId());
+    if (index == getStreamsCount())
+    {
+        streamIndexes.insert(getKey(packet.getDeviceId(), packet.getInterfaceId()), index);
+        streams.emplace_back(packet.getDeviceId(), packet.getInterfaceId(), blockSize, maxBlocksCount);
+    }
+
+    return streams[index].addPacket(packet);
+}
+
+void AnalogStreamAssembler::clear()
+{
+    streams.clear();
+    streamIndexes.clear();
+}
+
+size_t AnalogStreamAssembler::getStreamsCount() const
+{
+    return streams.size();
+}
+
+size_t AnalogStreamAssembler::getIndexByInterface(const uint16_t deviceId, const uint32_t interfaceId) const
+{
+    auto index = streamIndexes.find(getKey(deviceId, interfaceId));
+    return index == FlatIndexMap<uint64_t>::npos ? streams.size() : index;
+}
+
+AnalogStream& AnalogStreamAssembler::getStream(const size_t index)
+{
+    return streams[index];
+}
+
+const AnalogStream& AnalogStreamAssembler::getStream(const size_t index) const
+{
+    return streams[index];
+}
+
+void AnalogStreamAssembler::removeStream(const uint16_t deviceId, const uint32_t interfaceId)
+{
+    auto index = getIndexByInterface(deviceId, interfaceId);
+    if (index != getStreamsCount())
+    {
+        std::swap(streams[index], streams[streams.size() - 1]);
+        streams.pop_back();
+        streamIndexes.erase(getKey(deviceId, interfaceId));
+        if (index != streams.size())
+            streamIndexes.insert(getKey(streams[index].getDeviceId(), streams[index].getInterfaceId()), index);
+    }
+}
+
+uint64_t AnalogStreamAssembler::getKey(const uint16_t deviceId, const uint32_t interfaceId)
+{
+    return (static_cast<uint64_t>(deviceId) << 32) | interfaceId;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <asam_cmp/analog_stream_writer.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+AnalogStreamWriter::AnalogStreamWriter(const AnalogPayload& format, const DataContext& dataContext)
+    : format(format)
+    , sampleSize(format.getSampleDt() == AnalogPayload::SampleDt::aInt16 ? sizeof(int16_t) : sizeof(int32_t))
+    , sampleIntervalNs(static_cast<double>(format.getSampleInterval()) * 1e9)
+{
+    this->format.setData(format.getData(), 0);
+
+    constexpr size_t headersSize = sizeof(CmpHeader) + sizeof(MessageHeader) + sizeof(AnalogPayload::Header);
+    constexpr size_t maxPayloadDataSize = UINT16_MAX - sizeof(AnalogPayload::Header);
+    if (dataContext.maxBytesPerMessage > headersSize)
+        samplesPerPacket = std::min(dataContext.maxBytesPerMessage - headersSize, maxPayloadDataSize) / sampleSize;
+
+    if (samplesPerPacket == 0)
+        throw std::invalid_argument("maxBytesPerMessage is too small for Analog samples");
+}
+
+void AnalogStreamWriter::setDeviceId(const uint16_t id)
+{
+    deviceId = id;
+}
+
+uint16_t AnalogStreamWriter::getDeviceId() const
+{
+    return deviceId;
+}
+
+void AnalogStreamWriter::setStreamId(const uint8_t id)
+{
+    streamId = id;
+}
+
+uint8_t AnalogStreamWriter::getStreamId() const
+{
+    return streamId;
+}
+
+void AnalogStreamWriter::setInterfaceId(const uint32_t id)
+{
+    interfaceId = id;
+}
+
+uint32_t AnalogStreamWriter::getInterfaceId() const
+{
+    return interfaceId;
+}
+
+void AnalogStreamWriter::setTimestamp(const uint64_t timestamp)
+{
+    startTimestamp = timestamp;
+    samplesWritten = 0;
+    pendingSamples16.clear();
+    pendingSamples32.clear();
+}
+
+uint64_t AnalogStreamWriter::getTimestamp() const
+{
+    return getSampleTimestamp(samplesWritten);
+}
+
+size_t AnalogStreamWriter::getSamplesPerPacket() const
+{
+    return samplesPerPacket;
+}
+
+size_t AnalogStreamWriter::getPendingSamplesCount() const
+{
+    return pendingSamples16.size() + pendingSamples32.size();
+}
+
+std::vector<AnalogStreamWriter::PacketPtr> AnalogStreamWriter::write(const int16_t* samples, const size_t count)
+{
+    return writeSamples(samples, count, pendingSamples16);
+}
+
+std::vector<AnalogStreamWriter::PacketPtr> AnalogStreamWriter::write(const int32_t* samples, const size_t count)
+{
+    return writeSamples(samples, count, pendingSamples32);
+}
+
+std::vector<AnalogStreamWriter::PacketPtr> AnalogStreamWriter::flush()
+{
+    std::vector<PacketPtr> packets;
+    if (!pendingSamples16.empty())
+        packets.push_back(createPacket(pendingSamples16.data(), pendingSamples16.size()));
+    if (!pendingSamples32.empty())
+        packets.push_back(createPacket(pendingSamples32.data(), pendingSamples32.size()));
+
+    pendingSamples16.clear();
+    pendingSamples32.clear();
+    return packets;
+}
+
+template <typename SampleType>
+std::vector<AnalogStreamWriter::PacketPtr> AnalogStreamWriter::writeSamples(const SampleType* samples,
+                                                                            const size_t count,
+                                                                            std::vector<SampleType>& pendingSamples)
+{
+    if (AnalogPayload::SampleDtFromType<SampleType>::sampleDtType != format.getSampleDt())
+        throw std::invalid_argument("Sample type does not match the sample data type of the stream");
+
+    std::vector<PacketPtr> packets;
+    size_t pos = 0;
+
+    if (!pendingSamples.empty())
+    {
+        pos = std::min(count, samplesPerPacket - pendingSamples.size());
+        pendingSamples.insert(pendingSamples.end(), samples, samples + pos);
+        if (pendingSamples.size() < samplesPerPacket)
+            return packets;
+
+        packets.push_back(createPacket(pendingSamples.data(), pendingSamples.size()));
+        pendingSamples.clear();
+    }
+
+    packets.reserve(packets.size() + (count - pos) / samplesPerPacket);
+    for (; count - pos >= samplesPerPacket; pos += samplesPerPacket)
+        packets.push_back(createPacket(samples + pos, samplesPerPacket));
+
+    pendingSamples.insert(pendingSamples.end(), samples + pos, samples + count);
+    return packets;
+}
+
+template <typename SampleType>
+AnalogStreamWriter::PacketPtr AnalogStreamWriter::createPacket(const SampleType* samples, const size_t count)
+{
+    AnalogPayload payload(format);
+    payload.setSamples(samples, count);
+
+    auto packet = std::make_shared<Packet>();
+    packet->setDeviceId(deviceId);
+    packet->setStreamId(streamId);
+    packet->setInterfaceId(interfaceId);
+    packet->setTimestamp(getSampleTimestamp(samplesWritten));
+    packet->setPayload(std::move(payload));
+
+    samplesWritten += count;
+    return packet;
+}
+
+uint64_t AnalogStreamWriter::getSampleTimestamp(const uint64_t sampleIndex) const
+{
+    // Computed from the sample index rather than accumulated to avoid drift on long streams
+    return startTimestamp + static_cast<uint64_t>(std::llround(static_cast<double>(sampleIndex) * sampleIntervalNs));
+}
+
+END_NAMESPACE_ASAM_CMP
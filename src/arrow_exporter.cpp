@@ -0,0 +1,328 @@
+#include <algorithm>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/arrow_exporter.h>
+#include <asam_cmp/can_payload_base.h>
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/interface_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/sample_converter.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    using Type = ArrowWriter::Type;
+
+    // Columns every family starts with
+    enum CommonColumn : size_t
+    {
+        timestampColumn,
+        deviceIdColumn,
+        streamIdColumn,
+        interfaceIdColumn,
+        familyColumns
+    };
+
+    std::vector<ArrowWriter::Column> getColumns(const ArrowExporter::Family family)
+    {
+        std::vector<ArrowWriter::Column> columns = {
+            {"timestamp", Type::timestampNs}, {"device_id", Type::uint16}, {"stream_id", Type::uint8}, {"interface_id", Type::uint32}};
+
+        switch (family)
+        {
+            case ArrowExporter::Family::can:
+                columns.insert(columns.end(),
+                               {{"can_id", Type::uint32},
+                                {"ide", Type::boolean},
+                                {"fd", Type::boolean},
+                                {"dlc", Type::uint8},
+                                {"flags", Type::uint16},
+                                {"data", Type::binary}});
+                break;
+            case ArrowExporter::Family::lin:
+                columns.insert(columns.end(),
+                               {{"lin_id", Type::uint8},
+                                {"pid", Type::uint8},
+                                {"checksum", Type::uint8},
+                                {"flags", Type::uint16},
+                                {"data", Type::binary}});
+                break;
+            case ArrowExporter::Family::ethernet:
+                columns.insert(columns.end(), {{"flags", Type::uint16}, {"data", Type::binary}});
+                break;
+            case ArrowExporter::Family::analog:
+                columns.insert(columns.end(), {{"unit", Type::uint8}, {"sample_interval", Type::float32}, {"values", Type::float32List}});
+                break;
+            case ArrowExporter::Family::status:
+                columns.insert(columns.end(),
+                               {{"payload_type", Type::uint16},
+                                {"interface_status", Type::uint8},
+                                {"interface_type", Type::uint8},
+                                {"msg_total_rx", Type::uint32},
+                                {"msg_total_tx", Type::uint32},
+                                {"msg_dropped_rx", Type::uint32},
+                                {"msg_dropped_tx", Type::uint32},
+                                {"errors_total_rx", Type::uint32},
+                                {"errors_total_tx", Type::uint32},
+                                {"uptime", Type::uint64},
+                                {"gm_identity", Type::uint64},
+                                {"device_description", Type::utf8},
+                                {"serial_number", Type::utf8},
+                                {"hardware_version", Type::utf8},
+                                {"software_version", Type::utf8}});
+                break;
+        }
+        return columns;
+    }
+
+    const char* getFamilyName(const ArrowExporter::Family family)
+    {
+        switch (family)
+        {
+            case ArrowExporter::Family::can:
+                return "can";
+            case ArrowExporter::Family::lin:
+                return "lin";
+            case ArrowExporter::Family::ethernet:
+                return "ethernet";
+            case ArrowExporter::Family::analog:
+                return "analog";
+            case ArrowExporter::Family::status:
+            default:
+                return "status";
+        }
+    }
+
+    // Data bytes after a payload header, limited to the bytes of the payload
+    template <typename Header>
+    size_t getDataLength(const Header* header, const size_t payloadLength)
+    {
+        return std::min<size_t>(header->getDataLength(), payloadLength - sizeof(Header));
+    }
+}
+
+ArrowExporter::ArrowExporter(Options newOptions)
+    : options(std::move(newOptions))
+{
+}
+
+ArrowExporter::~ArrowExporter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+size_t ArrowExporter::write(const PacketBatch& batch)
+{
+    const auto& payloadTypes = batch.getPayloadTypes();
+    size_t rows = 0;
+    for (size_t index = 0; index < batch.size(); ++index)
+    {
+        bool written = false;
+        switch (payloadTypes[index])
+        {
+            case PayloadType::can:
+            case PayloadType::canFd:
+                written = writeCan(batch, index);
+                break;
+            case PayloadType::lin:
+                written = writeLin(batch, index);
+                break;
+            case PayloadType::ethernet:
+                written = writeEthernet(batch, index);
+                break;
+            case PayloadType::analog:
+                written = writeAnalog(batch, index);
+                break;
+            case PayloadType::cmStatMsg:
+            case PayloadType::ifStatMsg:
+                written = writeStatus(batch, index);
+                break;
+            default:
+                break;
+        }
+        rows += written ? 1 : 0;
+    }
+    return rows;
+}
+
+void ArrowExporter::close()
+{
+    for (auto& writer : writers)
+    {
+        if (writer)
+            writer->close();
+    }
+}
+
+std::string ArrowExporter::getPath(const Family family) const
+{
+    return options.basePath + "_" + getFamilyName(family) + ".arrow";
+}
+
+uint64_t ArrowExporter::getRowCount(const Family family) const
+{
+    const auto& writer = writers[static_cast<size_t>(family)];
+    return writer ? writer->getRowCount() : 0;
+}
+
+ArrowWriter& ArrowExporter::getWriter(const Family family)
+{
+    auto& writer = writers[static_cast<size_t>(family)];
+    if (!writer)
+        writer = std::make_unique<ArrowWriter>(getPath(family), getColumns(family), options.batchRows);
+    return *writer;
+}
+
+void ArrowExporter::appendCommon(ArrowWriter& writer, const PacketBatch& batch, const size_t index)
+{
+    writer.append(timestampColumn, batch.getTimestamps()[index]);
+    writer.append(deviceIdColumn, batch.getDeviceIds()[index]);
+    writer.append(streamIdColumn, batch.getStreamIds()[index]);
+    writer.append(interfaceIdColumn, batch.getInterfaceIds()[index]);
+}
+
+bool ArrowExporter::writeCan(const PacketBatch& batch, const size_t index)
+{
+    const size_t length = batch.getPayloadLength(index);
+    if (length < sizeof(CanPayloadBase::Header))
+        return false;
+
+    const auto payload = batch.getPayload(index);
+    const auto header = reinterpret_cast<const CanPayloadBase::Header*>(payload);
+    auto& writer = getWriter(Family::can);
+    appendCommon(writer, batch, index);
+    writer.append(familyColumns, header->getId());
+    writer.append(familyColumns + 1, header->getIde());
+    writer.append(familyColumns + 2, batch.getPayloadTypes()[index] == PayloadType::canFd);
+    writer.append(familyColumns + 3, header->getDlc());
+    writer.append(familyColumns + 4, header->getFlags());
+    writer.appendBinary(familyColumns + 5, payload + sizeof(CanPayloadBase::Header), getDataLength(header, length));
+    writer.endRow();
+    return true;
+}
+
+bool ArrowExporter::writeLin(const PacketBatch& batch, const size_t index)
+{
+    const size_t length = batch.getPayloadLength(index);
+    if (length < sizeof(LinPayload::Header))
+        return false;
+
+    const auto payload = batch.getPayload(index);
+    const auto header = reinterpret_cast<const LinPayload::Header*>(payload);
+    auto& writer = getWriter(Family::lin);
+    appendCommon(writer, batch, index);
+    writer.append(familyColumns, header->getLinId());
+    writer.append(familyColumns + 1, batch.getLinPids()[index]);
+    writer.append(familyColumns + 2, header->getChecksum());
+    writer.append(familyColumns + 3, header->getFlags());
+    writer.appendBinary(familyColumns + 4, payload + sizeof(LinPayload::Header), getDataLength(header, length));
+    writer.endRow();
+    return true;
+}
+
+bool ArrowExporter::writeEthernet(const PacketBatch& batch, const size_t index)
+{
+    const size_t length = batch.getPayloadLength(index);
+    if (length < sizeof(EthernetPayload::Header))
+        return false;
+
+    const auto payload = batch.getPayload(index);
+    const auto header = reinterpret_cast<const EthernetPayload::Header*>(payload);
+    auto& writer = getWriter(Family::ethernet);
+    appendCommon(writer, batch, index);
+    writer.append(familyColumns, header->getFlags());
+    writer.appendBinary(familyColumns + 1, payload + sizeof(EthernetPayload::Header), getDataLength(header, length));
+    writer.endRow();
+    return true;
+}
+
+bool ArrowExporter::writeAnalog(const PacketBatch& batch, const size_t index)
+{
+    const size_t length = batch.getPayloadLength(index);
+    if (length < sizeof(AnalogPayload::Header))
+        return false;
+
+    const auto payload = batch.getPayload(index);
+    const auto header = reinterpret_cast<const AnalogPayload::Header*>(payload);
+    const auto sampleData = payload + sizeof(AnalogPayload::Header);
+    const bool int16Samples = header->getSampleDt() == AnalogPayload::SampleDt::aInt16;
+    const size_t count = (length - sizeof(AnalogPayload::Header)) / (int16Samples ? sizeof(int16_t) : sizeof(int32_t));
+
+    samples.resize(count);
+    if (int16Samples)
+        SampleConverter::int16ToFloat(sampleData, count, header->getSampleScalar(), header->getSampleOffset(), samples.data());
+    else
+        SampleConverter::int32ToFloat(sampleData, count, header->getSampleScalar(), header->getSampleOffset(), samples.data());
+
+    auto& writer = getWriter(Family::analog);
+    appendCommon(writer, batch, index);
+    writer.append(familyColumns, to_underlying(header->getUnit()));
+    writer.appendFloat(familyColumns + 1, header->getSampleInterval());
+    writer.appendList(familyColumns + 2, samples.data(), samples.size());
+    writer.endRow();
+    return true;
+}
+
+bool ArrowExporter::writeStatus(const PacketBatch& batch, const size_t index)
+{
+    // Status messages are rare, so their variable length payloads are parsed by the payload classes
+    const auto payload = batch.getPayload(index);
+    const size_t length = batch.getPayloadLength(index);
+    const uint16_t payloadType = batch.getPayloadTypes()[index];
+
+    if (payloadType == PayloadType::ifStatMsg)
+    {
+        if (!InterfacePayload::isValidPayload(payload, length))
+            return false;
+
+        const InterfacePayload interfacePayload(payload, length);
+        auto& writer = getWriter(Family::status);
+        writer.append(timestampColumn, batch.getTimestamps()[index]);
+        writer.append(deviceIdColumn, batch.getDeviceIds()[index]);
+        writer.append(streamIdColumn, batch.getStreamIds()[index]);
+        writer.append(interfaceIdColumn, interfacePayload.getInterfaceId());
+        writer.append(familyColumns, payloadType);
+        writer.append(familyColumns + 1, to_underlying(interfacePayload.getInterfaceStatus()));
+        writer.append(familyColumns + 2, interfacePayload.getInterfaceType());
+        writer.append(familyColumns + 3, interfacePayload.getMsgTotalRx());
+        writer.append(familyColumns + 4, interfacePayload.getMsgTotalTx());
+        writer.append(familyColumns + 5, interfacePayload.getMsgDroppedRx());
+        writer.append(familyColumns + 6, interfacePayload.getMsgDroppedTx());
+        writer.append(familyColumns + 7, interfacePayload.getErrorsTotalRx());
+        writer.append(familyColumns + 8, interfacePayload.getErrorsTotalTx());
+        writer.append(familyColumns + 9, 0);
+        writer.append(familyColumns + 10, 0);
+        for (size_t column = familyColumns + 11; column < familyColumns + 15; ++column)
+            writer.appendString(column, {});
+        writer.endRow();
+        return true;
+    }
+
+    if (!CaptureModulePayload::isValidPayload(payload, length))
+        return false;
+
+    const CaptureModulePayload capturePayload(payload, length);
+    auto& writer = getWriter(Family::status);
+    appendCommon(writer, batch, index);
+    writer.append(familyColumns, payloadType);
+    for (size_t column = familyColumns + 1; column < familyColumns + 9; ++column)
+        writer.append(column, 0);
+    writer.append(familyColumns + 9, capturePayload.getUptime());
+    writer.append(familyColumns + 10, capturePayload.getGmIdentity());
+    writer.appendString(familyColumns + 11, capturePayload.getDeviceDescription());
+    writer.appendString(familyColumns + 12, capturePayload.getSerialNumber());
+    writer.appendString(familyColumns + 13, capturePayload.getHardwareVersion());
+    writer.appendString(familyColumns + 14, capturePayload.getSoftwareVersion());
+    writer.endRow();
+    return true;
+}
+
+END_NAMESPACE_ASAM_CMP
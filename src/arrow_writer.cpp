@@ -0,0 +1,650 @@
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+
+#include <asam_cmp/arrow_writer.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr char magic[] = "ARROW1";
+    constexpr uint32_t continuationMarker = 0xFFFFFFFF;
+
+    // Arrow format constants (Schema.fbs, Message.fbs)
+    constexpr int16_t metadataVersionV5 = 4;
+    constexpr uint8_t messageHeaderSchema = 1;
+    constexpr uint8_t messageHeaderRecordBatch = 3;
+    constexpr uint8_t typeInt = 2;
+    constexpr uint8_t typeFloatingPoint = 3;
+    constexpr uint8_t typeBinary = 4;
+    constexpr uint8_t typeUtf8 = 5;
+    constexpr uint8_t typeBool = 6;
+    constexpr uint8_t typeTimestamp = 10;
+    constexpr uint8_t typeList = 12;
+    constexpr int16_t precisionSingle = 1;
+    constexpr int16_t timeUnitNanosecond = 3;
+    constexpr int16_t endiannessLittle = 0;
+
+    size_t alignUp(const size_t value, const size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // FlatBuffers object of the Arrow metadata: a table, a string or a vector of structs or tables
+    struct FlatNode
+    {
+        enum class Kind
+        {
+            table,
+            string,
+            structVector,
+            tableVector
+        };
+
+        struct Field
+        {
+            uint16_t id{0};
+            std::vector<uint8_t> scalar;
+            std::unique_ptr<FlatNode> child;
+        };
+
+        template <typename T>
+        FlatNode& add(const uint16_t id, const T value)
+        {
+            Field field;
+            field.id = id;
+            field.scalar.resize(sizeof(T));
+            memcpy(field.scalar.data(), &value, sizeof(T));
+            fields.push_back(std::move(field));
+            return *this;
+        }
+
+        FlatNode& add(const uint16_t id, std::unique_ptr<FlatNode> child)
+        {
+            Field field;
+            field.id = id;
+            field.child = std::move(child);
+            fields.push_back(std::move(field));
+            return *this;
+        }
+
+        Kind kind{Kind::table};
+        std::vector<Field> fields;
+        // String or struct bytes
+        std::vector<uint8_t> bytes;
+        uint32_t count{0};
+        size_t alignment{4};
+        std::vector<std::unique_ptr<FlatNode>> children;
+    };
+
+    using FlatNodePtr = std::unique_ptr<FlatNode>;
+
+    FlatNodePtr makeTable()
+    {
+        return std::make_unique<FlatNode>();
+    }
+
+    FlatNodePtr makeString(const std::string_view value)
+    {
+        auto node = std::make_unique<FlatNode>();
+        node->kind = FlatNode::Kind::string;
+        node->bytes.assign(value.begin(), value.end());
+        node->count = static_cast<uint32_t>(value.size());
+        return node;
+    }
+
+    FlatNodePtr makeTableVector(std::vector<FlatNodePtr> children)
+    {
+        auto node = std::make_unique<FlatNode>();
+        node->kind = FlatNode::Kind::tableVector;
+        node->count = static_cast<uint32_t>(children.size());
+        node->children = std::move(children);
+        return node;
+    }
+
+    template <typename Struct>
+    FlatNodePtr makeStructVector(const std::vector<Struct>& structs)
+    {
+        auto node = std::make_unique<FlatNode>();
+        node->kind = FlatNode::Kind::structVector;
+        node->count = static_cast<uint32_t>(structs.size());
+        node->alignment = 8;
+        node->bytes.resize(structs.size() * sizeof(Struct));
+        if (!structs.empty())
+            memcpy(node->bytes.data(), structs.data(), node->bytes.size());
+        return node;
+    }
+
+    // Lays out objects front to back with children after their parents, so every offset points forward
+    // as FlatBuffers requires. Scalars are naturally aligned relative to the start of the buffer.
+    class FlatSerializer final
+    {
+    public:
+        std::vector<uint8_t> finish(const FlatNode& root)
+        {
+            buffer.assign(sizeof(uint32_t), 0);
+            patch(0, write(root));
+            return std::move(buffer);
+        }
+
+    private:
+        size_t write(const FlatNode& node)
+        {
+            switch (node.kind)
+            {
+                case FlatNode::Kind::table:
+                    return writeTable(node);
+                case FlatNode::Kind::string:
+                {
+                    align(4);
+                    const size_t position = buffer.size();
+                    append(node.count);
+                    buffer.insert(buffer.end(), node.bytes.begin(), node.bytes.end());
+                    buffer.push_back(0);
+                    return position;
+                }
+                case FlatNode::Kind::structVector:
+                {
+                    align(4);
+                    while ((buffer.size() + sizeof(uint32_t)) % node.alignment != 0)
+                        buffer.push_back(0);
+                    const size_t position = buffer.size();
+                    append(node.count);
+                    buffer.insert(buffer.end(), node.bytes.begin(), node.bytes.end());
+                    return position;
+                }
+                case FlatNode::Kind::tableVector:
+                default:
+                {
+                    align(4);
+                    const size_t position = buffer.size();
+                    append(node.count);
+                    buffer.resize(buffer.size() + node.children.size() * sizeof(uint32_t), 0);
+                    for (size_t index = 0; index < node.children.size(); ++index)
+                    {
+                        const size_t child = write(*node.children[index]);
+                        patch(position + sizeof(uint32_t) * (index + 1), child);
+                    }
+                    return position;
+                }
+            }
+        }
+
+        size_t writeTable(const FlatNode& node)
+        {
+            auto fieldSize = [](const FlatNode::Field& field) { return field.child ? sizeof(uint32_t) : field.scalar.size(); };
+
+            // Inline fields follow the offset to the vtable, ordered by descending size so that none needs padding
+            std::vector<size_t> order(node.fields.size());
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::stable_sort(order.begin(),
+                             order.end(),
+                             [&node, &fieldSize](const size_t lhs, const size_t rhs)
+                             { return fieldSize(node.fields[lhs]) > fieldSize(node.fields[rhs]); });
+
+            std::vector<uint16_t> fieldOffsets(node.fields.size());
+            size_t inlineSize = sizeof(int32_t);
+            uint16_t slotCount = 0;
+            for (const auto index : order)
+            {
+                const size_t size = fieldSize(node.fields[index]);
+                inlineSize = alignUp(inlineSize, size);
+                fieldOffsets[index] = static_cast<uint16_t>(inlineSize);
+                inlineSize += size;
+                slotCount = std::max<uint16_t>(slotCount, static_cast<uint16_t>(node.fields[index].id + 1));
+            }
+
+            std::vector<uint16_t> vtable(2 + slotCount, 0);
+            vtable[0] = static_cast<uint16_t>(vtable.size() * sizeof(uint16_t));
+            vtable[1] = static_cast<uint16_t>(inlineSize);
+            for (size_t index = 0; index < node.fields.size(); ++index)
+                vtable[2 + node.fields[index].id] = fieldOffsets[index];
+
+            align(2);
+            const size_t vtablePosition = buffer.size();
+            for (const auto value : vtable)
+                append(value);
+
+            align(8);
+            const size_t tablePosition = buffer.size();
+            buffer.resize(tablePosition + inlineSize, 0);
+            const auto vtableOffset = static_cast<int32_t>(tablePosition - vtablePosition);
+            memcpy(buffer.data() + tablePosition, &vtableOffset, sizeof(vtableOffset));
+
+            for (size_t index = 0; index < node.fields.size(); ++index)
+            {
+                const auto& field = node.fields[index];
+                if (!field.child)
+                    memcpy(buffer.data() + tablePosition + fieldOffsets[index], field.scalar.data(), field.scalar.size());
+            }
+            for (size_t index = 0; index < node.fields.size(); ++index)
+            {
+                const auto& field = node.fields[index];
+                if (field.child)
+                {
+                    const size_t child = write(*field.child);
+                    patch(tablePosition + fieldOffsets[index], child);
+                }
+            }
+            return tablePosition;
+        }
+
+        template <typename T>
+        void append(const T value)
+        {
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        void align(const size_t alignment)
+        {
+            buffer.resize(alignUp(buffer.size(), alignment), 0);
+        }
+
+        void patch(const size_t position, const size_t target)
+        {
+            const auto offset = static_cast<uint32_t>(target - position);
+            memcpy(buffer.data() + position, &offset, sizeof(offset));
+        }
+
+    private:
+        std::vector<uint8_t> buffer;
+    };
+
+#pragma pack(push, 1)
+    struct FieldNode
+    {
+        int64_t length{0};
+        int64_t nullCount{0};
+    };
+
+    struct BufferSpec
+    {
+        int64_t offset{0};
+        int64_t length{0};
+    };
+
+    struct FooterBlock
+    {
+        int64_t offset{0};
+        int32_t metadataLength{0};
+        int32_t padding{0};
+        int64_t bodyLength{0};
+    };
+#pragma pack(pop)
+
+    FlatNodePtr makeIntType(const int32_t bitWidth)
+    {
+        auto type = makeTable();
+        type->add<int32_t>(0, bitWidth);
+        type->add<uint8_t>(1, 0);
+        return type;
+    }
+
+    FlatNodePtr makeField(const std::string& name, const uint8_t typeId, FlatNodePtr type, std::vector<FlatNodePtr> children = {})
+    {
+        auto field = makeTable();
+        field->add(0, makeString(name));
+        field->add<uint8_t>(1, 0);
+        field->add<uint8_t>(2, typeId);
+        field->add(3, std::move(type));
+        field->add(5, makeTableVector(std::move(children)));
+        return field;
+    }
+
+    FlatNodePtr makeField(const ArrowWriter::Column& column)
+    {
+        switch (column.type)
+        {
+            case ArrowWriter::Type::uint8:
+                return makeField(column.name, typeInt, makeIntType(8));
+            case ArrowWriter::Type::uint16:
+                return makeField(column.name, typeInt, makeIntType(16));
+            case ArrowWriter::Type::uint32:
+                return makeField(column.name, typeInt, makeIntType(32));
+            case ArrowWriter::Type::uint64:
+                return makeField(column.name, typeInt, makeIntType(64));
+            case ArrowWriter::Type::float32:
+            {
+                auto type = makeTable();
+                type->add<int16_t>(0, precisionSingle);
+                return makeField(column.name, typeFloatingPoint, std::move(type));
+            }
+            case ArrowWriter::Type::boolean:
+                return makeField(column.name, typeBool, makeTable());
+            case ArrowWriter::Type::timestampNs:
+            {
+                auto type = makeTable();
+                type->add<int16_t>(0, timeUnitNanosecond);
+                return makeField(column.name, typeTimestamp, std::move(type));
+            }
+            case ArrowWriter::Type::binary:
+                return makeField(column.name, typeBinary, makeTable());
+            case ArrowWriter::Type::utf8:
+                return makeField(column.name, typeUtf8, makeTable());
+            case ArrowWriter::Type::float32List:
+            default:
+            {
+                auto itemType = makeTable();
+                itemType->add<int16_t>(0, precisionSingle);
+                std::vector<FlatNodePtr> children;
+                children.push_back(makeField("item", typeFloatingPoint, std::move(itemType)));
+                return makeField(column.name, typeList, makeTable(), std::move(children));
+            }
+        }
+    }
+
+    FlatNodePtr makeSchema(const std::vector<ArrowWriter::Column>& columns)
+    {
+        std::vector<FlatNodePtr> fields;
+        for (const auto& column : columns)
+            fields.push_back(makeField(column));
+
+        auto schema = makeTable();
+        schema->add<int16_t>(0, endiannessLittle);
+        schema->add(1, makeTableVector(std::move(fields)));
+        return schema;
+    }
+
+    std::vector<uint8_t> makeMessage(const uint8_t headerType, FlatNodePtr header, const int64_t bodyLength)
+    {
+        auto message = makeTable();
+        message->add<int16_t>(0, metadataVersionV5);
+        message->add<uint8_t>(1, headerType);
+        message->add(2, std::move(header));
+        message->add<int64_t>(3, bodyLength);
+        return FlatSerializer().finish(*message);
+    }
+
+    size_t getValueSize(const ArrowWriter::Type type)
+    {
+        switch (type)
+        {
+            case ArrowWriter::Type::uint8:
+            case ArrowWriter::Type::boolean:
+                return 1;
+            case ArrowWriter::Type::uint16:
+                return 2;
+            case ArrowWriter::Type::uint32:
+            case ArrowWriter::Type::float32:
+                return 4;
+            case ArrowWriter::Type::uint64:
+            case ArrowWriter::Type::timestampNs:
+                return 8;
+            default:
+                return 0;
+        }
+    }
+}
+
+ArrowWriter::ArrowWriter(const std::string& newPath, std::vector<Column> newColumns, const size_t newBatchRows)
+    : path(newPath)
+    , columns(std::move(newColumns))
+    , batchRows(std::max<size_t>(newBatchRows, 1))
+    , columnData(columns.size())
+{
+    for (size_t index = 0; index < columns.size(); ++index)
+    {
+        if (getValueSize(columns[index].type) == 0)
+            columnData[index].offsets.push_back(0);
+    }
+
+    stream.open(path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+        throw std::runtime_error("Cannot create Arrow file " + path);
+
+    const char header[8] = {magic[0], magic[1], magic[2], magic[3], magic[4], magic[5], 0, 0};
+    write(header, sizeof(header));
+    writeMessage(makeMessage(messageHeaderSchema, makeSchema(columns), 0), {}, 0);
+    checkStream();
+}
+
+ArrowWriter::~ArrowWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void ArrowWriter::append(const size_t column, const uint64_t value)
+{
+    auto& values = columnData[column].values;
+    switch (columns[column].type)
+    {
+        case Type::uint8:
+            values.push_back(static_cast<uint8_t>(value));
+            break;
+        case Type::boolean:
+            values.push_back(value != 0 ? 1 : 0);
+            break;
+        case Type::uint16:
+        {
+            const auto narrowed = static_cast<uint16_t>(value);
+            values.insert(values.end(), reinterpret_cast<const uint8_t*>(&narrowed), reinterpret_cast<const uint8_t*>(&narrowed) + 2);
+            break;
+        }
+        case Type::uint32:
+        {
+            const auto narrowed = static_cast<uint32_t>(value);
+            values.insert(values.end(), reinterpret_cast<const uint8_t*>(&narrowed), reinterpret_cast<const uint8_t*>(&narrowed) + 4);
+            break;
+        }
+        case Type::uint64:
+        case Type::timestampNs:
+            values.insert(values.end(), reinterpret_cast<const uint8_t*>(&value), reinterpret_cast<const uint8_t*>(&value) + 8);
+            break;
+        default:
+            throw std::invalid_argument("Column " + columns[column].name + " does not hold integers");
+    }
+}
+
+void ArrowWriter::appendFloat(const size_t column, const float value)
+{
+    if (columns[column].type != Type::float32)
+        throw std::invalid_argument("Column " + columns[column].name + " does not hold floats");
+
+    auto& values = columnData[column].values;
+    values.insert(values.end(), reinterpret_cast<const uint8_t*>(&value), reinterpret_cast<const uint8_t*>(&value) + sizeof(value));
+}
+
+void ArrowWriter::appendBinary(const size_t column, const void* data, const size_t size)
+{
+    if (columns[column].type != Type::binary && columns[column].type != Type::utf8)
+        throw std::invalid_argument("Column " + columns[column].name + " does not hold binary data");
+
+    auto& columnValues = columnData[column];
+    const auto bytes = reinterpret_cast<const uint8_t*>(data);
+    columnValues.values.insert(columnValues.values.end(), bytes, bytes + size);
+    columnValues.offsets.push_back(static_cast<int32_t>(columnValues.values.size()));
+}
+
+void ArrowWriter::appendString(const size_t column, const std::string_view value)
+{
+    appendBinary(column, value.data(), value.size());
+}
+
+void ArrowWriter::appendList(const size_t column, const float* values, const size_t count)
+{
+    if (columns[column].type != Type::float32List)
+        throw std::invalid_argument("Column " + columns[column].name + " does not hold lists");
+
+    auto& columnValues = columnData[column];
+    const auto bytes = reinterpret_cast<const uint8_t*>(values);
+    columnValues.values.insert(columnValues.values.end(), bytes, bytes + count * sizeof(float));
+    columnValues.offsets.push_back(static_cast<int32_t>(columnValues.values.size() / sizeof(float)));
+}
+
+void ArrowWriter::endRow()
+{
+    ++batchRowCount;
+    ++rowCount;
+    if (batchRowCount == batchRows)
+        flush();
+}
+
+void ArrowWriter::flush()
+{
+    if (batchRowCount == 0 || !stream.is_open())
+        return;
+
+    std::vector<FieldNode> nodes;
+    std::vector<BufferSpec> buffers;
+    std::vector<BodyBuffer> body;
+    std::vector<std::vector<uint8_t>> bitmaps;
+    int64_t bodyLength = 0;
+
+    auto addBuffer = [&buffers, &body, &bodyLength](const void* data, const size_t size)
+    {
+        buffers.push_back({bodyLength, static_cast<int64_t>(size)});
+        body.push_back({data, size});
+        bodyLength += static_cast<int64_t>(alignUp(size, 8));
+    };
+
+    const auto length = static_cast<int64_t>(batchRowCount);
+    bitmaps.reserve(columns.size());
+    for (size_t index = 0; index < columns.size(); ++index)
+    {
+        auto& data = columnData[index];
+        const size_t valueCount = getValueSize(columns[index].type) != 0 ? data.values.size() / getValueSize(columns[index].type)
+                                                                          : data.offsets.size() - 1;
+        if (valueCount != batchRowCount)
+            throw std::invalid_argument("Column " + columns[index].name + " does not have one value per row");
+
+        nodes.push_back({length, 0});
+        // No validity bitmap, the columns are not nullable
+        addBuffer(nullptr, 0);
+        switch (columns[index].type)
+        {
+            case Type::boolean:
+            {
+                std::vector<uint8_t> bits((batchRowCount + 7) / 8, 0);
+                for (size_t row = 0; row < batchRowCount; ++row)
+                    bits[row / 8] |= static_cast<uint8_t>(data.values[row] << (row % 8));
+                bitmaps.push_back(std::move(bits));
+                addBuffer(bitmaps.back().data(), bitmaps.back().size());
+                break;
+            }
+            case Type::binary:
+            case Type::utf8:
+                addBuffer(data.offsets.data(), data.offsets.size() * sizeof(int32_t));
+                addBuffer(data.values.data(), data.values.size());
+                break;
+            case Type::float32List:
+                addBuffer(data.offsets.data(), data.offsets.size() * sizeof(int32_t));
+                nodes.push_back({static_cast<int64_t>(data.values.size() / sizeof(float)), 0});
+                addBuffer(nullptr, 0);
+                addBuffer(data.values.data(), data.values.size());
+                break;
+            default:
+                addBuffer(data.values.data(), data.values.size());
+                break;
+        }
+    }
+
+    auto recordBatch = makeTable();
+    recordBatch->add<int64_t>(0, length);
+    recordBatch->add(1, makeStructVector(nodes));
+    recordBatch->add(2, makeStructVector(buffers));
+    blocks.push_back(writeMessage(makeMessage(messageHeaderRecordBatch, std::move(recordBatch), bodyLength), body, bodyLength));
+    checkStream();
+
+    for (auto& data : columnData)
+    {
+        data.values.clear();
+        if (!data.offsets.empty())
+            data.offsets.resize(1);
+    }
+    batchRowCount = 0;
+}
+
+void ArrowWriter::close()
+{
+    if (!stream.is_open())
+        return;
+
+    flush();
+
+    // End of stream marker, followed by the file footer
+    const uint32_t endOfStream[] = {continuationMarker, 0};
+    write(endOfStream, sizeof(endOfStream));
+
+    std::vector<FooterBlock> footerBlocks;
+    for (const auto& block : blocks)
+        footerBlocks.push_back({block.offset, block.metadataLength, 0, block.bodyLength});
+
+    auto footer = makeTable();
+    footer->add<int16_t>(0, metadataVersionV5);
+    footer->add(1, makeSchema(columns));
+    footer->add(2, makeStructVector(std::vector<FooterBlock>{}));
+    footer->add(3, makeStructVector(footerBlocks));
+    const auto footerData = FlatSerializer().finish(*footer);
+    const auto footerSize = static_cast<int32_t>(footerData.size());
+
+    write(footerData.data(), footerData.size());
+    write(&footerSize, sizeof(footerSize));
+    write(magic, 6);
+    stream.close();
+    checkStream();
+}
+
+const std::vector<ArrowWriter::Column>& ArrowWriter::getColumns() const
+{
+    return columns;
+}
+
+uint64_t ArrowWriter::getRowCount() const
+{
+    return rowCount;
+}
+
+size_t ArrowWriter::getBatchCount() const
+{
+    return blocks.size();
+}
+
+ArrowWriter::Block ArrowWriter::writeMessage(const std::vector<uint8_t>& metadata,
+                                             const std::vector<BodyBuffer>& body,
+                                             const int64_t bodyLength)
+{
+    // The continuation marker and the length prefix plus the metadata end 8-byte aligned
+    static const uint8_t padding[8]{};
+    const auto paddedSize = static_cast<int32_t>(alignUp(metadata.size(), 8));
+
+    Block block;
+    block.offset = fileOffset;
+    block.metadataLength = paddedSize + 8;
+    block.bodyLength = bodyLength;
+
+    write(&continuationMarker, sizeof(continuationMarker));
+    write(&paddedSize, sizeof(paddedSize));
+    write(metadata.data(), metadata.size());
+    write(padding, static_cast<size_t>(paddedSize) - metadata.size());
+    for (const auto& buffer : body)
+    {
+        if (buffer.size != 0)
+            write(buffer.data, buffer.size);
+        write(padding, alignUp(buffer.size, 8) - buffer.size);
+    }
+    return block;
+}
+
+void ArrowWriter::write(const void* data, const size_t size)
+{
+    stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    fileOffset += static_cast<int64_t>(size);
+}
+
+void ArrowWriter::checkStream() const
+{
+    if (stream.fail())
+        throw std::runtime_error("Cannot write Arrow file " + path);
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,886 @@
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#ifdef __linux__
+    #include <sys/syscall.h>
+    #if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+        #define ASAM_CMP_HAS_IO_URING
+        #include <linux/io_uring.h>
+        #include <sys/mman.h>
+        #include <sys/uio.h>
+    #endif
+#endif
+
+#include <asam_cmp/async_file.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr std::size_t ioAlignment = 4096;
+    // The thread pool backend does not need more threads than the disk can serve in parallel
+    constexpr std::size_t maxPoolThreads = 4;
+
+    struct IoBuffer
+    {
+        uint8_t* data{nullptr};
+        std::size_t size{0};
+    };
+
+    std::string errorMessage(const int error)
+    {
+        return std::error_code(error, std::generic_category()).message();
+    }
+
+    uint8_t* allocateAligned(std::vector<uint8_t>& storage, const std::size_t size)
+    {
+        storage.resize(size + ioAlignment);
+        const auto address = reinterpret_cast<std::uintptr_t>(storage.data());
+        return storage.data() + (ioAlignment - address % ioAlignment) % ioAlignment;
+    }
+
+#ifdef _WIN32
+    int openInput(const std::string& path, uint64_t& size)
+    {
+        const int fd = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+        if (fd >= 0)
+            size = static_cast<uint64_t>(_filelengthi64(fd));
+        return fd;
+    }
+
+    int openOutput(const std::string& path, bool& direct)
+    {
+        direct = false;
+        return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+
+    void disableDirectIo(const int)
+    {
+    }
+
+    void closeFile(const int fd)
+    {
+        _close(fd);
+    }
+
+    // Without pread and pwrite the file position is shared, so transfers of the pool threads are serialized
+    std::mutex positionMutex;
+
+    int64_t transfer(const int fd, uint8_t* data, const std::size_t size, const uint64_t offset, const bool write)
+    {
+        std::lock_guard<std::mutex> lock(positionMutex);
+        if (_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0)
+            return -errno;
+
+        std::size_t done = 0;
+        while (done < size)
+        {
+            const auto chunk = static_cast<unsigned>(std::min<std::size_t>(size - done, 1u << 30));
+            const int result = write ? _write(fd, data + done, chunk) : _read(fd, data + done, chunk);
+            if (result < 0)
+                return -errno;
+            if (result == 0)
+                break;
+            done += static_cast<std::size_t>(result);
+        }
+        return static_cast<int64_t>(done);
+    }
+#else
+    int openInput(const std::string& path, uint64_t& size)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat status;
+        if (fd >= 0 && fstat(fd, &status) == 0)
+            size = static_cast<uint64_t>(status.st_size);
+        return fd;
+    }
+
+    int openOutput(const std::string& path, bool& direct)
+    {
+        constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    #ifdef O_DIRECT
+        if (direct)
+        {
+            const int fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            if (fd >= 0 || errno != EINVAL)
+                return fd;
+        }
+    #endif
+        direct = false;
+        return ::open(path.c_str(), flags, 0644);
+    }
+
+    void disableDirectIo(const int fd)
+    {
+    #ifdef O_DIRECT
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+    #else
+        (void) fd;
+    #endif
+    }
+
+    void closeFile(const int fd)
+    {
+        ::close(fd);
+    }
+
+    int64_t transfer(const int fd, uint8_t* data, const std::size_t size, const uint64_t offset, const bool write)
+    {
+        std::size_t done = 0;
+        while (done < size)
+        {
+            const auto position = static_cast<off_t>(offset + done);
+            const ssize_t result = write ? pwrite(fd, data + done, size - done, position) : pread(fd, data + done, size - done, position);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                return -errno;
+            if (result == 0)
+                break;
+            done += static_cast<std::size_t>(result);
+        }
+        return static_cast<int64_t>(done);
+    }
+#endif
+}
+
+// Backend interface of AsyncFileSource and AsyncFileSink. Requests are identified by the index of their buffer.
+class AsyncIo
+{
+public:
+    struct Completion
+    {
+        std::size_t buffer{0};
+        // Transferred bytes or -errno
+        int64_t result{0};
+    };
+
+public:
+    virtual ~AsyncIo() = default;
+
+    virtual AsyncIoBackend getBackend() const = 0;
+    // Requests may be queued until the next call of wait
+    virtual void read(const std::size_t buffer, uint8_t* data, const std::size_t size, const uint64_t offset) = 0;
+    virtual void write(const std::size_t buffer, const uint8_t* data, const std::size_t size, const uint64_t offset) = 0;
+    // Submits the queued requests, waits for at least minCompletions and appends all completions that are available
+    virtual void wait(const std::size_t minCompletions, std::vector<Completion>& completions) = 0;
+};
+
+namespace
+{
+    class ThreadPoolIo final : public AsyncIo
+    {
+    public:
+        ThreadPoolIo(const int newFd, const std::size_t threadCount)
+            : fd(newFd)
+        {
+            for (std::size_t index = 0; index < threadCount; ++index)
+                threads.emplace_back(&ThreadPoolIo::workerThread, this);
+        }
+
+        ~ThreadPoolIo() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            requestReady.notify_all();
+            for (auto& thread : threads)
+                thread.join();
+        }
+
+        AsyncIoBackend getBackend() const override
+        {
+            return AsyncIoBackend::threadPool;
+        }
+
+        void read(const std::size_t buffer, uint8_t* data, const std::size_t size, const uint64_t offset) override
+        {
+            push({buffer, data, size, offset, false});
+        }
+
+        void write(const std::size_t buffer, const uint8_t* data, const std::size_t size, const uint64_t offset) override
+        {
+            push({buffer, const_cast<uint8_t*>(data), size, offset, true});
+        }
+
+        void wait(const std::size_t minCompletions, std::vector<Completion>& completions) override
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            requestDone.wait(lock, [this, minCompletions] { return finished.size() >= minCompletions; });
+            completions.insert(completions.end(), finished.begin(), finished.end());
+            finished.clear();
+        }
+
+    private:
+        struct Request
+        {
+            std::size_t buffer{0};
+            uint8_t* data{nullptr};
+            std::size_t size{0};
+            uint64_t offset{0};
+            bool write{false};
+        };
+
+        void push(const Request& request)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                requests.push_back(request);
+            }
+            requestReady.notify_one();
+        }
+
+        void workerThread()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                requestReady.wait(lock, [this] { return stopping || !requests.empty(); });
+                if (stopping)
+                    return;
+
+                const Request request = requests.front();
+                requests.pop_front();
+                lock.unlock();
+                const int64_t result = transfer(fd, request.data, request.size, request.offset, request.write);
+                lock.lock();
+
+                finished.push_back({request.buffer, result});
+                requestDone.notify_one();
+            }
+        }
+
+    private:
+        int fd;
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable requestReady;
+        std::condition_variable requestDone;
+        std::deque<Request> requests;
+        std::vector<Completion> finished;
+        bool stopping{false};
+    };
+
+#ifdef ASAM_CMP_HAS_IO_URING
+    // io_uring through the raw system calls. The buffers and the file are registered with the ring where the kernel
+    // allows it, so requests do not map the pages and look up the file every time.
+    class IoUringIo final : public AsyncIo
+    {
+    public:
+        // Throws std::runtime_error if the kernel does not support io_uring
+        IoUringIo(const int newFd, const std::vector<IoBuffer>& buffers)
+            : fd(newFd)
+        {
+            io_uring_params params{};
+            const auto entries = static_cast<unsigned>(std::max<std::size_t>(buffers.size(), 1));
+            ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (ringFd < 0)
+                throw std::runtime_error("Cannot set up io_uring: " + errorMessage(errno));
+
+            try
+            {
+                mapRings(params);
+            }
+            catch (...)
+            {
+                release();
+                throw;
+            }
+
+            std::vector<iovec> iovecs;
+            for (const auto& buffer : buffers)
+                iovecs.push_back({buffer.data, buffer.size});
+            fixedBuffers = syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0;
+            fixedFile = syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_FILES, &fd, 1) == 0;
+        }
+
+        ~IoUringIo() override
+        {
+            release();
+        }
+
+        AsyncIoBackend getBackend() const override
+        {
+            return AsyncIoBackend::ioUring;
+        }
+
+        void read(const std::size_t buffer, uint8_t* data, const std::size_t size, const uint64_t offset) override
+        {
+            prepare(fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_READ, buffer, data, size, offset);
+        }
+
+        void write(const std::size_t buffer, const uint8_t* data, const std::size_t size, const uint64_t offset) override
+        {
+            prepare(fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, buffer, data, size, offset);
+        }
+
+        void wait(const std::size_t minCompletions, std::vector<Completion>& completions) override
+        {
+            // All queued requests are submitted with one system call, which also waits for the completions
+            std::size_t reaped = reap(completions);
+            while (queued > 0 || reaped < minCompletions)
+            {
+                const auto waitCount = static_cast<unsigned>(reaped < minCompletions ? minCompletions - reaped : 0);
+                const long submitted =
+                    syscall(__NR_io_uring_enter, ringFd, queued, waitCount, waitCount ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+                if (submitted < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    throw std::runtime_error("Cannot submit io_uring requests: " + errorMessage(errno));
+                }
+                queued -= std::min<unsigned>(queued, static_cast<unsigned>(submitted));
+                reaped += reap(completions);
+            }
+        }
+
+    private:
+        void mapRings(const io_uring_params& params)
+        {
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap)
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+            sqRing = mapRing(sqRingSize, IORING_OFF_SQ_RING);
+            cqRing = singleMap ? sqRing : mapRing(cqRingSize, IORING_OFF_CQ_RING);
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mapRing(sqesSize, IORING_OFF_SQES));
+
+            auto* sq = static_cast<uint8_t*>(sqRing);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+            auto* cq = static_cast<uint8_t*>(cqRing);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        }
+
+        void* mapRing(const std::size_t size, const off_t offset)
+        {
+            void* ring = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, offset);
+            if (ring == MAP_FAILED)
+                throw std::runtime_error("Cannot map io_uring: " + errorMessage(errno));
+            return ring;
+        }
+
+        void release()
+        {
+            if (sqes != nullptr)
+                munmap(sqes, sqesSize);
+            if (cqRing != nullptr && cqRing != sqRing)
+                munmap(cqRing, cqRingSize);
+            if (sqRing != nullptr)
+                munmap(sqRing, sqRingSize);
+            if (ringFd >= 0)
+                ::close(ringFd);
+        }
+
+        void prepare(const uint8_t opcode, const std::size_t buffer, const uint8_t* data, const std::size_t size, const uint64_t offset)
+        {
+            // Only this thread writes the tail, there are never more requests than buffers and submission queue entries
+            const unsigned tail = *sqTail;
+            const unsigned index = tail & sqMask;
+            io_uring_sqe& sqe = sqes[index];
+            memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = opcode;
+            sqe.fd = fixedFile ? 0 : fd;
+            sqe.flags = fixedFile ? IOSQE_FIXED_FILE : 0;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = static_cast<uint32_t>(size);
+            sqe.off = offset;
+            if (fixedBuffers)
+                sqe.buf_index = static_cast<uint16_t>(buffer);
+            sqe.user_data = buffer;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            ++queued;
+        }
+
+        std::size_t reap(std::vector<Completion>& completions)
+        {
+            unsigned head = *cqHead;
+            const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            const std::size_t count = tail - head;
+            for (; head != tail; ++head)
+            {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                completions.push_back({static_cast<std::size_t>(cqe.user_data), cqe.res});
+            }
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+            return count;
+        }
+
+    private:
+        int fd;
+        int ringFd{-1};
+        bool fixedBuffers{false};
+        bool fixedFile{false};
+        unsigned queued{0};
+
+        void* sqRing{nullptr};
+        std::size_t sqRingSize{0};
+        void* cqRing{nullptr};
+        std::size_t cqRingSize{0};
+        io_uring_sqe* sqes{nullptr};
+        std::size_t sqesSize{0};
+
+        unsigned* sqTail{nullptr};
+        unsigned sqMask{0};
+        unsigned* sqArray{nullptr};
+        unsigned* cqHead{nullptr};
+        unsigned* cqTail{nullptr};
+        unsigned cqMask{0};
+        io_uring_cqe* cqes{nullptr};
+    };
+#endif
+
+    std::unique_ptr<AsyncIo> createIo(const AsyncIoBackend backend, const int fd, const std::vector<IoBuffer>& buffers)
+    {
+#ifdef ASAM_CMP_HAS_IO_URING
+        if (backend != AsyncIoBackend::threadPool)
+        {
+            try
+            {
+                return std::make_unique<IoUringIo>(fd, buffers);
+            }
+            catch (const std::exception&)
+            {
+                if (backend == AsyncIoBackend::ioUring)
+                    throw;
+            }
+        }
+#else
+        if (backend == AsyncIoBackend::ioUring)
+            throw std::runtime_error("io_uring is not supported on this platform");
+#endif
+        return std::make_unique<ThreadPoolIo>(fd, std::min(buffers.size(), maxPoolThreads));
+    }
+}
+
+bool isIoUringSupported()
+{
+#ifdef ASAM_CMP_HAS_IO_URING
+    static const bool supported = []
+    {
+        io_uring_params params{};
+        const int ringFd = static_cast<int>(syscall(__NR_io_uring_setup, 1u, &params));
+        if (ringFd < 0)
+            return false;
+        ::close(ringFd);
+        return true;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+AsyncFileSource::AsyncFileSource(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.blockSize = std::max<std::size_t>(options.blockSize, 1);
+    options.queueDepth = std::max<std::size_t>(options.queueDepth, 1);
+
+    fd = openInput(options.path, fileSize);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + options.path + ": " + errorMessage(errno));
+
+    // One buffer more than reads in flight for the block that is processed
+    buffers.resize(options.queueDepth + 1);
+    std::vector<IoBuffer> ioBuffers;
+    for (std::size_t index = 0; index < buffers.size(); ++index)
+    {
+        auto& buffer = buffers[index];
+        buffer.data = allocateAligned(buffer.storage, options.headroom + options.blockSize);
+        ioBuffers.push_back({buffer.data, options.headroom + options.blockSize});
+        freeBuffers.push_back(index);
+    }
+
+    try
+    {
+        io = createIo(options.backend, fd, ioBuffers);
+    }
+    catch (...)
+    {
+        closeFile(fd);
+        throw;
+    }
+    submitReads();
+}
+
+AsyncFileSource::~AsyncFileSource()
+{
+    // The kernel may still write into the buffers, so all reads have to complete before they are freed
+    for (const auto index : pendingBuffers)
+    {
+        try
+        {
+            waitForCompletion(buffers[index]);
+        }
+        catch (...)
+        {
+        }
+    }
+    io.reset();
+    closeFile(fd);
+}
+
+bool AsyncFileSource::next(Block& block, const uint8_t* prefix, const std::size_t prefixSize)
+{
+    if (pendingBuffers.empty())
+    {
+        if (currentBuffer != SIZE_MAX)
+            freeBuffers.push_back(currentBuffer);
+        currentBuffer = SIZE_MAX;
+        return false;
+    }
+
+    const std::size_t index = pendingBuffers.front();
+    auto& buffer = buffers[index];
+    waitForCompletion(buffer);
+    pendingBuffers.pop_front();
+
+    // The prefix may point into the current buffer or the staging area, it is copied before they are reused
+    uint8_t* data = buffer.data + options.headroom;
+    if (prefixSize <= options.headroom)
+    {
+        data -= prefixSize;
+        if (prefixSize != 0)
+            memcpy(data, prefix, prefixSize);
+    }
+    else
+    {
+        std::vector<uint8_t> combined(prefixSize + buffer.done);
+        memcpy(combined.data(), prefix, prefixSize);
+        memcpy(combined.data() + prefixSize, data, buffer.done);
+        staging.swap(combined);
+        data = staging.data();
+    }
+
+    block.data = data;
+    block.size = prefixSize + buffer.done;
+    block.offset = buffer.offset - prefixSize;
+
+    if (currentBuffer != SIZE_MAX)
+        freeBuffers.push_back(currentBuffer);
+    currentBuffer = index;
+    submitReads();
+    return true;
+}
+
+void AsyncFileSource::rewind()
+{
+    while (!pendingBuffers.empty())
+    {
+        const std::size_t index = pendingBuffers.front();
+        pendingBuffers.pop_front();
+        freeBuffers.push_back(index);
+        waitForCompletion(buffers[index]);
+    }
+    if (currentBuffer != SIZE_MAX)
+        freeBuffers.push_back(currentBuffer);
+    currentBuffer = SIZE_MAX;
+    staging.clear();
+
+    readOffset = 0;
+    submitReads();
+}
+
+uint64_t AsyncFileSource::getFileSize() const
+{
+    return fileSize;
+}
+
+AsyncIoBackend AsyncFileSource::getBackend() const
+{
+    return io->getBackend();
+}
+
+void AsyncFileSource::submitReads()
+{
+    while (!freeBuffers.empty() && readOffset < fileSize)
+    {
+        const std::size_t index = freeBuffers.back();
+        freeBuffers.pop_back();
+
+        auto& buffer = buffers[index];
+        buffer.offset = readOffset;
+        buffer.size = static_cast<std::size_t>(std::min<uint64_t>(options.blockSize, fileSize - readOffset));
+        buffer.done = 0;
+        buffer.complete = false;
+        io->read(index, buffer.data + options.headroom, buffer.size, buffer.offset);
+        pendingBuffers.push_back(index);
+        readOffset += buffer.size;
+    }
+
+    // Submits the reads without waiting
+    std::vector<AsyncIo::Completion> completions;
+    io->wait(0, completions);
+    for (const auto& completion : completions)
+        complete(completion.buffer, completion.result);
+}
+
+void AsyncFileSource::waitForCompletion(Buffer& buffer)
+{
+    std::vector<AsyncIo::Completion> completions;
+    while (!buffer.complete)
+    {
+        completions.clear();
+        io->wait(1, completions);
+        for (const auto& completion : completions)
+            complete(completion.buffer, completion.result);
+    }
+
+    if (!buffer.error.empty())
+        throw std::runtime_error(buffer.error);
+}
+
+void AsyncFileSource::complete(const std::size_t index, const int64_t result)
+{
+    auto& buffer = buffers[index];
+    if (result < 0)
+    {
+        buffer.error = "Cannot read " + options.path + ": " + errorMessage(static_cast<int>(-result));
+        buffer.complete = true;
+        return;
+    }
+
+    // A short read is continued, a read at the end of the file means that the file was truncated meanwhile
+    buffer.done += static_cast<std::size_t>(result);
+    if (result != 0 && buffer.done < buffer.size)
+        io->read(index, buffer.data + options.headroom + buffer.done, buffer.size - buffer.done, buffer.offset + buffer.done);
+    else
+        buffer.complete = true;
+}
+
+AsyncFileSink::AsyncFileSink(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.blockSize = std::max((options.blockSize + ioAlignment - 1) / ioAlignment * ioAlignment, ioAlignment);
+    options.queueDepth = std::max<std::size_t>(options.queueDepth, 1);
+
+    direct = options.directIo;
+    fd = openOutput(options.path, direct);
+    if (fd < 0)
+        throw std::runtime_error("Cannot create " + options.path + ": " + errorMessage(errno));
+
+    // One buffer more than writes in flight for the block that is filled
+    buffers.resize(options.queueDepth + 1);
+    std::vector<IoBuffer> ioBuffers;
+    for (std::size_t index = 0; index < buffers.size(); ++index)
+    {
+        auto& buffer = buffers[index];
+        buffer.data = allocateAligned(buffer.storage, options.blockSize);
+        ioBuffers.push_back({buffer.data, options.blockSize});
+        freeBuffers.push_back(index);
+    }
+
+    try
+    {
+        io = createIo(options.backend, fd, ioBuffers);
+    }
+    catch (...)
+    {
+        closeFile(fd);
+        throw;
+    }
+
+}
+
+AsyncFileSink::~AsyncFileSink()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void AsyncFileSink::write(const void* data, const std::size_t size)
+{
+    if (fd < 0)
+        throw std::runtime_error("File is closed: " + options.path);
+
+    auto bytes = static_cast<const uint8_t*>(data);
+    std::size_t remaining = size;
+    while (remaining != 0)
+    {
+        // The next block is taken when there is data for it, waits only if all blocks are in flight
+        if (currentBuffer == SIZE_MAX)
+        {
+            if (freeBuffers.empty())
+                ++stats.bufferWaits;
+            while (freeBuffers.empty())
+                reap(1);
+            currentBuffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            buffers[currentBuffer].used = 0;
+        }
+
+        auto& buffer = buffers[currentBuffer];
+        const std::size_t chunk = std::min(remaining, options.blockSize - buffer.used);
+        memcpy(buffer.data + buffer.used, bytes, chunk);
+        buffer.used += chunk;
+        bytes += chunk;
+        remaining -= chunk;
+        if (buffer.used < options.blockSize)
+            continue;
+
+        submitCurrent(options.blockSize);
+        fileOffset += options.blockSize;
+        currentBuffer = SIZE_MAX;
+
+        // Submits the block and collects finished writes without waiting
+        reap(0);
+    }
+    stats.bytes += size;
+}
+
+void AsyncFileSink::flush()
+{
+    if (fd < 0)
+        return;
+
+    // The current block stays current and is written again when it is full
+    const std::size_t used = currentBuffer != SIZE_MAX ? buffers[currentBuffer].used : 0;
+    const std::size_t size = direct ? used - used % ioAlignment : used;
+    if (size != 0)
+        submitCurrent(size);
+    while (writesInFlight != 0)
+        reap(1);
+}
+
+void AsyncFileSink::close()
+{
+    if (fd < 0)
+        return;
+
+    try
+    {
+        while (writesInFlight != 0)
+            reap(1);
+
+        // The unaligned end of the file is written without direct I/O
+        const std::size_t used = currentBuffer != SIZE_MAX ? buffers[currentBuffer].used : 0;
+        if (used != 0)
+        {
+            if (direct && used % ioAlignment != 0)
+                disableDirectIo(fd);
+            submitCurrent(used);
+            while (writesInFlight != 0)
+                reap(1);
+        }
+    }
+    catch (...)
+    {
+        while (writesInFlight != 0)
+        {
+            try
+            {
+                reap(1);
+            }
+            catch (...)
+            {
+            }
+        }
+        io.reset();
+        closeFile(fd);
+        fd = -1;
+        throw;
+    }
+
+    io.reset();
+    closeFile(fd);
+    fd = -1;
+}
+
+bool AsyncFileSink::isOpen() const
+{
+    return fd >= 0;
+}
+
+const AsyncFileSink::Stats& AsyncFileSink::getStats() const
+{
+    return stats;
+}
+
+AsyncIoBackend AsyncFileSink::getBackend() const
+{
+    return io ? io->getBackend() : options.backend;
+}
+
+void AsyncFileSink::submitCurrent(const std::size_t size)
+{
+    auto& buffer = buffers[currentBuffer];
+    buffer.offset = fileOffset;
+    buffer.size = size;
+    buffer.done = 0;
+    submitWrite(currentBuffer);
+    ++stats.writes;
+}
+
+void AsyncFileSink::submitWrite(const std::size_t index)
+{
+    auto& buffer = buffers[index];
+    io->write(index, buffer.data + buffer.done, buffer.size - buffer.done, buffer.offset + buffer.done);
+    ++writesInFlight;
+}
+
+void AsyncFileSink::reap(const std::size_t minCompletions)
+{
+    std::vector<AsyncIo::Completion> completions;
+    io->wait(minCompletions, completions);
+
+    std::string error;
+    for (const auto& completion : completions)
+    {
+        auto& buffer = buffers[completion.buffer];
+        --writesInFlight;
+        if (completion.result <= 0)
+        {
+            const int code = completion.result < 0 ? static_cast<int>(-completion.result) : EIO;
+            error = "Cannot write " + options.path + ": " + errorMessage(code);
+            buffer.done = buffer.size;
+        }
+        else
+        {
+            buffer.done += static_cast<std::size_t>(completion.result);
+        }
+
+        // A short write is continued, the block that is filled stays in use after flush
+        if (buffer.done < buffer.size)
+            submitWrite(completion.buffer);
+        else if (completion.buffer != currentBuffer)
+            freeBuffers.push_back(completion.buffer);
+    }
+
+    if (!error.empty())
+        throw std::runtime_error(error);
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,491 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <asam_cmp/capture_file_reader.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    uint16_t readBigEndian16(const uint8_t* data)
+    {
+        return static_cast<uint16_t>((data[0] << 8) | data[1]);
+    }
+
+    uint32_t readNative32(const uint8_t* data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint64_t toNanoseconds(const uint64_t ticks, const uint8_t resolution)
+    {
+        const uint8_t exponent = resolution & 0x7F;
+        if ((resolution & 0x80) != 0)
+        {
+            // Negative power of 2
+            if (exponent >= 64)
+                return 0;
+            const uint64_t seconds = ticks >> exponent;
+            const uint64_t fraction = ticks & ((uint64_t{1} << exponent) - 1);
+            return seconds * 1000000000u + static_cast<uint64_t>(std::ldexp(static_cast<double>(fraction), -exponent) * 1e9);
+        }
+
+        // Negative power of 10
+        uint64_t scale = 1;
+        if (exponent <= 9)
+        {
+            for (uint8_t i = exponent; i < 9; ++i)
+                scale *= 10;
+            return ticks * scale;
+        }
+        if (exponent > 28)
+            return 0;
+        for (uint8_t i = 9; i < exponent; ++i)
+            scale *= 10;
+        return ticks / scale;
+    }
+
+    constexpr uint32_t pcapMagicMicroseconds = 0xA1B2C3D4;
+    constexpr uint32_t pcapMagicNanoseconds = 0xA1B23C4D;
+    constexpr std::size_t pcapHeaderSize = 24;
+    constexpr std::size_t pcapRecordHeaderSize = 16;
+
+    constexpr uint32_t pcapngSectionHeaderBlock = 0x0A0D0D0A;
+    constexpr uint32_t pcapngInterfaceDescriptionBlock = 0x00000001;
+    constexpr uint32_t pcapngSimplePacketBlock = 0x00000003;
+    constexpr uint32_t pcapngEnhancedPacketBlock = 0x00000006;
+    constexpr uint32_t pcapngByteOrderMagic = 0x1A2B3C4D;
+    constexpr uint16_t pcapngOptionEnd = 0;
+    constexpr uint16_t pcapngOptionTimestampResolution = 9;
+    // Block type, block total length at the start and block total length at the end
+    constexpr std::size_t pcapngBlockOverhead = 12;
+
+    constexpr uint16_t etherTypeIpv4 = 0x0800;
+    constexpr uint16_t etherTypeIpv6 = 0x86DD;
+    constexpr uint16_t etherTypeVlan = 0x8100;
+    constexpr uint16_t etherTypeQinQ = 0x88A8;
+    constexpr uint8_t ipProtocolUdp = 17;
+    constexpr std::size_t ethernetHeaderSize = 14;
+    constexpr std::size_t vlanTagSize = 4;
+    constexpr std::size_t ipv4MinHeaderSize = 20;
+    constexpr std::size_t ipv6HeaderSize = 40;
+    constexpr std::size_t udpHeaderSize = 8;
+
+    // Processed parts of the mapping are released in steps of this size to bound the resident memory
+    constexpr std::size_t releaseWindow = 64 * 1024 * 1024;
+}
+
+CaptureFileReader::CaptureFileReader(const std::string& path)
+    : file(path)
+{
+    file.adviseSequential();
+    if (!readHeader())
+        throw std::runtime_error("Unsupported capture file format: " + path);
+}
+
+CaptureFileReader::CaptureFileReader(const AsyncFileSource::Options& sourceOptions)
+    : source(std::make_unique<AsyncFileSource>(sourceOptions))
+{
+    if (!readHeader())
+        throw std::runtime_error("Unsupported capture file format: " + sourceOptions.path);
+}
+
+CaptureFileReader::Format CaptureFileReader::getFormat() const
+{
+    return format;
+}
+
+void CaptureFileReader::setUdpPort(const uint16_t port)
+{
+    udpPort = port;
+}
+
+uint16_t CaptureFileReader::getUdpPort() const
+{
+    return udpPort;
+}
+
+bool CaptureFileReader::next(Frame& frame)
+{
+    const uint8_t* data;
+    std::size_t size;
+    uint64_t timestamp;
+    uint32_t interfaceIndex;
+    while (nextRecord(data, size, timestamp, interfaceIndex))
+    {
+        ++stats.records;
+        const uint32_t linkType =
+            format == Format::pcap ? pcapLinkType : (interfaceIndex < interfaces.size() ? interfaces[interfaceIndex].linkType : 0);
+        if (!extractPayload(data, size, linkType, udpPort, frame.data, frame.size))
+        {
+            ++stats.skippedRecords;
+            continue;
+        }
+
+        ++stats.frames;
+        frame.timestamp = timestamp;
+        frame.interfaceIndex = interfaceIndex;
+        return true;
+    }
+    return false;
+}
+
+void CaptureFileReader::rewind()
+{
+    if (source)
+        source->rewind();
+    windowData = nullptr;
+    windowOffset = 0;
+    windowSize = 0;
+    readHeader();
+    stats = {};
+}
+
+bool CaptureFileReader::isTruncated() const
+{
+    return truncated;
+}
+
+const CaptureFileReader::Stats& CaptureFileReader::getStats() const
+{
+    return stats;
+}
+
+bool CaptureFileReader::extractPayload(const uint8_t* data,
+                                       const std::size_t size,
+                                       const uint32_t linkType,
+                                       const uint16_t udpPort,
+                                       const uint8_t*& payload,
+                                       std::size_t& payloadSize)
+{
+    uint16_t etherType = 0;
+    std::size_t offset = 0;
+    switch (linkType)
+    {
+        case linkTypeEthernet:
+            if (size < ethernetHeaderSize)
+                return false;
+            etherType = readBigEndian16(data + 12);
+            offset = ethernetHeaderSize;
+            while ((etherType == etherTypeVlan || etherType == etherTypeQinQ) && offset + vlanTagSize <= size)
+            {
+                etherType = readBigEndian16(data + offset + 2);
+                offset += vlanTagSize;
+            }
+            break;
+        case linkTypeRaw:
+            if (size == 0)
+                return false;
+            etherType = (data[0] >> 4) == 4 ? etherTypeIpv4 : etherTypeIpv6;
+            break;
+        case linkTypeIpv4:
+            etherType = etherTypeIpv4;
+            break;
+        case linkTypeIpv6:
+            etherType = etherTypeIpv6;
+            break;
+        default:
+            return false;
+    }
+
+    if (etherType == cmpEtherType)
+    {
+        payload = data + offset;
+        payloadSize = size - offset;
+        return true;
+    }
+
+    // The IP length excludes the Ethernet padding of short frames
+    std::size_t end = size;
+    if (etherType == etherTypeIpv4)
+    {
+        if (size - offset < ipv4MinHeaderSize || (data[offset] >> 4) != 4)
+            return false;
+        const std::size_t headerSize = (data[offset] & 0x0F) * 4u;
+        // Fragments are not reassembled
+        const bool fragment = (readBigEndian16(data + offset + 6) & 0x3FFF) != 0;
+        if (headerSize < ipv4MinHeaderSize || size - offset < headerSize || data[offset + 9] != ipProtocolUdp || fragment)
+            return false;
+        end = std::min(end, offset + readBigEndian16(data + offset + 2));
+        offset += headerSize;
+    }
+    else if (etherType == etherTypeIpv6)
+    {
+        // Extension headers are not supported
+        if (size - offset < ipv6HeaderSize || (data[offset] >> 4) != 6 || data[offset + 6] != ipProtocolUdp)
+            return false;
+        end = std::min(end, offset + ipv6HeaderSize + readBigEndian16(data + offset + 4));
+        offset += ipv6HeaderSize;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (end < offset + udpHeaderSize)
+        return false;
+    if (udpPort != 0 && readBigEndian16(data + offset + 2) != udpPort)
+        return false;
+    end = std::min(end, offset + readBigEndian16(data + offset + 4));
+    offset += udpHeaderSize;
+    if (end < offset)
+        return false;
+
+    payload = data + offset;
+    payloadSize = end - offset;
+    return true;
+}
+
+bool CaptureFileReader::readHeader()
+{
+    offset = 0;
+    releasedOffset = 0;
+    truncated = false;
+    interfaces.clear();
+
+    const std::size_t size = getFileSize();
+    if (size < sizeof(uint32_t))
+        return false;
+    const uint8_t* data = load(0, std::min(size, pcapHeaderSize));
+    if (data == nullptr)
+        return false;
+
+    const uint32_t magic = readNative32(data);
+    if (magic == pcapngSectionHeaderBlock)
+    {
+        format = Format::pcapng;
+        return readSectionHeader(0);
+    }
+
+    if (size < pcapHeaderSize)
+        return false;
+
+    format = Format::pcap;
+    if (magic == pcapMagicMicroseconds || magic == pcapMagicNanoseconds)
+        swapped = false;
+    else if (magic == swapEndian(pcapMagicMicroseconds) || magic == swapEndian(pcapMagicNanoseconds))
+        swapped = true;
+    else
+        return false;
+
+    const bool nanoseconds = magic == pcapMagicNanoseconds || magic == swapEndian(pcapMagicNanoseconds);
+    pcapNanosecondsPerFraction = nanoseconds ? 1 : 1000;
+    // The upper bits contain FCS information
+    pcapLinkType = read32(data + 20) & 0xFFFF;
+    offset = pcapHeaderSize;
+    return true;
+}
+
+bool CaptureFileReader::nextRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp, uint32_t& interfaceIndex)
+{
+    releaseConsumed();
+    interfaceIndex = 0;
+    if (format == Format::pcap)
+        return nextPcapRecord(data, size, timestamp);
+    return nextPcapngRecord(data, size, timestamp, interfaceIndex);
+}
+
+bool CaptureFileReader::nextPcapRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp)
+{
+    const std::size_t fileSize = getFileSize();
+    if (truncated || offset + pcapRecordHeaderSize > fileSize)
+    {
+        truncated = truncated || offset != fileSize;
+        return false;
+    }
+
+    const uint8_t* record = load(offset, pcapRecordHeaderSize);
+    const std::size_t capturedLength = record != nullptr ? read32(record + 8) : 0;
+    if (record == nullptr || capturedLength > fileSize - offset - pcapRecordHeaderSize)
+    {
+        truncated = true;
+        return false;
+    }
+    record = load(offset, pcapRecordHeaderSize + capturedLength);
+    if (record == nullptr)
+    {
+        truncated = true;
+        return false;
+    }
+
+    timestamp = read32(record) * uint64_t{1000000000} + read32(record + 4) * uint64_t{pcapNanosecondsPerFraction};
+    data = record + pcapRecordHeaderSize;
+    size = capturedLength;
+    offset += pcapRecordHeaderSize + capturedLength;
+    return true;
+}
+
+bool CaptureFileReader::nextPcapngRecord(const uint8_t*& data, std::size_t& size, uint64_t& timestamp, uint32_t& interfaceIndex)
+{
+    const std::size_t fileSize = getFileSize();
+    while (!truncated && offset + pcapngBlockOverhead <= fileSize)
+    {
+        const uint8_t* block = load(offset, pcapngBlockOverhead);
+        if (block == nullptr)
+        {
+            truncated = true;
+            return false;
+        }
+        const uint32_t blockType = readNative32(block);
+        if (blockType == pcapngSectionHeaderBlock)
+        {
+            // A new section may change the byte order
+            if (!readSectionHeader(offset))
+                break;
+            continue;
+        }
+
+        const std::size_t blockLength = read32(block + 4);
+        if (blockLength < pcapngBlockOverhead || blockLength % 4 != 0 || blockLength > fileSize - offset)
+            break;
+        block = load(offset, blockLength);
+        if (block == nullptr)
+        {
+            truncated = true;
+            return false;
+        }
+        offset += blockLength;
+
+        if (blockType == pcapngInterfaceDescriptionBlock)
+        {
+            readInterface(block, blockLength);
+        }
+        else if (blockType == pcapngEnhancedPacketBlock)
+        {
+            constexpr std::size_t headerSize = 28;
+            if (blockLength < headerSize + 4)
+                continue;
+            const std::size_t capturedLength = read32(block + 20);
+            if (capturedLength > blockLength - headerSize - 4)
+                continue;
+
+            interfaceIndex = read32(block + 8);
+            const uint64_t ticks = (static_cast<uint64_t>(read32(block + 12)) << 32) | read32(block + 16);
+            const uint8_t resolution = interfaceIndex < interfaces.size() ? interfaces[interfaceIndex].timestampResolution : 6;
+            timestamp = toNanoseconds(ticks, resolution);
+            data = block + headerSize;
+            size = capturedLength;
+            return true;
+        }
+        else if (blockType == pcapngSimplePacketBlock)
+        {
+            constexpr std::size_t headerSize = 12;
+            if (blockLength < headerSize + 4)
+                continue;
+            interfaceIndex = 0;
+            timestamp = 0;
+            data = block + headerSize;
+            size = std::min<std::size_t>(read32(block + 8), blockLength - headerSize - 4);
+            return true;
+        }
+    }
+
+    truncated = truncated || offset != fileSize;
+    return false;
+}
+
+bool CaptureFileReader::readSectionHeader(const std::size_t blockOffset)
+{
+    const std::size_t fileSize = getFileSize();
+    const uint8_t* block = blockOffset + pcapngBlockOverhead + 4 <= fileSize ? load(blockOffset, pcapngBlockOverhead + 4) : nullptr;
+    if (block == nullptr)
+    {
+        truncated = true;
+        return false;
+    }
+
+    const uint32_t byteOrderMagic = readNative32(block + 8);
+    if (byteOrderMagic == pcapngByteOrderMagic)
+        swapped = false;
+    else if (byteOrderMagic == swapEndian(pcapngByteOrderMagic))
+        swapped = true;
+    else
+        return false;
+
+    const std::size_t blockLength = read32(block + 4);
+    if (blockLength < pcapngBlockOverhead + 4 || blockLength % 4 != 0 || blockLength > fileSize - blockOffset ||
+        load(blockOffset, blockLength) == nullptr)
+    {
+        truncated = true;
+        return false;
+    }
+
+    interfaces.clear();
+    offset = blockOffset + blockLength;
+    return true;
+}
+
+void CaptureFileReader::readInterface(const uint8_t* block, const std::size_t blockLength)
+{
+    Interface& newInterface = interfaces.emplace_back();
+    constexpr std::size_t headerSize = 16;
+    if (blockLength < headerSize + 4)
+        return;
+    newInterface.linkType = read16(block + 8);
+
+    const uint8_t* option = block + headerSize;
+    const uint8_t* end = block + blockLength - 4;
+    while (option + 4 <= end)
+    {
+        const uint16_t code = read16(option);
+        const uint16_t length = read16(option + 2);
+        if (code == pcapngOptionEnd || option + 4 + length > end)
+            break;
+        if (code == pcapngOptionTimestampResolution && length >= 1)
+            newInterface.timestampResolution = option[4];
+        option += 4 + ((length + 3u) & ~3u);
+    }
+}
+
+uint16_t CaptureFileReader::read16(const uint8_t* data) const
+{
+    uint16_t value;
+    memcpy(&value, data, sizeof(value));
+    return swapped ? swapEndian(value) : value;
+}
+
+uint32_t CaptureFileReader::read32(const uint8_t* data) const
+{
+    const uint32_t value = readNative32(data);
+    return swapped ? swapEndian(value) : value;
+}
+
+const uint8_t* CaptureFileReader::load(const std::size_t position, const std::size_t length)
+{
+    // Callers check the range against the file size first
+    if (!source)
+        return file.getData() + position;
+
+    while (position + length > windowOffset + windowSize)
+    {
+        // Records are loaded completely before the walk continues, so position never lies behind the window
+        const std::size_t keep = windowOffset + windowSize - position;
+        AsyncFileSource::Block block;
+        if (!source->next(block, windowData + (windowSize - keep), keep))
+            return nullptr;
+        windowData = block.data;
+        windowOffset = static_cast<std::size_t>(block.offset);
+        windowSize = block.size;
+    }
+    return windowData + (position - windowOffset);
+}
+
+std::size_t CaptureFileReader::getFileSize() const
+{
+    return source ? static_cast<std::size_t>(source->getFileSize()) : file.getSize();
+}
+
+void CaptureFileReader::releaseConsumed()
+{
+    // Streamed blocks are reused by the source
+    if (source || offset - releasedOffset < releaseWindow)
+        return;
+    file.release(releasedOffset, offset - releasedOffset);
+    releasedOffset = offset;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,513 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <asam_cmp/capture_file_writer.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr std::size_t ioAlignment = 4096;
+
+    constexpr uint32_t sectionHeaderBlock = 0x0A0D0D0A;
+    constexpr uint32_t interfaceDescriptionBlock = 0x00000001;
+    constexpr uint32_t enhancedPacketBlock = 0x00000006;
+    constexpr uint32_t byteOrderMagic = 0x1A2B3C4D;
+    constexpr uint16_t optionEnd = 0;
+    constexpr uint16_t optionInterfaceName = 2;
+    constexpr uint16_t optionTimestampResolution = 9;
+    constexpr uint8_t nanosecondResolution = 9;
+    // Block type, block length, interface id, timestamp (2 x 32 bit), captured length, original length
+    constexpr std::size_t packetBlockHeaderSize = 28;
+    constexpr std::size_t ethernetHeaderSize = 14;
+
+    std::size_t padded(const std::size_t size)
+    {
+        return (size + 3) & ~std::size_t{3};
+    }
+
+    std::string rotatedPath(const std::string& path, const std::size_t index)
+    {
+        if (index == 0)
+            return path;
+
+        const auto slash = path.find_last_of("/\\");
+        const auto dot = path.find_last_of('.');
+        const auto position = (dot == std::string::npos || (slash != std::string::npos && dot < slash)) ? path.size() : dot;
+        return path.substr(0, position) + "_" + std::to_string(index) + path.substr(position);
+    }
+
+    std::string lastError()
+    {
+        return std::error_code(errno, std::generic_category()).message();
+    }
+
+#ifdef _WIN32
+    int openOutput(const std::string& path, bool& direct)
+    {
+        direct = false;
+        return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+
+    bool writeOutput(const int fd, const uint8_t* data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            const auto chunk = static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30));
+            const int written = _write(fd, data, chunk);
+            if (written <= 0)
+                return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    void disableDirectIo(const int)
+    {
+    }
+
+    void closeOutput(const int fd)
+    {
+        _close(fd);
+    }
+#else
+    int openOutput(const std::string& path, bool& direct)
+    {
+        constexpr int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    #ifdef O_DIRECT
+        if (direct)
+        {
+            const int fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            if (fd >= 0 || errno != EINVAL)
+                return fd;
+        }
+    #endif
+        direct = false;
+        return ::open(path.c_str(), flags, 0644);
+    }
+
+    bool writeOutput(const int fd, const uint8_t* data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    void disableDirectIo(const int fd)
+    {
+    #ifdef O_DIRECT
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+    #else
+        (void) fd;
+    #endif
+    }
+
+    void closeOutput(const int fd)
+    {
+        ::close(fd);
+    }
+#endif
+}
+
+CaptureFileWriter::CaptureFileWriter(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.bufferSize = std::max((options.bufferSize + ioAlignment - 1) / ioAlignment * ioAlignment, ioAlignment);
+    options.bufferCount = std::max<std::size_t>(options.bufferCount, 2);
+
+    // The sink has its own blocks
+    if (!options.asyncIo)
+    {
+        buffers.resize(options.bufferCount);
+        for (auto& buffer : buffers)
+        {
+            buffer.storage.resize(options.bufferSize + ioAlignment);
+            const auto address = reinterpret_cast<std::uintptr_t>(buffer.storage.data());
+            buffer.data = buffer.storage.data() + (ioAlignment - address % ioAlignment) % ioAlignment;
+            freeBuffers.push_back(&buffer);
+        }
+        current = acquireBuffer();
+    }
+
+    openFile();
+    writeFileHeader();
+
+    if (options.backgroundFlush && !options.asyncIo)
+        thread = std::thread(&CaptureFileWriter::flushThread, this);
+}
+
+CaptureFileWriter::~CaptureFileWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+uint32_t CaptureFileWriter::addInterface(const std::string& name, const uint32_t linkType)
+{
+    interfaces.push_back({name, linkType});
+    if (isFileOpen())
+        writeInterfaceBlock(interfaces.back());
+    return static_cast<uint32_t>(interfaces.size() - 1);
+}
+
+void CaptureFileWriter::writeFrame(const uint32_t interfaceIndex, const uint64_t timestamp, const uint8_t* data, const std::size_t size)
+{
+    writePacketBlock(interfaceIndex, timestamp, nullptr, 0, data, size);
+}
+
+void CaptureFileWriter::writeCmpFrame(const uint32_t interfaceIndex, const uint64_t timestamp, const uint8_t* data, const std::size_t size)
+{
+    if (interfaceIndex >= interfaces.size() || interfaces[interfaceIndex].linkType != CaptureFileReader::linkTypeEthernet)
+    {
+        writePacketBlock(interfaceIndex, timestamp, nullptr, 0, data, size);
+        return;
+    }
+
+    uint8_t header[ethernetHeaderSize];
+    memcpy(header, options.destinationMac.data(), 6);
+    memcpy(header + 6, options.sourceMac.data(), 6);
+    header[12] = static_cast<uint8_t>(CaptureFileReader::cmpEtherType >> 8);
+    header[13] = static_cast<uint8_t>(CaptureFileReader::cmpEtherType);
+    writePacketBlock(interfaceIndex, timestamp, header, sizeof(header), data, size);
+}
+
+void CaptureFileWriter::writeCmpFrames(const uint32_t interfaceIndex,
+                                       const uint64_t timestamp,
+                                       const std::vector<std::vector<uint8_t>>& frames)
+{
+    for (const auto& frame : frames)
+        writeCmpFrame(interfaceIndex, timestamp, frame.data(), frame.size());
+}
+
+void CaptureFileWriter::flush()
+{
+    if (!isFileOpen())
+        return;
+    if (sink)
+    {
+        sink->flush();
+        return;
+    }
+
+    submitBuffer(false);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        bufferDone.wait(lock, [this] { return buffersInFlight == 0; });
+    }
+    checkError();
+}
+
+void CaptureFileWriter::close()
+{
+    if (isFileOpen())
+    {
+        submitBuffer(true);
+        fd = -1;
+    }
+
+    if (thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        bufferReady.notify_all();
+        thread.join();
+    }
+    checkError();
+}
+
+const CaptureFileWriter::Stats& CaptureFileWriter::getStats() const
+{
+    return stats;
+}
+
+const std::string& CaptureFileWriter::getCurrentPath() const
+{
+    return currentPath;
+}
+
+void CaptureFileWriter::openFile()
+{
+    currentPath = rotatedPath(options.path, fileIndex);
+    if (options.asyncIo)
+    {
+        AsyncFileSink::Options sinkOptions;
+        sinkOptions.path = currentPath;
+        sinkOptions.blockSize = options.bufferSize;
+        sinkOptions.queueDepth = options.bufferCount;
+        sinkOptions.directIo = options.directIo;
+        sinkOptions.backend = options.asyncIoBackend;
+        sink = std::make_unique<AsyncFileSink>(sinkOptions);
+    }
+    else
+    {
+        fileDirect = options.directIo;
+        fd = openOutput(currentPath, fileDirect);
+        if (fd < 0)
+            throw std::runtime_error("Cannot create capture file " + currentPath + ": " + lastError());
+    }
+
+    fileSize = 0;
+    fileHasFrames = false;
+    ++stats.files;
+}
+
+bool CaptureFileWriter::isFileOpen() const
+{
+    return fd >= 0 || sink != nullptr;
+}
+
+void CaptureFileWriter::writeFileHeader()
+{
+    const uint32_t blockLength = 28;
+    const uint32_t header[] = {sectionHeaderBlock, blockLength, byteOrderMagic};
+    const uint16_t version[] = {1, 0};
+    // Unknown section length
+    const uint64_t sectionLength = ~uint64_t{0};
+
+    append(header, sizeof(header));
+    append(version, sizeof(version));
+    append(&sectionLength, sizeof(sectionLength));
+    append(&blockLength, sizeof(blockLength));
+
+    for (const auto& fileInterface : interfaces)
+        writeInterfaceBlock(fileInterface);
+}
+
+void CaptureFileWriter::writeInterfaceBlock(const Interface& newInterface)
+{
+    const std::size_t nameLength = std::min<std::size_t>(newInterface.name.size(), 0xFFFF);
+    const std::size_t optionsLength = (nameLength ? 4 + padded(nameLength) : 0) + 4 + 4 + 4;
+    const auto blockLength = static_cast<uint32_t>(16 + optionsLength + 4);
+
+    const uint32_t header[] = {interfaceDescriptionBlock, blockLength};
+    const uint16_t linkType[] = {static_cast<uint16_t>(newInterface.linkType), 0};
+    // No snapshot length limit
+    const uint32_t snapLength = 0;
+    append(header, sizeof(header));
+    append(linkType, sizeof(linkType));
+    append(&snapLength, sizeof(snapLength));
+
+    static const uint8_t padding[4]{};
+    if (nameLength)
+    {
+        const uint16_t nameOption[] = {optionInterfaceName, static_cast<uint16_t>(nameLength)};
+        append(nameOption, sizeof(nameOption));
+        append(newInterface.name.data(), nameLength);
+        append(padding, padded(nameLength) - nameLength);
+    }
+    const uint16_t resolutionOption[] = {optionTimestampResolution, 1};
+    const uint8_t resolution[] = {nanosecondResolution, 0, 0, 0};
+    const uint16_t endOption[] = {optionEnd, 0};
+    append(resolutionOption, sizeof(resolutionOption));
+    append(resolution, sizeof(resolution));
+    append(endOption, sizeof(endOption));
+    append(&blockLength, sizeof(blockLength));
+}
+
+void CaptureFileWriter::writePacketBlock(const uint32_t interfaceIndex,
+                                         const uint64_t timestamp,
+                                         const uint8_t* header,
+                                         const std::size_t headerSize,
+                                         const uint8_t* data,
+                                         const std::size_t size)
+{
+    checkError();
+    if (!isFileOpen())
+        throw std::runtime_error("Capture file is closed");
+    if (interfaceIndex >= interfaces.size())
+        throw std::invalid_argument("Unknown capture interface");
+
+    const std::size_t capturedLength = headerSize + size;
+    const auto blockLength = static_cast<uint32_t>(packetBlockHeaderSize + padded(capturedLength) + 4);
+
+    const bool sizeExceeded = options.rotateSize != 0 && fileSize + blockLength > options.rotateSize;
+    const bool timeExceeded =
+        options.rotateInterval != 0 && timestamp > fileStartTime && timestamp - fileStartTime >= options.rotateInterval;
+    if (fileHasFrames && (sizeExceeded || timeExceeded))
+    {
+        submitBuffer(true);
+        ++fileIndex;
+        openFile();
+        writeFileHeader();
+    }
+    if (!fileHasFrames)
+    {
+        fileHasFrames = true;
+        fileStartTime = timestamp;
+    }
+
+    const uint32_t blockHeader[] = {enhancedPacketBlock,
+                                    blockLength,
+                                    interfaceIndex,
+                                    static_cast<uint32_t>(timestamp >> 32),
+                                    static_cast<uint32_t>(timestamp),
+                                    static_cast<uint32_t>(capturedLength),
+                                    static_cast<uint32_t>(capturedLength)};
+    static const uint8_t padding[4]{};
+
+    append(blockHeader, sizeof(blockHeader));
+    if (headerSize)
+        append(header, headerSize);
+    append(data, size);
+    append(padding, padded(capturedLength) - capturedLength);
+    append(&blockLength, sizeof(blockLength));
+    ++stats.frames;
+}
+
+void CaptureFileWriter::append(const void* data, const std::size_t size)
+{
+    if (sink)
+    {
+        sink->write(data, size);
+        fileSize += size;
+        stats.bytes += size;
+        return;
+    }
+
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    std::size_t remaining = size;
+    while (remaining != 0)
+    {
+        const std::size_t chunk = std::min(remaining, options.bufferSize - current->used);
+        memcpy(current->data + current->used, bytes, chunk);
+        current->used += chunk;
+        bytes += chunk;
+        remaining -= chunk;
+        if (current->used == options.bufferSize)
+            submitBuffer(false);
+    }
+    fileSize += size;
+    stats.bytes += size;
+}
+
+void CaptureFileWriter::submitBuffer(const bool lastOfFile)
+{
+    if (sink)
+    {
+        // The sink is released before closing, so a failed close leaves no file open
+        auto closing = std::move(sink);
+        stats.bufferWaits += closing->getStats().bufferWaits;
+        closing->close();
+        return;
+    }
+
+    // Direct I/O writes whole blocks, the rest is carried over to the next buffer until the file is closed
+    Buffer* buffer = current;
+    const std::size_t remainder = (fileDirect && !lastOfFile) ? buffer->used % ioAlignment : 0;
+    buffer->used -= remainder;
+    buffer->fd = fd;
+    buffer->direct = fileDirect;
+    buffer->closeFile = lastOfFile;
+
+    if (!options.backgroundFlush)
+    {
+        writeBuffer(*buffer);
+        memmove(buffer->data, buffer->data + buffer->used, remainder);
+        buffer->used = remainder;
+        checkError();
+        return;
+    }
+
+    Buffer* next = acquireBuffer();
+    memcpy(next->data, buffer->data + buffer->used, remainder);
+    next->used = remainder;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fullBuffers.push_back(buffer);
+        ++buffersInFlight;
+    }
+    bufferReady.notify_one();
+    current = next;
+}
+
+CaptureFileWriter::Buffer* CaptureFileWriter::acquireBuffer()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    if (freeBuffers.empty())
+    {
+        ++stats.bufferWaits;
+        bufferDone.wait(lock, [this] { return !freeBuffers.empty(); });
+    }
+
+    Buffer* buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    buffer->used = 0;
+    return buffer;
+}
+
+void CaptureFileWriter::writeBuffer(Buffer& buffer)
+{
+    if (buffer.used != 0 && !failed)
+    {
+        // The unaligned end of a file is written without direct I/O
+        if (buffer.direct && buffer.used % ioAlignment != 0)
+            disableDirectIo(buffer.fd);
+        if (!writeOutput(buffer.fd, buffer.data, buffer.used))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = "Cannot write capture file: " + lastError();
+            failed = true;
+        }
+    }
+    if (buffer.closeFile)
+        closeOutput(buffer.fd);
+}
+
+void CaptureFileWriter::flushThread()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        bufferReady.wait(lock, [this] { return stopping || !fullBuffers.empty(); });
+        if (fullBuffers.empty())
+            return;
+
+        Buffer* buffer = fullBuffers.front();
+        fullBuffers.pop_front();
+        lock.unlock();
+        writeBuffer(*buffer);
+        lock.lock();
+
+        freeBuffers.push_back(buffer);
+        --buffersInFlight;
+        bufferDone.notify_all();
+    }
+}
+
+void CaptureFileWriter::checkError()
+{
+    if (!failed)
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    throw std::runtime_error(error);
+}
+
+END_NAMESPACE_ASAM_CMP
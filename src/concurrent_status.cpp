@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/concurrent_status.h>
+#include <asam_cmp/interface_payload.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+const Packet& ConcurrentStatus::DeviceSnapshot::getPacket() const
+{
+    return *devicePacket;
+}
+
+uint64_t ConcurrentStatus::DeviceSnapshot::getEpoch() const
+{
+    return epoch;
+}
+
+size_t ConcurrentStatus::DeviceSnapshot::getInterfaceStatusCount() const
+{
+    return interfaces.size();
+}
+
+size_t ConcurrentStatus::DeviceSnapshot::getIndexByInterfaceId(const uint32_t interfaceId) const
+{
+    if (!interfaceIndexes)
+        return interfaces.size();
+
+    auto index = interfaceIndexes->find(interfaceId);
+    return index == FlatIndexMap<uint32_t>::npos ? interfaces.size() : index;
+}
+
+const InterfaceStatus& ConcurrentStatus::DeviceSnapshot::getInterfaceStatus(const size_t index) const
+{
+    return *interfaces[index];
+}
+
+uint64_t ConcurrentStatus::Snapshot::getEpoch() const
+{
+    return epoch;
+}
+
+size_t ConcurrentStatus::Snapshot::getDeviceStatusCount() const
+{
+    return devices.size();
+}
+
+size_t ConcurrentStatus::Snapshot::getIndexByDeviceId(const uint16_t deviceId) const
+{
+    if (!deviceIndexes)
+        return devices.size();
+
+    auto index = deviceIndexes->find(deviceId);
+    return index == FlatIndexMap<uint16_t>::npos ? devices.size() : index;
+}
+
+const ConcurrentStatus::DeviceSnapshot& ConcurrentStatus::Snapshot::getDeviceStatus(const size_t index) const
+{
+    return *devices[index];
+}
+
+std::shared_ptr<const ConcurrentStatus::DeviceSnapshot> ConcurrentStatus::Snapshot::getDeviceStatusPtr(const size_t index) const
+{
+    return devices[index];
+}
+
+ConcurrentStatus::ConcurrentStatus()
+    : current(std::make_shared<const Snapshot>())
+    , published(new SnapshotPtr(current))
+{
+    for (auto& slot : readerSlots)
+        slot.store(nullptr, std::memory_order_relaxed);
+}
+
+ConcurrentStatus::~ConcurrentStatus()
+{
+    // No reader may use the status during its destruction, so no slot protects a pointer anymore
+    delete published.load();
+    for (const auto* pointer : retired)
+        delete pointer;
+}
+
+void ConcurrentStatus::update(const Packet& packet)
+{
+    updateDevice(packet);
+}
+
+void ConcurrentStatus::update(Packet&& packet)
+{
+    updateDevice(std::move(packet));
+}
+
+void ConcurrentStatus::clear()
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+    publish(std::make_shared<Snapshot>());
+}
+
+void ConcurrentStatus::removeDeviceById(const uint16_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    auto index = current->getIndexByDeviceId(deviceId);
+    if (index == current->getDeviceStatusCount())
+        return;
+
+    auto snapshot = std::make_shared<Snapshot>(*current);
+    auto& devices = snapshot->devices;
+    auto deviceIndexes = std::make_shared<FlatIndexMap<uint16_t>>(*snapshot->deviceIndexes);
+    devices.set(index, devices.back());
+    devices.popBack();
+    deviceIndexes->erase(deviceId);
+    if (index != devices.size())
+        deviceIndexes->insert(devices[index]->getPacket().getDeviceId(), index);
+    snapshot->deviceIndexes = std::move(deviceIndexes);
+
+    publish(std::move(snapshot));
+}
+
+ConcurrentStatus::SnapshotPtr ConcurrentStatus::getSnapshot() const
+{
+    // Readers of different threads start at different slots to avoid contention on the first ones
+    thread_local const size_t firstSlot = std::hash<std::thread::id>()(std::this_thread::get_id()) % readerSlotCount;
+
+    const SnapshotPtr* pointer = published.load();
+    for (size_t attempt = 0;; ++attempt)
+    {
+        auto& slot = readerSlots[(firstSlot + attempt) % readerSlotCount];
+        const SnapshotPtr* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, pointer))
+        {
+            // The pointer is protected once the slot is visible while it is still published. A writer that replaces
+            // it later sees the slot and keeps the pointer alive until the slot is released.
+            for (const SnapshotPtr* latest = published.load(); latest != pointer; latest = published.load())
+            {
+                pointer = latest;
+                slot.store(pointer);
+            }
+            SnapshotPtr snapshot = *pointer;
+            slot.store(nullptr, std::memory_order_release);
+            return snapshot;
+        }
+
+        if (attempt % readerSlotCount == readerSlotCount - 1)
+            std::this_thread::yield();
+    }
+}
+
+uint64_t ConcurrentStatus::getEpoch() const
+{
+    return epoch.load(std::memory_order_acquire);
+}
+
+template <typename PacketType>
+void ConcurrentStatus::updateDevice(PacketType&& packet)
+{
+    const auto type = packet.getPayload().getType();
+    if (type != PayloadType::cmStatMsg && type != PayloadType::ifStatMsg)
+        return;
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+
+    // Only the writer replaces current, so it can be read under the writer lock
+    const auto deviceId = packet.getDeviceId();
+    const auto deviceIndex = current->getIndexByDeviceId(deviceId);
+    const bool newDevice = deviceIndex == current->getDeviceStatusCount();
+    if (newDevice && type != PayloadType::cmStatMsg)
+        return;
+
+    const uint64_t newEpoch = epoch.load(std::memory_order_relaxed) + 1;
+    auto device = newDevice ? std::make_shared<DeviceSnapshot>() : std::make_shared<DeviceSnapshot>(*current->devices[deviceIndex]);
+    device->epoch = newEpoch;
+
+    if (type == PayloadType::cmStatMsg)
+    {
+        // A restarted Capture Module resets its counters, the interface rates must not take that as a wrap-around
+        if (!newDevice && static_cast<const CaptureModulePayload&>(packet.getPayload()).getUptime() <
+                              static_cast<const CaptureModulePayload&>(device->devicePacket->getPayload()).getUptime())
+        {
+            for (size_t index = 0; index < device->interfaces.size(); ++index)
+            {
+                auto restarted = std::make_shared<InterfaceStatus>(*device->interfaces[index]);
+                restarted->restart();
+                device->interfaces.set(index, std::move(restarted));
+            }
+        }
+        device->devicePacket = std::make_shared<const Packet>(std::forward<PacketType>(packet));
+    }
+    else
+    {
+        const auto interfaceId = static_cast<const InterfacePayload&>(packet.getPayload()).getInterfaceId();
+        const auto interfaceIndex = device->getIndexByInterfaceId(interfaceId);
+        const bool newInterface = interfaceIndex == device->getInterfaceStatusCount();
+
+        // Only the rates of the previous status are copied to continue them, the packet is replaced anyway
+        auto interfaceStatus = std::make_shared<InterfaceStatus>();
+        if (!newInterface)
+            interfaceStatus->getRates() = device->interfaces[interfaceIndex]->getRates();
+        interfaceStatus->update(std::forward<PacketType>(packet));
+
+        if (!newInterface)
+        {
+            device->interfaces.set(interfaceIndex, std::move(interfaceStatus));
+        }
+        else
+        {
+            auto interfaceIndexes = device->interfaceIndexes ? std::make_shared<FlatIndexMap<uint32_t>>(*device->interfaceIndexes)
+                                                             : std::make_shared<FlatIndexMap<uint32_t>>();
+            interfaceIndexes->insert(interfaceId, device->interfaces.size());
+            device->interfaceIndexes = std::move(interfaceIndexes);
+            device->interfaces.pushBack(std::move(interfaceStatus));
+        }
+    }
+
+    auto snapshot = std::make_shared<Snapshot>(*current);
+    if (newDevice)
+    {
+        auto deviceIndexes = snapshot->deviceIndexes ? std::make_shared<FlatIndexMap<uint16_t>>(*snapshot->deviceIndexes)
+                                                     : std::make_shared<FlatIndexMap<uint16_t>>();
+        deviceIndexes->insert(deviceId, snapshot->devices.size());
+        snapshot->deviceIndexes = std::move(deviceIndexes);
+        snapshot->devices.pushBack(std::move(device));
+    }
+    else
+    {
+        snapshot->devices.set(deviceIndex, std::move(device));
+    }
+
+    publish(std::move(snapshot));
+}
+
+void ConcurrentStatus::publish(std::shared_ptr<Snapshot> snapshot)
+{
+    const uint64_t newEpoch = epoch.load(std::memory_order_relaxed) + 1;
+    snapshot->epoch = newEpoch;
+    current = std::move(snapshot);
+    retired.push_back(published.exchange(new SnapshotPtr(current)));
+    epoch.store(newEpoch, std::memory_order_release);
+    reclaim();
+}
+
+void ConcurrentStatus::reclaim()
+{
+    std::array<const SnapshotPtr*, readerSlotCount> protectedPointers;
+    for (size_t index = 0; index < readerSlotCount; ++index)
+        protectedPointers[index] = readerSlots[index].load();
+
+    auto isProtected = [&protectedPointers](const SnapshotPtr* pointer)
+    { return std::find(protectedPointers.begin(), protectedPointers.end(), pointer) != protectedPointers.end(); };
+    auto kept = std::partition(retired.begin(), retired.end(), isProtected);
+    for (auto it = kept; it != retired.end(); ++it)
+        delete *it;
+    retired.erase(kept, retired.end());
+}
+
+END_NAMESPACE_ASAM_CMP
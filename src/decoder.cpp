@@ -1,6 +1,7 @@
 #include <cstring>
 
 #include <asam_cmp/decoder.h>
+#include <asam_cmp/tecmp_converter.h>
 #include <asam_cmp/tecmp_decoder.h>
 #include <iomanip>
 #include <iostream>
@@ -20,12 +21,95 @@ std::vector<std::shared_ptr<Packet>> Decoder::decode(const void* data, const std
         return TECMP::Decoder::Decode(data, size);
 
     std::vector<std::shared_ptr<Packet>> packets;
+    decodeCmp(
+        dataPtr,
+        size,
+        [&packets](const CmpHeader& header, const uint8_t* message, const size_t messageSize)
+        {
+            auto packet = std::make_shared<Packet>(header.getMessageType(), message, messageSize);
+
+            packet->setVersion(header.getVersion());
+            packet->setDeviceId(header.getDeviceId());
+            packet->setStreamId(header.getStreamId());
+
+            packets.push_back(std::move(packet));
+        },
+        [&packets](std::shared_ptr<Packet>&& packet) { packets.push_back(std::move(packet)); });
+
+    return packets;
+}
+
+size_t Decoder::decode(const void* data, const std::size_t size, PacketBatch& batch)
+{
+    if (data == nullptr)
+        return 0;
+    if (size < sizeof(CmpHeader))
+        return 0;
+
+    const size_t packetCount = batch.size();
+    const auto dataPtr = reinterpret_cast<const uint8_t*>(data);
+    if (*dataPtr == 0x00)
+    {
+        for (const auto& packet : TECMP::Decoder::Decode(data, size))
+            batch.append(*packet);
+        return batch.size() - packetCount;
+    }
+
+    // Unsegmented messages go to the columns directly from the frame
+    decodeCmp(
+        dataPtr,
+        size,
+        [&batch](const CmpHeader& header, const uint8_t* message, const size_t)
+        {
+            batch.append(header.getVersion(),
+                         header.getDeviceId(),
+                         header.getStreamId(),
+                         0,
+                         header.getMessageType(),
+                         *reinterpret_cast<const MessageHeader*>(message),
+                         message + sizeof(MessageHeader));
+        },
+        [&batch](std::shared_ptr<Packet>&& packet) { batch.append(*packet); });
+
+    return batch.size() - packetCount;
+}
+
+size_t Decoder::decode(const void* data, const std::size_t size, std::vector<Packet>& packets)
+{
+    if (data == nullptr)
+        return 0;
+    if (size < sizeof(CmpHeader))
+        return 0;
+
+    const auto dataPtr = reinterpret_cast<const uint8_t*>(data);
+    if (*dataPtr == 0x00)
+        return TECMP::Converter::ConvertFrame(data, size, packets);
+
+    const size_t packetCount = packets.size();
+    decodeCmp(
+        dataPtr,
+        size,
+        [&packets](const CmpHeader& header, const uint8_t* message, const size_t messageSize)
+        {
+            auto& packet = packets.emplace_back(header.getMessageType(), message, messageSize);
+
+            packet.setVersion(header.getVersion());
+            packet.setDeviceId(header.getDeviceId());
+            packet.setStreamId(header.getStreamId());
+        },
+        [&packets](std::shared_ptr<Packet>&& packet) { packets.push_back(std::move(*packet)); });
+
+    return packets.size() - packetCount;
+}
+
+template <typename MessageHandler, typename PacketHandler>
+void Decoder::decodeCmp(const uint8_t* data, const std::size_t size, MessageHandler&& onMessage, PacketHandler&& onPacket)
+{
     const auto header = reinterpret_cast<const CmpHeader*>(data);
     const auto deviceId = header->getDeviceId();
     const auto streamId = header->getStreamId();
     auto packetPtr = reinterpret_cast<const uint8_t*>(header + 1);
     int curSize = static_cast<int>(size - sizeof(CmpHeader));
-    std::shared_ptr<Packet> packet;
     while (curSize > 0)
     {
         if (!Packet::isValidPacket(packetPtr, curSize))
@@ -37,14 +121,7 @@ std::vector<std::shared_ptr<Packet>> Decoder::decode(const void* data, const std
         if (!isSegmentedPacket(packetPtr, curSize))
         {
             segmentedPackets.erase({deviceId, streamId});
-
-            packet = std::make_shared<Packet>(header->getMessageType(), packetPtr, curSize);
-
-            packet->setVersion(header->getVersion());
-            packet->setDeviceId(deviceId);
-            packet->setStreamId(streamId);
-
-            packets.push_back(packet);
+            onMessage(*header, packetPtr, static_cast<size_t>(curSize));
         }
         else
         {
@@ -63,11 +140,11 @@ std::vector<std::shared_ptr<Packet>> Decoder::decode(const void* data, const std
                 }
                 else if (segmentedPackets[{deviceId, streamId}].isAssembled())
                 {
-                    packet = segmentedPackets[{deviceId, streamId}].getPacket();
+                    auto packet = segmentedPackets[{deviceId, streamId}].getPacket();
 
                     packet->setDeviceId(deviceId);
                     packet->setStreamId(streamId);
-                    packets.push_back(packet);
+                    onPacket(std::move(packet));
 
                     segmentedPackets.erase({deviceId, streamId});
                 }
@@ -75,12 +152,10 @@ std::vector<std::shared_ptr<Packet>> Decoder::decode(const void* data, const std
             break;
         }
 
-        const auto packetSize = packet->getPayloadLength() + sizeof(MessageHeader);
+        const auto packetSize = reinterpret_cast<const MessageHeader*>(packetPtr)->getPayloadLength() + sizeof(MessageHeader);
         packetPtr += packetSize;
         curSize -= static_cast<int>(packetSize);
     }
-
-    return packets;
 }
 
 bool Decoder::isSegmentedPacket(const uint8_t* data, const size_t)
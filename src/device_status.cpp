@@ -1,5 +1,4 @@
-#include <algorithm>
-
+#include <asam_cmp/capture_module_payload.h>
 #include <asam_cmp/device_status.h>
 #include <asam_cmp/interface_payload.h>
 
@@ -7,11 +6,22 @@ BEGIN_NAMESPACE_ASAM_CMP
 
 void DeviceStatus::update(const Packet& packet)
 {
-    if (packet.getPayload().getType() == PayloadType::ifStatMsg)
-        updateInterfaces(packet);
+    updateDevice(packet, lastSeen, nullptr);
+}
 
-    if (packet.getPayload().getType() == PayloadType::cmStatMsg)
-        devicePacket = packet;
+void DeviceStatus::update(Packet&& packet)
+{
+    updateDevice(std::move(packet), lastSeen, nullptr);
+}
+
+void DeviceStatus::update(const Packet& packet, const uint64_t time, const StatusSubscribers* statusSubscribers)
+{
+    updateDevice(packet, time, statusSubscribers);
+}
+
+void DeviceStatus::update(Packet&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers)
+{
+    updateDevice(std::move(packet), time, statusSubscribers);
 }
 
 Packet& DeviceStatus::getPacket()
@@ -31,10 +41,8 @@ std::size_t DeviceStatus::getInterfaceStatusCount() const
 
 size_t DeviceStatus::getIndexByInterfaceId(const uint32_t interfaceId) const
 {
-    auto intIt = std::find_if(interfaces.begin(),
-                              interfaces.end(),
-                              [&interfaceId](const InterfaceStatus& interface) { return interface.getInterfaceId() == interfaceId; });
-    return std::distance(interfaces.begin(), intIt);
+    auto index = interfaceIndexes.find(interfaceId);
+    return index == FlatIndexMap<uint32_t>::npos ? interfaces.size() : index;
 }
 
 InterfaceStatus& DeviceStatus::getInterfaceStatus(std::size_t index)
@@ -47,20 +55,87 @@ const InterfaceStatus& DeviceStatus::getInterfaceStatus(std::size_t index) const
     return interfaces[index];
 }
 
-void DeviceStatus::updateInterfaces(const Packet& packet)
+template <typename PacketType>
+void DeviceStatus::updateDevice(PacketType&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers)
+{
+    lastSeen = time;
+    if (packet.getPayload().getType() == PayloadType::ifStatMsg)
+    {
+        updateInterfaces(std::forward<PacketType>(packet), time, statusSubscribers);
+    }
+    else if (packet.getPayload().getType() == PayloadType::cmStatMsg)
+    {
+        detectRestart(packet);
+
+        // The first Capture Module message is reported by Status as an added device
+        if (!hasSubscribers(statusSubscribers) || !devicePacket.isValid())
+        {
+            devicePacket = std::forward<PacketType>(packet);
+            return;
+        }
+
+        StatusChange change;
+        change.type = StatusChange::Type::deviceChanged;
+        change.deviceId = packet.getDeviceId();
+        change.compareDevices(devicePacket, packet);
+
+        Packet previous = std::move(devicePacket);
+        devicePacket = std::forward<PacketType>(packet);
+        if (change.fields != 0)
+        {
+            change.previous = &previous;
+            change.current = &devicePacket;
+            notify(change, statusSubscribers);
+        }
+    }
+}
+
+template <typename PacketType>
+void DeviceStatus::updateInterfaces(PacketType&& packet, const uint64_t time, const StatusSubscribers* statusSubscribers)
 {
     auto newId = static_cast<const InterfacePayload&>(packet.getPayload()).getInterfaceId();
     auto index = getIndexByInterfaceId(newId);
+    const bool notifyChanges = hasSubscribers(statusSubscribers);
+
+    StatusChange change;
+    change.deviceId = packet.getDeviceId();
+    change.interfaceId = newId;
 
     if (index != getInterfaceStatusCount())
     {
-        interfaces[index].update(packet);
+        interfaces[index].lastSeen = time;
+        if (!notifyChanges)
+        {
+            interfaces[index].update(std::forward<PacketType>(packet));
+            return;
+        }
+
+        change.type = StatusChange::Type::interfaceChanged;
+        change.compareInterfaces(interfaces[index].getPacket(), packet);
+
+        Packet previous = std::move(interfaces[index].getPacket());
+        interfaces[index].update(std::forward<PacketType>(packet));
+        if (change.fields != 0)
+        {
+            change.previous = &previous;
+            change.current = &interfaces[index].getPacket();
+            notify(change, statusSubscribers);
+        }
     }
     else
     {
         InterfaceStatus interfaceStatus;
-        interfaceStatus.update(packet);
+        interfaceStatus.update(std::forward<PacketType>(packet));
+        interfaceStatus.lastSeen = time;
+        interfaceIndexes.insert(newId, interfaces.size());
         interfaces.push_back(std::move(interfaceStatus));
+
+        if (notifyChanges)
+        {
+            change.type = StatusChange::Type::interfaceAdded;
+            change.current = &interfaces.back().getPacket();
+            notify(change, statusSubscribers);
+        }
     }
 }
 
@@ -68,10 +143,69 @@ void DeviceStatus::removeInterfaceById(uint32_t interfaceId)
 {
     auto index = getIndexByInterfaceId(interfaceId);
     if (index != getInterfaceStatusCount())
+        removeInterface(index, StatusChange::Type::interfaceRemoved, nullptr);
+}
+
+uint64_t DeviceStatus::getLastSeen() const
+{
+    return lastSeen;
+}
+
+void DeviceStatus::removeInterface(const size_t index, const StatusChange::Type changeType, const StatusSubscribers* statusSubscribers)
+{
+    const auto interfaceId = interfaces[index].getInterfaceId();
+    if (hasSubscribers(statusSubscribers))
     {
-        std::swap(interfaces[index], interfaces[interfaces.size() - 1]);
-        interfaces.pop_back();
+        StatusChange change;
+        change.type = changeType;
+        change.deviceId = interfaces[index].getPacket().getDeviceId();
+        change.interfaceId = interfaceId;
+        change.previous = &interfaces[index].getPacket();
+        notify(change, statusSubscribers);
     }
+
+    std::swap(interfaces[index], interfaces[interfaces.size() - 1]);
+    interfaces.pop_back();
+    interfaceIndexes.erase(interfaceId);
+    if (index != interfaces.size())
+        interfaceIndexes.insert(interfaces[index].getInterfaceId(), index);
+}
+
+size_t DeviceStatus::subscribe(StatusCallback callback)
+{
+    return subscribers.subscribe(std::move(callback));
+}
+
+void DeviceStatus::unsubscribe(const size_t id)
+{
+    subscribers.unsubscribe(id);
+}
+
+void DeviceStatus::detectRestart(const Packet& packet)
+{
+    if (!devicePacket.isValid())
+        return;
+
+    // Uptime going backwards means the Capture Module restarted and reset its interface counters
+    const auto previousUptime = static_cast<const CaptureModulePayload&>(devicePacket.getPayload()).getUptime();
+    const auto uptime = static_cast<const CaptureModulePayload&>(packet.getPayload()).getUptime();
+    if (uptime < previousUptime)
+    {
+        for (auto& interfaceStatus : interfaces)
+            interfaceStatus.restart();
+    }
+}
+
+bool DeviceStatus::hasSubscribers(const StatusSubscribers* statusSubscribers) const
+{
+    return !subscribers.empty() || (statusSubscribers != nullptr && !statusSubscribers->empty());
+}
+
+void DeviceStatus::notify(const StatusChange& change, const StatusSubscribers* statusSubscribers) const
+{
+    subscribers.notify(change);
+    if (statusSubscribers != nullptr)
+        statusSubscribers->notify(change);
 }
 
 END_NAMESPACE_ASAM_CMP
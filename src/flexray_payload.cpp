@@ -0,0 +1,182 @@
+#include <asam_cmp/flexray_payload.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+uint16_t FlexRayPayload::Header::getFlags() const
+{
+    return swapEndian(flags);
+}
+
+void FlexRayPayload::Header::setFlags(const uint16_t newFlags)
+{
+    flags = swapEndian(newFlags);
+}
+
+bool FlexRayPayload::Header::getFlag(const Flags mask) const
+{
+    return (getFlags() & static_cast<uint16_t>(mask)) != 0;
+}
+
+void FlexRayPayload::Header::setFlag(const Flags mask, const bool value)
+{
+    if (value)
+        setFlags(getFlags() | static_cast<uint16_t>(mask));
+    else
+        setFlags(getFlags() & ~static_cast<uint16_t>(mask));
+}
+
+uint16_t FlexRayPayload::Header::getHeaderCrc() const
+{
+    return swapEndian(headerCrc);
+}
+
+void FlexRayPayload::Header::setHeaderCrc(const uint16_t crc)
+{
+    headerCrc = swapEndian(crc);
+}
+
+uint16_t FlexRayPayload::Header::getFrameId() const
+{
+    return swapEndian(frameId);
+}
+
+void FlexRayPayload::Header::setFrameId(const uint16_t id)
+{
+    frameId = swapEndian(id);
+}
+
+uint8_t FlexRayPayload::Header::getCycle() const
+{
+    return cycle;
+}
+
+void FlexRayPayload::Header::setCycle(const uint8_t newCycle)
+{
+    cycle = newCycle;
+}
+
+uint32_t FlexRayPayload::Header::getFrameCrc() const
+{
+    return (static_cast<uint32_t>(frameCrc[0]) << 16) | (static_cast<uint32_t>(frameCrc[1]) << 8) | frameCrc[2];
+}
+
+void FlexRayPayload::Header::setFrameCrc(const uint32_t crc)
+{
+    frameCrc[0] = static_cast<uint8_t>(crc >> 16);
+    frameCrc[1] = static_cast<uint8_t>(crc >> 8);
+    frameCrc[2] = static_cast<uint8_t>(crc);
+}
+
+uint8_t FlexRayPayload::Header::getPayloadLength() const
+{
+    return payloadLength;
+}
+
+void FlexRayPayload::Header::setPayloadLength(const uint8_t length)
+{
+    payloadLength = length;
+}
+
+FlexRayPayload::FlexRayPayload()
+    : Payload(PayloadType::flexRay, sizeof(Header))
+{
+}
+
+FlexRayPayload::FlexRayPayload(const uint8_t* data, const size_t size)
+    : Payload(PayloadType::flexRay, data, size)
+{
+}
+
+uint16_t FlexRayPayload::getFlags() const
+{
+    return getHeader()->getFlags();
+}
+
+void FlexRayPayload::setFlags(const uint16_t newFlags)
+{
+    getHeader()->setFlags(newFlags);
+}
+
+bool FlexRayPayload::getFlag(const Flags mask) const
+{
+    return getHeader()->getFlag(mask);
+}
+
+void FlexRayPayload::setFlag(const Flags mask, const bool value)
+{
+    getHeader()->setFlag(mask, value);
+}
+
+uint16_t FlexRayPayload::getHeaderCrc() const
+{
+    return getHeader()->getHeaderCrc();
+}
+
+void FlexRayPayload::setHeaderCrc(const uint16_t crc)
+{
+    getHeader()->setHeaderCrc(crc);
+}
+
+uint16_t FlexRayPayload::getFrameId() const
+{
+    return getHeader()->getFrameId();
+}
+
+void FlexRayPayload::setFrameId(const uint16_t id)
+{
+    getHeader()->setFrameId(id);
+}
+
+uint8_t FlexRayPayload::getCycle() const
+{
+    return getHeader()->getCycle();
+}
+
+void FlexRayPayload::setCycle(const uint8_t cycle)
+{
+    getHeader()->setCycle(cycle);
+}
+
+uint32_t FlexRayPayload::getFrameCrc() const
+{
+    return getHeader()->getFrameCrc();
+}
+
+void FlexRayPayload::setFrameCrc(const uint32_t crc)
+{
+    getHeader()->setFrameCrc(crc);
+}
+
+uint8_t FlexRayPayload::getPayloadLength() const
+{
+    return getHeader()->getPayloadLength();
+}
+
+const uint8_t* FlexRayPayload::getData() const
+{
+    return getPayloadLength() ? payloadData.data() + sizeof(Header) : nullptr;
+}
+
+void FlexRayPayload::setData(const uint8_t* data, const uint8_t dataLength)
+{
+    Payload::setData<Header>(data, dataLength);
+    getHeader()->setPayloadLength(dataLength);
+}
+
+bool FlexRayPayload::isValidPayload(const uint8_t* data, const size_t size)
+{
+    auto header = reinterpret_cast<const Header*>(data);
+    return (size >= sizeof(Header) && (header->getFlags() & errorMask) == 0 && header->getPayloadLength() <= size - sizeof(Header));
+}
+
+const FlexRayPayload::Header* FlexRayPayload::getHeader() const
+{
+    return reinterpret_cast<const Header*>(payloadData.data());
+}
+
+FlexRayPayload::Header* FlexRayPayload::getHeader()
+{
+    return reinterpret_cast<Header*>(payloadData.data());
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <asam_cmp/indexed_capture.h>
+#include <asam_cmp/message_header.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    // Blocks store their size in 32 bits
+    constexpr std::size_t maxBlockSize = 256 * 1024 * 1024;
+
+    uint64_t makeKey(const uint32_t interfaceId, const uint16_t deviceId, const uint16_t payloadType)
+    {
+        return static_cast<uint64_t>(interfaceId) | (static_cast<uint64_t>(deviceId) << 32) | (static_cast<uint64_t>(payloadType) << 48);
+    }
+
+    bool lessByKey(const IndexedCaptureFormat::IndexEntry& lhs, const IndexedCaptureFormat::IndexEntry& rhs)
+    {
+        if (lhs.interfaceId != rhs.interfaceId)
+            return lhs.interfaceId < rhs.interfaceId;
+        if (lhs.deviceId != rhs.deviceId)
+            return lhs.deviceId < rhs.deviceId;
+        if (lhs.payloadType != rhs.payloadType)
+            return lhs.payloadType < rhs.payloadType;
+        return lhs.blockIndex < rhs.blockIndex;
+    }
+
+    template <typename T>
+    bool contains(const std::vector<T>& values, const T value)
+    {
+        return values.empty() || std::find(values.begin(), values.end(), value) != values.end();
+    }
+
+    bool containsPayloadType(const std::vector<PayloadType>& payloadTypes, const uint16_t payloadType)
+    {
+        return payloadTypes.empty() || std::any_of(payloadTypes.begin(),
+                                                   payloadTypes.end(),
+                                                   [payloadType](const PayloadType& type) { return type.getType() == payloadType; });
+    }
+}
+
+IndexedCaptureWriter::IndexedCaptureWriter(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.blockSize = std::min(options.blockSize, maxBlockSize);
+
+    stream.open(options.path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+        throw std::runtime_error("Cannot create indexed capture " + options.path);
+
+    const Format::FileHeader header;
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.flush();
+    checkStream();
+    fileOffset = sizeof(header);
+}
+
+IndexedCaptureWriter::~IndexedCaptureWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+void IndexedCaptureWriter::write(const Packet& packet)
+{
+    if (!stream.is_open())
+        throw std::runtime_error("Indexed capture is closed");
+
+    const uint64_t timestamp = packet.getTimestamp();
+    if (blockHeader.recordCount != 0 && options.blockDuration != 0 && timestamp > blockHeader.minTimestamp &&
+        timestamp - blockHeader.minTimestamp >= options.blockDuration)
+        flushBlock();
+
+    const auto& payload = packet.getPayload();
+    const auto payloadType = static_cast<uint16_t>(payload.getType().getType());
+    const std::size_t payloadLength = payload.getLength();
+    const std::size_t recordSize = (sizeof(Format::RecordHeader) + sizeof(MessageHeader) + payloadLength + 3) & ~std::size_t{3};
+
+    Format::RecordHeader header;
+    header.recordSize = static_cast<uint32_t>(recordSize);
+    header.interfaceId = packet.getInterfaceId();
+    header.timestamp = timestamp;
+    header.deviceId = packet.getDeviceId();
+    header.payloadType = payloadType;
+    header.sequenceCounter = packet.getSequenceCounter();
+    header.version = packet.getVersion();
+    header.streamId = packet.getStreamId();
+
+    const std::size_t offset = records.size();
+    records.resize(offset + recordSize);
+    uint8_t* record = records.data() + offset;
+    memcpy(record, &header, sizeof(header));
+    packet.getRawMessageHeader(record + sizeof(header));
+    if (payloadLength != 0)
+        memcpy(record + sizeof(header) + sizeof(MessageHeader), payload.getRawPayload(), payloadLength);
+
+    const uint64_t key = makeKey(header.interfaceId, header.deviceId, payloadType);
+    auto keyIndex = blockKeyIndexes.find(key);
+    if (keyIndex == FlatIndexMap<uint64_t>::npos)
+    {
+        keyIndex = blockKeys.size();
+        blockKeyIndexes.insert(key, keyIndex);
+
+        Format::IndexEntry entry;
+        entry.interfaceId = header.interfaceId;
+        entry.deviceId = header.deviceId;
+        entry.payloadType = payloadType;
+        entry.blockIndex = static_cast<uint32_t>(blocks.size());
+        entry.minTimestamp = timestamp;
+        entry.maxTimestamp = timestamp;
+        blockKeys.push_back(entry);
+    }
+
+    auto& entry = blockKeys[keyIndex];
+    ++entry.recordCount;
+    entry.minTimestamp = std::min(entry.minTimestamp, timestamp);
+    entry.maxTimestamp = std::max(entry.maxTimestamp, timestamp);
+
+    blockHeader.minTimestamp = blockHeader.recordCount == 0 ? timestamp : std::min(blockHeader.minTimestamp, timestamp);
+    blockHeader.maxTimestamp = blockHeader.recordCount == 0 ? timestamp : std::max(blockHeader.maxTimestamp, timestamp);
+    ++blockHeader.recordCount;
+    ++packetCount;
+
+    if (records.size() >= options.blockSize)
+        flushBlock();
+}
+
+void IndexedCaptureWriter::flushBlock()
+{
+    if (blockHeader.recordCount == 0)
+        return;
+
+    blockHeader.keyCount = static_cast<uint32_t>(blockKeys.size());
+    const std::size_t keysSize = blockKeys.size() * sizeof(Format::IndexEntry);
+    blockHeader.blockSize = static_cast<uint32_t>(sizeof(Format::BlockHeader) + keysSize + records.size());
+
+    // Readers index a block only after all of its bytes are in the file
+    stream.write(reinterpret_cast<const char*>(&blockHeader), sizeof(blockHeader));
+    stream.write(reinterpret_cast<const char*>(blockKeys.data()), static_cast<std::streamsize>(keysSize));
+    stream.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size()));
+    stream.flush();
+    checkStream();
+
+    Format::BlockEntry block;
+    block.offset = fileOffset;
+    block.minTimestamp = blockHeader.minTimestamp;
+    block.maxTimestamp = blockHeader.maxTimestamp;
+    block.blockSize = blockHeader.blockSize;
+    block.recordCount = blockHeader.recordCount;
+    blocks.push_back(block);
+    entries.insert(entries.end(), blockKeys.begin(), blockKeys.end());
+    fileOffset += blockHeader.blockSize;
+
+    records.clear();
+    blockKeys.clear();
+    blockKeyIndexes.clear();
+    blockHeader = Format::BlockHeader{};
+}
+
+void IndexedCaptureWriter::close()
+{
+    if (!stream.is_open())
+        return;
+
+    flushBlock();
+    std::sort(entries.begin(), entries.end(), lessByKey);
+
+    Format::Trailer trailer;
+    trailer.footerOffset = fileOffset;
+    trailer.blockCount = static_cast<uint32_t>(blocks.size());
+    trailer.entryCount = static_cast<uint32_t>(entries.size());
+
+    stream.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(Format::BlockEntry)));
+    stream.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Format::IndexEntry)));
+    stream.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    stream.close();
+    checkStream();
+}
+
+std::size_t IndexedCaptureWriter::getBlockCount() const
+{
+    return blocks.size();
+}
+
+uint64_t IndexedCaptureWriter::getPacketCount() const
+{
+    return packetCount;
+}
+
+void IndexedCaptureWriter::checkStream() const
+{
+    if (stream.fail())
+        throw std::runtime_error("Cannot write indexed capture " + options.path);
+}
+
+IndexedCaptureReader::IndexedCaptureReader(const std::string& newPath)
+    : path(newPath)
+    , file(newPath)
+{
+    const auto header = reinterpret_cast<const Format::FileHeader*>(file.getData());
+    if (file.getSize() < sizeof(Format::FileHeader) || header->magic != Format::fileMagic || header->version != Format::version)
+        throw std::runtime_error("Not an indexed capture: " + path);
+
+    complete = readFooter();
+    if (!complete)
+        readBlocks();
+}
+
+bool IndexedCaptureReader::isComplete() const
+{
+    return complete;
+}
+
+bool IndexedCaptureReader::refresh()
+{
+    if (complete)
+        return false;
+
+    const std::size_t blockCount = blocks.size();
+    file.open(path);
+    complete = readFooter();
+    if (!complete)
+        readBlocks();
+    return blocks.size() > blockCount;
+}
+
+std::size_t IndexedCaptureReader::getBlockCount() const
+{
+    return blocks.size();
+}
+
+uint64_t IndexedCaptureReader::getPacketCount() const
+{
+    return packetCount;
+}
+
+uint64_t IndexedCaptureReader::getBeginTime() const
+{
+    uint64_t time = std::numeric_limits<uint64_t>::max();
+    for (const auto& block : blocks)
+        time = std::min(time, block.minTimestamp);
+    return blocks.empty() ? 0 : time;
+}
+
+uint64_t IndexedCaptureReader::getEndTime() const
+{
+    uint64_t time = 0;
+    for (const auto& block : blocks)
+        time = std::max(time, block.maxTimestamp);
+    return time;
+}
+
+const IndexedCaptureReader::Stats& IndexedCaptureReader::getStats() const
+{
+    return stats;
+}
+
+std::vector<Packet> IndexedCaptureReader::query(const Query& query)
+{
+    std::vector<Packet> packets;
+    this->query(query, [&packets](Packet&& packet) { packets.push_back(std::move(packet)); });
+    return packets;
+}
+
+bool IndexedCaptureReader::readFooter()
+{
+    const std::size_t size = file.getSize();
+    if (size < sizeof(Format::FileHeader) + sizeof(Format::Trailer))
+        return false;
+
+    const auto trailer = reinterpret_cast<const Format::Trailer*>(file.getData() + size - sizeof(Format::Trailer));
+    const uint64_t footerSize = static_cast<uint64_t>(trailer->blockCount) * sizeof(Format::BlockEntry) +
+                                static_cast<uint64_t>(trailer->entryCount) * sizeof(Format::IndexEntry) + sizeof(Format::Trailer);
+    if (trailer->magic != Format::trailerMagic || trailer->footerOffset < sizeof(Format::FileHeader) ||
+        trailer->footerOffset + footerSize != size)
+        return false;
+
+    const auto blockEntries = reinterpret_cast<const Format::BlockEntry*>(file.getData() + trailer->footerOffset);
+    const auto indexEntries = reinterpret_cast<const Format::IndexEntry*>(blockEntries + trailer->blockCount);
+    blocks.assign(blockEntries, blockEntries + trailer->blockCount);
+    entries.assign(indexEntries, indexEntries + trailer->entryCount);
+
+    packetCount = 0;
+    for (const auto& block : blocks)
+    {
+        if (block.offset + block.blockSize > trailer->footerOffset)
+            throw std::runtime_error("Corrupted indexed capture: " + path);
+        packetCount += block.recordCount;
+    }
+    nextBlockOffset = trailer->footerOffset;
+    return true;
+}
+
+void IndexedCaptureReader::readBlocks()
+{
+    const std::size_t size = file.getSize();
+    const std::size_t entryCount = entries.size();
+
+    // A block that is not completely written yet ends the walk
+    while (nextBlockOffset + sizeof(Format::BlockHeader) <= size)
+    {
+        const auto header = reinterpret_cast<const Format::BlockHeader*>(file.getData() + nextBlockOffset);
+        if (header->magic != Format::blockMagic ||
+            header->blockSize < sizeof(Format::BlockHeader) + static_cast<uint64_t>(header->keyCount) * sizeof(Format::IndexEntry) ||
+            nextBlockOffset + header->blockSize > size)
+            break;
+
+        const auto blockIndex = static_cast<uint32_t>(blocks.size());
+        Format::BlockEntry block;
+        block.offset = nextBlockOffset;
+        block.minTimestamp = header->minTimestamp;
+        block.maxTimestamp = header->maxTimestamp;
+        block.blockSize = header->blockSize;
+        block.recordCount = header->recordCount;
+        blocks.push_back(block);
+
+        const auto keys = reinterpret_cast<const Format::IndexEntry*>(header + 1);
+        for (uint32_t index = 0; index < header->keyCount; ++index)
+        {
+            entries.push_back(keys[index]);
+            entries.back().blockIndex = blockIndex;
+        }
+
+        packetCount += header->recordCount;
+        nextBlockOffset += header->blockSize;
+    }
+
+    if (entries.size() != entryCount)
+        std::sort(entries.begin(), entries.end(), lessByKey);
+}
+
+std::vector<uint32_t> IndexedCaptureReader::findBlocks(const Query& query) const
+{
+    std::vector<uint32_t> blockIndexes;
+    auto addMatching = [&query, &blockIndexes](auto begin, const auto end)
+    {
+        for (; begin != end; ++begin)
+        {
+            if (begin->maxTimestamp < query.beginTime || begin->minTimestamp > query.endTime ||
+                !contains(query.deviceIds, begin->deviceId) || !containsPayloadType(query.payloadTypes, begin->payloadType))
+                continue;
+            blockIndexes.push_back(begin->blockIndex);
+        }
+    };
+
+    if (query.interfaceIds.empty())
+    {
+        addMatching(entries.begin(), entries.end());
+    }
+    else
+    {
+        // Entries are sorted by interface id first
+        for (const auto interfaceId : query.interfaceIds)
+        {
+            auto range = std::equal_range(entries.begin(),
+                                          entries.end(),
+                                          interfaceId,
+                                          [](const auto& lhs, const auto& rhs)
+                                          {
+                                              if constexpr (std::is_same_v<std::decay_t<decltype(lhs)>, uint32_t>)
+                                                  return lhs < rhs.interfaceId;
+                                              else
+                                                  return lhs.interfaceId < rhs;
+                                          });
+            addMatching(range.first, range.second);
+        }
+    }
+
+    std::sort(blockIndexes.begin(), blockIndexes.end());
+    blockIndexes.erase(std::unique(blockIndexes.begin(), blockIndexes.end()), blockIndexes.end());
+    return blockIndexes;
+}
+
+const uint8_t* IndexedCaptureReader::getRecords(const Format::BlockEntry& block) const
+{
+    const uint8_t* data = file.getData() + block.offset;
+    const auto header = reinterpret_cast<const Format::BlockHeader*>(data);
+    const uint64_t keysEnd = sizeof(Format::BlockHeader) + static_cast<uint64_t>(header->keyCount) * sizeof(Format::IndexEntry);
+    if (block.blockSize < keysEnd)
+        throw std::runtime_error("Corrupted indexed capture: " + path);
+    return data + keysEnd;
+}
+
+void IndexedCaptureReader::checkRecord(const uint8_t* record, const uint8_t* blockEnd) const
+{
+    const auto remaining = static_cast<std::size_t>(blockEnd - record);
+    if (remaining < sizeof(Format::RecordHeader))
+        throw std::runtime_error("Corrupted indexed capture: " + path);
+    const uint32_t recordSize = reinterpret_cast<const Format::RecordHeader*>(record)->recordSize;
+    if (recordSize < sizeof(Format::RecordHeader) + sizeof(MessageHeader) || recordSize > remaining)
+        throw std::runtime_error("Corrupted indexed capture: " + path);
+    // The packet is created from the payload length of the message header, the record is that length padded to 4 bytes
+    const auto messageHeader = reinterpret_cast<const MessageHeader*>(record + sizeof(Format::RecordHeader));
+    const std::size_t payloadLength = messageHeader->getPayloadLength();
+    if (((sizeof(Format::RecordHeader) + sizeof(MessageHeader) + payloadLength + 3) & ~std::size_t{3}) != recordSize)
+        throw std::runtime_error("Corrupted indexed capture: " + path);
+}
+
+bool IndexedCaptureReader::matches(const Query& query, const uint8_t* record) const
+{
+    const auto header = reinterpret_cast<const Format::RecordHeader*>(record);
+    return header->timestamp >= query.beginTime && header->timestamp <= query.endTime && contains(query.interfaceIds, header->interfaceId) &&
+           contains(query.deviceIds, header->deviceId) && containsPayloadType(query.payloadTypes, header->payloadType);
+}
+
+Packet IndexedCaptureReader::createPacket(const uint8_t* record) const
+{
+    const auto header = reinterpret_cast<const Format::RecordHeader*>(record);
+    Packet packet(static_cast<CmpHeader::MessageType>(header->payloadType >> 8),
+                  record + sizeof(Format::RecordHeader),
+                  header->recordSize - sizeof(Format::RecordHeader));
+    packet.setDeviceId(header->deviceId);
+    packet.setSequenceCounter(header->sequenceCounter);
+    packet.setVersion(header->version);
+    packet.setStreamId(header->streamId);
+    return packet;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,165 @@
+#include <cmath>
+
+#include <asam_cmp/interface_rates.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+void InterfaceRates::setTimeConstant(const uint64_t newTimeConstant)
+{
+    timeConstant = newTimeConstant;
+}
+
+uint64_t InterfaceRates::getTimeConstant() const
+{
+    return timeConstant;
+}
+
+void InterfaceRates::setWindow(const uint64_t newWindow)
+{
+    window = newWindow;
+}
+
+uint64_t InterfaceRates::getWindow() const
+{
+    return window;
+}
+
+void InterfaceRates::update(const InterfacePayload& payload, const uint64_t timestamp)
+{
+    const auto counters = readCounters(payload);
+
+    // A timestamp going backwards can not give a rate, start again from this message
+    if (!hasBaseline || timestamp < lastTimestamp)
+    {
+        hasBaseline = true;
+        lastTimestamp = timestamp;
+        lastCounters = counters;
+        return;
+    }
+
+    // Repeated message
+    if (timestamp == lastTimestamp)
+        return;
+
+    Interval interval;
+    interval.duration = timestamp - lastTimestamp;
+    for (size_t i = 0; i < counterCount; ++i)
+        interval.deltas[i] = counters[i] - lastCounters[i];
+
+    const double seconds = static_cast<double>(interval.duration) * 1e-9;
+    const double alpha = timeConstant == 0 ? 1.0 : 1.0 - std::exp(-static_cast<double>(interval.duration) / timeConstant);
+    for (size_t i = 0; i < counterCount; ++i)
+    {
+        const double rate = interval.deltas[i] / seconds;
+        ewma[i] = valid ? ewma[i] + alpha * (rate - ewma[i]) : rate;
+    }
+    ewmaRates = toRates(ewma);
+    valid = true;
+
+    pushInterval(interval);
+
+    lastTimestamp = timestamp;
+    lastCounters = counters;
+}
+
+void InterfaceRates::restart()
+{
+    if (hasBaseline)
+        ++restartCount;
+    hasBaseline = false;
+}
+
+void InterfaceRates::reset()
+{
+    hasBaseline = false;
+    valid = false;
+    ewma.fill(0);
+    ewmaRates = Rates{};
+    intervalsBegin = 0;
+    intervalsCount = 0;
+    windowDuration = 0;
+    windowDeltas.fill(0);
+    restartCount = 0;
+}
+
+bool InterfaceRates::isValid() const
+{
+    return valid;
+}
+
+const InterfaceRates::Rates& InterfaceRates::getEwmaRates() const
+{
+    return ewmaRates;
+}
+
+InterfaceRates::Rates InterfaceRates::getWindowedRates() const
+{
+    if (windowDuration == 0)
+        return Rates{};
+
+    const double seconds = static_cast<double>(windowDuration) * 1e-9;
+    std::array<double, counterCount> values;
+    for (size_t i = 0; i < counterCount; ++i)
+        values[i] = windowDeltas[i] / seconds;
+    return toRates(values);
+}
+
+uint64_t InterfaceRates::getWindowedDuration() const
+{
+    return windowDuration;
+}
+
+uint32_t InterfaceRates::getRestartCount() const
+{
+    return restartCount;
+}
+
+InterfaceRates::Counters InterfaceRates::readCounters(const InterfacePayload& payload)
+{
+    return {payload.getMsgTotalRx(),
+            payload.getMsgTotalTx(),
+            payload.getMsgDroppedRx(),
+            payload.getMsgDroppedTx(),
+            payload.getErrorsTotalRx(),
+            payload.getErrorsTotalTx()};
+}
+
+InterfaceRates::Rates InterfaceRates::toRates(const std::array<double, counterCount>& values)
+{
+    Rates rates;
+    rates.msgTotalRx = values[0];
+    rates.msgTotalTx = values[1];
+    rates.msgDroppedRx = values[2];
+    rates.msgDroppedTx = values[3];
+    rates.errorsTotalRx = values[4];
+    rates.errorsTotalTx = values[5];
+    return rates;
+}
+
+void InterfaceRates::pushInterval(const Interval& interval)
+{
+    if (intervalsCount == maxWindowIntervals)
+        popInterval();
+
+    intervals[(intervalsBegin + intervalsCount) % maxWindowIntervals] = interval;
+    ++intervalsCount;
+    windowDuration += interval.duration;
+    for (size_t i = 0; i < counterCount; ++i)
+        windowDeltas[i] += interval.deltas[i];
+
+    // Keep the newest interval even if it is longer than the window
+    while (intervalsCount > 1 && windowDuration - intervals[intervalsBegin].duration >= window)
+        popInterval();
+}
+
+void InterfaceRates::popInterval()
+{
+    const auto& oldest = intervals[intervalsBegin];
+    windowDuration -= oldest.duration;
+    for (size_t i = 0; i < counterCount; ++i)
+        windowDeltas[i] -= oldest.deltas[i];
+    intervalsBegin = (intervalsBegin + 1) % maxWindowIntervals;
+    --intervalsCount;
+}
+
+END_NAMESPACE_ASAM_CMP
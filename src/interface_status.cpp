@@ -5,10 +5,20 @@ BEGIN_NAMESPACE_ASAM_CMP
 
 void InterfaceStatus::update(const Packet& packet)
 {
-    interfaceId = static_cast<const InterfacePayload&>(packet.getPayload()).getInterfaceId();
+    const auto& payload = static_cast<const InterfacePayload&>(packet.getPayload());
+    interfaceId = payload.getInterfaceId();
+    rates.update(payload, packet.getTimestamp());
     interfacePacket = packet;
 }
 
+void InterfaceStatus::update(Packet&& packet)
+{
+    const auto& payload = static_cast<const InterfacePayload&>(packet.getPayload());
+    interfaceId = payload.getInterfaceId();
+    rates.update(payload, packet.getTimestamp());
+    interfacePacket = std::move(packet);
+}
+
 Packet& InterfaceStatus::getPacket()
 {
     return interfacePacket;
@@ -24,4 +34,24 @@ uint32_t InterfaceStatus::getInterfaceId() const
     return interfaceId;
 }
 
+InterfaceRates& InterfaceStatus::getRates()
+{
+    return rates;
+}
+
+const InterfaceRates& InterfaceStatus::getRates() const
+{
+    return rates;
+}
+
+void InterfaceStatus::restart()
+{
+    rates.restart();
+}
+
+uint64_t InterfaceStatus::getLastSeen() const
+{
+    return lastSeen;
+}
+
 END_NAMESPACE_ASAM_CMP
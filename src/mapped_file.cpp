@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <asam_cmp/mapped_file.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+MappedFile::MappedFile(const std::string& path)
+{
+    open(path);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(fileHandle, other.fileHandle);
+        std::swap(mappingHandle, other.mappingHandle);
+#else
+        std::swap(fd, other.fd);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string& path)
+{
+    close();
+
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        fileHandle = nullptr;
+        throw std::runtime_error("Cannot open file " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize))
+    {
+        close();
+        throw std::runtime_error("Cannot get the size of file " + path);
+    }
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size == 0)
+        return;
+
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle != nullptr)
+        data = reinterpret_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        close();
+        throw std::runtime_error("Cannot map file " + path);
+    }
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr)
+        UnmapViewOfFile(data);
+    if (mappingHandle != nullptr)
+        CloseHandle(mappingHandle);
+    if (fileHandle != nullptr)
+        CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+bool MappedFile::isOpen() const
+{
+    return fileHandle != nullptr;
+}
+
+void MappedFile::adviseSequential() const
+{
+    // Sequential access is requested with FILE_FLAG_SEQUENTIAL_SCAN on open
+}
+
+void MappedFile::release(const std::size_t, const std::size_t) const
+{
+    // Windows trims the pages of the view from the working set on demand
+}
+
+#else
+
+void MappedFile::open(const std::string& path)
+{
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open file " + path);
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        close();
+        throw std::runtime_error("Cannot get the size of file " + path);
+    }
+    size = static_cast<std::size_t>(fileStat.st_size);
+    if (size == 0)
+        return;
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close();
+        throw std::runtime_error("Cannot map file " + path);
+    }
+    data = reinterpret_cast<const uint8_t*>(mapping);
+}
+
+void MappedFile::close()
+{
+    if (data != nullptr)
+        munmap(const_cast<uint8_t*>(data), size);
+    if (fd >= 0)
+        ::close(fd);
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+
+bool MappedFile::isOpen() const
+{
+    return fd >= 0;
+}
+
+void MappedFile::adviseSequential() const
+{
+    if (data != nullptr)
+        madvise(const_cast<uint8_t*>(data), size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(const std::size_t offset, const std::size_t length) const
+{
+    if (data == nullptr || offset >= size)
+        return;
+
+    // madvise needs a page aligned start, pages that are only partly in the range are kept
+    static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t begin = (offset + pageSize - 1) / pageSize * pageSize;
+    const std::size_t end = std::min(offset + length, size) / pageSize * pageSize;
+    if (begin < end)
+        madvise(const_cast<uint8_t*>(data) + begin, end - begin, MADV_DONTNEED);
+}
+
+#endif
+
+const uint8_t* MappedFile::getData() const
+{
+    return data;
+}
+
+std::size_t MappedFile::getSize() const
+{
+    return size;
+}
+
+END_NAMESPACE_ASAM_CMP
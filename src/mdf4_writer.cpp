@@ -0,0 +1,931 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#ifdef ASAM_CMP_HAS_ZLIB
+    #include <zlib.h>
+#endif
+
+#include <asam_cmp/can_payload_base.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/mdf4_writer.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr size_t blockHeaderSize = 24;
+    constexpr size_t idBlockSize = 64;
+    constexpr size_t headerBlockSize = blockHeaderSize + 6 * 8 + 32;
+    constexpr uint16_t mdfVersion = 410;
+
+    // Record layouts, all records start with the float64 master channel
+    constexpr size_t timeSize = 8;
+    constexpr size_t canDataOffset = 15;
+    constexpr size_t canDataSize = 8;
+    constexpr size_t canFdDataSize = 64;
+    constexpr size_t linDataOffset = 12;
+    constexpr size_t linDataSize = 8;
+    constexpr size_t ethernetHeaderSize = 14;
+    constexpr size_t ethernetRecordSize = 33;
+
+    constexpr uint16_t canErrorFlags = 0x03FF;
+    constexpr uint16_t linErrorFlags = 0x01FF;
+
+    enum ChannelType : uint8_t
+    {
+        fixedLength = 0,
+        variableLength = 1,
+        master = 2
+    };
+
+    enum DataType : uint8_t
+    {
+        unsignedLe = 0,
+        unsignedBe = 1,
+        signedBe = 3,
+        floatLe = 4,
+        byteArray = 10
+    };
+
+    enum SourceType : uint8_t
+    {
+        sourceBus = 2,
+        sourceIo = 3
+    };
+
+    enum BusType : uint8_t
+    {
+        busNone = 0,
+        busCan = 2,
+        busLin = 3,
+        busEthernet = 7
+    };
+
+    constexpr uint16_t groupBusEvent = 0x0002;
+    constexpr uint16_t groupPlainBusEvent = 0x0004;
+    constexpr uint32_t channelBusEvent = 0x0400;
+    constexpr uint8_t zipDeflate = 0;
+    constexpr uint8_t zipTransposeDeflate = 1;
+
+    // Symbols of AnalogPayload::Unit, indexed by its value
+    const char* const unitSymbols[] = {
+        "", "s", "m", "kg", "A", "K", "mol", "cd", "Hz", "rad", "sr", "N", "Pa", "J", "W", "C", "V", "F", "Ohm", "S", "Wb", "T",
+        "H", "\xC2\xB0" "C", "lm", "lx", "Bq", "Gy", "Sv", "kat", "m/s", "m/s^2", "m/s^3", "m/s^4", "rad/s", "rad/s^2", "Hz/s",
+        "m^3/s", "m^2", "m^3", "N*s", "N*m/s", "N*m", "kg/m^2", "kg/m^3", "m^3/kg", "J*s", "J/kg", "J/m^3", "N/m", "W/m^2",
+        "m^2/s", "Pa*s", "kg/s", "W/(sr*m^3)", "Gy/s", "m/m^3", "W/m^3", "J/(m^2*s)", "kg*m^2", "W/sr", "mol/m^3", "m^3/mol",
+        "J/(K*mol)", "J/mol", "mol/kg", "kg/mol", "C/m", "C/m^2", "C/m^3", "A/m^2", "S/m", "F/m", "H/m", "V/m", "A/m", "C/kg",
+        "A*m^2", "lm*s", "lx*s", "cd/m^2", "lm/W", "J/K", "J/(kg*K)", "W/(m*K)"};
+
+    const char* getUnitSymbol(const AnalogPayload::Unit unit)
+    {
+        const auto index = static_cast<size_t>(unit);
+        return index < sizeof(unitSymbols) / sizeof(unitSymbols[0]) ? unitSymbols[index] : "";
+    }
+
+    // Channel groups and bus channels are looked up by kind, device id and interface id
+    uint64_t getKey(const uint8_t kind, const uint16_t deviceId, const uint32_t interfaceId)
+    {
+        return (static_cast<uint64_t>(kind) << 48) | (static_cast<uint64_t>(deviceId) << 32) | interfaceId;
+    }
+
+    uint64_t padded(const uint64_t size)
+    {
+        return (size + 7) & ~uint64_t{7};
+    }
+
+    // Little-endian block data, written field by field
+    class BlockData final
+    {
+    public:
+        template <typename T>
+        BlockData& add(const T value)
+        {
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+            return *this;
+        }
+
+        BlockData& add(const char* text, const size_t size)
+        {
+            data.insert(data.end(), text, text + size);
+            return *this;
+        }
+
+        BlockData& zeros(const size_t count)
+        {
+            data.insert(data.end(), count, 0);
+            return *this;
+        }
+
+        std::vector<uint8_t> data;
+    };
+
+    void addBlockHeader(std::vector<uint8_t>& bytes, const char* id, const uint64_t length, const uint64_t linkCount)
+    {
+        BlockData header;
+        header.add(id, 4).zeros(4).add(length).add(linkCount);
+        bytes.insert(bytes.end(), header.data.begin(), header.data.end());
+    }
+
+    struct Channel
+    {
+        Channel(std::string name,
+                const uint32_t byteOffset,
+                const uint32_t bitCount,
+                const uint8_t dataType = unsignedLe,
+                const uint8_t bitOffset = 0)
+            : name(std::move(name))
+            , byteOffset(byteOffset)
+            , bitCount(bitCount)
+            , dataType(dataType)
+            , bitOffset(bitOffset)
+        {
+        }
+
+        std::string name;
+        uint32_t byteOffset;
+        uint32_t bitCount;
+        uint8_t dataType;
+        uint8_t bitOffset;
+        uint8_t type{fixedLength};
+        uint32_t flags{0};
+        uint64_t composition{0};
+        uint64_t conversion{0};
+        uint64_t data{0};
+        std::string unit;
+    };
+
+    // Appends the channel hierarchy at the end of the file; children are added before their parents, so every link
+    // points to a block that already has its offset
+    class BlockBuilder final
+    {
+    public:
+        explicit BlockBuilder(const uint64_t base)
+            : base(base)
+        {
+        }
+
+        uint64_t addBlock(const char* id, const std::vector<uint64_t>& links, const std::vector<uint8_t>& data)
+        {
+            const uint64_t offset = base + bytes.size();
+            addBlockHeader(bytes, id, blockHeaderSize + links.size() * 8 + data.size(), links.size());
+            for (const auto link : links)
+                bytes.insert(bytes.end(), reinterpret_cast<const uint8_t*>(&link), reinterpret_cast<const uint8_t*>(&link) + 8);
+            bytes.insert(bytes.end(), data.begin(), data.end());
+            bytes.resize(padded(bytes.size()));
+            return offset;
+        }
+
+        uint64_t addText(const std::string& text, const char* id = "##TX")
+        {
+            if (text.empty())
+                return 0;
+
+            auto& offset = texts[std::string(id) + text];
+            if (offset == 0)
+            {
+                std::vector<uint8_t> data(text.begin(), text.end());
+                data.push_back(0);
+                offset = addBlock(id, {}, data);
+            }
+            return offset;
+        }
+
+        // Returns the first channel of the list
+        uint64_t addChannels(const std::vector<Channel>& channels)
+        {
+            uint64_t next = 0;
+            for (auto channel = channels.rbegin(); channel != channels.rend(); ++channel)
+            {
+                BlockData data;
+                data.add(channel->type)
+                    .add<uint8_t>(channel->type == master ? 1 : 0)
+                    .add(channel->dataType)
+                    .add(channel->bitOffset)
+                    .add(channel->byteOffset)
+                    .add(channel->bitCount)
+                    .add(channel->flags)
+                    .add<uint32_t>(0)
+                    .zeros(4)
+                    .zeros(6 * 8);
+                next = addBlock("##CN",
+                                {next,
+                                 channel->composition,
+                                 addText(channel->name),
+                                 0,
+                                 channel->conversion,
+                                 channel->data,
+                                 addText(channel->unit),
+                                 0},
+                                data.data);
+            }
+            return next;
+        }
+
+        const std::vector<uint8_t>& getBytes() const
+        {
+            return bytes;
+        }
+
+    private:
+        uint64_t base;
+        std::vector<uint8_t> bytes;
+        std::unordered_map<std::string, uint64_t> texts;
+    };
+}
+
+Mdf4Writer::Mdf4Writer(Options newOptions)
+    : options(std::move(newOptions))
+    , compress(options.compress && isCompressionSupported())
+    , startTime(options.startTime)
+{
+    options.blockSize = std::max<size_t>(options.blockSize, 4096);
+    options.maxPendingBlocks = std::max<size_t>(options.maxPendingBlocks, 1);
+
+    file.open(options.path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Cannot create MDF file " + options.path);
+
+    writeFileHeader(false);
+    fileEnd = idBlockSize + headerBlockSize;
+    thread = std::thread(&Mdf4Writer::workerThread, this);
+}
+
+Mdf4Writer::~Mdf4Writer()
+{
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
+}
+
+bool Mdf4Writer::write(const Packet& packet)
+{
+    const auto& payload = packet.getPayload();
+    return writePayload(packet.getDeviceId(),
+                        packet.getInterfaceId(),
+                        packet.getTimestamp(),
+                        payload.getType().getType(),
+                        payload.getRawPayload(),
+                        payload.getLength());
+}
+
+size_t Mdf4Writer::write(const std::vector<std::shared_ptr<Packet>>& packets)
+{
+    size_t count = 0;
+    for (const auto& packet : packets)
+        count += write(*packet) ? 1 : 0;
+    return count;
+}
+
+size_t Mdf4Writer::write(const PacketBatch& batch)
+{
+    const auto& deviceIds = batch.getDeviceIds();
+    const auto& interfaceIds = batch.getInterfaceIds();
+    const auto& timestamps = batch.getTimestamps();
+    const auto& payloadTypes = batch.getPayloadTypes();
+
+    size_t count = 0;
+    for (size_t index = 0; index < batch.size(); ++index)
+    {
+        count += writePayload(deviceIds[index],
+                              interfaceIds[index],
+                              timestamps[index],
+                              payloadTypes[index],
+                              batch.getPayload(index),
+                              batch.getPayloadLength(index))
+                     ? 1
+                     : 0;
+    }
+    return count;
+}
+
+void Mdf4Writer::close()
+{
+    if (closed)
+        return;
+    closed = true;
+
+    for (auto& group : groups)
+    {
+        submit(group->records, group->recordSize);
+        submit(group->signalData, 0);
+    }
+    stopWorker();
+    checkError();
+
+    if (!started && startTime == 0)
+    {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        startTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+    }
+
+    writeChannelHierarchy();
+    writeFileHeader(true);
+    file.close();
+    if (!file)
+        throw std::runtime_error("Cannot write MDF file " + options.path);
+}
+
+size_t Mdf4Writer::getChannelGroupCount() const
+{
+    return groups.size();
+}
+
+const Mdf4Writer::Stats& Mdf4Writer::getStats() const
+{
+    return stats;
+}
+
+bool Mdf4Writer::isCompressionSupported()
+{
+#ifdef ASAM_CMP_HAS_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool Mdf4Writer::writePayload(const uint16_t deviceId,
+                              const uint32_t interfaceId,
+                              const uint64_t timestamp,
+                              const uint32_t type,
+                              const uint8_t* payload,
+                              const size_t length)
+{
+    if (closed)
+        throw std::runtime_error("MDF file is closed");
+
+    switch (type)
+    {
+        case PayloadType::can:
+            return writeCan(deviceId, interfaceId, Kind::can, getTime(timestamp), payload, length);
+        case PayloadType::canFd:
+            return writeCan(deviceId, interfaceId, Kind::canFd, getTime(timestamp), payload, length);
+        case PayloadType::lin:
+            return writeLin(deviceId, interfaceId, getTime(timestamp), payload, length);
+        case PayloadType::ethernet:
+            return writeEthernet(deviceId, interfaceId, getTime(timestamp), payload, length);
+        case PayloadType::analog:
+            return writeAnalog(deviceId, interfaceId, getTime(timestamp), payload, length);
+        default:
+            return false;
+    }
+}
+
+bool Mdf4Writer::writeCan(
+    const uint16_t deviceId, const uint32_t interfaceId, const Kind kind, const double time, const uint8_t* payload, const size_t length)
+{
+    if (length < sizeof(CanPayloadBase::Header))
+        return false;
+
+    const auto header = reinterpret_cast<const CanPayloadBase::Header*>(payload);
+    if ((header->getFlags() & canErrorFlags) != 0)
+        return false;
+
+    auto& group = getGroup(kind, deviceId, interfaceId);
+    const size_t dataSize = group.recordSize - canDataOffset;
+    const size_t dataLength = std::min({static_cast<size_t>(header->getDataLength()), length - sizeof(CanPayloadBase::Header), dataSize});
+
+    uint8_t* record = addRecord(group);
+    uint32_t id = header->getId() & 0x1FFFFFFF;
+    if (header->getIde())
+        id |= 0x80000000;
+    uint8_t dlcFlags = header->getDlc() & 0x0F;
+    if (kind == Kind::canFd)
+        dlcFlags |= 0x10;
+    if (header->getFlag(CanPayloadBase::Flags::brs))
+        dlcFlags |= 0x20;
+    if (header->getFlag(CanPayloadBase::Flags::esi))
+        dlcFlags |= 0x40;
+
+    memcpy(record, &time, sizeof(time));
+    record[8] = group.busChannel;
+    memcpy(record + 9, &id, sizeof(id));
+    record[13] = dlcFlags;
+    record[14] = static_cast<uint8_t>(dataLength);
+    memcpy(record + canDataOffset, payload + sizeof(CanPayloadBase::Header), dataLength);
+    ++stats.frames;
+    return true;
+}
+
+bool Mdf4Writer::writeLin(
+    const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length)
+{
+    if (length < sizeof(LinPayload::Header))
+        return false;
+
+    const auto header = reinterpret_cast<const LinPayload::Header*>(payload);
+    if ((header->getFlags() & linErrorFlags) != 0)
+        return false;
+
+    auto& group = getGroup(Kind::lin, deviceId, interfaceId);
+    const size_t dataLength = std::min({static_cast<size_t>(header->getDataLength()), length - sizeof(LinPayload::Header), linDataSize});
+
+    uint8_t* record = addRecord(group);
+    memcpy(record, &time, sizeof(time));
+    record[8] = group.busChannel;
+    record[9] = header->getLinId() & 0x3F;
+    record[10] = static_cast<uint8_t>(dataLength);
+    record[11] = header->getChecksum();
+    memcpy(record + linDataOffset, payload + sizeof(LinPayload::Header), dataLength);
+    ++stats.frames;
+    return true;
+}
+
+bool Mdf4Writer::writeEthernet(
+    const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length)
+{
+    if (length < sizeof(EthernetPayload::Header))
+        return false;
+
+    const auto header = reinterpret_cast<const EthernetPayload::Header*>(payload);
+    auto& group = getGroup(Kind::ethernet, deviceId, interfaceId);
+    const uint8_t* frame = payload + sizeof(EthernetPayload::Header);
+    size_t frameLength = std::min<size_t>(header->getDataLength(), length - sizeof(EthernetPayload::Header));
+
+    uint8_t* record = addRecord(group);
+    memcpy(record, &time, sizeof(time));
+    record[8] = group.busChannel;
+    // Destination, source and EtherType (big-endian) are taken from the frame, DataBytes holds the rest
+    if (frameLength >= ethernetHeaderSize)
+    {
+        memcpy(record + 9, frame, ethernetHeaderSize);
+        frame += ethernetHeaderSize;
+        frameLength -= ethernetHeaderSize;
+    }
+    const auto dataLength = static_cast<uint16_t>(frameLength);
+    const uint64_t dataOffset = group.signalData.size;
+    memcpy(record + 23, &dataLength, sizeof(dataLength));
+    memcpy(record + 25, &dataOffset, sizeof(dataOffset));
+    addSignalData(group, frame, dataLength);
+    ++stats.frames;
+    return true;
+}
+
+bool Mdf4Writer::writeAnalog(
+    const uint16_t deviceId, const uint32_t interfaceId, const double time, const uint8_t* payload, const size_t length)
+{
+    if (length < sizeof(AnalogPayload::Header))
+        return false;
+
+    const auto header = reinterpret_cast<const AnalogPayload::Header*>(payload);
+    const auto sampleDt = header->getSampleDt();
+    if (sampleDt != AnalogPayload::SampleDt::aInt16 && sampleDt != AnalogPayload::SampleDt::aInt32)
+        return false;
+
+    const size_t sampleSize = sampleDt == AnalogPayload::SampleDt::aInt16 ? sizeof(int16_t) : sizeof(int32_t);
+    const auto index = groupIndexes.find(getKey(static_cast<uint8_t>(Kind::analog), deviceId, interfaceId));
+    Group* group = index == FlatIndexMap<uint64_t>::npos ? nullptr : groups[index].get();
+
+    // The scaling is part of the channel group, so changed parameters start a new one
+    if (group == nullptr || group->sampleDt != sampleDt || group->unit != header->getUnit() ||
+        group->sampleOffset != header->getSampleOffset() || group->sampleScalar != header->getSampleScalar())
+    {
+        group = &addGroup(Kind::analog, deviceId, interfaceId, timeSize + sampleSize);
+        group->sampleDt = sampleDt;
+        group->unit = header->getUnit();
+        group->sampleOffset = header->getSampleOffset();
+        group->sampleScalar = header->getSampleScalar();
+    }
+
+    const uint8_t* samples = payload + sizeof(AnalogPayload::Header);
+    const size_t count = (length - sizeof(AnalogPayload::Header)) / sampleSize;
+    const double interval = header->getSampleInterval();
+    for (size_t sample = 0; sample < count; ++sample)
+    {
+        const double sampleTime = time + interval * static_cast<double>(sample);
+        uint8_t* record = addRecord(*group);
+        memcpy(record, &sampleTime, sizeof(sampleTime));
+        memcpy(record + timeSize, samples + sample * sampleSize, sampleSize);
+    }
+    stats.samples += count;
+    return true;
+}
+
+Mdf4Writer::Group& Mdf4Writer::getGroup(const Kind kind, const uint16_t deviceId, const uint32_t interfaceId)
+{
+    const auto index = groupIndexes.find(getKey(static_cast<uint8_t>(kind), deviceId, interfaceId));
+    if (index != FlatIndexMap<uint64_t>::npos)
+        return *groups[index];
+
+    switch (kind)
+    {
+        case Kind::can:
+            return addGroup(kind, deviceId, interfaceId, canDataOffset + canDataSize);
+        case Kind::canFd:
+            return addGroup(kind, deviceId, interfaceId, canDataOffset + canFdDataSize);
+        case Kind::lin:
+            return addGroup(kind, deviceId, interfaceId, linDataOffset + linDataSize);
+        case Kind::ethernet:
+        default:
+            // Analog groups depend on the sample type and are added by writeAnalog
+            return addGroup(kind, deviceId, interfaceId, ethernetRecordSize);
+    }
+}
+
+Mdf4Writer::Group& Mdf4Writer::addGroup(const Kind kind, const uint16_t deviceId, const uint32_t interfaceId, const size_t recordSize)
+{
+    // CAN and CAN FD frames of an interface share the bus channel
+    const size_t busIndex = kind == Kind::can ? 0 : static_cast<size_t>(kind) - 1;
+    const uint64_t busKey = getKey(static_cast<uint8_t>(busIndex), deviceId, interfaceId);
+    auto busChannel = busChannels.find(busKey);
+    if (busChannel == FlatIndexMap<uint64_t>::npos)
+    {
+        // Bus channels are 8 bit, further buses share the last number
+        auto& count = busChannelCounts[busIndex];
+        if (count != 0xFF)
+            ++count;
+        busChannel = count;
+        busChannels.insert(busKey, busChannel);
+    }
+
+    auto group = std::make_unique<Group>();
+    group->kind = kind;
+    group->deviceId = deviceId;
+    group->interfaceId = interfaceId;
+    group->busChannel = static_cast<uint8_t>(busChannel);
+    group->recordSize = recordSize;
+
+    groupIndexes.insert(getKey(static_cast<uint8_t>(kind), deviceId, interfaceId), groups.size());
+    groups.push_back(std::move(group));
+    return *groups.back();
+}
+
+double Mdf4Writer::getTime(const uint64_t timestamp)
+{
+    if (!started)
+    {
+        started = true;
+        if (startTime == 0)
+            startTime = timestamp;
+    }
+    return static_cast<double>(static_cast<int64_t>(timestamp - startTime)) / 1e9;
+}
+
+uint8_t* Mdf4Writer::addRecord(Group& group)
+{
+    auto& stream = group.records;
+    if (stream.buffer.size() + group.recordSize > options.blockSize)
+        submit(stream, group.recordSize);
+
+    stream.buffer.resize(stream.buffer.size() + group.recordSize);
+    stream.size += group.recordSize;
+    ++group.cycleCount;
+    return stream.buffer.data() + stream.buffer.size() - group.recordSize;
+}
+
+void Mdf4Writer::addSignalData(Group& group, const uint8_t* data, const size_t size)
+{
+    // Every value is stored with its 32 bit length and never split between blocks
+    auto& stream = group.signalData;
+    const auto valueLength = static_cast<uint32_t>(size);
+    if (!stream.buffer.empty() && stream.buffer.size() + sizeof(valueLength) + size > options.blockSize)
+        submit(stream, 0);
+
+    const auto lengthBytes = reinterpret_cast<const uint8_t*>(&valueLength);
+    stream.buffer.insert(stream.buffer.end(), lengthBytes, lengthBytes + sizeof(valueLength));
+    stream.buffer.insert(stream.buffer.end(), data, data + size);
+    stream.size += sizeof(valueLength) + size;
+}
+
+void Mdf4Writer::submit(Stream& stream, const size_t recordSize)
+{
+    if (stream.buffer.empty())
+        return;
+    checkError();
+
+    stats.dataBytes += stream.buffer.size();
+    ++stats.blocks;
+
+    Job job;
+    job.data = std::move(stream.buffer);
+    job.blocks = &stream.blocks;
+    job.recordSize = recordSize;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [this] { return jobs.size() < options.maxPendingBlocks || failed; });
+        jobs.push_back(std::move(job));
+        if (!freeBuffers.empty())
+        {
+            stream.buffer = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+    jobReady.notify_one();
+    stream.buffer.clear();
+}
+
+void Mdf4Writer::writeFileHeader(const bool finished)
+{
+    std::vector<uint8_t> bytes;
+    BlockData id;
+    id.add(finished ? "MDF     " : "UnFinMF ", 8).add("4.10    ", 8).add("asamcmp ", 8).zeros(4).add(mdfVersion).zeros(30);
+    // An unfinished file has no cycle counters and no channel hierarchy yet
+    id.add<uint16_t>(finished ? 0 : 1).add<uint16_t>(0);
+    bytes = std::move(id.data);
+
+    addBlockHeader(bytes, "##HD", headerBlockSize, 6);
+    BlockData header;
+    header.add(firstDataGroup).add(fileHistory).zeros(4 * 8);
+    // Start time in UTC, no time zone, local PC reference time
+    header.add(startTime).add<int16_t>(0).add<int16_t>(0).add<uint8_t>(0).add<uint8_t>(0).add<uint8_t>(0).zeros(1);
+    header.add(0.0).add(0.0);
+    bytes.insert(bytes.end(), header.data.begin(), header.data.end());
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+        throw std::runtime_error("Cannot write MDF file " + options.path);
+}
+
+void Mdf4Writer::writeChannelHierarchy()
+{
+    BlockBuilder builder(fileEnd);
+
+    auto addDataLink = [this, &builder](const Stream& stream, const uint8_t zipType) -> uint64_t
+    {
+        const auto& blocks = stream.blocks;
+        if (blocks.empty())
+            return 0;
+        if (!compress && blocks.size() == 1)
+            return blocks.front().offset;
+
+        std::vector<uint64_t> links{0};
+        BlockData data;
+        data.add<uint8_t>(0).zeros(3).add(static_cast<uint32_t>(blocks.size()));
+        uint64_t offset = 0;
+        for (const auto& block : blocks)
+        {
+            links.push_back(block.offset);
+            data.add(offset);
+            offset += block.dataLength;
+        }
+        const uint64_t list = builder.addBlock("##DL", links, data.data);
+        if (!compress)
+            return list;
+
+        // Data lists with compressed blocks are referenced through a header list
+        BlockData headerList;
+        headerList.add<uint16_t>(0).add(zipType).zeros(5);
+        return builder.addBlock("##HL", {list}, headerList.data);
+    };
+
+    // Data groups are linked to the next one, so they are added in reverse order
+    uint64_t nextDataGroup = 0;
+    for (auto groupIt = groups.rbegin(); groupIt != groups.rend(); ++groupIt)
+    {
+        const Group& group = **groupIt;
+
+        const char* prefix = "";
+        uint8_t sourceType = sourceBus;
+        uint8_t busType = busNone;
+        switch (group.kind)
+        {
+            case Kind::can:
+            case Kind::canFd:
+                prefix = "CAN";
+                busType = busCan;
+                break;
+            case Kind::lin:
+                prefix = "LIN";
+                busType = busLin;
+                break;
+            case Kind::ethernet:
+                prefix = "ETH";
+                busType = busEthernet;
+                break;
+            case Kind::analog:
+                prefix = "Analog";
+                sourceType = sourceIo;
+                break;
+        }
+        const std::string busName = prefix + std::to_string(group.busChannel);
+        const std::string sourcePath =
+            "CMP device " + std::to_string(group.deviceId) + " interface " + std::to_string(group.interfaceId);
+
+        BlockData sourceData;
+        sourceData.add(sourceType).add(busType).add<uint8_t>(0).zeros(5);
+        const uint64_t source = builder.addBlock("##SI", {builder.addText(busName), builder.addText(sourcePath), 0}, sourceData.data);
+
+        Channel timeChannel("Timestamp", 0, 64, floatLe);
+        timeChannel.type = master;
+        timeChannel.unit = "s";
+        std::vector<Channel> channels{timeChannel};
+        uint16_t groupFlags = groupBusEvent | groupPlainBusEvent;
+
+        // Bus event structure that covers the record after the master channel
+        auto addFrame = [&channels, &group](const char* name, const uint64_t members)
+        {
+            Channel frame(name, timeSize, static_cast<uint32_t>((group.recordSize - timeSize) * 8), byteArray);
+            frame.flags = channelBusEvent;
+            frame.composition = members;
+            channels.push_back(frame);
+        };
+
+        switch (group.kind)
+        {
+            case Kind::can:
+            case Kind::canFd:
+            {
+                const auto dataBits = static_cast<uint32_t>((group.recordSize - canDataOffset) * 8);
+                const uint64_t members = builder.addChannels({{"CAN_DataFrame.BusChannel", 8, 8},
+                                                              {"CAN_DataFrame.ID", 9, 29},
+                                                              {"CAN_DataFrame.IDE", 12, 1, unsignedLe, 7},
+                                                              {"CAN_DataFrame.DLC", 13, 4},
+                                                              {"CAN_DataFrame.EDL", 13, 1, unsignedLe, 4},
+                                                              {"CAN_DataFrame.BRS", 13, 1, unsignedLe, 5},
+                                                              {"CAN_DataFrame.ESI", 13, 1, unsignedLe, 6},
+                                                              {"CAN_DataFrame.DataLength", 14, 8},
+                                                              {"CAN_DataFrame.DataBytes", canDataOffset, dataBits, byteArray}});
+                addFrame("CAN_DataFrame", members);
+                break;
+            }
+            case Kind::lin:
+            {
+                const uint64_t members = builder.addChannels({{"LIN_Frame.BusChannel", 8, 8},
+                                                              {"LIN_Frame.ID", 9, 6},
+                                                              {"LIN_Frame.DataLength", 10, 8},
+                                                              {"LIN_Frame.Checksum", 11, 8},
+                                                              {"LIN_Frame.DataBytes", linDataOffset, linDataSize * 8, byteArray}});
+                addFrame("LIN_Frame", members);
+                break;
+            }
+            case Kind::ethernet:
+            {
+                // The record holds the offset of the value in the signal data
+                Channel dataBytes("ETH_Frame.DataBytes", 25, 64, byteArray);
+                dataBytes.type = variableLength;
+                dataBytes.data = addDataLink(group.signalData, zipDeflate);
+                const uint64_t members = builder.addChannels({{"ETH_Frame.BusChannel", 8, 8},
+                                                              {"ETH_Frame.Destination", 9, 48, byteArray},
+                                                              {"ETH_Frame.Source", 15, 48, byteArray},
+                                                              {"ETH_Frame.EtherType", 21, 16, unsignedBe},
+                                                              {"ETH_Frame.DataLength", 23, 16},
+                                                              dataBytes});
+                addFrame("ETH_Frame", members);
+                break;
+            }
+            case Kind::analog:
+            {
+                // Physical value = offset + scalar * raw value
+                const std::string unit = getUnitSymbol(group.unit);
+                BlockData conversionData;
+                conversionData.add<uint8_t>(1).add<uint8_t>(0).add<uint16_t>(0).add<uint16_t>(0).add<uint16_t>(2);
+                conversionData.add(0.0).add(0.0).add(static_cast<double>(group.sampleOffset)).add(static_cast<double>(group.sampleScalar));
+                const uint64_t conversion = builder.addBlock("##CC", {0, builder.addText(unit), 0, 0}, conversionData.data);
+
+                const bool int16Samples = group.sampleDt == AnalogPayload::SampleDt::aInt16;
+                // Samples are copied in the big-endian byte order of the payload
+                Channel value{busName, timeSize, int16Samples ? 16u : 32u, signedBe};
+                value.conversion = conversion;
+                value.unit = unit;
+                channels.push_back(value);
+                groupFlags = 0;
+                break;
+            }
+        }
+
+        BlockData groupData;
+        groupData.add<uint64_t>(0).add(group.cycleCount).add(groupFlags).add<uint16_t>('.').zeros(4);
+        groupData.add(static_cast<uint32_t>(group.recordSize)).add<uint32_t>(0);
+        const uint64_t channelGroup =
+            builder.addBlock("##CG", {0, builder.addChannels(channels), builder.addText(busName), source, 0, 0}, groupData.data);
+
+        const uint64_t records = addDataLink(group.records, zipTransposeDeflate);
+        BlockData dataGroupData;
+        dataGroupData.add<uint8_t>(0).zeros(7);
+        nextDataGroup = builder.addBlock("##DG", {nextDataGroup, channelGroup, records, 0}, dataGroupData.data);
+    }
+    firstDataGroup = nextDataGroup;
+
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    const std::string comment =
+        "<FHcomment>\n<TX>Converted from ASAM CMP</TX>\n<tool_id>asam_cmp</tool_id>\n<tool_vendor>openDAQ</tool_vendor>\n"
+        "<tool_version>1.0.0</tool_version>\n</FHcomment>";
+    BlockData historyData;
+    historyData.add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()));
+    historyData.add<int16_t>(0).add<int16_t>(0).add<uint8_t>(0).zeros(3);
+    fileHistory = builder.addBlock("##FH", {0, builder.addText(comment, "##MD")}, historyData.data);
+
+    const auto& bytes = builder.getBytes();
+    file.seekp(static_cast<std::streamoff>(fileEnd));
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file)
+        throw std::runtime_error("Cannot write MDF file " + options.path);
+    stats.fileBytes = fileEnd + bytes.size();
+}
+
+void Mdf4Writer::writeBlock(const Job& job)
+{
+    const bool records = job.recordSize != 0;
+    const uint8_t* data = job.data.data();
+    size_t size = job.data.size();
+    std::vector<uint8_t> header;
+
+#ifdef ASAM_CMP_HAS_ZLIB
+    if (compress)
+    {
+        // Transposing the records puts equal bytes of consecutive records next to each other
+        uint8_t zipType = zipDeflate;
+        uint32_t zipParameter = 0;
+        const uint8_t* input = job.data.data();
+        const size_t rows = job.recordSize != 0 ? job.data.size() / job.recordSize : 0;
+        if (job.recordSize > 1 && rows > 1)
+        {
+            zipType = zipTransposeDeflate;
+            zipParameter = static_cast<uint32_t>(job.recordSize);
+            transposed.resize(job.data.size());
+            for (size_t row = 0; row < rows; ++row)
+                for (size_t column = 0; column < job.recordSize; ++column)
+                    transposed[column * rows + row] = job.data[row * job.recordSize + column];
+            input = transposed.data();
+        }
+
+        uLongf compressedSize = compressBound(static_cast<uLong>(job.data.size()));
+        compressed.resize(compressedSize);
+        if (compress2(compressed.data(), &compressedSize, input, static_cast<uLong>(job.data.size()), Z_BEST_SPEED) == Z_OK &&
+            compressedSize < job.data.size())
+        {
+            BlockData zipData;
+            zipData.add(records ? "DT" : "SD", 2).add(zipType).zeros(1).add(zipParameter);
+            zipData.add<uint64_t>(job.data.size()).add<uint64_t>(compressedSize);
+            addBlockHeader(header, "##DZ", blockHeaderSize + zipData.data.size() + compressedSize, 0);
+            header.insert(header.end(), zipData.data.begin(), zipData.data.end());
+            data = compressed.data();
+            size = compressedSize;
+        }
+    }
+#endif
+
+    if (header.empty())
+        addBlockHeader(header, records ? "##DT" : "##SD", blockHeaderSize + size, 0);
+
+    static const uint8_t padding[8]{};
+    const uint64_t blockSize = header.size() + size;
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    file.write(reinterpret_cast<const char*>(padding), static_cast<std::streamsize>(padded(blockSize) - blockSize));
+    if (!file)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        error = "Cannot write MDF file " + options.path;
+        failed = true;
+        return;
+    }
+
+    job.blocks->push_back({fileEnd, job.data.size()});
+    fileEnd += padded(blockSize);
+}
+
+void Mdf4Writer::workerThread()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        jobReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty())
+            return;
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        lock.unlock();
+        if (!failed)
+            writeBlock(job);
+        lock.lock();
+
+        job.data.clear();
+        freeBuffers.push_back(std::move(job.data));
+        jobDone.notify_all();
+    }
+}
+
+void Mdf4Writer::stopWorker()
+{
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    thread.join();
+}
+
+void Mdf4Writer::checkError()
+{
+    if (!failed)
+        return;
+    std::lock_guard<std::mutex> lock(mutex);
+    throw std::runtime_error(error);
+}
+
+END_NAMESPACE_ASAM_CMP
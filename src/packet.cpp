@@ -3,6 +3,7 @@
 #include <asam_cmp/can_payload.h>
 #include <asam_cmp/capture_module_payload.h>
 #include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
 #include <asam_cmp/interface_payload.h>
 #include <asam_cmp/lin_payload.h>
 #include <asam_cmp/packet.h>
@@ -260,6 +261,11 @@ void Packet::setPayload(const Payload& newPayload)
     payload = std::make_unique<Payload>(newPayload);
 }
 
+void Packet::setPayload(Payload&& newPayload)
+{
+    payload = std::make_unique<Payload>(std::move(newPayload));
+}
+
 const Payload& Packet::getPayload() const
 {
     return *payload;
@@ -301,6 +307,10 @@ std::unique_ptr<Payload> Packet::create(const PayloadType type, const uint8_t* d
             if (EthernetPayload::isValidPayload(data, size))
                 return std::make_unique<EthernetPayload>(data, size);
             break;
+        case PayloadType::flexRay:
+            if (FlexRayPayload::isValidPayload(data, size))
+                return std::make_unique<FlexRayPayload>(data, size);
+            break;
         case PayloadType::cmStatMsg:
             if (CaptureModulePayload::isValidPayload(data, size))
                 return std::make_unique<CaptureModulePayload>(data, size);
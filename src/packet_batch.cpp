@@ -0,0 +1,291 @@
+#include <cstring>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/can_payload_base.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/packet_batch.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+void PacketBatch::clear()
+{
+    timestamps.clear();
+    interfaceIds.clear();
+    vendorIds.clear();
+    deviceIds.clear();
+    streamIds.clear();
+    versions.clear();
+    sequenceCounters.clear();
+    payloadTypes.clear();
+    commonFlags.clear();
+    payloadFlags.clear();
+    payloadOffsets.resize(1);
+    payloadArena.clear();
+
+    canIds.clear();
+    canDlcs.clear();
+    linPids.clear();
+    analogUnits.clear();
+}
+
+void PacketBatch::reserve(const size_t packetCount, const size_t payloadBytes)
+{
+    timestamps.reserve(packetCount);
+    interfaceIds.reserve(packetCount);
+    vendorIds.reserve(packetCount);
+    deviceIds.reserve(packetCount);
+    streamIds.reserve(packetCount);
+    versions.reserve(packetCount);
+    sequenceCounters.reserve(packetCount);
+    payloadTypes.reserve(packetCount);
+    commonFlags.reserve(packetCount);
+    payloadFlags.reserve(packetCount);
+    payloadOffsets.reserve(packetCount + 1);
+    payloadArena.reserve(payloadBytes);
+
+    canIds.reserve(packetCount);
+    canDlcs.reserve(packetCount);
+    linPids.reserve(packetCount);
+    analogUnits.reserve(packetCount);
+}
+
+size_t PacketBatch::size() const
+{
+    return timestamps.size();
+}
+
+bool PacketBatch::empty() const
+{
+    return timestamps.empty();
+}
+
+void PacketBatch::append(const Packet& packet)
+{
+    const auto& payload = packet.getPayload();
+    MessageHeader header;
+    header.setTimestamp(packet.getTimestamp());
+    header.setInterfaceId(packet.getInterfaceId());
+    header.setCommonFlags(packet.getCommonFlags());
+    header.setPayloadLength(static_cast<uint16_t>(payload.getLength()));
+
+    appendRow(packet.getVersion(),
+              packet.getDeviceId(),
+              packet.getStreamId(),
+              packet.getSequenceCounter(),
+              packet.getMessageType(),
+              header,
+              payload.getType(),
+              payload.getRawPayload());
+    // The packet keeps both ids regardless of its message type
+    interfaceIds.back() = packet.getInterfaceId();
+    vendorIds.back() = packet.getVendorId();
+}
+
+void PacketBatch::append(const uint8_t version,
+                         const uint16_t deviceId,
+                         const uint8_t streamId,
+                         const uint16_t sequenceCounter,
+                         const CmpHeader::MessageType messageType,
+                         const MessageHeader& header,
+                         const uint8_t* payload)
+{
+    appendRow(version, deviceId, streamId, sequenceCounter, messageType, header, PayloadType(messageType, header.getPayloadType()), payload);
+}
+
+Packet PacketBatch::getPacket(const size_t index) const
+{
+    const PayloadType type(payloadTypes[index]);
+    const size_t length = getPayloadLength(index);
+
+    std::vector<uint8_t> message(sizeof(MessageHeader) + length);
+    MessageHeader header;
+    header.setPayloadType(type.getRawPayloadType());
+    header.setPayloadLength(static_cast<uint16_t>(length));
+    memcpy(message.data(), &header, sizeof(header));
+    if (length != 0)
+        memcpy(message.data() + sizeof(header), getPayload(index), length);
+
+    Packet packet(type.getMessageType(), message.data(), message.size());
+    packet.setVersion(versions[index]);
+    packet.setDeviceId(deviceIds[index]);
+    packet.setStreamId(streamIds[index]);
+    packet.setSequenceCounter(sequenceCounters[index]);
+    packet.setTimestamp(timestamps[index]);
+    packet.setInterfaceId(interfaceIds[index]);
+    packet.setVendorId(vendorIds[index]);
+    packet.setCommonFlags(commonFlags[index]);
+    return packet;
+}
+
+const std::vector<uint64_t>& PacketBatch::getTimestamps() const
+{
+    return timestamps;
+}
+
+const std::vector<uint32_t>& PacketBatch::getInterfaceIds() const
+{
+    return interfaceIds;
+}
+
+const std::vector<uint16_t>& PacketBatch::getVendorIds() const
+{
+    return vendorIds;
+}
+
+const std::vector<uint16_t>& PacketBatch::getDeviceIds() const
+{
+    return deviceIds;
+}
+
+const std::vector<uint8_t>& PacketBatch::getStreamIds() const
+{
+    return streamIds;
+}
+
+const std::vector<uint8_t>& PacketBatch::getVersions() const
+{
+    return versions;
+}
+
+const std::vector<uint16_t>& PacketBatch::getSequenceCounters() const
+{
+    return sequenceCounters;
+}
+
+const std::vector<uint16_t>& PacketBatch::getPayloadTypes() const
+{
+    return payloadTypes;
+}
+
+const std::vector<uint8_t>& PacketBatch::getCommonFlags() const
+{
+    return commonFlags;
+}
+
+const std::vector<uint16_t>& PacketBatch::getPayloadFlags() const
+{
+    return payloadFlags;
+}
+
+const std::vector<uint64_t>& PacketBatch::getPayloadOffsets() const
+{
+    return payloadOffsets;
+}
+
+const std::vector<uint8_t>& PacketBatch::getPayloadArena() const
+{
+    return payloadArena;
+}
+
+const std::vector<uint32_t>& PacketBatch::getCanIds() const
+{
+    return canIds;
+}
+
+const std::vector<uint8_t>& PacketBatch::getCanDlcs() const
+{
+    return canDlcs;
+}
+
+const std::vector<uint8_t>& PacketBatch::getLinPids() const
+{
+    return linPids;
+}
+
+const std::vector<uint8_t>& PacketBatch::getAnalogUnits() const
+{
+    return analogUnits;
+}
+
+const uint8_t* PacketBatch::getPayload(const size_t index) const
+{
+    return payloadArena.data() + payloadOffsets[index];
+}
+
+size_t PacketBatch::getPayloadLength(const size_t index) const
+{
+    return static_cast<size_t>(payloadOffsets[index + 1] - payloadOffsets[index]);
+}
+
+void PacketBatch::appendRow(const uint8_t version,
+                            const uint16_t deviceId,
+                            const uint8_t streamId,
+                            const uint16_t sequenceCounter,
+                            const CmpHeader::MessageType messageType,
+                            const MessageHeader& header,
+                            const PayloadType type,
+                            const uint8_t* payload)
+{
+    const size_t length = header.getPayloadLength();
+
+    timestamps.push_back(header.getTimestamp());
+    interfaceIds.push_back(messageType == CmpHeader::MessageType::data ? header.getInterfaceId() : 0);
+    vendorIds.push_back(messageType == CmpHeader::MessageType::status || messageType == CmpHeader::MessageType::vendor ? header.getVendorId()
+                                                                                                                         : 0);
+    deviceIds.push_back(deviceId);
+    streamIds.push_back(streamId);
+    versions.push_back(version);
+    sequenceCounters.push_back(sequenceCounter);
+    payloadTypes.push_back(static_cast<uint16_t>(type.getType()));
+    commonFlags.push_back(header.getCommonFlags());
+    payloadArena.insert(payloadArena.end(), payload, payload + length);
+    payloadOffsets.push_back(payloadArena.size());
+
+    uint16_t flags = 0;
+    uint32_t canId = 0;
+    uint8_t canDlc = 0;
+    uint8_t linPid = 0;
+    uint8_t analogUnit = 0;
+    // Error frames fail Payload validation, their headers are still read for the flag columns
+    switch (type.getType())
+    {
+        case PayloadType::can:
+        case PayloadType::canFd:
+        {
+            if (length < sizeof(CanPayloadBase::Header))
+                break;
+            const auto canHeader = reinterpret_cast<const CanPayloadBase::Header*>(payload);
+            flags = canHeader->getFlags();
+            canId = canHeader->getId();
+            canDlc = canHeader->getDlc();
+            break;
+        }
+        case PayloadType::lin:
+        {
+            if (length < sizeof(LinPayload::Header))
+                break;
+            const auto linHeader = reinterpret_cast<const LinPayload::Header*>(payload);
+            flags = linHeader->getFlags();
+            linPid = static_cast<uint8_t>(linHeader->getLinId() | (linHeader->getParityBits() << 6));
+            break;
+        }
+        case PayloadType::analog:
+        {
+            if (length < sizeof(AnalogPayload::Header))
+                break;
+            const auto analogHeader = reinterpret_cast<const AnalogPayload::Header*>(payload);
+            flags = analogHeader->getFlags();
+            analogUnit = to_underlying(analogHeader->getUnit());
+            break;
+        }
+        case PayloadType::ethernet:
+            if (length >= sizeof(EthernetPayload::Header))
+                flags = reinterpret_cast<const EthernetPayload::Header*>(payload)->getFlags();
+            break;
+        case PayloadType::flexRay:
+            if (length >= sizeof(FlexRayPayload::Header))
+                flags = reinterpret_cast<const FlexRayPayload::Header*>(payload)->getFlags();
+            break;
+        default:
+            break;
+    }
+    payloadFlags.push_back(flags);
+    canIds.push_back(canId);
+    canDlcs.push_back(canDlc);
+    linPids.push_back(linPid);
+    analogUnits.push_back(analogUnit);
+}
+
+END_NAMESPACE_ASAM_CMP
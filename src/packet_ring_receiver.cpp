@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <asam_cmp/packet_ring_receiver.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr uint16_t cmpEtherType = 0x99FE;
+    constexpr size_t ethernetHeaderSize = 14;
+
+    std::string lastError()
+    {
+        return std::error_code(errno, std::generic_category()).message();
+    }
+
+    int getFanoutType(const PacketRingReceiver::FanoutMode mode)
+    {
+        switch (mode)
+        {
+            case PacketRingReceiver::FanoutMode::loadBalance:
+                return PACKET_FANOUT_LB;
+            case PacketRingReceiver::FanoutMode::cpu:
+                return PACKET_FANOUT_CPU;
+            default:
+                return PACKET_FANOUT_HASH;
+        }
+    }
+}
+
+PacketRingReceiver::PacketRingReceiver(Options newOptions, BatchHandler newHandler)
+    : options(std::move(newOptions))
+    , handler(std::move(newHandler))
+{
+    options.threadCount = std::max<size_t>(options.threadCount, 1);
+    options.blockCount = std::max<uint32_t>(options.blockCount, 1);
+    ringSize = static_cast<size_t>(options.blockSize) * options.blockCount;
+
+    int interfaceIndex = 0;
+    if (!options.interfaceName.empty())
+    {
+        interfaceIndex = static_cast<int>(if_nametoindex(options.interfaceName.c_str()));
+        if (interfaceIndex == 0)
+            throw std::runtime_error("Unknown network interface " + options.interfaceName);
+    }
+
+    // Without an id the first socket lets the kernel assign a free one, which may be 0 as well
+    uint16_t fanoutGroup = options.fanoutGroup;
+    const bool assignFanoutGroup = options.fanoutGroup == 0;
+
+    try
+    {
+        for (size_t index = 0; index < options.threadCount; ++index)
+        {
+            workers.push_back(std::make_unique<Worker>());
+            openSocket(*workers.back(), interfaceIndex, fanoutGroup, assignFanoutGroup && index == 0);
+        }
+    }
+    catch (...)
+    {
+        for (auto& worker : workers)
+            closeSocket(*worker);
+        throw;
+    }
+}
+
+PacketRingReceiver::~PacketRingReceiver()
+{
+    running = false;
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+        closeSocket(*worker);
+    }
+}
+
+void PacketRingReceiver::start()
+{
+    if (running)
+        return;
+
+    running = true;
+    for (size_t index = 0; index < workers.size(); ++index)
+        workers[index]->thread = std::thread(&PacketRingReceiver::receiveThread, this, index);
+}
+
+void PacketRingReceiver::stop()
+{
+    running = false;
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error.empty())
+    {
+        const auto message = std::move(error);
+        error.clear();
+        throw std::runtime_error(message);
+    }
+}
+
+PacketRingReceiver::Stats PacketRingReceiver::getStats() const
+{
+    Stats stats;
+    for (const auto& worker : workers)
+    {
+        stats.frames += worker->frames.load(std::memory_order_relaxed);
+        stats.bytes += worker->bytes.load(std::memory_order_relaxed);
+        stats.packets += worker->packets.load(std::memory_order_relaxed);
+        stats.blocks += worker->blocks.load(std::memory_order_relaxed);
+        stats.truncated += worker->truncated.load(std::memory_order_relaxed);
+        stats.drops += worker->drops.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void PacketRingReceiver::openSocket(Worker& worker, const int interfaceIndex, uint16_t& fanoutGroup, const bool assignFanoutGroup)
+{
+    worker.fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(cmpEtherType));
+    if (worker.fd < 0)
+        throw std::runtime_error("Cannot create packet socket: " + lastError());
+
+    auto setOption = [&worker](const int name, const void* value, const socklen_t size, const char* description)
+    {
+        if (setsockopt(worker.fd, SOL_PACKET, name, value, size) != 0)
+            throw std::runtime_error(std::string("Cannot set ") + description + ": " + lastError());
+    };
+
+    const int version = TPACKET_V3;
+    setOption(PACKET_VERSION, &version, sizeof(version), "PACKET_VERSION");
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // Kernels before 4.20 do not know the option, their outgoing frames are skipped while decoding
+    if (options.ignoreOutgoing)
+    {
+        const int ignore = 1;
+        setsockopt(worker.fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore, sizeof(ignore));
+    }
+#endif
+
+    tpacket_req3 request{};
+    request.tp_block_size = options.blockSize;
+    request.tp_block_nr = options.blockCount;
+    request.tp_frame_size = options.frameSize;
+    request.tp_frame_nr = static_cast<unsigned int>(ringSize / options.frameSize);
+    request.tp_retire_blk_tov = options.blockTimeout;
+    setOption(PACKET_RX_RING, &request, sizeof(request), "PACKET_RX_RING");
+
+    void* ring = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_LOCKED, worker.fd, 0);
+    if (ring == MAP_FAILED)
+    {
+        // Locking needs RLIMIT_MEMLOCK, the ring works without it
+        ring = mmap(nullptr, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, worker.fd, 0);
+        if (ring == MAP_FAILED)
+            throw std::runtime_error("Cannot map packet ring: " + lastError());
+    }
+    worker.ring = static_cast<uint8_t*>(ring);
+
+    sockaddr_ll address{};
+    address.sll_family = AF_PACKET;
+    address.sll_protocol = htons(cmpEtherType);
+    address.sll_ifindex = interfaceIndex;
+    if (bind(worker.fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        throw std::runtime_error("Cannot bind packet socket: " + lastError());
+
+    if (options.threadCount > 1)
+    {
+        const int flags = assignFanoutGroup ? PACKET_FANOUT_FLAG_UNIQUEID : 0;
+        const int fanout = fanoutGroup | ((getFanoutType(options.fanoutMode) | flags) << 16);
+        setOption(PACKET_FANOUT, &fanout, sizeof(fanout), "PACKET_FANOUT");
+
+        if (assignFanoutGroup)
+        {
+            // The other sockets join the group with the id the kernel assigned
+            int assigned = 0;
+            socklen_t size = sizeof(assigned);
+            if (getsockopt(worker.fd, SOL_PACKET, PACKET_FANOUT, &assigned, &size) != 0)
+                throw std::runtime_error("Cannot get PACKET_FANOUT: " + lastError());
+            fanoutGroup = static_cast<uint16_t>(assigned & 0xFFFF);
+        }
+    }
+}
+
+void PacketRingReceiver::closeSocket(Worker& worker)
+{
+    if (worker.ring != nullptr)
+        munmap(worker.ring, ringSize);
+    if (worker.fd >= 0)
+        close(worker.fd);
+    worker.ring = nullptr;
+    worker.fd = -1;
+}
+
+void PacketRingReceiver::receiveThread(const size_t threadIndex)
+{
+    auto& worker = *workers[threadIndex];
+    Decoder decoder;
+    Batch batch;
+    batch.threadIndex = threadIndex;
+    pollfd descriptor{worker.fd, POLLIN | POLLERR, 0};
+    uint32_t blockIndex = 0;
+
+    try
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            auto* block = reinterpret_cast<tpacket_block_desc*>(worker.ring + static_cast<size_t>(blockIndex) * options.blockSize);
+            auto& status = block->hdr.bh1.block_status;
+            if ((__atomic_load_n(&status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) == 0)
+            {
+                const int ready = poll(&descriptor, 1, options.pollTimeout);
+                if (ready < 0 && errno != EINTR)
+                    throw std::runtime_error("Cannot poll packet socket: " + lastError());
+                continue;
+            }
+
+            decodeBlock(reinterpret_cast<const uint8_t*>(block), decoder, batch, worker);
+            if (!batch.packets.empty())
+                handler(batch);
+
+            // The frames of the batch were copied by the decoder, so the block can go back to the kernel
+            __atomic_store_n(&status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            blockIndex = (blockIndex + 1) % options.blockCount;
+
+            tpacket_stats_v3 kernelStats{};
+            socklen_t length = sizeof(kernelStats);
+            if (getsockopt(worker.fd, SOL_PACKET, PACKET_STATISTICS, &kernelStats, &length) == 0)
+                worker.drops.fetch_add(kernelStats.tp_drops, std::memory_order_relaxed);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        setError(e.what());
+    }
+}
+
+void PacketRingReceiver::decodeBlock(const uint8_t* block, Decoder& decoder, Batch& batch, Worker& worker)
+{
+    const auto& header = reinterpret_cast<const tpacket_block_desc*>(block)->hdr.bh1;
+    batch.packets.clear();
+    batch.receiveTimes.clear();
+
+    uint64_t bytes = 0;
+    uint64_t truncated = 0;
+    const uint8_t* frame = block + header.offset_to_first_pkt;
+    for (uint32_t index = 0; index < header.num_pkts; ++index)
+    {
+        const auto* frameHeader = reinterpret_cast<const tpacket3_hdr*>(frame);
+        // The link layer address follows the aligned frame header
+        const auto* linkAddress = reinterpret_cast<const sockaddr_ll*>(frame + TPACKET_ALIGN(sizeof(tpacket3_hdr)));
+        const bool skipped = options.ignoreOutgoing && linkAddress->sll_pkttype == PACKET_OUTGOING;
+        if (!skipped && frameHeader->tp_snaplen < frameHeader->tp_len)
+        {
+            ++truncated;
+        }
+        else if (!skipped && frameHeader->tp_snaplen > ethernetHeaderSize)
+        {
+            // VLAN tags are removed by the kernel, the EtherType follows the MAC addresses
+            bytes += frameHeader->tp_snaplen;
+            decoder.decode(frame + frameHeader->tp_mac + ethernetHeaderSize, frameHeader->tp_snaplen - ethernetHeaderSize, batch.packets);
+            const uint64_t receiveTime = static_cast<uint64_t>(frameHeader->tp_sec) * 1000000000 + frameHeader->tp_nsec;
+            batch.receiveTimes.resize(batch.packets.size(), receiveTime);
+        }
+        frame += frameHeader->tp_next_offset;
+    }
+
+    worker.frames.fetch_add(header.num_pkts, std::memory_order_relaxed);
+    worker.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    worker.packets.fetch_add(batch.packets.size(), std::memory_order_relaxed);
+    worker.blocks.fetch_add(1, std::memory_order_relaxed);
+    worker.truncated.fetch_add(truncated, std::memory_order_relaxed);
+}
+
+void PacketRingReceiver::setError(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error.empty())
+        error = message;
+}
+
+END_NAMESPACE_ASAM_CMP
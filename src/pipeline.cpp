@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <asam_cmp/pipeline.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    uint64_t now()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void updateMax(std::atomic<uint64_t>& max, const uint64_t value)
+    {
+        uint64_t current = max.load(std::memory_order_relaxed);
+        while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void addTime(std::atomic<uint64_t>& sum, std::atomic<uint64_t>& max, const uint64_t value)
+    {
+        sum.fetch_add(value, std::memory_order_relaxed);
+        updateMax(max, value);
+    }
+}
+
+void Pipeline::Batch::addFrame(const void* data, const size_t size)
+{
+    const auto bytes = static_cast<const uint8_t*>(data);
+    frameData.insert(frameData.end(), bytes, bytes + size);
+    frameEnds.push_back(frameData.size());
+}
+
+void Pipeline::Batch::selectAll()
+{
+    selection.resize(packets.size());
+    for (size_t index = 0; index < selection.size(); ++index)
+        selection[index] = static_cast<uint32_t>(index);
+}
+
+void Pipeline::Batch::clear()
+{
+    frameData.clear();
+    frameEnds.clear();
+    packets.clear();
+    selection.clear();
+    sequence = 0;
+    pushTime = 0;
+    enqueueTime = 0;
+}
+
+Pipeline::Stage::Stage(const StageOptions& newOptions, Handler newHandler)
+    : options(newOptions)
+    , handler(std::move(newHandler))
+    , queue(newOptions.queueCapacity)
+{
+    options.threadCount = std::max<size_t>(options.threadCount, 1);
+}
+
+Pipeline::Pipeline()
+    : Pipeline(Options{})
+{
+}
+
+Pipeline::Pipeline(Options newOptions)
+    : options(newOptions)
+    , freeBatches(newOptions.poolSize)
+{
+}
+
+Pipeline::~Pipeline()
+{
+    try
+    {
+        stop();
+    }
+    catch (...)
+    {
+    }
+}
+
+size_t Pipeline::addStage(const StageOptions& stageOptions, StageHandler handler)
+{
+    return addInternalStage(stageOptions, [handler = std::move(handler)](Batch& batch, const size_t) { handler(batch); });
+}
+
+size_t Pipeline::addDecodeStage(const StageOptions& stageOptions)
+{
+    auto decoders = std::vector<Decoder>(std::max<size_t>(stageOptions.threadCount, 1));
+    return addInternalStage(stageOptions,
+                            [decoders = std::move(decoders)](Batch& batch, const size_t threadIndex) mutable
+                            {
+                                Decoder& decoder = decoders[threadIndex];
+                                batch.packets.clear();
+                                size_t begin = 0;
+                                for (const auto end : batch.frameEnds)
+                                {
+                                    decoder.decode(batch.frameData.data() + begin, end - begin, batch.packets);
+                                    begin = end;
+                                }
+                                batch.selectAll();
+                            });
+}
+
+size_t Pipeline::addFilterStage(const StageOptions& stageOptions, PacketFilter filter)
+{
+    return addInternalStage(stageOptions,
+                            [filter = std::move(filter)](Batch& batch, const size_t)
+                            {
+                                auto& selection = batch.selection;
+                                const auto removed = std::remove_if(selection.begin(),
+                                                                    selection.end(),
+                                                                    [&batch, &filter](const uint32_t index)
+                                                                    { return !filter(batch.packets, index); });
+                                selection.erase(removed, selection.end());
+                            });
+}
+
+size_t Pipeline::addPayloadStage(const StageOptions& stageOptions, const PayloadType type, PacketHandler handler)
+{
+    const auto rawType = static_cast<uint16_t>(type.getType());
+    return addInternalStage(stageOptions,
+                            [rawType, handler = std::move(handler)](Batch& batch, const size_t)
+                            {
+                                const auto& payloadTypes = batch.packets.getPayloadTypes();
+                                for (const auto index : batch.selection)
+                                {
+                                    if (payloadTypes[index] == rawType)
+                                        handler(batch.packets, index);
+                                }
+                            });
+}
+
+size_t Pipeline::getStageCount() const
+{
+    return stages.size();
+}
+
+void Pipeline::start()
+{
+    if (running)
+        return;
+    if (stages.empty())
+        throw std::runtime_error("Pipeline has no stages");
+
+    for (size_t stageIndex = 0; stageIndex < stages.size(); ++stageIndex)
+    {
+        Stage& stage = *stages[stageIndex];
+        stage.closed = false;
+        stage.activeThreads = stage.options.threadCount;
+        for (size_t threadIndex = 0; threadIndex < stage.options.threadCount; ++threadIndex)
+            stage.threads.emplace_back(&Pipeline::stageThread, this, stageIndex, threadIndex);
+    }
+    running = true;
+}
+
+void Pipeline::stop()
+{
+    if (running.exchange(false))
+    {
+        // Every stage drains its queue and closes the next one when its last thread exits
+        stages.front()->closed.store(true, std::memory_order_release);
+        for (auto& stage : stages)
+        {
+            for (auto& thread : stage->threads)
+                thread.join();
+            stage->threads.clear();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error.empty())
+    {
+        const auto message = std::move(error);
+        error.clear();
+        throw std::runtime_error(message);
+    }
+}
+
+bool Pipeline::isRunning() const
+{
+    return running;
+}
+
+Pipeline::BatchPtr Pipeline::acquireBatch()
+{
+    BatchPtr batch;
+    if (!freeBatches.tryPop(batch))
+        batch = std::make_unique<Batch>();
+    return batch;
+}
+
+bool Pipeline::push(BatchPtr batch)
+{
+    if (!running)
+        throw std::runtime_error("Pipeline is not running");
+
+    batch->sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    batch->pushTime = now();
+    return enqueue(*stages.front(), batch);
+}
+
+std::vector<Pipeline::StageStats> Pipeline::getStats() const
+{
+    std::vector<StageStats> result;
+    for (const auto& stage : stages)
+    {
+        StageStats& stats = result.emplace_back();
+        stats.name = stage->options.name;
+        stats.batches = stage->batches.load(std::memory_order_relaxed);
+        stats.packets = stage->packets.load(std::memory_order_relaxed);
+        stats.droppedBatches = stage->droppedBatches.load(std::memory_order_relaxed);
+        stats.errors = stage->errors.load(std::memory_order_relaxed);
+        stats.queueTime = stage->queueTime.load(std::memory_order_relaxed);
+        stats.maxQueueTime = stage->maxQueueTime.load(std::memory_order_relaxed);
+        stats.processingTime = stage->processingTime.load(std::memory_order_relaxed);
+        stats.maxProcessingTime = stage->maxProcessingTime.load(std::memory_order_relaxed);
+        stats.latency = stage->latency.load(std::memory_order_relaxed);
+        stats.maxLatency = stage->maxLatency.load(std::memory_order_relaxed);
+        stats.queueSize = stage->queue.size();
+    }
+    return result;
+}
+
+size_t Pipeline::addInternalStage(const StageOptions& stageOptions, Handler handler)
+{
+    if (running)
+        throw std::runtime_error("Stages cannot be added to a running pipeline");
+
+    stages.push_back(std::make_unique<Stage>(stageOptions, std::move(handler)));
+    return stages.size() - 1;
+}
+
+void Pipeline::stageThread(const size_t stageIndex, const size_t threadIndex)
+{
+    Stage& stage = *stages[stageIndex];
+    Stage* nextStage = stageIndex + 1 < stages.size() ? stages[stageIndex + 1].get() : nullptr;
+    BatchPtr batch;
+    unsigned attempts = 0;
+
+    while (true)
+    {
+        // Read before the pop: once the stage is closed nothing is pushed anymore, so an empty queue stays empty
+        const bool closed = stage.closed.load(std::memory_order_acquire);
+        if (!stage.queue.tryPop(batch))
+        {
+            if (closed)
+                break;
+            idle(attempts);
+            continue;
+        }
+        attempts = 0;
+
+        const uint64_t startTime = now();
+        bool failed = false;
+        try
+        {
+            stage.handler(*batch, threadIndex);
+        }
+        catch (const std::exception& e)
+        {
+            failed = true;
+            setError(stage.options.name + ": " + e.what());
+        }
+        catch (...)
+        {
+            failed = true;
+            setError(stage.options.name + ": unknown error");
+        }
+        const uint64_t endTime = now();
+
+        addTime(stage.queueTime, stage.maxQueueTime, startTime - batch->enqueueTime);
+        addTime(stage.processingTime, stage.maxProcessingTime, endTime - startTime);
+        addTime(stage.latency, stage.maxLatency, endTime - batch->pushTime);
+        stage.batches.fetch_add(1, std::memory_order_relaxed);
+        stage.packets.fetch_add(batch->selection.size(), std::memory_order_relaxed);
+
+        if (failed)
+        {
+            stage.errors.fetch_add(1, std::memory_order_relaxed);
+            recycle(batch);
+        }
+        else if (nextStage != nullptr)
+        {
+            enqueue(*nextStage, batch);
+        }
+        else
+        {
+            recycle(batch);
+        }
+    }
+
+    if (stage.activeThreads.fetch_sub(1, std::memory_order_acq_rel) == 1 && nextStage != nullptr)
+        nextStage->closed.store(true, std::memory_order_release);
+}
+
+bool Pipeline::enqueue(Stage& stage, BatchPtr& batch)
+{
+    batch->enqueueTime = now();
+    unsigned attempts = 0;
+    while (!stage.queue.tryPush(batch))
+    {
+        switch (stage.options.dropPolicy)
+        {
+            case DropPolicy::dropNewest:
+                stage.droppedBatches.fetch_add(1, std::memory_order_relaxed);
+                recycle(batch);
+                return false;
+            case DropPolicy::dropOldest:
+            {
+                // The stage threads may take the oldest batch first, then the push succeeds without dropping
+                BatchPtr oldest;
+                if (stage.queue.tryPop(oldest))
+                {
+                    stage.droppedBatches.fetch_add(1, std::memory_order_relaxed);
+                    recycle(oldest);
+                }
+                break;
+            }
+            default:
+                idle(attempts);
+                break;
+        }
+    }
+    return true;
+}
+
+void Pipeline::recycle(BatchPtr& batch)
+{
+    // The pool keeps the capacity of the batch, a full pool frees it
+    batch->clear();
+    freeBatches.tryPush(batch);
+    batch.reset();
+}
+
+void Pipeline::idle(unsigned& attempts) const
+{
+    if (++attempts <= options.spinCount)
+        std::this_thread::yield();
+    else
+        std::this_thread::sleep_for(std::chrono::nanoseconds(options.idleSleep));
+}
+
+void Pipeline::setError(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error.empty())
+        error = message;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,92 @@
+#include <asam_cmp/protocol_decoder.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+ProtocolDecoder::ProtocolDecoder(const TECMP::Converter::Options& tecmpOptions)
+    : tecmpDecoder(tecmpOptions)
+{
+}
+
+ProtocolDecoder::Protocol ProtocolDecoder::classify(const void* data, const std::size_t size)
+{
+    if (data == nullptr || size < sizeof(CmpHeader))
+        return Protocol::unknown;
+
+    // A CMP frame starts with its non-zero version, the first byte of a TECMP frame is always zero
+    const auto dataPtr = reinterpret_cast<const uint8_t*>(data);
+    if (*dataPtr != 0x00)
+    {
+        if (*dataPtr != cmpVersion)
+            return Protocol::unknown;
+        switch (reinterpret_cast<const CmpHeader*>(data)->getMessageType())
+        {
+            case CmpHeader::MessageType::data:
+            case CmpHeader::MessageType::control:
+            case CmpHeader::MessageType::status:
+            case CmpHeader::MessageType::vendor:
+                return Protocol::cmp;
+            case CmpHeader::MessageType::undefined:
+            default:
+                return Protocol::unknown;
+        }
+    }
+
+    if (size < sizeof(TECMP::CmpHeader))
+        return Protocol::unknown;
+    // Zero filled data would pass as a TECMP control message, a TECMP version is required as well
+    const auto tecmpHeader = reinterpret_cast<const TECMP::CmpHeader*>(data);
+    return (tecmpHeader->isValid() && tecmpHeader->getVersion() != 0) ? Protocol::tecmp : Protocol::unknown;
+}
+
+const std::vector<Packet>& ProtocolDecoder::decode(const void* data, const std::size_t size)
+{
+    lastProtocol = classify(data, size);
+    auto& protocolStats = stats[to_underlying(lastProtocol)];
+    ++protocolStats.frames;
+    protocolStats.bytes += size;
+
+    packets.clear();
+    switch (lastProtocol)
+    {
+        case Protocol::cmp:
+            cmpDecoder.decode(data, size, packets);
+            break;
+        case Protocol::tecmp:
+        {
+            const auto& tecmpPackets = tecmpDecoder.decode(data, size);
+            protocolStats.packets += tecmpPackets.size();
+            return tecmpPackets;
+        }
+        case Protocol::unknown:
+            break;
+    }
+
+    protocolStats.packets += packets.size();
+    return packets;
+}
+
+void ProtocolDecoder::reset()
+{
+    cmpDecoder = Decoder();
+    tecmpDecoder.reset();
+    lastProtocol = Protocol::unknown;
+    stats = {};
+    packets.clear();
+}
+
+ProtocolDecoder::Protocol ProtocolDecoder::getLastProtocol() const
+{
+    return lastProtocol;
+}
+
+const ProtocolDecoder::Stats& ProtocolDecoder::getStats(const Protocol protocol) const
+{
+    return stats[to_underlying(protocol)];
+}
+
+const TECMP::Decoder& ProtocolDecoder::getTecmpDecoder() const
+{
+    return tecmpDecoder;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <thread>
+
+#include <asam_cmp/capture_file_reader.h>
+#include <asam_cmp/protocol_decoder.h>
+#include <asam_cmp/replay_engine.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    // Longest single sleep, so that stop is noticed during long pauses of the recording
+    constexpr std::chrono::milliseconds maxSleep{100};
+}
+
+void ReplayEngine::JitterHistogram::add(const int64_t jitter)
+{
+    const auto bucket = static_cast<size_t>(std::abs(jitter) / resolution);
+    ++buckets[std::min(bucket, bucketCount)];
+
+    min = count == 0 ? jitter : std::min(min, jitter);
+    max = count == 0 ? jitter : std::max(max, jitter);
+    sum += static_cast<double>(jitter);
+    squareSum += static_cast<double>(jitter) * static_cast<double>(jitter);
+    ++count;
+}
+
+void ReplayEngine::JitterHistogram::fill(Stats& stats) const
+{
+    if (count == 0)
+        return;
+
+    stats.minJitter = min;
+    stats.maxJitter = max;
+    stats.meanJitter = sum / static_cast<double>(count);
+    stats.jitterStandardDeviation = std::sqrt(std::max(squareSum / static_cast<double>(count) - stats.meanJitter * stats.meanJitter, 0.0));
+
+    auto percentile = [this](const double fraction)
+    {
+        const auto rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+        {
+            seen += buckets[bucket];
+            if (seen >= rank)
+                return static_cast<int64_t>(bucket + 1) * resolution;
+        }
+        return std::max(std::abs(min), std::abs(max));
+    };
+    stats.p50Jitter = percentile(0.5);
+    stats.p99Jitter = percentile(0.99);
+    stats.p999Jitter = percentile(0.999);
+}
+
+ReplayEngine::ReplayEngine()
+    : ReplayEngine(Options{})
+{
+}
+
+ReplayEngine::ReplayEngine(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.maxBatchPackets = std::max<size_t>(options.maxBatchPackets, 1);
+    if (!(options.speed > 0))
+        options.speed = 0;
+}
+
+void ReplayEngine::addPacket(const Packet& packet)
+{
+    packets.push_back(packet);
+}
+
+void ReplayEngine::addPackets(const std::vector<std::shared_ptr<Packet>>& newPackets)
+{
+    packets.reserve(packets.size() + newPackets.size());
+    for (const auto& packet : newPackets)
+        packets.push_back(*packet);
+}
+
+size_t ReplayEngine::loadCapture(const std::string& path)
+{
+    CaptureFileReader reader(path);
+    ProtocolDecoder decoder;
+    return reader.decode(decoder, [this](const Packet& packet) { packets.push_back(packet); });
+}
+
+size_t ReplayEngine::getPacketCount() const
+{
+    return packets.size();
+}
+
+void ReplayEngine::clear()
+{
+    packets.clear();
+    encoders.clear();
+}
+
+void ReplayEngine::run(const FrameSink& sink)
+{
+    stopping = false;
+    stats = {};
+    if (packets.empty())
+        return;
+
+    auto byTimestamp = [](const Packet& lhs, const Packet& rhs) { return lhs.getTimestamp() < rhs.getTimestamp(); };
+    if (!std::is_sorted(packets.begin(), packets.end(), byTimestamp))
+        std::stable_sort(packets.begin(), packets.end(), byTimestamp);
+    for (auto& encoder : encoders)
+        encoder.second.restart();
+
+    JitterHistogram histogram;
+    firstTimestamp = packets.front().getTimestamp();
+    startTime = Clock::now();
+
+    for (size_t begin = 0; begin < packets.size() && !stopping;)
+    {
+        const size_t end = getBatchEnd(begin);
+        encodeBatch(begin, end);
+
+        if (options.speed > 0)
+        {
+            waitUntil(getDueTime(packets[begin]));
+            if (stopping)
+                break;
+        }
+
+        const auto emitTime = Clock::now();
+        sink(frames);
+
+        if (options.speed > 0)
+        {
+            for (size_t index = begin; index < end; ++index)
+                histogram.add(std::chrono::duration_cast<std::chrono::nanoseconds>(emitTime - getDueTime(packets[index])).count());
+        }
+        stats.packets += end - begin;
+        stats.frames += frames.size();
+        ++stats.batches;
+        begin = end;
+    }
+
+    stats.duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime).count());
+    histogram.fill(stats);
+}
+
+void ReplayEngine::stop()
+{
+    stopping = true;
+}
+
+const ReplayEngine::Stats& ReplayEngine::getStats() const
+{
+    return stats;
+}
+
+size_t ReplayEngine::getBatchEnd(const size_t begin) const
+{
+    // The batch window is given in replay time, packets are compared in recording time
+    const uint64_t first = packets[begin].getTimestamp();
+    uint64_t last = UINT64_MAX;
+    if (options.speed > 0)
+    {
+        const auto window = static_cast<uint64_t>(static_cast<double>(options.batchWindow) * options.speed);
+        last = first + std::min(window, UINT64_MAX - first);
+    }
+
+    size_t end = begin + 1;
+    while (end < packets.size() && end - begin < options.maxBatchPackets && packets[end].getTimestamp() <= last)
+        ++end;
+    return end;
+}
+
+void ReplayEngine::encodeBatch(const size_t begin, const size_t end)
+{
+    frames.clear();
+
+    // Consecutive packets of the same stream are encoded together, so they can share CMP frames
+    for (size_t runBegin = begin; runBegin < end;)
+    {
+        const auto deviceId = packets[runBegin].getDeviceId();
+        const auto streamId = packets[runBegin].getStreamId();
+        size_t runEnd = runBegin + 1;
+        while (runEnd < end && packets[runEnd].getDeviceId() == deviceId && packets[runEnd].getStreamId() == streamId)
+            ++runEnd;
+
+        auto encoded = getEncoder(packets[runBegin]).encode(packets.begin() + runBegin, packets.begin() + runEnd, options.dataContext);
+        std::move(encoded.begin(), encoded.end(), std::back_inserter(frames));
+        runBegin = runEnd;
+    }
+}
+
+Encoder& ReplayEngine::getEncoder(const Packet& packet)
+{
+    const uint32_t key = (static_cast<uint32_t>(packet.getDeviceId()) << 8) | packet.getStreamId();
+    auto inserted = encoders.try_emplace(key);
+    if (inserted.second)
+    {
+        inserted.first->second.setDeviceId(packet.getDeviceId());
+        inserted.first->second.setStreamId(packet.getStreamId());
+    }
+    return inserted.first->second;
+}
+
+ReplayEngine::Clock::time_point ReplayEngine::getDueTime(const Packet& packet) const
+{
+    const double offset = static_cast<double>(packet.getTimestamp() - firstTimestamp) / options.speed;
+    return startTime + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::nano>(offset));
+}
+
+void ReplayEngine::waitUntil(const Clock::time_point dueTime) const
+{
+    const auto spinThreshold = std::chrono::nanoseconds(options.spinThreshold);
+    while (!stopping)
+    {
+        const auto now = Clock::now();
+        if (now >= dueTime)
+            return;
+
+        // Sleeping wakes up too late by up to the timer slack, the last part of the wait is spent busy-waiting
+        const auto remaining = dueTime - now;
+        if (remaining > spinThreshold)
+            std::this_thread::sleep_for(std::min<Clock::duration>(remaining - spinThreshold, maxSleep));
+    }
+}
+
+END_NAMESPACE_ASAM_CMP
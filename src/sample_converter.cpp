@@ -0,0 +1,880 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <initializer_list>
+
+#include <asam_cmp/sample_converter.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || (defined(__i386__) && defined(__SSE2__))
+    #define ASAM_CMP_X86_SIMD
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define ASAM_CMP_TARGET_AVX2
+    #else
+        #define ASAM_CMP_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    #define ASAM_CMP_NEON_SIMD
+    #include <arm_neon.h>
+    #if defined(__aarch64__) || defined(_M_ARM64)
+        #define ASAM_CMP_NEON_DOUBLE
+    #endif
+#endif
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    using InstructionSet = SampleConverter::InstructionSet;
+    using MinMaxSum = SampleConverter::MinMaxSum;
+    using MinMaxSumKernel = void (*)(const uint8_t*, const size_t, int32_t&, int32_t&, int64_t&);
+
+    template <typename Raw>
+    inline Raw loadBigEndian(const uint8_t* src)
+    {
+        Raw value;
+        memcpy(&value, src, sizeof(Raw));
+        return static_cast<Raw>(swapEndian(static_cast<std::make_unsigned_t<Raw>>(value)));
+    }
+
+    template <typename Raw, typename Real>
+    void toRealScalar(const uint8_t* src, const size_t count, const Real scalar, const Real offset, Real* dst)
+    {
+        for (size_t i = 0; i < count; ++i)
+            dst[i] = static_cast<Real>(loadBigEndian<Raw>(src + i * sizeof(Raw))) * scalar + offset;
+    }
+
+    template <typename Raw>
+    void toBigEndianScalar(const Raw* src, const size_t count, uint8_t* dst)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto value = swapEndian(static_cast<std::make_unsigned_t<Raw>>(src[i]));
+            memcpy(dst + i * sizeof(Raw), &value, sizeof(Raw));
+        }
+    }
+
+    template <typename Raw>
+    void minMaxSumScalar(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int32_t value = loadBigEndian<Raw>(src + i * sizeof(Raw));
+            min = value < min ? value : min;
+            max = value > max ? value : max;
+            sum += value;
+        }
+    }
+
+    inline void foldMinMax(const int32_t laneMin, const int32_t laneMax, int32_t& min, int32_t& max)
+    {
+        min = laneMin < min ? laneMin : min;
+        max = laneMax > max ? laneMax : max;
+    }
+
+    // The kernels reduce their lanes in registers, so even buckets of a single vector benefit from them
+    template <typename Raw, MinMaxSumKernel kernel>
+    void minMaxSumBuckets(const uint8_t* src, const size_t count, const size_t bucketSize, MinMaxSum* dst)
+    {
+        for (size_t pos = 0; pos < count; pos += bucketSize, ++dst)
+        {
+            *dst = MinMaxSum{};
+            kernel(src + pos * sizeof(Raw), std::min(bucketSize, count - pos), dst->min, dst->max, dst->sum);
+        }
+    }
+
+#ifdef ASAM_CMP_X86_SIMD
+
+    inline __m128i swapBytes16Sse2(const __m128i value)
+    {
+        return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+    }
+
+    inline __m128i swapBytes32Sse2(const __m128i value)
+    {
+        const __m128i swapped = swapBytes16Sse2(value);
+        return _mm_or_si128(_mm_slli_epi32(swapped, 16), _mm_srli_epi32(swapped, 16));
+    }
+
+    void int16ToFloatSse2(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const __m128 vScalar = _mm_set1_ps(scalar);
+        const __m128 vOffset = _mm_set1_ps(offset);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i raw = swapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int16_t))));
+            const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+            const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), vScalar), vOffset));
+            _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), vScalar), vOffset));
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    void int32ToFloatSse2(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const __m128 vScalar = _mm_set1_ps(scalar);
+        const __m128 vOffset = _mm_set1_ps(offset);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i raw = swapBytes32Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int32_t))));
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(raw), vScalar), vOffset));
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+
+    inline void storeInt32AsDoubleSse2(const __m128i raw, const __m128d vScalar, const __m128d vOffset, double* dst)
+    {
+        _mm_storeu_pd(dst, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(raw), vScalar), vOffset));
+        _mm_storeu_pd(dst + 2, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(_mm_srli_si128(raw, 8)), vScalar), vOffset));
+    }
+
+    void int16ToDoubleSse2(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const __m128d vScalar = _mm_set1_pd(scalar);
+        const __m128d vOffset = _mm_set1_pd(offset);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i raw = swapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int16_t))));
+            storeInt32AsDoubleSse2(_mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16), vScalar, vOffset, dst + i);
+            storeInt32AsDoubleSse2(_mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16), vScalar, vOffset, dst + i + 4);
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    void int32ToDoubleSse2(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const __m128d vScalar = _mm_set1_pd(scalar);
+        const __m128d vOffset = _mm_set1_pd(offset);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i raw = swapBytes32Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int32_t))));
+            storeInt32AsDoubleSse2(raw, vScalar, vOffset, dst + i);
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+
+    void int16ToBigEndianSse2(const int16_t* src, const size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * sizeof(int16_t)), swapBytes16Sse2(raw));
+        }
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int16_t));
+    }
+
+    void int32ToBigEndianSse2(const int32_t* src, const size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * sizeof(int32_t)), swapBytes32Sse2(raw));
+        }
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int32_t));
+    }
+
+    inline __m128i signExtendLo32To64Sse2(const __m128i value)
+    {
+        return _mm_unpacklo_epi32(value, _mm_srai_epi32(value, 31));
+    }
+
+    inline __m128i signExtendHi32To64Sse2(const __m128i value)
+    {
+        return _mm_unpackhi_epi32(value, _mm_srai_epi32(value, 31));
+    }
+
+    inline int64_t horizontalSum64Sse2(const __m128i value)
+    {
+        int64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), value);
+        return lanes[0] + lanes[1];
+    }
+
+    inline int32_t horizontalMin16Sse2(__m128i value)
+    {
+        value = _mm_min_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+        value = _mm_min_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_min_epi16(value, _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<int16_t>(_mm_cvtsi128_si32(value));
+    }
+
+    inline int32_t horizontalMax16Sse2(__m128i value)
+    {
+        value = _mm_max_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+        value = _mm_max_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        value = _mm_max_epi16(value, _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<int16_t>(_mm_cvtsi128_si32(value));
+    }
+
+    // SSE2 has no 32-bit min/max, select with comparison masks instead
+    inline __m128i min32Sse2(const __m128i lhs, const __m128i rhs)
+    {
+        const __m128i less = _mm_cmplt_epi32(lhs, rhs);
+        return _mm_or_si128(_mm_and_si128(less, lhs), _mm_andnot_si128(less, rhs));
+    }
+
+    inline __m128i max32Sse2(const __m128i lhs, const __m128i rhs)
+    {
+        const __m128i greater = _mm_cmpgt_epi32(lhs, rhs);
+        return _mm_or_si128(_mm_and_si128(greater, lhs), _mm_andnot_si128(greater, rhs));
+    }
+
+    inline int32_t horizontalMin32Sse2(__m128i value)
+    {
+        value = min32Sse2(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+        value = min32Sse2(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(value);
+    }
+
+    inline int32_t horizontalMax32Sse2(__m128i value)
+    {
+        value = max32Sse2(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+        value = max32Sse2(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(value);
+    }
+
+    void int16MinMaxSumSse2(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 8)
+        {
+            minMaxSumScalar<int16_t>(src, count, min, max, sum);
+            return;
+        }
+
+        const __m128i ones = _mm_set1_epi16(1);
+        __m128i vMin = _mm_set1_epi16(INT16_MAX);
+        __m128i vMax = _mm_set1_epi16(INT16_MIN);
+        __m128i vSum = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i raw = swapBytes16Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int16_t))));
+            vMin = _mm_min_epi16(vMin, raw);
+            vMax = _mm_max_epi16(vMax, raw);
+            const __m128i pairs = _mm_madd_epi16(raw, ones);
+            vSum = _mm_add_epi64(vSum, _mm_add_epi64(signExtendLo32To64Sse2(pairs), signExtendHi32To64Sse2(pairs)));
+        }
+
+        foldMinMax(horizontalMin16Sse2(vMin), horizontalMax16Sse2(vMax), min, max);
+        sum += horizontalSum64Sse2(vSum);
+        minMaxSumScalar<int16_t>(src + i * sizeof(int16_t), count - i, min, max, sum);
+    }
+
+    void int32MinMaxSumSse2(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 4)
+        {
+            minMaxSumScalar<int32_t>(src, count, min, max, sum);
+            return;
+        }
+
+        __m128i vMin = _mm_set1_epi32(INT32_MAX);
+        __m128i vMax = _mm_set1_epi32(INT32_MIN);
+        __m128i vSum = _mm_setzero_si128();
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128i raw = swapBytes32Sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int32_t))));
+            vMin = min32Sse2(raw, vMin);
+            vMax = max32Sse2(raw, vMax);
+            vSum = _mm_add_epi64(vSum, _mm_add_epi64(signExtendLo32To64Sse2(raw), signExtendHi32To64Sse2(raw)));
+        }
+
+        foldMinMax(horizontalMin32Sse2(vMin), horizontalMax32Sse2(vMax), min, max);
+        sum += horizontalSum64Sse2(vSum);
+        minMaxSumScalar<int32_t>(src + i * sizeof(int32_t), count - i, min, max, sum);
+    }
+
+    ASAM_CMP_TARGET_AVX2 inline __m128i swapMask16()
+    {
+        return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    }
+
+    ASAM_CMP_TARGET_AVX2 inline __m256i swapMask32()
+    {
+        return _mm256_setr_epi8(
+            3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int16ToFloatAvx2(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const __m256 vScalar = _mm256_set1_ps(scalar);
+        const __m256 vOffset = _mm256_set1_ps(offset);
+        const __m128i mask = swapMask16();
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i raw0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int16_t))), mask);
+            const __m128i raw1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i + 8) * sizeof(int16_t))), mask);
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw0)), vScalar, vOffset));
+            _mm256_storeu_ps(dst + i + 8, _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw1)), vScalar, vOffset));
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int32ToFloatAvx2(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const __m256 vScalar = _mm256_set1_ps(scalar);
+        const __m256 vOffset = _mm256_set1_ps(offset);
+        const __m256i mask = swapMask32();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i raw =
+                _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(int32_t))), mask);
+            _mm256_storeu_ps(dst + i, _mm256_fmadd_ps(_mm256_cvtepi32_ps(raw), vScalar, vOffset));
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int16ToDoubleAvx2(
+        const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const __m256d vScalar = _mm256_set1_pd(scalar);
+        const __m256d vOffset = _mm256_set1_pd(offset);
+        const __m128i mask = swapMask16();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i raw = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(int16_t))), mask);
+            const __m256i wide = _mm256_cvtepi16_epi32(raw);
+            _mm256_storeu_pd(dst + i, _mm256_fmadd_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(wide)), vScalar, vOffset));
+            _mm256_storeu_pd(dst + i + 4, _mm256_fmadd_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(wide, 1)), vScalar, vOffset));
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int32ToDoubleAvx2(
+        const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const __m256d vScalar = _mm256_set1_pd(scalar);
+        const __m256d vOffset = _mm256_set1_pd(offset);
+        const __m256i mask = swapMask32();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i raw =
+                _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(int32_t))), mask);
+            _mm256_storeu_pd(dst + i, _mm256_fmadd_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(raw)), vScalar, vOffset));
+            _mm256_storeu_pd(dst + i + 4, _mm256_fmadd_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(raw, 1)), vScalar, vOffset));
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int16ToBigEndianAvx2(const int16_t* src, const size_t count, uint8_t* dst)
+    {
+        const __m256i mask = _mm256_broadcastsi128_si256(swapMask16());
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * sizeof(int16_t)), _mm256_shuffle_epi8(raw, mask));
+        }
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int16_t));
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int32ToBigEndianAvx2(const int32_t* src, const size_t count, uint8_t* dst)
+    {
+        const __m256i mask = swapMask32();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * sizeof(int32_t)), _mm256_shuffle_epi8(raw, mask));
+        }
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int32_t));
+    }
+
+    ASAM_CMP_TARGET_AVX2 inline int64_t horizontalSum64Avx2(const __m256i value)
+    {
+        return horizontalSum64Sse2(_mm_add_epi64(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1)));
+    }
+
+    ASAM_CMP_TARGET_AVX2 inline int32_t horizontalMin32Avx2(const __m256i value)
+    {
+        __m128i half = _mm_min_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_min_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(half);
+    }
+
+    ASAM_CMP_TARGET_AVX2 inline int32_t horizontalMax32Avx2(const __m256i value)
+    {
+        __m128i half = _mm_max_epi32(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+        half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+        half = _mm_max_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(half);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int16MinMaxSumAvx2(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 16)
+        {
+            minMaxSumScalar<int16_t>(src, count, min, max, sum);
+            return;
+        }
+
+        const __m256i mask = _mm256_broadcastsi128_si256(swapMask16());
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i vMin = _mm256_set1_epi16(INT16_MAX);
+        __m256i vMax = _mm256_set1_epi16(INT16_MIN);
+        __m256i vSum = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i raw =
+                _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(int16_t))), mask);
+            vMin = _mm256_min_epi16(vMin, raw);
+            vMax = _mm256_max_epi16(vMax, raw);
+            const __m256i pairs = _mm256_madd_epi16(raw, ones);
+            vSum = _mm256_add_epi64(vSum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+            vSum = _mm256_add_epi64(vSum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+        }
+
+        foldMinMax(horizontalMin16Sse2(_mm_min_epi16(_mm256_castsi256_si128(vMin), _mm256_extracti128_si256(vMin, 1))),
+                   horizontalMax16Sse2(_mm_max_epi16(_mm256_castsi256_si128(vMax), _mm256_extracti128_si256(vMax, 1))),
+                   min,
+                   max);
+        sum += horizontalSum64Avx2(vSum);
+        minMaxSumScalar<int16_t>(src + i * sizeof(int16_t), count - i, min, max, sum);
+    }
+
+    ASAM_CMP_TARGET_AVX2 void int32MinMaxSumAvx2(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 8)
+        {
+            minMaxSumScalar<int32_t>(src, count, min, max, sum);
+            return;
+        }
+
+        const __m256i mask = swapMask32();
+        __m256i vMin = _mm256_set1_epi32(INT32_MAX);
+        __m256i vMax = _mm256_set1_epi32(INT32_MIN);
+        __m256i vSum = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256i raw =
+                _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(int32_t))), mask);
+            vMin = _mm256_min_epi32(vMin, raw);
+            vMax = _mm256_max_epi32(vMax, raw);
+            vSum = _mm256_add_epi64(vSum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(raw)));
+            vSum = _mm256_add_epi64(vSum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(raw, 1)));
+        }
+
+        foldMinMax(horizontalMin32Avx2(vMin), horizontalMax32Avx2(vMax), min, max);
+        sum += horizontalSum64Avx2(vSum);
+        minMaxSumScalar<int32_t>(src + i * sizeof(int32_t), count - i, min, max, sum);
+    }
+
+    bool cpuSupportsAvx2()
+    {
+    #if defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+
+        __cpuid(info, 1);
+        const bool fma = (info[2] & (1 << 12)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #endif
+    }
+
+#endif  // ASAM_CMP_X86_SIMD
+
+#ifdef ASAM_CMP_NEON_SIMD
+
+    void int16ToFloatNeon(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const float32x4_t vScalar = vdupq_n_f32(scalar);
+        const float32x4_t vOffset = vdupq_n_f32(offset);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t raw = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(src + i * sizeof(int16_t))));
+            const float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(raw)));
+            const float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(raw)));
+            vst1q_f32(dst + i, vmlaq_f32(vOffset, lo, vScalar));
+            vst1q_f32(dst + i + 4, vmlaq_f32(vOffset, hi, vScalar));
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    void int32ToFloatNeon(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+    {
+        const float32x4_t vScalar = vdupq_n_f32(scalar);
+        const float32x4_t vOffset = vdupq_n_f32(offset);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const int32x4_t raw = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8(src + i * sizeof(int32_t))));
+            vst1q_f32(dst + i, vmlaq_f32(vOffset, vcvtq_f32_s32(raw), vScalar));
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+
+    #ifdef ASAM_CMP_NEON_DOUBLE
+    inline void storeInt32AsDoubleNeon(const int32x4_t raw, const float64x2_t vScalar, const float64x2_t vOffset, double* dst)
+    {
+        const float64x2_t lo = vcvtq_f64_s64(vmovl_s32(vget_low_s32(raw)));
+        const float64x2_t hi = vcvtq_f64_s64(vmovl_s32(vget_high_s32(raw)));
+        vst1q_f64(dst, vfmaq_f64(vOffset, lo, vScalar));
+        vst1q_f64(dst + 2, vfmaq_f64(vOffset, hi, vScalar));
+    }
+
+    void int16ToDoubleNeon(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const float64x2_t vScalar = vdupq_n_f64(scalar);
+        const float64x2_t vOffset = vdupq_n_f64(offset);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t raw = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(src + i * sizeof(int16_t))));
+            storeInt32AsDoubleNeon(vmovl_s16(vget_low_s16(raw)), vScalar, vOffset, dst + i);
+            storeInt32AsDoubleNeon(vmovl_s16(vget_high_s16(raw)), vScalar, vOffset, dst + i + 4);
+        }
+        toRealScalar<int16_t>(src + i * sizeof(int16_t), count - i, scalar, offset, dst + i);
+    }
+
+    void int32ToDoubleNeon(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+    {
+        const float64x2_t vScalar = vdupq_n_f64(scalar);
+        const float64x2_t vOffset = vdupq_n_f64(offset);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const int32x4_t raw = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8(src + i * sizeof(int32_t))));
+            storeInt32AsDoubleNeon(raw, vScalar, vOffset, dst + i);
+        }
+        toRealScalar<int32_t>(src + i * sizeof(int32_t), count - i, scalar, offset, dst + i);
+    }
+    #endif  // ASAM_CMP_NEON_DOUBLE
+
+    void int16ToBigEndianNeon(const int16_t* src, const size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+            vst1q_u8(dst + i * sizeof(int16_t), vrev16q_u8(vreinterpretq_u8_s16(vld1q_s16(src + i))));
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int16_t));
+    }
+
+    void int32ToBigEndianNeon(const int32_t* src, const size_t count, uint8_t* dst)
+    {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+            vst1q_u8(dst + i * sizeof(int32_t), vrev32q_u8(vreinterpretq_u8_s32(vld1q_s32(src + i))));
+        toBigEndianScalar(src + i, count - i, dst + i * sizeof(int32_t));
+    }
+
+    inline int32_t horizontalMin16Neon(const int16x8_t value)
+    {
+        int16x4_t half = vpmin_s16(vget_low_s16(value), vget_high_s16(value));
+        half = vpmin_s16(half, half);
+        half = vpmin_s16(half, half);
+        return vget_lane_s16(half, 0);
+    }
+
+    inline int32_t horizontalMax16Neon(const int16x8_t value)
+    {
+        int16x4_t half = vpmax_s16(vget_low_s16(value), vget_high_s16(value));
+        half = vpmax_s16(half, half);
+        half = vpmax_s16(half, half);
+        return vget_lane_s16(half, 0);
+    }
+
+    inline int32_t horizontalMin32Neon(const int32x4_t value)
+    {
+        const int32x2_t half = vpmin_s32(vget_low_s32(value), vget_high_s32(value));
+        return vget_lane_s32(vpmin_s32(half, half), 0);
+    }
+
+    inline int32_t horizontalMax32Neon(const int32x4_t value)
+    {
+        const int32x2_t half = vpmax_s32(vget_low_s32(value), vget_high_s32(value));
+        return vget_lane_s32(vpmax_s32(half, half), 0);
+    }
+
+    void int16MinMaxSumNeon(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 8)
+        {
+            minMaxSumScalar<int16_t>(src, count, min, max, sum);
+            return;
+        }
+
+        int16x8_t vMin = vdupq_n_s16(INT16_MAX);
+        int16x8_t vMax = vdupq_n_s16(INT16_MIN);
+        int64x2_t vSum = vdupq_n_s64(0);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const int16x8_t raw = vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(src + i * sizeof(int16_t))));
+            vMin = vminq_s16(vMin, raw);
+            vMax = vmaxq_s16(vMax, raw);
+            vSum = vpadalq_s32(vSum, vpaddlq_s16(raw));
+        }
+
+        foldMinMax(horizontalMin16Neon(vMin), horizontalMax16Neon(vMax), min, max);
+        sum += vgetq_lane_s64(vSum, 0) + vgetq_lane_s64(vSum, 1);
+        minMaxSumScalar<int16_t>(src + i * sizeof(int16_t), count - i, min, max, sum);
+    }
+
+    void int32MinMaxSumNeon(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+    {
+        if (count < 4)
+        {
+            minMaxSumScalar<int32_t>(src, count, min, max, sum);
+            return;
+        }
+
+        int32x4_t vMin = vdupq_n_s32(INT32_MAX);
+        int32x4_t vMax = vdupq_n_s32(INT32_MIN);
+        int64x2_t vSum = vdupq_n_s64(0);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const int32x4_t raw = vreinterpretq_s32_u8(vrev32q_u8(vld1q_u8(src + i * sizeof(int32_t))));
+            vMin = vminq_s32(vMin, raw);
+            vMax = vmaxq_s32(vMax, raw);
+            vSum = vpadalq_s32(vSum, raw);
+        }
+
+        foldMinMax(horizontalMin32Neon(vMin), horizontalMax32Neon(vMax), min, max);
+        sum += vgetq_lane_s64(vSum, 0) + vgetq_lane_s64(vSum, 1);
+        minMaxSumScalar<int32_t>(src + i * sizeof(int32_t), count - i, min, max, sum);
+    }
+
+#endif  // ASAM_CMP_NEON_SIMD
+
+    struct Kernels
+    {
+        InstructionSet instructionSet;
+        void (*int16ToFloat)(const uint8_t*, const size_t, const float, const float, float*);
+        void (*int32ToFloat)(const uint8_t*, const size_t, const float, const float, float*);
+        void (*int16ToDouble)(const uint8_t*, const size_t, const double, const double, double*);
+        void (*int32ToDouble)(const uint8_t*, const size_t, const double, const double, double*);
+        void (*int16ToBigEndian)(const int16_t*, const size_t, uint8_t*);
+        void (*int32ToBigEndian)(const int32_t*, const size_t, uint8_t*);
+        void (*int16MinMaxSum)(const uint8_t*, const size_t, int32_t&, int32_t&, int64_t&);
+        void (*int32MinMaxSum)(const uint8_t*, const size_t, int32_t&, int32_t&, int64_t&);
+        void (*int16MinMaxSumBuckets)(const uint8_t*, const size_t, const size_t, MinMaxSum*);
+        void (*int32MinMaxSumBuckets)(const uint8_t*, const size_t, const size_t, MinMaxSum*);
+    };
+
+    constexpr Kernels scalarKernels{InstructionSet::scalar,
+                                    toRealScalar<int16_t, float>,
+                                    toRealScalar<int32_t, float>,
+                                    toRealScalar<int16_t, double>,
+                                    toRealScalar<int32_t, double>,
+                                    toBigEndianScalar<int16_t>,
+                                    toBigEndianScalar<int32_t>,
+                                    minMaxSumScalar<int16_t>,
+                                    minMaxSumScalar<int32_t>,
+                                    minMaxSumBuckets<int16_t, minMaxSumScalar<int16_t>>,
+                                    minMaxSumBuckets<int32_t, minMaxSumScalar<int32_t>>};
+
+#ifdef ASAM_CMP_X86_SIMD
+    constexpr Kernels sse2Kernels{InstructionSet::sse2,
+                                  int16ToFloatSse2,
+                                  int32ToFloatSse2,
+                                  int16ToDoubleSse2,
+                                  int32ToDoubleSse2,
+                                  int16ToBigEndianSse2,
+                                  int32ToBigEndianSse2,
+                                  int16MinMaxSumSse2,
+                                  int32MinMaxSumSse2,
+                                  minMaxSumBuckets<int16_t, int16MinMaxSumSse2>,
+                                  minMaxSumBuckets<int32_t, int32MinMaxSumSse2>};
+
+    constexpr Kernels avx2Kernels{InstructionSet::avx2,
+                                  int16ToFloatAvx2,
+                                  int32ToFloatAvx2,
+                                  int16ToDoubleAvx2,
+                                  int32ToDoubleAvx2,
+                                  int16ToBigEndianAvx2,
+                                  int32ToBigEndianAvx2,
+                                  int16MinMaxSumAvx2,
+                                  int32MinMaxSumAvx2,
+                                  minMaxSumBuckets<int16_t, int16MinMaxSumAvx2>,
+                                  minMaxSumBuckets<int32_t, int32MinMaxSumAvx2>};
+#endif
+
+#ifdef ASAM_CMP_NEON_SIMD
+    #ifdef ASAM_CMP_NEON_DOUBLE
+    constexpr Kernels neonKernels{InstructionSet::neon,
+                                  int16ToFloatNeon,
+                                  int32ToFloatNeon,
+                                  int16ToDoubleNeon,
+                                  int32ToDoubleNeon,
+                                  int16ToBigEndianNeon,
+                                  int32ToBigEndianNeon,
+                                  int16MinMaxSumNeon,
+                                  int32MinMaxSumNeon,
+                                  minMaxSumBuckets<int16_t, int16MinMaxSumNeon>,
+                                  minMaxSumBuckets<int32_t, int32MinMaxSumNeon>};
+    #else
+    constexpr Kernels neonKernels{InstructionSet::neon,
+                                  int16ToFloatNeon,
+                                  int32ToFloatNeon,
+                                  toRealScalar<int16_t, double>,
+                                  toRealScalar<int32_t, double>,
+                                  int16ToBigEndianNeon,
+                                  int32ToBigEndianNeon,
+                                  int16MinMaxSumNeon,
+                                  int32MinMaxSumNeon,
+                                  minMaxSumBuckets<int16_t, int16MinMaxSumNeon>,
+                                  minMaxSumBuckets<int32_t, int32MinMaxSumNeon>};
+    #endif
+#endif
+
+    const Kernels* getKernels(const InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case InstructionSet::scalar:
+                return &scalarKernels;
+#ifdef ASAM_CMP_X86_SIMD
+            case InstructionSet::sse2:
+                return &sse2Kernels;
+            case InstructionSet::avx2:
+                return cpuSupportsAvx2() ? &avx2Kernels : nullptr;
+#endif
+#ifdef ASAM_CMP_NEON_SIMD
+            case InstructionSet::neon:
+                return &neonKernels;
+#endif
+            default:
+                return nullptr;
+        }
+    }
+
+    const Kernels* detectKernels()
+    {
+        for (auto instructionSet : {InstructionSet::avx2, InstructionSet::neon, InstructionSet::sse2})
+        {
+            if (auto kernels = getKernels(instructionSet))
+                return kernels;
+        }
+        return &scalarKernels;
+    }
+
+    std::atomic<const Kernels*>& activeKernels()
+    {
+        static std::atomic<const Kernels*> kernels{detectKernels()};
+        return kernels;
+    }
+
+    const Kernels& kernels()
+    {
+        return *activeKernels().load(std::memory_order_relaxed);
+    }
+}
+
+void SampleConverter::int16ToFloat(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+{
+    kernels().int16ToFloat(src, count, scalar, offset, dst);
+}
+
+void SampleConverter::int32ToFloat(const uint8_t* src, const size_t count, const float scalar, const float offset, float* dst)
+{
+    kernels().int32ToFloat(src, count, scalar, offset, dst);
+}
+
+void SampleConverter::int16ToDouble(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+{
+    kernels().int16ToDouble(src, count, scalar, offset, dst);
+}
+
+void SampleConverter::int32ToDouble(const uint8_t* src, const size_t count, const double scalar, const double offset, double* dst)
+{
+    kernels().int32ToDouble(src, count, scalar, offset, dst);
+}
+
+void SampleConverter::toBigEndian(const int16_t* src, const size_t count, uint8_t* dst)
+{
+    kernels().int16ToBigEndian(src, count, dst);
+}
+
+void SampleConverter::toBigEndian(const int32_t* src, const size_t count, uint8_t* dst)
+{
+    kernels().int32ToBigEndian(src, count, dst);
+}
+
+void SampleConverter::int16MinMaxSum(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+{
+    kernels().int16MinMaxSum(src, count, min, max, sum);
+}
+
+void SampleConverter::int32MinMaxSum(const uint8_t* src, const size_t count, int32_t& min, int32_t& max, int64_t& sum)
+{
+    kernels().int32MinMaxSum(src, count, min, max, sum);
+}
+
+void SampleConverter::int16MinMaxSumBuckets(const uint8_t* src, const size_t count, const size_t bucketSize, MinMaxSum* dst)
+{
+    kernels().int16MinMaxSumBuckets(src, count, std::max<size_t>(bucketSize, 1), dst);
+}
+
+void SampleConverter::int32MinMaxSumBuckets(const uint8_t* src, const size_t count, const size_t bucketSize, MinMaxSum* dst)
+{
+    kernels().int32MinMaxSumBuckets(src, count, std::max<size_t>(bucketSize, 1), dst);
+}
+
+SampleConverter::InstructionSet SampleConverter::getInstructionSet()
+{
+    return kernels().instructionSet;
+}
+
+bool SampleConverter::isSupported(const InstructionSet instructionSet)
+{
+    return getKernels(instructionSet) != nullptr;
+}
+
+bool SampleConverter::setInstructionSet(const InstructionSet instructionSet)
+{
+    auto newKernels = getKernels(instructionSet);
+    if (newKernels == nullptr)
+        return false;
+
+    activeKernels().store(newKernels, std::memory_order_relaxed);
+    return true;
+}
+
+END_NAMESPACE_ASAM_CMP
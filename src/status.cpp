@@ -1,27 +1,23 @@
-#include <algorithm>
-
+#include <asam_cmp/interface_payload.h>
 #include <asam_cmp/status.h>
 
 BEGIN_NAMESPACE_ASAM_CMP
 
 void Status::update(const Packet& packet)
 {
-    auto index = getIndexByDeviceId(packet.getDeviceId());
-    if (index < getDeviceStatusCount())
-    {
-        devices[index].update(packet);
-    }
-    else if (packet.getPayload().getType() == PayloadType::cmStatMsg)
-    {
-        DeviceStatus deviceStatus;
-        deviceStatus.update(packet);
-        devices.push_back(std::move(deviceStatus));
-    }
+    updateDevice(packet);
+}
+
+void Status::update(Packet&& packet)
+{
+    updateDevice(std::move(packet));
 }
 
 void Status::clear()
 {
     devices.clear();
+    deviceIndexes.clear();
+    agingWheel.clear();
 }
 
 std::size_t Status::getDeviceStatusCount() const
@@ -31,9 +27,8 @@ std::size_t Status::getDeviceStatusCount() const
 
 size_t Status::getIndexByDeviceId(const uint16_t deviceId) const
 {
-    auto devIt = std::find_if(
-        devices.begin(), devices.end(), [&deviceId](const DeviceStatus& device) { return device.getPacket().getDeviceId() == deviceId; });
-    return std::distance(devices.begin(), devIt);
+    auto index = deviceIndexes.find(deviceId);
+    return index == FlatIndexMap<uint16_t>::npos ? devices.size() : index;
 }
 
 DeviceStatus& Status::getDeviceStatus(std::size_t index)
@@ -49,10 +44,173 @@ void Status::removeDeviceById(uint16_t deviceId)
 {
     auto index = getIndexByDeviceId(deviceId);
     if (index != getDeviceStatusCount())
+        removeDevice(index, StatusChange::Type::deviceRemoved);
+}
+
+size_t Status::subscribe(StatusCallback callback)
+{
+    return subscribers.subscribe(std::move(callback));
+}
+
+void Status::unsubscribe(const size_t id)
+{
+    subscribers.unsubscribe(id);
+}
+
+void Status::setTimeToLive(const uint64_t newTimeToLive)
+{
+    timeToLive = newTimeToLive;
+    agingWheel.clear();
+    if (timeToLive == 0)
+        return;
+
+    agingWheel = TimerWheel(timeToLive / agingSlotsPerTimeToLive, 4 * agingSlotsPerTimeToLive);
+    scheduleAllForAging();
+}
+
+uint64_t Status::getTimeToLive() const
+{
+    return timeToLive;
+}
+
+void Status::advanceTime(const uint64_t now)
+{
+    if (now < currentTime)
+        return;
+
+    currentTime = now;
+    if (timeToLive != 0)
+        agingWheel.advance(now, [this, now](const TimerWheel::Timer& timer) { return onTimer(timer, now); });
+}
+
+uint64_t Status::getTime() const
+{
+    return currentTime;
+}
+
+template <typename PacketType>
+void Status::updateDevice(PacketType&& packet)
+{
+    const auto deviceId = packet.getDeviceId();
+    auto index = getIndexByDeviceId(deviceId);
+    if (index < getDeviceStatusCount())
+    {
+        // New interfaces have to be scheduled for aging
+        const bool scheduleInterface = timeToLive != 0 && packet.getPayload().getType() == PayloadType::ifStatMsg;
+        const auto interfaceId = scheduleInterface ? static_cast<const InterfacePayload&>(packet.getPayload()).getInterfaceId() : 0;
+        devices[index].update(std::forward<PacketType>(packet), currentTime, &subscribers);
+        if (scheduleInterface)
+            scheduleAging(deviceId, interfaceId);
+    }
+    else if (packet.getPayload().getType() == PayloadType::cmStatMsg)
+    {
+        DeviceStatus deviceStatus;
+        deviceStatus.update(std::forward<PacketType>(packet), currentTime, nullptr);
+        deviceIndexes.insert(deviceId, devices.size());
+        devices.push_back(std::move(deviceStatus));
+        if (timeToLive != 0)
+        {
+            devices.back().agingTicket = nextAgingTicket++;
+            agingWheel.schedule(deviceTimerFlag | deviceId, devices.back().agingTicket, currentTime + timeToLive);
+        }
+
+        if (!subscribers.empty())
+        {
+            StatusChange change;
+            change.type = StatusChange::Type::deviceAdded;
+            change.deviceId = deviceId;
+            change.current = &devices.back().getPacket();
+            subscribers.notify(change);
+        }
+    }
+}
+
+void Status::removeDevice(const size_t index, const StatusChange::Type changeType)
+{
+    const auto deviceId = devices[index].getPacket().getDeviceId();
+    if (!subscribers.empty())
+    {
+        StatusChange change;
+        change.type = changeType;
+        change.deviceId = deviceId;
+        change.previous = &devices[index].getPacket();
+        subscribers.notify(change);
+    }
+
+    std::swap(devices[index], devices[devices.size() - 1]);
+    devices.pop_back();
+    deviceIndexes.erase(deviceId);
+    if (index != devices.size())
+        deviceIndexes.insert(devices[index].getPacket().getDeviceId(), index);
+}
+
+void Status::scheduleAging(const uint16_t deviceId, const uint32_t interfaceId)
+{
+    auto& device = devices[getIndexByDeviceId(deviceId)];
+    const auto interfaceIndex = device.getIndexByInterfaceId(interfaceId);
+    if (interfaceIndex == device.getInterfaceStatusCount())
+        return;
+
+    // Interfaces are scheduled once, later updates only move the last seen time that is checked when the timer fires
+    auto& interfaceStatus = device.getInterfaceStatus(interfaceIndex);
+    if (interfaceStatus.agingTicket != 0)
+        return;
+
+    interfaceStatus.agingTicket = nextAgingTicket++;
+    agingWheel.schedule((static_cast<uint64_t>(deviceId) << 32) | interfaceId, interfaceStatus.agingTicket,
+                        interfaceStatus.lastSeen + timeToLive);
+}
+
+void Status::scheduleAllForAging()
+{
+    for (auto& device : devices)
     {
-        std::swap(devices[index], devices[devices.size() - 1]);
-        devices.pop_back();
+        const auto deviceId = device.getPacket().getDeviceId();
+        device.agingTicket = nextAgingTicket++;
+        agingWheel.schedule(deviceTimerFlag | deviceId, device.agingTicket, device.lastSeen + timeToLive);
+
+        for (size_t i = 0; i < device.getInterfaceStatusCount(); ++i)
+        {
+            auto& interfaceStatus = device.getInterfaceStatus(i);
+            interfaceStatus.agingTicket = nextAgingTicket++;
+            agingWheel.schedule((static_cast<uint64_t>(deviceId) << 32) | interfaceStatus.getInterfaceId(), interfaceStatus.agingTicket,
+                                interfaceStatus.lastSeen + timeToLive);
+        }
     }
 }
 
+uint64_t Status::onTimer(const TimerWheel::Timer& timer, const uint64_t now)
+{
+    // Timers of removed or replaced items do not match the ticket of a current item
+    const bool deviceTimer = (timer.key & deviceTimerFlag) != 0;
+    const auto deviceId = static_cast<uint16_t>(deviceTimer ? timer.key : timer.key >> 32);
+    const auto deviceIndex = getIndexByDeviceId(deviceId);
+    if (deviceIndex == getDeviceStatusCount())
+        return TimerWheel::done;
+    auto& device = devices[deviceIndex];
+
+    if (deviceTimer)
+    {
+        if (device.agingTicket != timer.ticket)
+            return TimerWheel::done;
+        if (device.lastSeen + timeToLive > now)
+            return device.lastSeen + timeToLive;
+
+        removeDevice(deviceIndex, StatusChange::Type::deviceExpired);
+        return TimerWheel::done;
+    }
+
+    const auto interfaceIndex = device.getIndexByInterfaceId(static_cast<uint32_t>(timer.key));
+    if (interfaceIndex == device.getInterfaceStatusCount())
+        return TimerWheel::done;
+    const auto& interfaceStatus = device.getInterfaceStatus(interfaceIndex);
+    if (interfaceStatus.agingTicket != timer.ticket)
+        return TimerWheel::done;
+    if (interfaceStatus.lastSeen + timeToLive > now)
+        return interfaceStatus.lastSeen + timeToLive;
+
+    device.removeInterface(interfaceIndex, StatusChange::Type::interfaceExpired, &subscribers);
+    return TimerWheel::done;
+}
+
 END_NAMESPACE_ASAM_CMP
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstring>
+
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/interface_payload.h>
+#include <asam_cmp/status_change.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    bool equalBytes(const uint8_t* lhs, const size_t lhsSize, const uint8_t* rhs, const size_t rhsSize)
+    {
+        return lhsSize == rhsSize && (lhsSize == 0 || memcmp(lhs, rhs, lhsSize) == 0);
+    }
+}
+
+bool StatusChange::hasField(const Field field) const
+{
+    return (fields & static_cast<uint32_t>(field)) != 0;
+}
+
+void StatusChange::compareInterfaces(const Packet& previousPacket, const Packet& currentPacket)
+{
+    const auto& prev = static_cast<const InterfacePayload&>(previousPacket.getPayload());
+    const auto& cur = static_cast<const InterfacePayload&>(currentPacket.getPayload());
+
+    auto compare = [this](const auto prevValue, const auto curValue, const Field field)
+    {
+        if (prevValue != curValue)
+            fields |= static_cast<uint32_t>(field);
+    };
+
+    compare(prev.getInterfaceStatus(), cur.getInterfaceStatus(), Field::interfaceStatus);
+    compare(prev.getMsgTotalRx(), cur.getMsgTotalRx(), Field::msgTotalRx);
+    compare(prev.getMsgTotalTx(), cur.getMsgTotalTx(), Field::msgTotalTx);
+    compare(prev.getMsgDroppedRx(), cur.getMsgDroppedRx(), Field::msgDroppedRx);
+    compare(prev.getMsgDroppedTx(), cur.getMsgDroppedTx(), Field::msgDroppedTx);
+    compare(prev.getErrorsTotalRx(), cur.getErrorsTotalRx(), Field::errorsTotalRx);
+    compare(prev.getErrorsTotalTx(), cur.getErrorsTotalTx(), Field::errorsTotalTx);
+    compare(prev.getInterfaceType(), cur.getInterfaceType(), Field::interfaceType);
+    compare(prev.getFeatureSupportBitmask(), cur.getFeatureSupportBitmask(), Field::featureSupportBitmask);
+    if (!equalBytes(prev.getStreamIds(), prev.getStreamIdsCount(), cur.getStreamIds(), cur.getStreamIdsCount()))
+        fields |= static_cast<uint32_t>(Field::streamIds);
+    if (!equalBytes(prev.getVendorData(), prev.getVendorDataLength(), cur.getVendorData(), cur.getVendorDataLength()))
+        fields |= static_cast<uint32_t>(Field::interfaceVendorData);
+
+    // Unsigned subtraction handles counter wrap-around
+    deltas.msgTotalRx = cur.getMsgTotalRx() - prev.getMsgTotalRx();
+    deltas.msgTotalTx = cur.getMsgTotalTx() - prev.getMsgTotalTx();
+    deltas.msgDroppedRx = cur.getMsgDroppedRx() - prev.getMsgDroppedRx();
+    deltas.msgDroppedTx = cur.getMsgDroppedTx() - prev.getMsgDroppedTx();
+    deltas.errorsTotalRx = cur.getErrorsTotalRx() - prev.getErrorsTotalRx();
+    deltas.errorsTotalTx = cur.getErrorsTotalTx() - prev.getErrorsTotalTx();
+}
+
+void StatusChange::compareDevices(const Packet& previousPacket, const Packet& currentPacket)
+{
+    const auto& prev = static_cast<const CaptureModulePayload&>(previousPacket.getPayload());
+    const auto& cur = static_cast<const CaptureModulePayload&>(currentPacket.getPayload());
+
+    auto compare = [this](const auto prevValue, const auto curValue, const Field field)
+    {
+        if (prevValue != curValue)
+            fields |= static_cast<uint32_t>(field);
+    };
+
+    compare(prev.getGmIdentity(), cur.getGmIdentity(), Field::gmIdentity);
+    compare(prev.getGmClockQuality(), cur.getGmClockQuality(), Field::gmClockQuality);
+    compare(prev.getCurrentUtcOffset(), cur.getCurrentUtcOffset(), Field::currentUtcOffset);
+    compare(prev.getTimeSource(), cur.getTimeSource(), Field::timeSource);
+    compare(prev.getDomainNumber(), cur.getDomainNumber(), Field::domainNumber);
+    compare(prev.getGptpFlags(), cur.getGptpFlags(), Field::gptpFlags);
+    if (prev.getDeviceDescription() != cur.getDeviceDescription() || prev.getSerialNumber() != cur.getSerialNumber() ||
+        prev.getHardwareVersion() != cur.getHardwareVersion() || prev.getSoftwareVersion() != cur.getSoftwareVersion())
+        fields |= static_cast<uint32_t>(Field::deviceInfo);
+    if (!equalBytes(prev.getVendorData(), prev.getVendorDataLength(), cur.getVendorData(), cur.getVendorDataLength()))
+        fields |= static_cast<uint32_t>(Field::deviceVendorData);
+}
+
+size_t StatusSubscribers::subscribe(StatusCallback callback)
+{
+    const size_t id = nextId++;
+    callbacks.emplace_back(id, std::move(callback));
+    return id;
+}
+
+void StatusSubscribers::unsubscribe(const size_t id)
+{
+    auto it = std::find_if(callbacks.begin(), callbacks.end(), [id](const auto& callback) { return callback.first == id; });
+    if (it != callbacks.end())
+        callbacks.erase(it);
+}
+
+bool StatusSubscribers::empty() const
+{
+    return callbacks.empty();
+}
+
+void StatusSubscribers::notify(const StatusChange& change) const
+{
+    for (const auto& callback : callbacks)
+        callback.second(change);
+}
+
+END_NAMESPACE_ASAM_CMP
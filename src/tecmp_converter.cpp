@@ -1,6 +1,13 @@
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include <asam_cmp/analog_payload.h>
 #include <asam_cmp/can_fd_payload.h>
 #include <asam_cmp/can_payload.h>
 #include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
 #include <asam_cmp/interface_payload.h>
 #include <asam_cmp/lin_payload.h>
 #include <asam_cmp/tecmp_can_payload.h>
@@ -110,9 +117,10 @@ PacketPtr TECMP::Converter::ConvertDataPayload(CmpHeader& header, const TecmpPay
             return convertLinPayload(header, payload);
             break;
         case CmpHeader::DataType::flexRay:
-        case CmpHeader::DataType::uartRs232:
         case CmpHeader::DataType::analog:
         case CmpHeader::DataType::ethernet:
+            return ConvertRawDataPayload(header, payload);
+        case CmpHeader::DataType::uartRs232:
         case CmpHeader::DataType::invalid:
             break;
     }
@@ -157,3 +165,305 @@ PacketPtr TECMP::Converter::GetPackageFromTecmpHeader(const TECMP::CmpHeader& he
     packet->setInterfaceId(header.getInterfaceId());
     return packet;
 }
+
+PacketPtr TECMP::Converter::ConvertRawDataPayload(const CmpHeader& header, const TecmpPayloadPtr& payload)
+{
+    // These data types have no TECMP payload class, their raw entry data is converted like in ConvertFrame
+    EntryView entry;
+    entry.deviceId = header.getDeviceId();
+    entry.sequenceCounter = header.getSequenceCounter();
+    entry.messageType = header.getMessageType();
+    entry.dataType = header.getDataType();
+    entry.deviceFlags = header.getDeviceFlags();
+    entry.interfaceId = header.getInterfaceId();
+    entry.timestamp = header.getTimestamp();
+    entry.data = payload->getRawPayload();
+    entry.length = payload->getLength();
+
+    std::vector<Packet> packets;
+    if (ConvertEntry(entry, packets) == 0)
+        return nullptr;
+    return std::make_shared<Packet>(std::move(packets.front()));
+}
+
+namespace
+{
+    template <typename T>
+    T readBigEndian(const uint8_t* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return ASAM::CMP::swapEndian(value);
+    }
+
+    // Capture Module and Interface Status entries start with vendorId, version, type, reserved, vendorDataLength,
+    // deviceId and serialNumber
+    constexpr std::size_t statusGenericSize = 12;
+    constexpr std::size_t vendorDataLengthOffset = 4;
+    constexpr std::size_t serialNumberOffset = 8;
+    // Capture Module vendor data: reserved, software version (3 bytes), hardware version (2 bytes), ...
+    constexpr std::size_t swVersionOffset = statusGenericSize + 1;
+    constexpr std::size_t hwVersionOffset = swVersionOffset + 3;
+    // Interface Status entries: interfaceId, messagesTotal, errorsTotal and vendor data for every interface
+    constexpr std::size_t busDataSize = 12;
+    // CAN entries: arbId, dlc, data, crc
+    constexpr std::size_t canHeaderSize = 5;
+    constexpr std::size_t canCrcSize = 3;
+    // Data lengths above 8 bytes that CAN FD can encode
+    constexpr uint8_t canFdDataLengths[] = {12, 16, 20, 24, 32, 48, 64};
+    // LIN entries: pid, dataLength, data, crc
+    constexpr std::size_t linHeaderSize = 2;
+    // FlexRay entries: cycle, frameId, dataLength, data, headerCrc, frameCrc
+    constexpr std::size_t flexRayHeaderSize = 4;
+    constexpr std::size_t flexRayCrcSize = 5;
+
+    // Entry data flags
+    constexpr uint16_t flexRayNullFrameFlag = 0x0001;
+    constexpr uint16_t flexRayStartupFrameFlag = 0x0002;
+    constexpr uint16_t flexRaySyncFrameFlag = 0x0004;
+    constexpr uint16_t flexRayWusFlag = 0x0008;
+    constexpr uint16_t flexRayPpiFlag = 0x0010;
+    constexpr uint16_t flexRayCasFlag = 0x0020;
+    constexpr uint16_t crcErrorFlag = 0x2000;
+    constexpr uint16_t flexRayHeaderCrcErrorFlag = 0x4000;
+
+    bool isValidCanDataLength(const uint8_t dataLength)
+    {
+        const auto end = std::end(canFdDataLengths);
+        return dataLength <= 8 || std::find(std::begin(canFdDataLengths), end, dataLength) != end;
+    }
+}
+
+std::size_t TECMP::Converter::ConvertFrame(const void* data, const std::size_t size, std::vector<Packet>& packets)
+{
+    return ConvertFrame(data, size, packets, Options{});
+}
+
+std::size_t TECMP::Converter::ConvertFrame(const void* data, const std::size_t size, std::vector<Packet>& packets, const Options& options)
+{
+    EntryReader reader(data, size);
+    EntryView entry;
+    std::size_t count = 0;
+    while (reader.next(entry))
+        count += ConvertEntry(entry, packets, options);
+    return count;
+}
+
+std::size_t TECMP::Converter::ConvertEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    return ConvertEntry(entry, packets, Options{});
+}
+
+std::size_t TECMP::Converter::ConvertEntry(const EntryView& entry, std::vector<Packet>& packets, const Options& options)
+{
+    // Like in ConvertPacket, invalid packets are dropped and not counted
+    const std::size_t first = packets.size();
+    ConvertEntryPayload(entry, packets, options);
+    const auto invalid = std::remove_if(packets.begin() + static_cast<std::ptrdiff_t>(first),
+                                        packets.end(),
+                                        [](const Packet& packet) { return !packet.isValid(); });
+    packets.erase(invalid, packets.end());
+    return packets.size() - first;
+}
+
+std::size_t TECMP::Converter::ConvertEntryPayload(const EntryView& entry, std::vector<Packet>& packets, const Options& options)
+{
+    switch (entry.messageType)
+    {
+        case CmpHeader::MessageType::cmStatus:
+            return ConvertCaptureModuleEntry(entry, packets);
+        case CmpHeader::MessageType::busStatus:
+            return ConvertInterfaceEntry(entry, packets);
+        case CmpHeader::MessageType::data:
+            switch (entry.dataType)
+            {
+                case CmpHeader::DataType::can:
+                case CmpHeader::DataType::canFd:
+                    return ConvertCanEntry(entry, packets);
+                case CmpHeader::DataType::lin:
+                    return ConvertLinEntry(entry, packets);
+                case CmpHeader::DataType::flexRay:
+                    return ConvertFlexRayEntry(entry, packets);
+                case CmpHeader::DataType::analog:
+                    return ConvertAnalogEntry(entry, packets, options);
+                case CmpHeader::DataType::ethernet:
+                    return ConvertEthernetEntry(entry, packets);
+                case CmpHeader::DataType::uartRs232:
+                case CmpHeader::DataType::invalid:
+                    break;
+            }
+            break;
+        case CmpHeader::MessageType::control:
+        case CmpHeader::MessageType::configStatus:
+        case CmpHeader::MessageType::replayData:
+        case CmpHeader::MessageType::invalid:
+            break;
+    }
+    return 0;
+}
+
+Packet& TECMP::Converter::AddPacket(const EntryView& entry, std::vector<Packet>& packets)
+{
+    auto& packet = packets.emplace_back();
+    packet.setDeviceId(entry.deviceId);
+    packet.setTimestamp(entry.timestamp);
+    packet.setInterfaceId(entry.interfaceId);
+    return packet;
+}
+
+std::size_t TECMP::Converter::ConvertCaptureModuleEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length < hwVersionOffset + 2)
+        return 0;
+
+    const uint8_t* data = entry.data;
+    const std::string swVersion = "v" + std::to_string(data[swVersionOffset]) + "." + std::to_string(data[swVersionOffset + 1]) + "." +
+                                  std::to_string(data[swVersionOffset + 2]);
+    const std::string hwVersion = "v" + std::to_string(data[hwVersionOffset]) + "." + std::to_string(data[hwVersionOffset + 1]);
+
+    ASAM::CMP::CaptureModulePayload cmPayload;
+    cmPayload.setData("", std::to_string(readBigEndian<uint32_t>(data + serialNumberOffset)), hwVersion, swVersion, {});
+    AddPacket(entry, packets).setPayload(std::move(cmPayload));
+    return 1;
+}
+
+std::size_t TECMP::Converter::ConvertInterfaceEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length < statusGenericSize)
+        return 0;
+
+    const std::size_t stride = busDataSize + readBigEndian<uint16_t>(entry.data + vendorDataLengthOffset);
+    std::size_t count = 0;
+    for (std::size_t offset = statusGenericSize; offset + busDataSize <= entry.length; offset += stride)
+    {
+        const uint8_t* busData = entry.data + offset;
+        const auto interfaceId = readBigEndian<uint32_t>(busData);
+
+        ASAM::CMP::InterfacePayload interfacePayload;
+        interfacePayload.setInterfaceId(interfaceId);
+        interfacePayload.setMsgTotalRx(readBigEndian<uint32_t>(busData + 4));
+        interfacePayload.setErrorsTotalRx(readBigEndian<uint32_t>(busData + 8));
+
+        auto& packet = AddPacket(entry, packets);
+        packet.setInterfaceId(interfaceId);
+        packet.setPayload(std::move(interfacePayload));
+        ++count;
+    }
+    return count;
+}
+
+std::size_t TECMP::Converter::ConvertCanEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length < canHeaderSize)
+        return 0;
+
+    const auto arbId = readBigEndian<uint32_t>(entry.data);
+    const uint8_t dlc = entry.data[4];
+    if (!isValidCanDataLength(dlc) || entry.length < canHeaderSize + dlc)
+        return 0;
+
+    const uint8_t* canData = entry.data + canHeaderSize;
+    uint32_t crc = 0;
+    if (entry.length >= canHeaderSize + dlc + canCrcSize)
+        memcpy(&crc, canData + dlc, canCrcSize);
+
+    auto& packet = AddPacket(entry, packets);
+    if (dlc > 8)
+    {
+        ASAM::CMP::CanFdPayload canFdPayload;
+        canFdPayload.setId(arbId);
+        canFdPayload.setData(canData, dlc);
+        canFdPayload.setCrc(crc);
+        packet.setPayload(std::move(canFdPayload));
+    }
+    else
+    {
+        ASAM::CMP::CanPayload canPayload;
+        canPayload.setId(arbId);
+        canPayload.setData(canData, dlc);
+        canPayload.setCrc(static_cast<uint16_t>(crc));
+        packet.setPayload(std::move(canPayload));
+    }
+    return 1;
+}
+
+std::size_t TECMP::Converter::ConvertLinEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length < linHeaderSize)
+        return 0;
+
+    const uint8_t dataLength = entry.data[1];
+    if (entry.length < linHeaderSize + dataLength)
+        return 0;
+
+    ASAM::CMP::LinPayload linPayload;
+    linPayload.setLinId(entry.data[0]);
+    linPayload.setChecksum(entry.length > linHeaderSize + dataLength ? entry.data[linHeaderSize + dataLength] : 0);
+    linPayload.setData(entry.data + linHeaderSize, dataLength);
+
+    AddPacket(entry, packets).setPayload(std::move(linPayload));
+    return 1;
+}
+
+std::size_t TECMP::Converter::ConvertFlexRayEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length < flexRayHeaderSize)
+        return 0;
+
+    const uint8_t dataLength = entry.data[3];
+    if (entry.length < flexRayHeaderSize + dataLength)
+        return 0;
+
+    ASAM::CMP::FlexRayPayload flexRayPayload;
+    flexRayPayload.setCycle(entry.data[0]);
+    flexRayPayload.setFrameId(readBigEndian<uint16_t>(entry.data + 1));
+    flexRayPayload.setData(entry.data + flexRayHeaderSize, dataLength);
+    if (entry.length >= flexRayHeaderSize + dataLength + flexRayCrcSize)
+    {
+        const uint8_t* crc = entry.data + flexRayHeaderSize + dataLength;
+        flexRayPayload.setHeaderCrc(readBigEndian<uint16_t>(crc));
+        flexRayPayload.setFrameCrc((static_cast<uint32_t>(crc[2]) << 16) | (static_cast<uint32_t>(crc[3]) << 8) | crc[4]);
+    }
+
+    using Flags = ASAM::CMP::FlexRayPayload::Flags;
+    flexRayPayload.setFlag(Flags::nullFrame, (entry.dataFlags & flexRayNullFrameFlag) != 0);
+    flexRayPayload.setFlag(Flags::startupFrame, (entry.dataFlags & flexRayStartupFrameFlag) != 0);
+    flexRayPayload.setFlag(Flags::syncFrame, (entry.dataFlags & flexRaySyncFrameFlag) != 0);
+    flexRayPayload.setFlag(Flags::wus, (entry.dataFlags & flexRayWusFlag) != 0);
+    flexRayPayload.setFlag(Flags::ppi, (entry.dataFlags & flexRayPpiFlag) != 0);
+    flexRayPayload.setFlag(Flags::cas, (entry.dataFlags & flexRayCasFlag) != 0);
+    flexRayPayload.setFlag(Flags::crcFrameErr, (entry.dataFlags & crcErrorFlag) != 0);
+    flexRayPayload.setFlag(Flags::crcHeaderErr, (entry.dataFlags & flexRayHeaderCrcErrorFlag) != 0);
+
+    AddPacket(entry, packets).setPayload(std::move(flexRayPayload));
+    return 1;
+}
+
+std::size_t TECMP::Converter::ConvertAnalogEntry(const EntryView& entry, std::vector<Packet>& packets, const Options& options)
+{
+    // TECMP analog samples are big endian int16 like the CMP ones, so they are taken over without conversion.
+    // Scaling is vendor specific and left to the user.
+    ASAM::CMP::AnalogPayload analogPayload;
+    analogPayload.setSampleDt(ASAM::CMP::AnalogPayload::SampleDt::aInt16);
+    analogPayload.setSampleScalar(1.f);
+    analogPayload.setSampleInterval(options.analogSampleInterval);
+    analogPayload.setUnit(options.analogUnit);
+    analogPayload.setData(entry.data, entry.length & ~static_cast<std::size_t>(1));
+
+    AddPacket(entry, packets).setPayload(std::move(analogPayload));
+    return 1;
+}
+
+std::size_t TECMP::Converter::ConvertEthernetEntry(const EntryView& entry, std::vector<Packet>& packets)
+{
+    if (entry.length > std::numeric_limits<uint16_t>::max())
+        return 0;
+
+    // The frame is copied once, straight from the TECMP frame into the payload of the packet
+    ASAM::CMP::EthernetPayload ethernetPayload;
+    ethernetPayload.setData(entry.data, static_cast<uint16_t>(entry.length));
+    ethernetPayload.setFlag(ASAM::CMP::EthernetPayload::Flags::fcsErr, (entry.dataFlags & crcErrorFlag) != 0);
+
+    AddPacket(entry, packets).setPayload(std::move(ethernetPayload));
+    return 1;
+}
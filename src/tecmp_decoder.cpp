@@ -1,175 +1,196 @@
-#include <asam_cmp/tecmp_can_payload.h>
-#include <asam_cmp/tecmp_capture_module_payload.h>
 #include <asam_cmp/tecmp_converter.h>
 #include <asam_cmp/tecmp_decoder.h>
-#include <asam_cmp/tecmp_interface_payload.h>
-#include <asam_cmp/tecmp_lin_payload.h>
 
-using TECMP::CmpHeader;
+using ASAM::CMP::Packet;
 using PacketPtr = std::shared_ptr<ASAM::CMP::Packet>;
-using TecmpPayloadPtr = std::shared_ptr<TECMP::Payload>;
+
+TECMP::Decoder::Decoder(const Converter::Options& newConverterOptions)
+    : converterOptions(newConverterOptions)
+{
+}
 
 std::vector<PacketPtr> TECMP::Decoder::Decode(const void* data, const std::size_t size)
 {
+    std::vector<Packet> converted;
+    Converter::ConvertFrame(data, size, converted);
+
     std::vector<PacketPtr> packets;
-    std::vector<TecmpPayloadPtr> payloads;
+    packets.reserve(converted.size());
+    for (auto& packet : converted)
+        packets.push_back(std::make_shared<Packet>(std::move(packet)));
 
-    uint8_t* payloadPtr;
-    auto header = GetHeader(data, size, &payloadPtr);
-    if (!header.isValid() || payloadPtr == nullptr)
-        return packets;
+    return packets;
+}
 
-    // Handle payload in method - returns vector of payloads
-    payloads = HandlePayload(payloadPtr, size - sizeof(header), header);
-    if (payloads.empty())
+const std::vector<Packet>& TECMP::Decoder::decode(const void* data, const std::size_t size)
+{
+    packets.clear();
+
+    EntryReader reader(data, size);
+    EntryView entry;
+    ++stats.frames;
+    if (!reader.isValid() || !reader.next(entry))
+    {
+        ++stats.invalidFrames;
         return packets;
+    }
+
+    const auto& header = reader.getHeader();
+    auto& device = getDeviceState(header.getDeviceId());
+    ++device.stats.frames;
+    checkSequenceCounter(device, header.getSequenceCounter());
 
-    // Iterate through packets and header, turn into packets
-    packets = ConvertPacketsToAsam(payloads, header);
+    const bool startOfSegment = header.isStartOfSegment();
+    const bool endOfSegment = header.isEndOfSegment();
+    // Frames without segment flags are unsegmented unless a segmented frame is in progress
+    if ((startOfSegment && endOfSegment) || (!startOfSegment && !endOfSegment && device.segmentState == SegmentState::none))
+    {
+        do
+            Converter::ConvertEntry(entry, packets, converterOptions);
+        while (reader.next(entry));
+    }
+    else
+    {
+        // A segmented frame carries one entry
+        addSegment(device, entry, startOfSegment, endOfSegment);
+    }
 
     return packets;
 }
 
-TecmpPayloadPtr TECMP::Decoder::GetCaptureModulePayload(const uint8_t* payloadData, const std::size_t size)
+void TECMP::Decoder::reset()
 {
-    CaptureModulePayload payload(payloadData, size);
-    if (payload.isValid())
-        return std::make_shared<Payload>(payload);
-
-    return {};
+    stats = Stats{};
+    devices.clear();
+    deviceIndexes.clear();
+    packets.clear();
 }
 
-TECMP::CmpHeader TECMP::Decoder::GetHeader(const void* data, const std::size_t size, uint8_t** payloadPtr)
+const TECMP::Decoder::Stats& TECMP::Decoder::getStats() const
 {
-    CmpHeader header;
-    *payloadPtr = nullptr;
+    return stats;
+}
 
-    if (size < sizeof(CmpHeader))
-        return {};
+size_t TECMP::Decoder::getDeviceCount() const
+{
+    return devices.size();
+}
 
-    memcpy(&header, data, sizeof(CmpHeader));
+size_t TECMP::Decoder::getIndexByDeviceId(const uint8_t deviceId) const
+{
+    auto index = deviceIndexes.find(deviceId);
+    return index == ASAM::CMP::FlatIndexMap<uint8_t>::npos ? devices.size() : index;
+}
 
-    if (!header.getPayloadLength())
-        return {};
+uint8_t TECMP::Decoder::getDeviceId(const size_t index) const
+{
+    return devices[index].deviceId;
+}
 
-    if (size < sizeof(CmpHeader) + header.getPayloadLength())
-        return {};
+const TECMP::Decoder::Stats& TECMP::Decoder::getDeviceStats(const size_t index) const
+{
+    return devices[index].stats;
+}
 
-    auto tempPtr = reinterpret_cast<const uint8_t*>(data) + sizeof(CmpHeader);
-    *payloadPtr = const_cast<uint8_t*>(tempPtr);
-    return header;
+TECMP::Decoder::DeviceState& TECMP::Decoder::getDeviceState(const uint8_t deviceId)
+{
+    auto index = getIndexByDeviceId(deviceId);
+    if (index != devices.size())
+        return devices[index];
+
+    deviceIndexes.insert(deviceId, devices.size());
+    devices.emplace_back();
+    devices.back().deviceId = deviceId;
+    return devices.back();
 }
 
-std::vector<TecmpPayloadPtr> TECMP::Decoder::HandlePayload(const uint8_t* data, const std::size_t size, TECMP::CmpHeader& header)
+void TECMP::Decoder::count(DeviceState& device, uint64_t Stats::*counter, const uint64_t value)
 {
-    std::vector<TecmpPayloadPtr> payloads;
-    switch (header.getMessageType())
-    {
-        case CmpHeader::MessageType::cmStatus:
-        {
-            auto payload = GetCaptureModulePayload(data, size);
-            if (payload->getMessageType() == CmpHeader::MessageType::cmStatus)
-                payloads.push_back(payload);
-            break;
-        }
-        case CmpHeader::MessageType::data:
-        {
-            auto payload = GetDataPayload(data, size, header);
-            if (payload->getMessageType() == CmpHeader::MessageType::data)
-                payloads.push_back(payload);
-            break;
-        }
-        case CmpHeader::MessageType::busStatus:
-        {
-            payloads = GetInterfacePayload(data, size, header);
-            break;
-        }
-        case CmpHeader::MessageType::configStatus:
-        case CmpHeader::MessageType::replayData:
-        case CmpHeader::MessageType::invalid:
-        case CmpHeader::MessageType::control:
-            break;  // Not implimented
-    }
-    return payloads;
+    stats.*counter += value;
+    device.stats.*counter += value;
 }
-TecmpPayloadPtr TECMP::Decoder::GetDataPayload(const uint8_t* payloadData, const std::size_t size, TECMP::CmpHeader& header)
+
+void TECMP::Decoder::checkSequenceCounter(DeviceState& device, const uint16_t sequenceCounter)
 {
-    switch (header.getDataType())
+    if (!device.hasSequenceCounter)
     {
-        case CmpHeader::DataType::can:
-        case CmpHeader::DataType::canFd:
-        {
-            auto payload = GetCanPayload(payloadData, size);
-            if (payload->getMessageType() == CmpHeader::MessageType::data && payload->getType() == PayloadType::can)
-                return payload;
-            break;
-        }
-        case CmpHeader::DataType::lin:
-        {
-            auto payload = GetLinPayload(payloadData, size);
-            if (payload->getMessageType() == CmpHeader::MessageType::data && payload->getType() == PayloadType::lin)
-                return payload;
-            break;
-        }
-        case CmpHeader::DataType::flexRay:
-        case CmpHeader::DataType::uartRs232:
-        case CmpHeader::DataType::analog:
-        case CmpHeader::DataType::ethernet:
-        case CmpHeader::DataType::invalid:
-            break;  // Not implimented
+        device.hasSequenceCounter = true;
+        device.sequenceCounter = sequenceCounter;
+        return;
     }
-    return nullptr;
-}
-std::vector<TecmpPayloadPtr> TECMP::Decoder::GetInterfacePayload(const uint8_t* payloadData,
-                                                                 const std::size_t size,
-                                                                 TECMP::CmpHeader& header)
-{
-    std::vector<TecmpPayloadPtr> payloads;
-    if (header.getMessageType() != CmpHeader::MessageType::busStatus)
-        return payloads;
 
-    // Get base values
-    InterfacePayload payload;
-    std::size_t busDataOffset = 12;
-    payload.setGenericData(payloadData);
-
-    while (size - busDataOffset >= 12)
+    // The distance to the expected counter modulo 2^16 tells lost frames (forward) from repeated ones (backward)
+    const uint16_t gap = static_cast<uint16_t>(sequenceCounter - static_cast<uint16_t>(device.sequenceCounter + 1));
+    if (gap >= 0x8000)
     {
-        auto tempPayload = payload;
-        tempPayload.setBusData(payloadData + busDataOffset, 12);
-        payloads.push_back(std::make_shared<Payload>(tempPayload));
-        busDataOffset += 12;
+        count(device, &Stats::sequenceErrors);
+        // Single repeated frames keep the counter, a run of consecutive frames behind it is a restarted counter
+        const bool consecutive = device.backwardFrames != 0 && sequenceCounter == static_cast<uint16_t>(device.backwardCounter + 1);
+        device.backwardFrames = consecutive ? static_cast<uint8_t>(device.backwardFrames + 1) : 1;
+        device.backwardCounter = sequenceCounter;
+        if (device.backwardFrames < sequenceResyncFrames)
+            return;
+
+        count(device, &Stats::sequenceResyncs);
+        device.backwardFrames = 0;
+        device.sequenceCounter = sequenceCounter;
+        return;
     }
 
-    return payloads;
-}
-TecmpPayloadPtr TECMP::Decoder::GetCanPayload(const uint8_t* payloadData, const std::size_t size)
-{
-    CanPayload payload(payloadData, size);
-    if (payload.isValid())
-        return std::make_shared<Payload>(payload);
+    device.backwardFrames = 0;
+    device.sequenceCounter = sequenceCounter;
+    if (gap == 0)
+        return;
 
-    return {};
+    count(device, &Stats::lostFrames, gap);
+    // A lost frame may have been a segment
+    if (device.segmentState == SegmentState::reassembling)
+        dropSegments(device);
 }
 
-TecmpPayloadPtr TECMP::Decoder::GetLinPayload(const uint8_t* payloadData, const std::size_t size)
+void TECMP::Decoder::addSegment(DeviceState& device, const EntryView& entry, const bool startOfSegment, const bool endOfSegment)
 {
-    LinPayload payload(payloadData, size);
-    if (payload.isValid())
-        return std::make_shared<Payload>(payload);
+    count(device, &Stats::segments);
 
-    return {};
-}
-std::vector<PacketPtr> TECMP::Decoder::ConvertPacketsToAsam(std::vector<TecmpPayloadPtr> payloads, TECMP::CmpHeader& header)
-{
-    std::vector<PacketPtr> packets;
+    if (startOfSegment)
+    {
+        if (device.segmentState == SegmentState::reassembling)
+            count(device, &Stats::reassemblyErrors);
 
-    for (const auto& payload : payloads)
+        device.segmentState = SegmentState::reassembling;
+        device.segmentEntry = entry;
+        device.segmentData.assign(entry.data, entry.data + entry.length);
+        return;
+    }
+
+    if (device.segmentState != SegmentState::reassembling)
     {
-        auto packet = TECMP::Converter::ConvertPacket(header, payload);
-        if (packet)
-            packets.push_back(packet);
+        // A stray segment without start is counted once, the rest of its frame is dropped silently
+        if (device.segmentState == SegmentState::none)
+        {
+            count(device, &Stats::reassemblyErrors);
+            device.segmentState = SegmentState::discarding;
+        }
+        if (endOfSegment)
+            device.segmentState = SegmentState::none;
+        return;
     }
 
-    return packets;
+    device.segmentData.insert(device.segmentData.end(), entry.data, entry.data + entry.length);
+    if (!endOfSegment)
+        return;
+
+    device.segmentState = SegmentState::none;
+    count(device, &Stats::reassembledFrames);
+
+    auto assembled = device.segmentEntry;
+    assembled.data = device.segmentData.data();
+    assembled.length = device.segmentData.size();
+    Converter::ConvertEntry(assembled, packets, converterOptions);
+}
+
+void TECMP::Decoder::dropSegments(DeviceState& device)
+{
+    count(device, &Stats::reassemblyErrors);
+    device.segmentState = SegmentState::discarding;
 }
@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/can_fd_payload.h>
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
+#include <asam_cmp/interface_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/tecmp_encoder.h>
+#include <asam_cmp/tecmp_entry.h>
+
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+
+namespace
+{
+    template <typename T>
+    void writeBigEndian(uint8_t* data, const T value)
+    {
+        const T swapped = ASAM::CMP::swapEndian(value);
+        memcpy(data, &swapped, sizeof(T));
+    }
+
+    // Reads up to count numbers separated by any other characters, e.g. "v1.2.3"
+    void parseVersion(const std::string_view version, uint8_t* numbers, const std::size_t count)
+    {
+        const char* it = version.data();
+        const char* end = version.data() + version.size();
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            it = std::find_if(it, end, [](const char c) { return c >= '0' && c <= '9'; });
+            unsigned value = 0;
+            it = std::from_chars(it, end, value).ptr;
+            numbers[i] = static_cast<uint8_t>(value);
+        }
+    }
+
+    constexpr uint8_t tecmpVersion = 3;
+    constexpr uint16_t endOfSegmentFlag = 0x0001;
+    constexpr uint16_t startOfSegmentFlag = 0x0002;
+
+    // Status entries: vendorId, version, type, vendorDataLength, deviceId, serialNumber
+    constexpr std::size_t statusGenericSize = 12;
+    // Capture Module vendor data: reserved, software version (3 bytes), hardware version (2 bytes)
+    constexpr std::size_t cmVendorDataSize = 6;
+    // Interface Status entries: interfaceId, messagesTotal, errorsTotal
+    constexpr std::size_t busDataSize = 12;
+    // CAN entries: arbId, dlc, data, crc
+    constexpr std::size_t canHeaderSize = 5;
+    constexpr std::size_t canCrcSize = 3;
+    // LIN entries: pid, dataLength, data, crc
+    constexpr std::size_t linHeaderSize = 2;
+    constexpr std::size_t linCrcSize = 1;
+    // FlexRay entries: cycle, frameId, dataLength, data, headerCrc, frameCrc
+    constexpr std::size_t flexRayHeaderSize = 4;
+    constexpr std::size_t flexRayCrcSize = 5;
+
+    // Entry data flags
+    constexpr uint16_t flexRayNullFrameFlag = 0x0001;
+    constexpr uint16_t flexRayStartupFrameFlag = 0x0002;
+    constexpr uint16_t flexRaySyncFrameFlag = 0x0004;
+    constexpr uint16_t flexRayWusFlag = 0x0008;
+    constexpr uint16_t flexRayPpiFlag = 0x0010;
+    constexpr uint16_t flexRayCasFlag = 0x0020;
+    constexpr uint16_t crcErrorFlag = 0x2000;
+    constexpr uint16_t flexRayHeaderCrcErrorFlag = 0x4000;
+}
+
+std::vector<std::vector<uint8_t>> TECMP::Encoder::encode(const Packet& packet, const DataContext& dataContext)
+{
+    init(dataContext);
+    putPacket(packet);
+    return getEncodedData();
+}
+
+void TECMP::Encoder::setDeviceId(const uint8_t newDeviceId)
+{
+    deviceId = newDeviceId;
+    restart();
+}
+
+void TECMP::Encoder::restart()
+{
+    sequenceCounter = 0;
+}
+
+uint8_t TECMP::Encoder::getDeviceId() const
+{
+    return deviceId;
+}
+
+uint16_t TECMP::Encoder::getSequenceCounter() const
+{
+    return sequenceCounter;
+}
+
+void TECMP::Encoder::init(const DataContext& dataContext)
+{
+    if (dataContext.maxBytesPerMessage <= sizeof(CmpHeader))
+        throw std::invalid_argument("maxBytesPerMessage is too small for a TECMP entry");
+
+    maxBytesPerMessage = dataContext.maxBytesPerMessage;
+    frames.clear();
+    frameSize = 0;
+    frameHeader = CmpHeader();
+    frameHeader.setDeviceId(deviceId);
+    frameHeader.setVersion(tecmpVersion);
+}
+
+void TECMP::Encoder::putPacket(const Packet& packet)
+{
+    EntryInfo info;
+    if (!getEntryInfo(packet, info))
+        return;
+
+    const std::size_t entrySize = EntryReader::entryHeaderSize + info.length;
+    if (EntryReader::frameHeaderSize + entrySize > maxBytesPerMessage)
+    {
+        putSegmentedPacket(packet, info);
+        return;
+    }
+
+    if (frames.empty() || frameHeader.getDeviceFlags() != 0 || info.messageType != frameHeader.getMessageType() ||
+        info.dataType != frameHeader.getDataType() || frameSize + entrySize > maxBytesPerMessage)
+        addNewFrame(info, 0);
+
+    // The entry is written in place, there is no intermediate payload
+    writeEntryData(packet, addEntry(packet, info, info.length));
+}
+
+void TECMP::Encoder::putSegmentedPacket(const Packet& packet, const EntryInfo& info)
+{
+    segmentData.resize(info.length);
+    writeEntryData(packet, segmentData.data());
+
+    // A segmented frame carries one entry
+    const std::size_t maxSegmentLength =
+        std::min(maxBytesPerMessage - sizeof(CmpHeader), static_cast<std::size_t>(std::numeric_limits<uint16_t>::max()));
+    for (std::size_t offset = 0; offset < info.length; offset += maxSegmentLength)
+    {
+        const std::size_t length = std::min(maxSegmentLength, info.length - offset);
+        uint16_t deviceFlags = 0;
+        if (offset == 0)
+            deviceFlags |= startOfSegmentFlag;
+        if (offset + length == info.length)
+            deviceFlags |= endOfSegmentFlag;
+
+        addNewFrame(info, deviceFlags);
+        memcpy(addEntry(packet, info, length), segmentData.data() + offset, length);
+    }
+}
+
+std::vector<std::vector<uint8_t>> TECMP::Encoder::getEncodedData()
+{
+    if (!frames.empty())
+        frames.back().resize(frameSize);
+    return std::move(frames);
+}
+
+void TECMP::Encoder::addNewFrame(const EntryInfo& info, const uint16_t deviceFlags)
+{
+    if (!frames.empty())
+        frames.back().resize(frameSize);
+
+    frameHeader.setSequenceCounter(sequenceCounter++);
+    frameHeader.setMessageType(info.messageType);
+    frameHeader.setDataType(info.dataType);
+    frameHeader.setDeviceFlags(deviceFlags);
+
+    auto& frame = frames.emplace_back(maxBytesPerMessage);
+    memcpy(frame.data(), &frameHeader, EntryReader::frameHeaderSize);
+    frameSize = EntryReader::frameHeaderSize;
+}
+
+uint8_t* TECMP::Encoder::addEntry(const Packet& packet, const EntryInfo& info, const std::size_t length)
+{
+    uint8_t* entry = frames.back().data() + frameSize;
+    writeBigEndian<uint32_t>(entry, packet.getInterfaceId());
+    writeBigEndian<uint64_t>(entry + 4, packet.getTimestamp());
+    writeBigEndian<uint16_t>(entry + 12, static_cast<uint16_t>(length));
+    writeBigEndian<uint16_t>(entry + 14, info.dataFlags);
+
+    frameSize += EntryReader::entryHeaderSize + length;
+    return entry + EntryReader::entryHeaderSize;
+}
+
+bool TECMP::Encoder::getEntryInfo(const Packet& packet, EntryInfo& info) const
+{
+    using DataType = CmpHeader::DataType;
+    using MessageType = CmpHeader::MessageType;
+
+    const auto& payload = packet.getPayload();
+    info.messageType = MessageType::data;
+    switch (payload.getType().getType())
+    {
+        case PayloadType::can:
+            info.dataType = DataType::can;
+            info.length = canHeaderSize + static_cast<const ASAM::CMP::CanPayload&>(payload).getDataLength() + canCrcSize;
+            return true;
+        case PayloadType::canFd:
+            info.dataType = DataType::canFd;
+            info.length = canHeaderSize + static_cast<const ASAM::CMP::CanFdPayload&>(payload).getDataLength() + canCrcSize;
+            return true;
+        case PayloadType::lin:
+            info.dataType = DataType::lin;
+            info.length = linHeaderSize + static_cast<const ASAM::CMP::LinPayload&>(payload).getDataLength() + linCrcSize;
+            return true;
+        case PayloadType::flexRay:
+        {
+            using Flags = ASAM::CMP::FlexRayPayload::Flags;
+            const auto& flexRayPayload = static_cast<const ASAM::CMP::FlexRayPayload&>(payload);
+            info.dataType = DataType::flexRay;
+            info.length = flexRayHeaderSize + flexRayPayload.getPayloadLength() + flexRayCrcSize;
+            info.dataFlags = (flexRayPayload.getFlag(Flags::nullFrame) ? flexRayNullFrameFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::startupFrame) ? flexRayStartupFrameFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::syncFrame) ? flexRaySyncFrameFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::wus) ? flexRayWusFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::ppi) ? flexRayPpiFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::cas) ? flexRayCasFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::crcFrameErr) ? crcErrorFlag : 0) |
+                             (flexRayPayload.getFlag(Flags::crcHeaderErr) ? flexRayHeaderCrcErrorFlag : 0);
+            return true;
+        }
+        case PayloadType::analog:
+        {
+            // TECMP carries int16 samples only
+            const auto& analogPayload = static_cast<const ASAM::CMP::AnalogPayload&>(payload);
+            if (analogPayload.getSampleDt() != ASAM::CMP::AnalogPayload::SampleDt::aInt16)
+                return false;
+            info.dataType = DataType::analog;
+            info.length = analogPayload.getSamplesCount() * sizeof(int16_t);
+            return true;
+        }
+        case PayloadType::ethernet:
+        {
+            const auto& ethernetPayload = static_cast<const ASAM::CMP::EthernetPayload&>(payload);
+            info.dataType = DataType::ethernet;
+            info.length = ethernetPayload.getDataLength();
+            info.dataFlags = ethernetPayload.getFlag(ASAM::CMP::EthernetPayload::Flags::fcsErr) ? crcErrorFlag : 0;
+            return true;
+        }
+        case PayloadType::cmStatMsg:
+            info.messageType = MessageType::cmStatus;
+            info.dataType = static_cast<DataType>(0);
+            info.length = statusGenericSize + cmVendorDataSize;
+            return true;
+        case PayloadType::ifStatMsg:
+            info.messageType = MessageType::busStatus;
+            info.dataType = static_cast<DataType>(0);
+            info.length = statusGenericSize + busDataSize;
+            return true;
+        default:
+            return false;
+    }
+}
+
+void TECMP::Encoder::writeEntryData(const Packet& packet, uint8_t* data) const
+{
+    const auto& payload = packet.getPayload();
+    switch (payload.getType().getType())
+    {
+        case PayloadType::can:
+        case PayloadType::canFd:
+        {
+            const auto& canPayload = static_cast<const ASAM::CMP::CanPayloadBase&>(payload);
+            const uint32_t crc = payload.getType() == PayloadType::can ? static_cast<const ASAM::CMP::CanPayload&>(payload).getCrc()
+                                                                        : static_cast<const ASAM::CMP::CanFdPayload&>(payload).getCrc();
+            const uint8_t dataLength = canPayload.getDataLength();
+            writeBigEndian<uint32_t>(data, canPayload.getId());
+            data[4] = dataLength;
+            if (dataLength)
+                memcpy(data + canHeaderSize, canPayload.getData(), dataLength);
+            memcpy(data + canHeaderSize + dataLength, &crc, canCrcSize);
+            break;
+        }
+        case PayloadType::lin:
+        {
+            const auto& linPayload = static_cast<const ASAM::CMP::LinPayload&>(payload);
+            const uint8_t dataLength = linPayload.getDataLength();
+            data[0] = linPayload.getLinId();
+            data[1] = dataLength;
+            if (dataLength)
+                memcpy(data + linHeaderSize, linPayload.getData(), dataLength);
+            data[linHeaderSize + dataLength] = linPayload.getChecksum();
+            break;
+        }
+        case PayloadType::flexRay:
+        {
+            const auto& flexRayPayload = static_cast<const ASAM::CMP::FlexRayPayload&>(payload);
+            const uint8_t dataLength = flexRayPayload.getPayloadLength();
+            data[0] = flexRayPayload.getCycle();
+            writeBigEndian<uint16_t>(data + 1, flexRayPayload.getFrameId());
+            data[3] = dataLength;
+            if (dataLength)
+                memcpy(data + flexRayHeaderSize, flexRayPayload.getData(), dataLength);
+            uint8_t* crc = data + flexRayHeaderSize + dataLength;
+            const uint32_t frameCrc = flexRayPayload.getFrameCrc();
+            writeBigEndian<uint16_t>(crc, flexRayPayload.getHeaderCrc());
+            crc[2] = static_cast<uint8_t>(frameCrc >> 16);
+            crc[3] = static_cast<uint8_t>(frameCrc >> 8);
+            crc[4] = static_cast<uint8_t>(frameCrc);
+            break;
+        }
+        case PayloadType::analog:
+        {
+            // Both protocols store big endian samples
+            const auto& analogPayload = static_cast<const ASAM::CMP::AnalogPayload&>(payload);
+            const std::size_t length = analogPayload.getSamplesCount() * sizeof(int16_t);
+            if (length)
+                memcpy(data, analogPayload.getData(), length);
+            break;
+        }
+        case PayloadType::ethernet:
+        {
+            const auto& ethernetPayload = static_cast<const ASAM::CMP::EthernetPayload&>(payload);
+            if (ethernetPayload.getDataLength())
+                memcpy(data, ethernetPayload.getData(), ethernetPayload.getDataLength());
+            break;
+        }
+        case PayloadType::cmStatMsg:
+        {
+            const auto& cmPayload = static_cast<const ASAM::CMP::CaptureModulePayload&>(payload);
+            const auto serialNumber = cmPayload.getSerialNumber();
+            uint32_t serial = 0;
+            std::from_chars(serialNumber.data(), serialNumber.data() + serialNumber.size(), serial);
+
+            memset(data, 0, statusGenericSize + cmVendorDataSize);
+            writeBigEndian<uint16_t>(data + 4, static_cast<uint16_t>(cmVendorDataSize));
+            writeBigEndian<uint16_t>(data + 6, deviceId);
+            writeBigEndian<uint32_t>(data + 8, serial);
+            parseVersion(cmPayload.getSoftwareVersion(), data + statusGenericSize + 1, 3);
+            parseVersion(cmPayload.getHardwareVersion(), data + statusGenericSize + 4, 2);
+            break;
+        }
+        case PayloadType::ifStatMsg:
+        {
+            const auto& interfacePayload = static_cast<const ASAM::CMP::InterfacePayload&>(payload);
+            memset(data, 0, statusGenericSize);
+            writeBigEndian<uint16_t>(data + 6, deviceId);
+            uint8_t* busData = data + statusGenericSize;
+            writeBigEndian<uint32_t>(busData, interfacePayload.getInterfaceId());
+            writeBigEndian<uint32_t>(busData + 4, interfacePayload.getMsgTotalRx());
+            writeBigEndian<uint32_t>(busData + 8, interfacePayload.getErrorsTotalRx());
+            break;
+        }
+        default:
+            break;
+    }
+}
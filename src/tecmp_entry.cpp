@@ -0,0 +1,73 @@
+#include <asam_cmp/tecmp_entry.h>
+#include <cstring>
+
+using ASAM::CMP::swapEndian;
+
+static_assert(sizeof(TECMP::CmpHeader) == TECMP::EntryReader::frameHeaderSize + TECMP::EntryReader::entryHeaderSize,
+              "CmpHeader is the frame header followed by the first entry header");
+
+namespace
+{
+    template <typename T>
+    T readBigEndian(const uint8_t* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return swapEndian(value);
+    }
+}
+
+TECMP::EntryReader::EntryReader(const void* data, const std::size_t size)
+    : frameData(reinterpret_cast<const uint8_t*>(data))
+    , frameSize(size)
+{
+    if (size < sizeof(CmpHeader))
+        return;
+
+    memcpy(&header, data, sizeof(CmpHeader));
+    valid = header.isValid();
+}
+
+bool TECMP::EntryReader::isValid() const
+{
+    return valid;
+}
+
+const TECMP::CmpHeader& TECMP::EntryReader::getHeader() const
+{
+    return header;
+}
+
+bool TECMP::EntryReader::next(EntryView& entry)
+{
+    if (!valid || truncated || offset + entryHeaderSize > frameSize)
+        return false;
+
+    const uint8_t* entryHeader = frameData + offset;
+    const std::size_t length = readBigEndian<uint16_t>(entryHeader + 12);
+    if (offset + entryHeaderSize + length > frameSize)
+    {
+        truncated = true;
+        return false;
+    }
+
+    entry.deviceId = header.getDeviceId();
+    entry.sequenceCounter = header.getSequenceCounter();
+    entry.messageType = header.getMessageType();
+    entry.dataType = header.getDataType();
+    entry.deviceFlags = header.getDeviceFlags();
+
+    entry.interfaceId = readBigEndian<uint32_t>(entryHeader);
+    entry.timestamp = readBigEndian<uint64_t>(entryHeader + 4);
+    entry.dataFlags = readBigEndian<uint16_t>(entryHeader + 14);
+    entry.data = entryHeader + entryHeaderSize;
+    entry.length = length;
+
+    offset += entryHeaderSize + length;
+    return true;
+}
+
+bool TECMP::EntryReader::isTruncated() const
+{
+    return truncated;
+}
@@ -63,6 +63,31 @@ void TECMP::CmpHeader::setDeviceFlags(uint16_t newFlags)
 {
     deviceFlags = swapEndian(newFlags);
 }
+
+bool TECMP::CmpHeader::isEndOfSegment() const
+{
+    return (deviceFlags & eosMask) != 0;
+}
+
+bool TECMP::CmpHeader::isStartOfSegment() const
+{
+    return (deviceFlags & sosMask) != 0;
+}
+
+bool TECMP::CmpHeader::isSpy() const
+{
+    return (deviceFlags & spyMask) != 0;
+}
+
+bool TECMP::CmpHeader::isMultiFrame() const
+{
+    return (deviceFlags & multiFrameMask) != 0;
+}
+
+bool TECMP::CmpHeader::isDeviceOverflow() const
+{
+    return (deviceFlags & deviceOverflowMask) != 0;
+}
 uint32_t TECMP::CmpHeader::getInterfaceId() const
 {
     return swapEndian(interfaceId);
@@ -0,0 +1,51 @@
+#include <algorithm>
+
+#include <asam_cmp/timer_wheel.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+TimerWheel::TimerWheel(const uint64_t granularity, const size_t slotCount)
+    : granularity(std::max<uint64_t>(granularity, 1))
+{
+    size_t capacity = 1;
+    while (capacity < slotCount)
+        capacity <<= 1;
+    slots.resize(capacity);
+}
+
+void TimerWheel::schedule(const uint64_t key, const uint64_t ticket, const uint64_t expiry)
+{
+    // Expiries in the past fire with the next advance
+    const uint64_t tick = std::max(expiry / granularity, currentTick);
+    slots[getSlot(tick)].push_back({key, ticket, expiry});
+    ++count;
+}
+
+void TimerWheel::clear()
+{
+    for (auto& slot : slots)
+        slot.clear();
+    count = 0;
+}
+
+size_t TimerWheel::size() const
+{
+    return count;
+}
+
+uint64_t TimerWheel::getGranularity() const
+{
+    return granularity;
+}
+
+size_t TimerWheel::getSlotCount() const
+{
+    return slots.size();
+}
+
+size_t TimerWheel::getSlot(const uint64_t tick) const
+{
+    return static_cast<size_t>(tick & (slots.size() - 1));
+}
+
+END_NAMESPACE_ASAM_CMP
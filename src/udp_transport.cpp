@@ -0,0 +1,347 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <asam_cmp/udp_transport.h>
+
+BEGIN_NAMESPACE_ASAM_CMP
+
+namespace
+{
+    constexpr size_t controlSize = CMSG_SPACE(sizeof(timespec));
+    using ControlBuffer = std::aligned_storage_t<controlSize, alignof(cmsghdr)>;
+
+    std::string lastError()
+    {
+        return std::error_code(errno, std::generic_category()).message();
+    }
+
+    sockaddr_in createAddress(const std::string& address, const uint16_t port)
+    {
+        sockaddr_in socketAddress{};
+        socketAddress.sin_family = AF_INET;
+        socketAddress.sin_port = htons(port);
+        if (inet_pton(AF_INET, address.c_str(), &socketAddress.sin_addr) != 1)
+            throw std::invalid_argument("Invalid IPv4 address " + address);
+        return socketAddress;
+    }
+
+    void setOption(const int fd, const int name, const int value, const char* description)
+    {
+        if (setsockopt(fd, SOL_SOCKET, name, &value, sizeof(value)) != 0)
+        {
+            const auto message = std::string("Cannot set ") + description + ": " + lastError();
+            close(fd);
+            throw std::runtime_error(message);
+        }
+    }
+
+    uint64_t getSystemTime()
+    {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+
+    uint64_t getKernelTime(msghdr& header, const uint64_t fallback)
+    {
+        for (auto* control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(&header, control))
+        {
+            if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS)
+            {
+                timespec time;
+                memcpy(&time, CMSG_DATA(control), sizeof(time));
+                return static_cast<uint64_t>(time.tv_sec) * 1000000000 + static_cast<uint64_t>(time.tv_nsec);
+            }
+        }
+        return fallback;
+    }
+}
+
+UdpReceiver::UdpReceiver(Options newOptions, BatchHandler newHandler)
+    : options(std::move(newOptions))
+    , handler(std::move(newHandler))
+    , port(options.port)
+{
+    options.threadCount = std::max<size_t>(options.threadCount, 1);
+    options.batchSize = std::max<size_t>(options.batchSize, 1);
+
+    // Sockets are bound here, so datagrams sent before start are queued in their receive buffers
+    try
+    {
+        for (size_t index = 0; index < options.threadCount; ++index)
+        {
+            auto worker = std::make_unique<Worker>();
+            worker->fd = openSocket();
+            workers.push_back(std::move(worker));
+        }
+    }
+    catch (...)
+    {
+        for (auto& worker : workers)
+            close(worker->fd);
+        throw;
+    }
+}
+
+UdpReceiver::~UdpReceiver()
+{
+    running = false;
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+        close(worker->fd);
+    }
+}
+
+void UdpReceiver::start()
+{
+    if (running)
+        return;
+
+    running = true;
+    for (size_t index = 0; index < workers.size(); ++index)
+        workers[index]->thread = std::thread(&UdpReceiver::receiveThread, this, index);
+}
+
+void UdpReceiver::stop()
+{
+    running = false;
+    for (auto& worker : workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (!error.empty())
+    {
+        const auto message = std::move(error);
+        error.clear();
+        throw std::runtime_error(message);
+    }
+}
+
+uint16_t UdpReceiver::getPort() const
+{
+    return port;
+}
+
+UdpReceiver::Stats UdpReceiver::getStats() const
+{
+    Stats stats;
+    for (const auto& worker : workers)
+    {
+        stats.datagrams += worker->datagrams.load(std::memory_order_relaxed);
+        stats.bytes += worker->bytes.load(std::memory_order_relaxed);
+        stats.packets += worker->packets.load(std::memory_order_relaxed);
+        stats.batches += worker->batches.load(std::memory_order_relaxed);
+        stats.truncated += worker->truncated.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+int UdpReceiver::openSocket()
+{
+    const auto address = createAddress(options.address, port);
+
+    const int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error("Cannot create UDP socket: " + lastError());
+
+    setOption(fd, SO_REUSEPORT, 1, "SO_REUSEPORT");
+    if (options.receiveBufferSize > 0)
+        setOption(fd, SO_RCVBUF, options.receiveBufferSize, "SO_RCVBUF");
+    if (options.kernelTimestamps)
+        setOption(fd, SO_TIMESTAMPNS, 1, "SO_TIMESTAMPNS");
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const auto message = "Cannot bind UDP socket to " + options.address + ":" + std::to_string(port) + ": " + lastError();
+        close(fd);
+        throw std::runtime_error(message);
+    }
+
+    // The sockets after the first one join the port that was bound first
+    if (port == 0)
+    {
+        sockaddr_in bound{};
+        socklen_t length = sizeof(bound);
+        getsockname(fd, reinterpret_cast<sockaddr*>(&bound), &length);
+        port = ntohs(bound.sin_port);
+    }
+    return fd;
+}
+
+void UdpReceiver::receiveThread(const size_t threadIndex)
+{
+    auto& worker = *workers[threadIndex];
+    const size_t batchSize = options.batchSize;
+    const size_t datagramSize = options.maxDatagramSize;
+
+    std::vector<uint8_t> buffers(batchSize * datagramSize);
+    std::vector<iovec> iovecs(batchSize);
+    std::vector<ControlBuffer> controls(batchSize);
+    std::vector<mmsghdr> messages(batchSize);
+    for (size_t index = 0; index < batchSize; ++index)
+    {
+        iovecs[index].iov_base = buffers.data() + index * datagramSize;
+        iovecs[index].iov_len = datagramSize;
+    }
+
+    Decoder decoder;
+    Batch batch;
+    batch.threadIndex = threadIndex;
+    pollfd descriptor{worker.fd, POLLIN, 0};
+
+    try
+    {
+        while (running.load(std::memory_order_relaxed))
+        {
+            const int ready = poll(&descriptor, 1, options.pollTimeout);
+            if (ready < 0 && errno != EINTR)
+                throw std::runtime_error("Cannot poll UDP socket: " + lastError());
+            if (ready <= 0)
+                continue;
+
+            // recvmmsg overwrites the lengths and flags of the headers
+            for (size_t index = 0; index < batchSize; ++index)
+            {
+                auto& header = messages[index].msg_hdr;
+                header = msghdr{};
+                header.msg_iov = &iovecs[index];
+                header.msg_iovlen = 1;
+                header.msg_control = &controls[index];
+                header.msg_controllen = controlSize;
+            }
+
+            const int count = recvmmsg(worker.fd, messages.data(), static_cast<unsigned int>(batchSize), MSG_DONTWAIT, nullptr);
+            if (count < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    continue;
+                throw std::runtime_error("Cannot receive UDP datagrams: " + lastError());
+            }
+
+            const uint64_t clockTime = getSystemTime();
+            batch.packets.clear();
+            batch.receiveTimes.clear();
+            uint64_t bytes = 0;
+            uint64_t truncated = 0;
+            for (int index = 0; index < count; ++index)
+            {
+                auto& header = messages[index].msg_hdr;
+                if (header.msg_flags & MSG_TRUNC)
+                {
+                    ++truncated;
+                    continue;
+                }
+
+                bytes += messages[index].msg_len;
+                decoder.decode(iovecs[index].iov_base, messages[index].msg_len, batch.packets);
+                const uint64_t receiveTime = options.kernelTimestamps ? getKernelTime(header, clockTime) : clockTime;
+                batch.receiveTimes.resize(batch.packets.size(), receiveTime);
+            }
+
+            worker.datagrams.fetch_add(static_cast<uint64_t>(count), std::memory_order_relaxed);
+            worker.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            worker.packets.fetch_add(batch.packets.size(), std::memory_order_relaxed);
+            worker.batches.fetch_add(1, std::memory_order_relaxed);
+            worker.truncated.fetch_add(truncated, std::memory_order_relaxed);
+
+            if (!batch.packets.empty())
+                handler(batch);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        setError(e.what());
+    }
+}
+
+void UdpReceiver::setError(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error.empty())
+        error = message;
+}
+
+UdpSender::UdpSender(Options newOptions)
+    : options(std::move(newOptions))
+{
+    options.batchSize = std::max<size_t>(options.batchSize, 1);
+
+    const auto address = createAddress(options.address, options.port);
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        throw std::runtime_error("Cannot create UDP socket: " + lastError());
+
+    if (options.sendBufferSize > 0)
+        setOption(fd, SO_SNDBUF, options.sendBufferSize, "SO_SNDBUF");
+
+    // A connected socket needs no address per datagram
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        const auto message = "Cannot connect UDP socket to " + options.address + ":" + std::to_string(options.port) + ": " + lastError();
+        close(fd);
+        throw std::runtime_error(message);
+    }
+}
+
+UdpSender::~UdpSender()
+{
+    close(fd);
+}
+
+void UdpSender::send(const std::vector<std::vector<uint8_t>>& frames)
+{
+    const size_t batchSize = std::min(options.batchSize, frames.size());
+    std::vector<iovec> iovecs(batchSize);
+    std::vector<mmsghdr> messages(batchSize);
+
+    for (size_t offset = 0; offset < frames.size();)
+    {
+        const size_t count = std::min(batchSize, frames.size() - offset);
+        for (size_t index = 0; index < count; ++index)
+        {
+            const auto& frame = frames[offset + index];
+            iovecs[index].iov_base = const_cast<uint8_t*>(frame.data());
+            iovecs[index].iov_len = frame.size();
+            messages[index].msg_hdr = msghdr{};
+            messages[index].msg_hdr.msg_iov = &iovecs[index];
+            messages[index].msg_hdr.msg_iovlen = 1;
+        }
+
+        // sendmmsg may send fewer datagrams than requested, the rest is sent with the next call
+        const int sent = sendmmsg(fd, messages.data(), static_cast<unsigned int>(count), 0);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error("Cannot send UDP datagrams: " + lastError());
+        }
+
+        for (int index = 0; index < sent; ++index)
+            stats.bytes += messages[index].msg_len;
+        stats.datagrams += static_cast<uint64_t>(sent);
+        ++stats.calls;
+        offset += static_cast<size_t>(sent);
+    }
+}
+
+const UdpSender::Stats& UdpSender::getStats() const
+{
+    return stats;
+}
+
+END_NAMESPACE_ASAM_CMP
@@ -12,6 +12,7 @@
 #include <asam_cmp/analog_payload.h>
 #include <asam_cmp/decoder.h>
 #include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
 #include <asam_cmp/interface_payload.h>
 
 template <typename Header>
@@ -52,6 +53,16 @@ inline std::vector<uint8_t> createEthernetDataMessage(const std::vector<uint8_t>
     return createMessage(header, data);
 }
 
+inline std::vector<uint8_t> createFlexRayDataMessage(const uint16_t frameId, const uint8_t cycle, const std::vector<uint8_t>& data)
+{
+    ASAM::CMP::FlexRayPayload::Header header;
+    header.setFrameId(frameId);
+    header.setCycle(cycle);
+    header.setPayloadLength(static_cast<uint8_t>(data.size()));
+
+    return createMessage(header, data);
+}
+
 inline std::vector<uint8_t> createAnalogDataMessage(const std::vector<uint8_t>& data)
 {
     ASAM::CMP::AnalogPayload::Header header;
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/analog_decimator.h>
+
+using ASAM::CMP::AnalogDecimator;
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::Packet;
+
+class AnalogDecimatorTest : public ::testing::Test
+{
+protected:
+    // Sample values are the sample indices counted from timestamp 0
+    static Packet createPacket(const uint64_t firstSample, const size_t samplesCount, const float scalar = 1.f)
+    {
+        std::vector<int32_t> samples(samplesCount);
+        std::iota(samples.begin(), samples.end(), static_cast<int32_t>(firstSample));
+
+        AnalogPayload payload;
+        payload.setSampleInterval(sampleInterval);
+        payload.setSampleScalar(scalar);
+        payload.setSamples(samples.data(), samples.size());
+
+        Packet packet;
+        packet.setTimestamp(firstSample * sampleIntervalNs);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+protected:
+    static constexpr float sampleInterval = 0.0078125f;
+    static constexpr uint64_t sampleIntervalNs = 7'812'500;
+    static constexpr size_t factor = 4;
+    static constexpr size_t levelsCount = 3;
+};
+
+TEST_F(AnalogDecimatorTest, Levels)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    ASSERT_TRUE(decimator.addPacket(createPacket(0, 32)));
+    ASSERT_TRUE(decimator.addPacket(createPacket(32, 32)));
+
+    ASSERT_EQ(decimator.getBucketsCount(0), 16u);
+    ASSERT_EQ(decimator.getBucketsCount(1), 4u);
+    ASSERT_EQ(decimator.getBucketsCount(2), 1u);
+    ASSERT_EQ(decimator.getBucketDuration(1), 16 * sampleIntervalNs);
+
+    const auto& bucket = decimator.getBucket(1, 2);
+    ASSERT_EQ(bucket.timestamp, 32 * sampleIntervalNs);
+    ASSERT_EQ(bucket.endTimestamp, 48 * sampleIntervalNs);
+    ASSERT_DOUBLE_EQ(bucket.min, 32.);
+    ASSERT_DOUBLE_EQ(bucket.max, 47.);
+    ASSERT_DOUBLE_EQ(bucket.getMean(), 39.5);
+
+    const auto& top = decimator.getBucket(2, 0);
+    ASSERT_EQ(top.count, 64u);
+    ASSERT_DOUBLE_EQ(top.min, 0.);
+    ASSERT_DOUBLE_EQ(top.max, 63.);
+    ASSERT_DOUBLE_EQ(top.getMean(), 31.5);
+}
+
+TEST_F(AnalogDecimatorTest, GapClosesBuckets)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 6));
+    ASSERT_EQ(decimator.getBucketsCount(0), 1u);
+
+    decimator.addPacket(createPacket(100, 6));
+    ASSERT_EQ(decimator.getBucketsCount(0), 3u);
+    ASSERT_EQ(decimator.getBucket(0, 1).count, 2u);
+    ASSERT_EQ(decimator.getBucket(0, 1).endTimestamp, 6 * sampleIntervalNs);
+    ASSERT_EQ(decimator.getBucketsCount(1), 1u);
+    ASSERT_EQ(decimator.getBucket(1, 0).count, 6u);
+    ASSERT_EQ(decimator.getBucketsCount(2), 1u);
+}
+
+TEST_F(AnalogDecimatorTest, RejectsOverlappingPackets)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    ASSERT_TRUE(decimator.addPacket(createPacket(100, 8)));
+    ASSERT_FALSE(decimator.addPacket(createPacket(104, 8)));
+    ASSERT_FALSE(decimator.addPacket(createPacket(100, 8)));
+    ASSERT_TRUE(decimator.addPacket(createPacket(108, 8)));
+    ASSERT_EQ(decimator.getTimestampResets(), 0u);
+
+    ASSERT_EQ(decimator.getBucketsCount(0), 4u);
+    for (size_t index = 1; index < decimator.getBucketsCount(0); ++index)
+        ASSERT_GE(decimator.getBucket(0, index).timestamp, decimator.getBucket(0, index - 1).endTimestamp);
+
+    const auto pixels = decimator.query(100 * sampleIntervalNs, 116 * sampleIntervalNs, 4);
+    for (size_t index = 0; index < pixels.size(); ++index)
+        ASSERT_DOUBLE_EQ(pixels[index].min, 100. + index * 4);
+}
+
+TEST_F(AnalogDecimatorTest, TimestampReset)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    ASSERT_TRUE(decimator.addPacket(createPacket(100, 8)));
+    ASSERT_TRUE(decimator.addPacket(createPacket(108, 8)));
+
+    // The device restarts, following packets continue the new time base
+    ASSERT_TRUE(decimator.addPacket(createPacket(0, 8)));
+    ASSERT_TRUE(decimator.addPacket(createPacket(8, 8)));
+    ASSERT_EQ(decimator.getTimestampResets(), 1u);
+
+    ASSERT_EQ(decimator.getBucketsCount(0), 4u);
+    ASSERT_EQ(decimator.getBucket(0, 0).timestamp, 0u);
+    ASSERT_EQ(decimator.getBucketsCount(1), 1u);
+    ASSERT_DOUBLE_EQ(decimator.getBucket(1, 0).max, 15.);
+
+    const auto pixels = decimator.query(0, 16 * sampleIntervalNs, 4);
+    for (size_t index = 0; index < pixels.size(); ++index)
+        ASSERT_DOUBLE_EQ(pixels[index].min, index * 4.);
+
+    decimator.clear();
+    ASSERT_EQ(decimator.getTimestampResets(), 0u);
+}
+
+TEST_F(AnalogDecimatorTest, SelectLevel)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 64));
+
+    ASSERT_EQ(decimator.selectLevel(0, 64 * sampleIntervalNs, 64), 0u);
+    ASSERT_EQ(decimator.selectLevel(0, 64 * sampleIntervalNs, 4), 1u);
+    ASSERT_EQ(decimator.selectLevel(0, 64 * sampleIntervalNs, 1), 2u);
+    ASSERT_EQ(decimator.selectLevel(0, 64 * sampleIntervalNs, 0), 0u);
+}
+
+TEST_F(AnalogDecimatorTest, Query)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    for (uint64_t i = 0; i < 8; ++i)
+        decimator.addPacket(createPacket(i * 8, 8));
+
+    auto pixels = decimator.query(0, 64 * sampleIntervalNs, 4);
+    ASSERT_EQ(pixels.size(), 4u);
+    for (size_t i = 0; i < pixels.size(); ++i)
+    {
+        ASSERT_EQ(pixels[i].count, 16u);
+        ASSERT_DOUBLE_EQ(pixels[i].min, i * 16.);
+        ASSERT_DOUBLE_EQ(pixels[i].max, i * 16. + 15.);
+    }
+
+    pixels = decimator.query(32 * sampleIntervalNs, 48 * sampleIntervalNs, 2);
+    ASSERT_EQ(pixels[0].count, 8u);
+    ASSERT_DOUBLE_EQ(pixels[0].min, 32.);
+    ASSERT_DOUBLE_EQ(pixels[1].max, 47.);
+}
+
+TEST_F(AnalogDecimatorTest, QueryIncludesOpenBuckets)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 10));
+
+    auto pixels = decimator.query(0, 10 * sampleIntervalNs, 1);
+    ASSERT_EQ(pixels[0].count, 10u);
+    ASSERT_DOUBLE_EQ(pixels[0].min, 0.);
+    ASSERT_DOUBLE_EQ(pixels[0].max, 9.);
+    ASSERT_DOUBLE_EQ(pixels[0].getMean(), 4.5);
+}
+
+TEST_F(AnalogDecimatorTest, EmptyPixels)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 16));
+
+    auto pixels = decimator.query(0, 32 * sampleIntervalNs, 2);
+    ASSERT_EQ(pixels[0].count, 16u);
+    ASSERT_EQ(pixels[1].count, 0u);
+}
+
+TEST_F(AnalogDecimatorTest, NegativeScalar)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 4, -2.f));
+
+    const auto& bucket = decimator.getBucket(0, 0);
+    ASSERT_DOUBLE_EQ(bucket.min, -6.);
+    ASSERT_DOUBLE_EQ(bucket.max, 0.);
+    ASSERT_DOUBLE_EQ(bucket.getMean(), -3.);
+}
+
+TEST_F(AnalogDecimatorTest, MaxBucketsPerLevel)
+{
+    AnalogDecimator decimator(factor, levelsCount, 2);
+    decimator.addPacket(createPacket(0, 64));
+
+    ASSERT_EQ(decimator.getBucketsCount(0), 2u);
+    ASSERT_EQ(decimator.getBucket(0, 0).timestamp, 56 * sampleIntervalNs);
+    ASSERT_EQ(decimator.getBucketsCount(1), 2u);
+    ASSERT_EQ(decimator.getBucketsCount(2), 1u);
+}
+
+TEST_F(AnalogDecimatorTest, Clear)
+{
+    AnalogDecimator decimator(factor, levelsCount);
+    decimator.addPacket(createPacket(0, 64));
+    decimator.clear();
+
+    ASSERT_EQ(decimator.getBucketsCount(0), 0u);
+    ASSERT_EQ(decimator.query(0, 64 * sampleIntervalNs, 4)[0].count, 0u);
+}
+
+TEST_F(AnalogDecimatorTest, NotAnalogPacket)
+{
+    AnalogDecimator decimator;
+    ASSERT_FALSE(decimator.addPacket(Packet()));
+}
@@ -182,3 +182,81 @@ TEST_F(AnalogPayloadTest, SampleDtTypeTraits)
     ASSERT_EQ(AnalogPayload::SampleDtFromType<int16_t>::sampleDtType, AnalogPayload::SampleDt::aInt16);
     ASSERT_EQ(AnalogPayload::SampleDtFromType<int32_t>::sampleDtType, AnalogPayload::SampleDt::aInt32);
 }
+
+TEST_F(AnalogPayloadTest, ToFloat)
+{
+    std::vector<int16_t> samples = {-32768, -1, 0, 1, 2, 3, 4, 5, 6, 7, 32767};
+    std::vector<uint8_t> bytes(samples.size() * sizeof(int16_t));
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        auto value = ASAM::CMP::swapEndian(static_cast<uint16_t>(samples[i]));
+        memcpy(bytes.data() + i * sizeof(int16_t), &value, sizeof(value));
+    }
+
+    dcPayload.setData(bytes.data(), bytes.size());
+    dcPayload.setSampleScalar(0.5f);
+    dcPayload.setSampleOffset(10.f);
+
+    std::vector<float> values(dcPayload.getSamplesCount());
+    dcPayload.toFloat(values.data());
+    for (size_t i = 0; i < samples.size(); ++i)
+        ASSERT_FLOAT_EQ(values[i], samples[i] * 0.5f + 10.f);
+}
+
+TEST_F(AnalogPayloadTest, ToDouble)
+{
+    std::vector<int32_t> samples = {std::numeric_limits<int32_t>::min(), -100000, 0, 100000, std::numeric_limits<int32_t>::max()};
+    std::vector<uint8_t> bytes(samples.size() * sizeof(int32_t));
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        auto value = ASAM::CMP::swapEndian(static_cast<uint32_t>(samples[i]));
+        memcpy(bytes.data() + i * sizeof(int32_t), &value, sizeof(value));
+    }
+
+    dcPayload.setSampleDt(AnalogPayload::SampleDt::aInt32);
+    dcPayload.setData(bytes.data(), bytes.size());
+    dcPayload.setSampleScalar(2.f);
+    dcPayload.setSampleOffset(-1.f);
+
+    std::vector<double> values(dcPayload.getSamplesCount());
+    dcPayload.toDouble(values.data());
+    for (size_t i = 0; i < samples.size(); ++i)
+        ASSERT_DOUBLE_EQ(values[i], samples[i] * 2.0 - 1.0);
+}
+
+TEST_F(AnalogPayloadTest, ToFloatBatch)
+{
+    payload->setSampleScalar(1.f);
+    std::vector<AnalogPayload> payloads = {*payload, dcPayload, *payload};
+
+    const auto count = AnalogPayload::getSamplesCount(payloads.begin(), payloads.end());
+    ASSERT_EQ(count, 2 * payload->getSamplesCount());
+
+    std::vector<float> values(count);
+    ASSERT_EQ(AnalogPayload::toFloat(payloads.begin(), payloads.end(), values.data()), count);
+
+    std::vector<float> expected(payload->getSamplesCount());
+    payload->toFloat(expected.data());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), values.begin()));
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), values.begin() + expected.size()));
+}
+
+TEST_F(AnalogPayloadTest, ToDoubleBatchPackets)
+{
+    payload->setSampleScalar(1.f);
+    auto analogPacket = std::make_shared<ASAM::CMP::Packet>();
+    analogPacket->setPayload(*payload);
+    auto canPacket = std::make_shared<ASAM::CMP::Packet>();
+    canPacket->setPayload(ASAM::CMP::CanPayload{});
+    std::vector<std::shared_ptr<ASAM::CMP::Packet>> packets = {analogPacket, canPacket, analogPacket, nullptr};
+
+    const auto count = AnalogPayload::getSamplesCount(packets.begin(), packets.end());
+    ASSERT_EQ(count, 2 * payload->getSamplesCount());
+
+    std::vector<double> values(count);
+    ASSERT_EQ(AnalogPayload::toDouble(packets.begin(), packets.end(), values.data()), count);
+
+    std::vector<double> expected(payload->getSamplesCount());
+    payload->toDouble(expected.data());
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), values.begin() + expected.size()));
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/analog_stream.h>
+#include <asam_cmp/can_payload.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::AnalogStream;
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::Packet;
+
+class AnalogStreamTest : public ::testing::Test
+{
+protected:
+    // Sample values continue the ramp started at timestamp 0
+    static Packet createPacket(const uint64_t timestamp, const size_t samplesCount)
+    {
+        const auto firstSample = static_cast<int16_t>(timestamp / sampleIntervalNs);
+        std::vector<int16_t> samples(samplesCount);
+        std::iota(samples.begin(), samples.end(), firstSample);
+
+        AnalogPayload payload;
+        payload.setSampleInterval(sampleInterval);
+        payload.setSampleScalar(1.f);
+        payload.setSamples(samples.data(), samples.size());
+
+        Packet packet;
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+    static void checkRamp(const AnalogStream::Block& block)
+    {
+        const auto firstSample = static_cast<float>(block.getTimestamp() / sampleIntervalNs);
+        for (size_t i = 0; i < block.getSize(); ++i)
+            ASSERT_FLOAT_EQ(block.getData()[i], firstSample + static_cast<float>(i));
+    }
+
+protected:
+    static constexpr float sampleInterval = 0.0078125f;
+    static constexpr uint64_t sampleIntervalNs = 7'812'500;
+    static constexpr size_t packetSize = 128;
+};
+
+TEST_F(AnalogStreamTest, ContinuousPackets)
+{
+    AnalogStream stream(0, 0, 1024);
+    for (uint64_t i = 0; i < 4; ++i)
+        ASSERT_TRUE(stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize)));
+
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    const auto& block = stream.getBlock(0);
+    ASSERT_EQ(block.getSize(), 4 * packetSize);
+    ASSERT_EQ(block.getTimestamp(), 0u);
+    ASSERT_EQ(block.getEndTimestamp(), 4 * packetSize * sampleIntervalNs);
+    checkRamp(block);
+
+    ASSERT_EQ(stream.getStats().packets, 4u);
+    ASSERT_EQ(stream.getStats().samples, 4 * packetSize);
+    ASSERT_EQ(stream.getStats().gaps, 0u);
+}
+
+TEST_F(AnalogStreamTest, JitterIsTolerated)
+{
+    AnalogStream stream;
+    stream.addPacket(createPacket(0, packetSize));
+    stream.addPacket(createPacket(packetSize * sampleIntervalNs + sampleIntervalNs / 3, packetSize));
+    stream.addPacket(createPacket(2 * packetSize * sampleIntervalNs - sampleIntervalNs / 3, packetSize));
+
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    ASSERT_EQ(stream.getBlock(0).getSize(), 3 * packetSize);
+}
+
+TEST_F(AnalogStreamTest, BlockOverflow)
+{
+    AnalogStream stream(0, 0, 300);
+    const float* firstBlockData = nullptr;
+    for (uint64_t i = 0; i < 4; ++i)
+    {
+        stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize));
+        if (i == 0)
+            firstBlockData = stream.getBlock(0).getData();
+    }
+
+    ASSERT_EQ(stream.getBlocksCount(), 2u);
+    ASSERT_EQ(stream.getBlock(0).getData(), firstBlockData);
+    ASSERT_EQ(stream.getBlock(0).getSize(), 300u);
+    ASSERT_EQ(stream.getBlock(1).getSize(), 4 * packetSize - 300);
+    ASSERT_TRUE(stream.getBlock(1).isContinuous());
+    ASSERT_EQ(stream.getBlock(1).getTimestamp(), stream.getBlock(0).getEndTimestamp());
+    checkRamp(stream.getBlock(0));
+    checkRamp(stream.getBlock(1));
+}
+
+TEST_F(AnalogStreamTest, Gap)
+{
+    AnalogStream stream;
+    stream.addPacket(createPacket(0, packetSize));
+    stream.addPacket(createPacket(3 * packetSize * sampleIntervalNs, packetSize));
+
+    ASSERT_EQ(stream.getBlocksCount(), 2u);
+    ASSERT_FALSE(stream.getBlock(1).isContinuous());
+    ASSERT_EQ(stream.getBlock(1).getTimestamp(), 3 * packetSize * sampleIntervalNs);
+    checkRamp(stream.getBlock(1));
+    ASSERT_EQ(stream.getStats().gaps, 1u);
+    ASSERT_EQ(stream.getStats().missingSamples, 2 * packetSize);
+}
+
+TEST_F(AnalogStreamTest, Overlap)
+{
+    AnalogStream stream;
+    stream.addPacket(createPacket(0, packetSize));
+    stream.addPacket(createPacket(packetSize / 2 * sampleIntervalNs, packetSize));
+
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    ASSERT_EQ(stream.getBlock(0).getSize(), packetSize + packetSize / 2);
+    checkRamp(stream.getBlock(0));
+    ASSERT_EQ(stream.getStats().overlaps, 1u);
+    ASSERT_EQ(stream.getStats().droppedSamples, packetSize / 2);
+}
+
+TEST_F(AnalogStreamTest, Duplicate)
+{
+    AnalogStream stream;
+    stream.addPacket(createPacket(0, packetSize));
+    stream.addPacket(createPacket(0, packetSize));
+
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    ASSERT_EQ(stream.getBlock(0).getSize(), packetSize);
+    ASSERT_EQ(stream.getStats().droppedSamples, packetSize);
+}
+
+TEST_F(AnalogStreamTest, TimestampReset)
+{
+    AnalogStream stream;
+    for (uint64_t i = 10; i < 13; ++i)
+        stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize));
+    // The device clock restarts at 0
+    for (uint64_t i = 0; i < 2; ++i)
+        ASSERT_TRUE(stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize)));
+
+    ASSERT_EQ(stream.getBlocksCount(), 2u);
+    const auto& block = stream.getBlock(1);
+    ASSERT_FALSE(block.isContinuous());
+    ASSERT_EQ(block.getTimestamp(), 0u);
+    ASSERT_EQ(block.getSize(), 2 * packetSize);
+    checkRamp(block);
+    ASSERT_EQ(stream.getStats().timestampJumps, 1u);
+    ASSERT_EQ(stream.getStats().overlaps, 0u);
+    ASSERT_EQ(stream.getStats().droppedSamples, 0u);
+    ASSERT_EQ(stream.getIndexByTimestamp(packetSize * sampleIntervalNs), 1u);
+}
+
+TEST_F(AnalogStreamTest, IntervalChangeStartsNewBlock)
+{
+    AnalogStream stream;
+    stream.addPacket(createPacket(0, packetSize));
+
+    auto packet = createPacket(packetSize * sampleIntervalNs, packetSize);
+    static_cast<AnalogPayload&>(packet.getPayload()).setSampleInterval(sampleInterval * 2);
+    stream.addPacket(packet);
+
+    ASSERT_EQ(stream.getBlocksCount(), 2u);
+    ASSERT_FALSE(stream.getBlock(1).isContinuous());
+    ASSERT_EQ(stream.getStats().gaps, 0u);
+}
+
+TEST_F(AnalogStreamTest, MaxBlocksCount)
+{
+    AnalogStream stream(0, 0, packetSize, 2);
+    for (uint64_t i = 0; i < 5; ++i)
+        stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize));
+
+    ASSERT_EQ(stream.getBlocksCount(), 2u);
+    ASSERT_EQ(stream.getBlock(0).getTimestamp(), 3 * packetSize * sampleIntervalNs);
+    checkRamp(stream.getBlock(0));
+    checkRamp(stream.getBlock(1));
+}
+
+TEST_F(AnalogStreamTest, IndexByTimestamp)
+{
+    AnalogStream stream(0, 0, packetSize);
+    for (uint64_t i = 0; i < 3; ++i)
+        stream.addPacket(createPacket(i * packetSize * sampleIntervalNs, packetSize));
+
+    ASSERT_EQ(stream.getIndexByTimestamp(0), 0u);
+    ASSERT_EQ(stream.getIndexByTimestamp(packetSize * sampleIntervalNs + 5), 1u);
+    ASSERT_EQ(stream.getIndexByTimestamp(3 * packetSize * sampleIntervalNs), stream.getBlocksCount());
+
+    stream.removeBlocks(2);
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    ASSERT_EQ(stream.getIndexByTimestamp(0), stream.getBlocksCount());
+}
+
+TEST_F(AnalogStreamTest, NotAnalogPacket)
+{
+    Packet packet;
+    packet.setPayload(CanPayload());
+
+    AnalogStream stream;
+    ASSERT_FALSE(stream.addPacket(packet));
+    ASSERT_EQ(stream.getStats().packets, 0u);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <asam_cmp/analog_stream_assembler.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::AnalogStreamAssembler;
+using ASAM::CMP::Packet;
+
+class AnalogStreamAssemblerTest : public ::testing::Test
+{
+protected:
+    static Packet createPacket(const uint16_t deviceId, const uint32_t interfaceId, const uint64_t timestamp)
+    {
+        std::vector<int16_t> samples(samplesCount, static_cast<int16_t>(interfaceId));
+        AnalogPayload payload;
+        payload.setSampleInterval(1e-3f);
+        payload.setSampleScalar(1.f);
+        payload.setSamples(samples.data(), samples.size());
+
+        Packet packet;
+        packet.setDeviceId(deviceId);
+        packet.setInterfaceId(interfaceId);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+protected:
+    static constexpr size_t samplesCount = 10;
+    static constexpr uint64_t packetDuration = samplesCount * 1'000'000;
+};
+
+TEST_F(AnalogStreamAssemblerTest, StreamPerInterface)
+{
+    AnalogStreamAssembler assembler;
+    for (uint64_t i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(assembler.addPacket(createPacket(1, 1, i * packetDuration)));
+        ASSERT_TRUE(assembler.addPacket(createPacket(1, 2, i * packetDuration)));
+        ASSERT_TRUE(assembler.addPacket(createPacket(2, 1, i * packetDuration)));
+    }
+    ASSERT_EQ(assembler.getStreamsCount(), 3u);
+
+    auto index = assembler.getIndexByInterface(1, 2);
+    ASSERT_LT(index, assembler.getStreamsCount());
+    const auto& stream = assembler.getStream(index);
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    ASSERT_EQ(stream.getBlock(0).getSize(), 3 * samplesCount);
+    ASSERT_FLOAT_EQ(stream.getBlock(0).getData()[0], 2.f);
+}
+
+TEST_F(AnalogStreamAssemblerTest, RemoveStream)
+{
+    AnalogStreamAssembler assembler;
+    assembler.addPacket(createPacket(1, 1, 0));
+    assembler.addPacket(createPacket(1, 2, 0));
+
+    assembler.removeStream(1, 1);
+    ASSERT_EQ(assembler.getStreamsCount(), 1u);
+    ASSERT_EQ(assembler.getIndexByInterface(1, 1), assembler.getStreamsCount());
+    ASSERT_EQ(assembler.getStream(0).getInterfaceId(), 2u);
+    ASSERT_EQ(assembler.getIndexByInterface(1, 2), 0u);
+
+    assembler.clear();
+    ASSERT_EQ(assembler.getStreamsCount(), 0u);
+    ASSERT_EQ(assembler.getIndexByInterface(1, 2), 0u);
+    ASSERT_TRUE(assembler.addPacket(createPacket(1, 2, 0)));
+    ASSERT_EQ(assembler.getStreamsCount(), 1u);
+}
+
+TEST_F(AnalogStreamAssemblerTest, IgnoresOtherPackets)
+{
+    AnalogStreamAssembler assembler;
+    ASSERT_FALSE(assembler.addPacket(Packet()));
+    ASSERT_EQ(assembler.getStreamsCount(), 0u);
+}
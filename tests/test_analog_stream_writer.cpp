@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+
+#include <asam_cmp/analog_stream_writer.h>
+#include <asam_cmp/decoder.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::AnalogStreamWriter;
+using ASAM::CMP::CmpHeader;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Decoder;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::MessageHeader;
+using ASAM::CMP::PayloadType;
+using PacketPtr = std::shared_ptr<ASAM::CMP::Packet>;
+
+class AnalogStreamWriterTest : public ::testing::Test
+{
+public:
+    AnalogStreamWriterTest()
+    {
+        format.setSampleDt(AnalogPayload::SampleDt::aInt16);
+        format.setUnit(AnalogPayload::Unit::volt);
+        format.setSampleInterval(sampleInterval);
+        format.setSampleScalar(0.5f);
+        format.setSampleOffset(1.f);
+
+        samples.resize(samplesCount);
+        std::iota(samples.begin(), samples.end(), int16_t{-500});
+    }
+
+protected:
+    uint64_t expectedTimestamp(const uint64_t sampleIndex) const
+    {
+        return timestamp + static_cast<uint64_t>(std::llround(static_cast<double>(sampleIndex) * sampleInterval * 1e9));
+    }
+
+protected:
+    static constexpr float sampleInterval = 1e-5f;
+    static constexpr uint64_t timestamp = 1'000'000;
+    static constexpr size_t samplesCount = 2000;
+
+    AnalogPayload format;
+    std::vector<int16_t> samples;
+};
+
+TEST_F(AnalogStreamWriterTest, SamplesPerPacket)
+{
+    AnalogStreamWriter writer(format);
+    constexpr size_t headersSize = sizeof(CmpHeader) + sizeof(MessageHeader) + sizeof(AnalogPayload::Header);
+    ASSERT_EQ(writer.getSamplesPerPacket(), (DataContext{}.maxBytesPerMessage - headersSize) / sizeof(int16_t));
+}
+
+TEST_F(AnalogStreamWriterTest, TooSmallMessage)
+{
+    ASSERT_THROW(AnalogStreamWriter(format, DataContext{0, 40}), std::invalid_argument);
+}
+
+TEST_F(AnalogStreamWriterTest, FramesAreFilled)
+{
+    DataContext dataContext;
+    AnalogStreamWriter writer(format, dataContext);
+    writer.setTimestamp(timestamp);
+    auto packets = writer.write(samples.data(), samples.size());
+
+    ASSERT_EQ(packets.size(), samplesCount / writer.getSamplesPerPacket());
+    ASSERT_EQ(writer.getPendingSamplesCount(), samplesCount % writer.getSamplesPerPacket());
+
+    Encoder encoder;
+    for (const auto& packet : packets)
+    {
+        auto frames = encoder.encode(*packet, dataContext);
+        ASSERT_EQ(frames.size(), 1u);
+        ASSERT_EQ(frames[0].size(), dataContext.maxBytesPerMessage);
+    }
+}
+
+TEST_F(AnalogStreamWriterTest, ContinuousTimestamps)
+{
+    AnalogStreamWriter writer(format);
+    writer.setTimestamp(timestamp);
+
+    std::vector<PacketPtr> packets;
+    for (size_t pos = 0; pos < samplesCount; pos += 333)
+    {
+        auto newPackets = writer.write(samples.data() + pos, std::min<size_t>(333, samplesCount - pos));
+        packets.insert(packets.end(), newPackets.begin(), newPackets.end());
+    }
+    auto lastPackets = writer.flush();
+    packets.insert(packets.end(), lastPackets.begin(), lastPackets.end());
+    ASSERT_EQ(writer.getPendingSamplesCount(), 0u);
+    ASSERT_EQ(writer.getTimestamp(), expectedTimestamp(samplesCount));
+
+    size_t sampleIndex = 0;
+    std::vector<int16_t> decodedSamples;
+    for (const auto& packet : packets)
+    {
+        ASSERT_EQ(packet->getPayload().getType(), PayloadType::analog);
+        ASSERT_EQ(packet->getTimestamp(), expectedTimestamp(sampleIndex));
+
+        const auto& payload = static_cast<const AnalogPayload&>(packet->getPayload());
+        ASSERT_EQ(payload.getUnit(), AnalogPayload::Unit::volt);
+        ASSERT_FLOAT_EQ(payload.getSampleScalar(), 0.5f);
+        for (size_t i = 0; i < payload.getSamplesCount(); ++i)
+        {
+            const uint8_t* sample = payload.getData() + i * sizeof(int16_t);
+            decodedSamples.push_back(static_cast<int16_t>((sample[0] << 8) | sample[1]));
+        }
+        sampleIndex += payload.getSamplesCount();
+    }
+    ASSERT_EQ(decodedSamples, samples);
+}
+
+TEST_F(AnalogStreamWriterTest, EncodeDecode)
+{
+    DataContext dataContext;
+    AnalogStreamWriter writer(format, dataContext);
+    writer.setDeviceId(3);
+    writer.setStreamId(1);
+    writer.setInterfaceId(7);
+    writer.setTimestamp(timestamp);
+    auto packets = writer.write(samples.data(), samples.size());
+
+    Encoder encoder;
+    Decoder decoder;
+    size_t sampleIndex = 0;
+    for (const auto& frame : encoder.encode(packets.begin(), packets.end(), dataContext))
+    {
+        auto decoded = decoder.decode(frame.data(), frame.size());
+        ASSERT_EQ(decoded.size(), 1u);
+        ASSERT_EQ(decoded[0]->getInterfaceId(), 7u);
+        ASSERT_EQ(decoded[0]->getTimestamp(), expectedTimestamp(sampleIndex));
+        sampleIndex += static_cast<const AnalogPayload&>(decoded[0]->getPayload()).getSamplesCount();
+    }
+    ASSERT_EQ(sampleIndex, packets.size() * writer.getSamplesPerPacket());
+}
+
+TEST_F(AnalogStreamWriterTest, SetTimestampDiscardsPendingSamples)
+{
+    AnalogStreamWriter writer(format);
+    writer.write(samples.data(), 10);
+    ASSERT_EQ(writer.getPendingSamplesCount(), 10u);
+
+    writer.setTimestamp(timestamp);
+    ASSERT_EQ(writer.getPendingSamplesCount(), 0u);
+    ASSERT_EQ(writer.getTimestamp(), timestamp);
+    ASSERT_TRUE(writer.flush().empty());
+}
+
+TEST_F(AnalogStreamWriterTest, WrongSampleType)
+{
+    AnalogStreamWriter writer(format);
+    std::vector<int32_t> samples32(10);
+    ASSERT_THROW(writer.write(samples32.data(), samples32.size()), std::invalid_argument);
+}
+
+TEST_F(AnalogStreamWriterTest, Int32Samples)
+{
+    format.setSampleDt(AnalogPayload::SampleDt::aInt32);
+    AnalogStreamWriter writer(format);
+    std::vector<int32_t> samples32(samples.begin(), samples.end());
+    auto packets = writer.write(samples32.data(), samples32.size());
+    auto lastPackets = writer.flush();
+    packets.insert(packets.end(), lastPackets.begin(), lastPackets.end());
+
+    std::vector<float> values(AnalogPayload::getSamplesCount(packets.begin(), packets.end()));
+    ASSERT_EQ(values.size(), samplesCount);
+    AnalogPayload::toFloat(packets.begin(), packets.end(), values.data());
+    for (size_t i = 0; i < samplesCount; ++i)
+        ASSERT_FLOAT_EQ(values[i], samples32[i] * 0.5f + 1.f);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/arrow_exporter.h>
+#include <asam_cmp/can_fd_payload.h>
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/lin_payload.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::ArrowExporter;
+using ASAM::CMP::CanFdPayload;
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CaptureModulePayload;
+using ASAM::CMP::EthernetPayload;
+using ASAM::CMP::LinPayload;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PacketBatch;
+using ASAM::CMP::Payload;
+using ASAM::CMP::PayloadType;
+using Family = ArrowExporter::Family;
+
+class ArrowExporterFixture : public ::testing::Test
+{
+public:
+    ArrowExporterFixture()
+    {
+        options.basePath = ::testing::TempDir() + "asam_cmp_export";
+        options.batchRows = 16;
+    }
+
+    ~ArrowExporterFixture() override
+    {
+        for (const auto family : {Family::can, Family::lin, Family::ethernet, Family::analog, Family::status})
+            std::remove((options.basePath + "_" + names[static_cast<size_t>(family)] + ".arrow").c_str());
+    }
+
+protected:
+    static void append(PacketBatch& batch, const uint64_t timestamp, const Payload& payload)
+    {
+        Packet packet;
+        packet.setDeviceId(2);
+        packet.setInterfaceId(5);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        batch.append(packet);
+    }
+
+    static bool isArrowFile(const std::string& path)
+    {
+        std::ifstream stream(path, std::ios::binary);
+        char magic[6]{};
+        stream.read(magic, sizeof(magic));
+        return stream && std::string(magic, sizeof(magic)) == "ARROW1";
+    }
+
+protected:
+    ArrowExporter::Options options;
+    const char* names[5] = {"can", "lin", "ethernet", "analog", "status"};
+};
+
+TEST_F(ArrowExporterFixture, FamilyFiles)
+{
+    const uint8_t data[] = {1, 2, 3, 4};
+    PacketBatch batch;
+    for (uint64_t timestamp = 0; timestamp < 40; ++timestamp)
+    {
+        CanPayload canPayload;
+        canPayload.setId(0x100 + static_cast<uint32_t>(timestamp));
+        canPayload.setData(data, sizeof(data));
+        append(batch, timestamp, canPayload);
+    }
+
+    CanFdPayload canFdPayload;
+    canFdPayload.setData(data, sizeof(data));
+    append(batch, 40, canFdPayload);
+
+    LinPayload linPayload;
+    linPayload.setLinId(0x10);
+    linPayload.setData(data, 2);
+    append(batch, 41, linPayload);
+
+    EthernetPayload ethernetPayload;
+    ethernetPayload.setData(data, sizeof(data));
+    append(batch, 42, ethernetPayload);
+
+    AnalogPayload analogPayload;
+    const int16_t samples[] = {1, 2, 3};
+    analogPayload.setSamples(samples, 3);
+    append(batch, 43, analogPayload);
+
+    CaptureModulePayload capturePayload;
+    capturePayload.setData("device", "serial", "hw", "sw", {});
+    append(batch, 44, capturePayload);
+
+    // Not exported
+    append(batch, 45, Payload(PayloadType::spi, data, sizeof(data)));
+
+    {
+        ArrowExporter exporter(options);
+        ASSERT_EQ(exporter.write(batch), 45u);
+        exporter.close();
+
+        ASSERT_EQ(exporter.getRowCount(Family::can), 41u);
+        ASSERT_EQ(exporter.getRowCount(Family::lin), 1u);
+        ASSERT_EQ(exporter.getRowCount(Family::ethernet), 1u);
+        ASSERT_EQ(exporter.getRowCount(Family::analog), 1u);
+        ASSERT_EQ(exporter.getRowCount(Family::status), 1u);
+        ASSERT_EQ(exporter.getPath(Family::can), options.basePath + "_can.arrow");
+    }
+
+    for (const auto name : names)
+        ASSERT_TRUE(isArrowFile(options.basePath + "_" + name + ".arrow")) << name;
+}
+
+TEST_F(ArrowExporterFixture, FilesCreatedOnDemand)
+{
+    const uint8_t data[] = {1, 2};
+    PacketBatch batch;
+    LinPayload linPayload;
+    linPayload.setData(data, sizeof(data));
+    append(batch, 1, linPayload);
+
+    ArrowExporter exporter(options);
+    ASSERT_EQ(exporter.write(batch), 1u);
+    exporter.close();
+
+    ASSERT_TRUE(isArrowFile(exporter.getPath(Family::lin)));
+    ASSERT_FALSE(isArrowFile(exporter.getPath(Family::can)));
+    ASSERT_EQ(exporter.getRowCount(Family::can), 0u);
+}
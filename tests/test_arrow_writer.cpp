@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <asam_cmp/arrow_writer.h>
+
+using ASAM::CMP::ArrowWriter;
+using Type = ArrowWriter::Type;
+
+class ArrowWriterFixture : public ::testing::Test
+{
+public:
+    ArrowWriterFixture()
+        : path(::testing::TempDir() + "asam_cmp_writer.arrow")
+    {
+    }
+
+    ~ArrowWriterFixture() override
+    {
+        std::remove(path.c_str());
+    }
+
+protected:
+    std::vector<uint8_t> readFile() const
+    {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    }
+
+    template <typename T>
+    static bool contains(const std::vector<uint8_t>& file, const std::vector<T>& values)
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(values.data());
+        return std::search(file.begin(), file.end(), bytes, bytes + values.size() * sizeof(T)) != file.end();
+    }
+
+protected:
+    std::string path;
+    std::vector<ArrowWriter::Column> columns = {{"timestamp", Type::timestampNs},
+                                                {"id", Type::uint32},
+                                                {"value", Type::float32},
+                                                {"data", Type::binary},
+                                                {"samples", Type::float32List}};
+};
+
+TEST_F(ArrowWriterFixture, FileLayout)
+{
+    {
+        ArrowWriter writer(path, columns, 4);
+        for (uint32_t row = 0; row < 10; ++row)
+        {
+            const uint8_t data[] = {0xAB, 0xCD, static_cast<uint8_t>(row)};
+            const float samples[] = {1.5f, static_cast<float>(row)};
+            writer.append(0, 1000 + row);
+            writer.append(1, 0x11223300 + row);
+            writer.appendFloat(2, 0.25f * row);
+            writer.appendBinary(3, data, sizeof(data));
+            writer.appendList(4, samples, row % 3);
+            writer.endRow();
+        }
+        ASSERT_EQ(writer.getBatchCount(), 2u);
+        writer.close();
+        ASSERT_EQ(writer.getRowCount(), 10u);
+        ASSERT_EQ(writer.getBatchCount(), 3u);
+    }
+
+    const auto file = readFile();
+    ASSERT_GT(file.size(), 16u);
+    ASSERT_EQ(memcmp(file.data(), "ARROW1\0\0", 8), 0);
+    ASSERT_EQ(memcmp(file.data() + file.size() - 6, "ARROW1", 6), 0);
+
+    int32_t footerSize = 0;
+    memcpy(&footerSize, file.data() + file.size() - 10, sizeof(footerSize));
+    ASSERT_GT(footerSize, 0);
+    ASSERT_LT(static_cast<size_t>(footerSize), file.size());
+
+    // Schema message right after the magic
+    uint32_t continuation = 0;
+    memcpy(&continuation, file.data() + 8, sizeof(continuation));
+    ASSERT_EQ(continuation, 0xFFFFFFFFu);
+
+    // Values are stored as contiguous little-endian arrays per batch
+    ASSERT_TRUE(contains(file, std::vector<uint64_t>{1000, 1001, 1002, 1003}));
+    ASSERT_TRUE(contains(file, std::vector<uint32_t>{0x11223308, 0x11223309}));
+    ASSERT_TRUE(contains(file, std::vector<int32_t>{0, 3, 6, 9, 12}));
+    ASSERT_TRUE(contains(file, std::vector<uint8_t>{0xAB, 0xCD, 0x04, 0xAB, 0xCD, 0x05}));
+}
+
+TEST_F(ArrowWriterFixture, TypeMismatch)
+{
+    ArrowWriter writer(path, columns);
+    ASSERT_THROW(writer.appendFloat(1, 1.0f), std::invalid_argument);
+    ASSERT_THROW(writer.append(2, 1), std::invalid_argument);
+    ASSERT_THROW(writer.appendString(0, "text"), std::invalid_argument);
+    ASSERT_THROW(writer.appendList(3, nullptr, 0), std::invalid_argument);
+}
+
+TEST_F(ArrowWriterFixture, MissingValue)
+{
+    ArrowWriter writer(path, columns);
+    writer.append(0, 1);
+    writer.endRow();
+    ASSERT_THROW(writer.flush(), std::invalid_argument);
+}
+
+TEST_F(ArrowWriterFixture, EmptyFile)
+{
+    {
+        ArrowWriter writer(path, {{"flag", Type::boolean}, {"name", Type::utf8}});
+    }
+
+    const auto file = readFile();
+    ASSERT_EQ(memcmp(file.data(), "ARROW1\0\0", 8), 0);
+    ASSERT_EQ(memcmp(file.data() + file.size() - 6, "ARROW1", 6), 0);
+}
+
+TEST_F(ArrowWriterFixture, InvalidPath)
+{
+    ASSERT_THROW(ArrowWriter writer(::testing::TempDir() + "missing_directory/file.arrow", columns), std::runtime_error);
+}
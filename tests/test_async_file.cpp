@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <asam_cmp/async_file.h>
+
+using ASAM::CMP::AsyncFileSink;
+using ASAM::CMP::AsyncFileSource;
+using ASAM::CMP::AsyncIoBackend;
+
+class AsyncFileFixture : public ::testing::TestWithParam<AsyncIoBackend>
+{
+public:
+    AsyncFileFixture()
+    {
+        path = ::testing::TempDir() + "asam_cmp_async_file";
+        data.resize(100000);
+        for (std::size_t index = 0; index < data.size(); ++index)
+            data[index] = static_cast<uint8_t>(index * 7 + index / 251);
+    }
+
+    ~AsyncFileFixture() override
+    {
+        std::remove(path.c_str());
+    }
+
+protected:
+    void SetUp() override
+    {
+        if (GetParam() == AsyncIoBackend::ioUring && !ASAM::CMP::isIoUringSupported())
+            GTEST_SKIP() << "io_uring is not available";
+    }
+
+    void writeFile(const std::vector<uint8_t>& content) const
+    {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(content.data()), content.size());
+    }
+
+    std::vector<uint8_t> readFile() const
+    {
+        std::ifstream input(path, std::ios::binary);
+        return std::vector<uint8_t>((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    }
+
+    AsyncFileSource::Options createSourceOptions() const
+    {
+        AsyncFileSource::Options options;
+        options.path = path;
+        options.blockSize = 4096;
+        options.queueDepth = 4;
+        options.headroom = 512;
+        options.backend = GetParam();
+        return options;
+    }
+
+    AsyncFileSink::Options createSinkOptions() const
+    {
+        AsyncFileSink::Options options;
+        options.path = path;
+        options.blockSize = 8192;
+        options.queueDepth = 2;
+        options.backend = GetParam();
+        return options;
+    }
+
+protected:
+    std::string path;
+    std::vector<uint8_t> data;
+};
+
+TEST_P(AsyncFileFixture, Read)
+{
+    writeFile(data);
+    AsyncFileSource source(createSourceOptions());
+    ASSERT_EQ(source.getFileSize(), data.size());
+    ASSERT_NE(source.getBackend(), AsyncIoBackend::automatic);
+    if (GetParam() != AsyncIoBackend::automatic)
+    {
+        ASSERT_EQ(source.getBackend(), GetParam());
+    }
+
+    std::vector<uint8_t> content;
+    AsyncFileSource::Block block;
+    while (source.next(block))
+    {
+        ASSERT_EQ(block.offset, content.size());
+        ASSERT_LE(block.size, 4096u);
+        content.insert(content.end(), block.data, block.data + block.size);
+    }
+    ASSERT_EQ(content, data);
+    ASSERT_FALSE(source.next(block));
+}
+
+TEST_P(AsyncFileFixture, Prefix)
+{
+    writeFile(data);
+    AsyncFileSource source(createSourceOptions());
+
+    // Keeps an unprocessed tail of every block, alternately smaller and larger than the headroom
+    std::size_t keep = 0;
+    uint64_t expectedOffset = 0;
+    std::size_t blocks = 0;
+    AsyncFileSource::Block block;
+    while (source.next(block, block.data + block.size - keep, keep))
+    {
+        ASSERT_EQ(block.offset, expectedOffset);
+        ASSERT_TRUE(std::equal(block.data, block.data + block.size, data.begin() + static_cast<std::ptrdiff_t>(block.offset)));
+        keep = std::min<std::size_t>(block.size, ++blocks % 2 != 0 ? 100 : 700);
+        expectedOffset = block.offset + block.size - keep;
+    }
+    ASSERT_EQ(expectedOffset + keep, data.size());
+    ASSERT_GT(blocks, 20u);
+}
+
+TEST_P(AsyncFileFixture, Rewind)
+{
+    writeFile(data);
+    AsyncFileSource source(createSourceOptions());
+
+    AsyncFileSource::Block block;
+    ASSERT_TRUE(source.next(block));
+    ASSERT_TRUE(source.next(block));
+    ASSERT_EQ(block.offset, 4096u);
+    source.rewind();
+
+    std::size_t size = 0;
+    while (source.next(block))
+    {
+        ASSERT_EQ(block.offset, size);
+        size += block.size;
+    }
+    ASSERT_EQ(size, data.size());
+}
+
+TEST_P(AsyncFileFixture, EmptyFile)
+{
+    writeFile({});
+    AsyncFileSource source(createSourceOptions());
+    AsyncFileSource::Block block;
+    ASSERT_FALSE(source.next(block));
+}
+
+TEST_P(AsyncFileFixture, MissingFile)
+{
+    auto options = createSourceOptions();
+    options.path = ::testing::TempDir() + "asam_cmp_missing/file";
+    ASSERT_THROW(AsyncFileSource source(options), std::runtime_error);
+
+    auto sinkOptions = createSinkOptions();
+    sinkOptions.path = options.path;
+    ASSERT_THROW(AsyncFileSink sink(sinkOptions), std::runtime_error);
+}
+
+TEST_P(AsyncFileFixture, Write)
+{
+    AsyncFileSink sink(createSinkOptions());
+    ASSERT_TRUE(sink.isOpen());
+
+    // Writes of all sizes, more blocks than in flight
+    std::size_t offset = 0;
+    for (std::size_t size = 1; offset < data.size(); size = size * 3 + 1)
+    {
+        const std::size_t chunk = std::min(size, data.size() - offset);
+        sink.write(data.data() + offset, chunk);
+        offset += chunk;
+    }
+    sink.close();
+    ASSERT_FALSE(sink.isOpen());
+    ASSERT_THROW(sink.write(data.data(), 1), std::runtime_error);
+
+    ASSERT_EQ(readFile(), data);
+    ASSERT_EQ(sink.getStats().bytes, data.size());
+    ASSERT_GE(sink.getStats().writes, data.size() / 8192);
+}
+
+TEST_P(AsyncFileFixture, Flush)
+{
+    AsyncFileSink sink(createSinkOptions());
+    sink.write(data.data(), 10000);
+    sink.flush();
+    ASSERT_EQ(readFile(), std::vector<uint8_t>(data.begin(), data.begin() + 10000));
+
+    // The flushed part of the block is written again with the rest
+    sink.write(data.data() + 10000, data.size() - 10000);
+    sink.close();
+    ASSERT_EQ(readFile(), data);
+}
+
+TEST_P(AsyncFileFixture, DirectIo)
+{
+    // File systems without O_DIRECT support fall back to buffered writes
+    auto options = createSinkOptions();
+    options.directIo = true;
+    {
+        AsyncFileSink sink(options);
+        sink.write(data.data(), data.size());
+        sink.flush();
+    }
+    ASSERT_EQ(readFile(), data);
+}
+
+INSTANTIATE_TEST_SUITE_P(AsyncFile,
+                         AsyncFileFixture,
+                         ::testing::Values(AsyncIoBackend::automatic, AsyncIoBackend::ioUring, AsyncIoBackend::threadPool));
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <asam_cmp/bounded_queue.h>
+
+using ASAM::CMP::BoundedQueue;
+
+TEST(BoundedQueueTest, Capacity)
+{
+    ASSERT_EQ(BoundedQueue<int>(0).capacity(), 2u);
+    ASSERT_EQ(BoundedQueue<int>(8).capacity(), 8u);
+    ASSERT_EQ(BoundedQueue<int>(9).capacity(), 16u);
+}
+
+TEST(BoundedQueueTest, Fifo)
+{
+    BoundedQueue<int> queue(4);
+    int value = 0;
+    ASSERT_FALSE(queue.tryPop(value));
+
+    for (int round = 0; round < 3; ++round)
+    {
+        for (value = 0; value < 4; ++value)
+            ASSERT_TRUE(queue.tryPush(value));
+        ASSERT_FALSE(queue.tryPush(value));
+        ASSERT_EQ(queue.size(), 4u);
+
+        for (int expected = 0; expected < 4; ++expected)
+        {
+            ASSERT_TRUE(queue.tryPop(value));
+            ASSERT_EQ(value, expected);
+        }
+        ASSERT_FALSE(queue.tryPop(value));
+        ASSERT_EQ(queue.size(), 0u);
+    }
+}
+
+TEST(BoundedQueueTest, MoveOnly)
+{
+    BoundedQueue<std::unique_ptr<int>> queue(2);
+    auto first = std::make_unique<int>(1);
+    auto second = std::make_unique<int>(2);
+    auto third = std::make_unique<int>(3);
+    ASSERT_TRUE(queue.tryPush(first));
+    ASSERT_TRUE(queue.tryPush(second));
+    ASSERT_EQ(first, nullptr);
+
+    // A failed push leaves the value with the caller
+    ASSERT_FALSE(queue.tryPush(third));
+    ASSERT_NE(third, nullptr);
+
+    std::unique_ptr<int> value;
+    ASSERT_TRUE(queue.tryPop(value));
+    ASSERT_EQ(*value, 1);
+}
+
+TEST(BoundedQueueTest, MultipleProducersAndConsumers)
+{
+    constexpr int threadCount = 4;
+    constexpr int valuesPerThread = 100000;
+    BoundedQueue<int> queue(64);
+
+    std::atomic<int> consumed{0};
+    std::atomic<long long> sum{0};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < threadCount; ++thread)
+    {
+        threads.emplace_back(
+            [&queue, thread]()
+            {
+                for (int index = 0; index < valuesPerThread; ++index)
+                {
+                    int value = thread * valuesPerThread + index;
+                    while (!queue.tryPush(value))
+                        std::this_thread::yield();
+                }
+            });
+        threads.emplace_back(
+            [&queue, &consumed, &sum]()
+            {
+                int value;
+                while (consumed.load() < threadCount * valuesPerThread)
+                {
+                    if (!queue.tryPop(value))
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    sum += value;
+                    ++consumed;
+                }
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const long long count = threadCount * valuesPerThread;
+    ASSERT_EQ(consumed.load(), count);
+    ASSERT_EQ(sum.load(), count * (count - 1) / 2);
+}
@@ -0,0 +1,355 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <numeric>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_file_reader.h>
+#include <asam_cmp/encoder.h>
+
+using ASAM::CMP::AsyncFileSource;
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CaptureFileReader;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Packet;
+using ASAM::CMP::ProtocolDecoder;
+
+class CaptureFileReaderFixture : public ::testing::Test
+{
+public:
+    CaptureFileReaderFixture()
+    {
+        path = ::testing::TempDir() + "asam_cmp_capture";
+
+        std::vector<uint8_t> data(8);
+        std::iota(data.begin(), data.end(), uint8_t{});
+        CanPayload canPayload;
+        canPayload.setId(0x123);
+        canPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+
+        Packet packet;
+        packet.setInterfaceId(0x20);
+        packet.setPayload(canPayload);
+        packets = {packet, packet};
+
+        encoder.setDeviceId(3);
+        cmpFrame = encoder.encode(packets.begin(), packets.end(), dataContext)[0];
+    }
+
+    ~CaptureFileReaderFixture() override
+    {
+        std::remove(path.c_str());
+    }
+
+protected:
+    static void append16(std::vector<uint8_t>& out, const uint16_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    template <typename T>
+    static void appendNative(std::vector<uint8_t>& out, const T value)
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    std::vector<uint8_t> createEthernetFrame(const uint16_t etherType, const std::vector<uint8_t>& payload, const bool vlan = false)
+    {
+        std::vector<uint8_t> frame(12, 0xAA);
+        if (vlan)
+        {
+            append16(frame, 0x8100);
+            append16(frame, 0x0005);
+        }
+        append16(frame, etherType);
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        return frame;
+    }
+
+    std::vector<uint8_t> createUdpFrame(const uint16_t port, const std::vector<uint8_t>& payload, const bool vlan = false)
+    {
+        std::vector<uint8_t> ip = {0x45, 0x00};
+        append16(ip, static_cast<uint16_t>(20 + 8 + payload.size()));
+        ip.insert(ip.end(), {0x00, 0x00, 0x40, 0x00, 0x40, 17, 0x00, 0x00, 10, 0, 0, 1, 10, 0, 0, 2});
+        append16(ip, 50000);
+        append16(ip, port);
+        append16(ip, static_cast<uint16_t>(8 + payload.size()));
+        append16(ip, 0);
+        ip.insert(ip.end(), payload.begin(), payload.end());
+
+        auto frame = createEthernetFrame(0x0800, ip, vlan);
+        // Ethernet padding must not be taken as payload
+        frame.resize(std::max<size_t>(frame.size(), 60), 0);
+        return frame;
+    }
+
+    void writePcap(const std::vector<std::vector<uint8_t>>& frames, const bool nanoseconds)
+    {
+        std::vector<uint8_t> file;
+        appendNative<uint32_t>(file, nanoseconds ? 0xA1B23C4D : 0xA1B2C3D4);
+        appendNative<uint16_t>(file, 2);
+        appendNative<uint16_t>(file, 4);
+        appendNative<uint32_t>(file, 0);
+        appendNative<uint32_t>(file, 0);
+        appendNative<uint32_t>(file, 65535);
+        appendNative<uint32_t>(file, 1);
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            appendNative<uint32_t>(file, 100 + static_cast<uint32_t>(i));
+            appendNative<uint32_t>(file, 500);
+            appendNative<uint32_t>(file, static_cast<uint32_t>(frames[i].size()));
+            appendNative<uint32_t>(file, static_cast<uint32_t>(frames[i].size()));
+            file.insert(file.end(), frames[i].begin(), frames[i].end());
+        }
+        write(file);
+    }
+
+    void writePcapng(const std::vector<std::vector<uint8_t>>& frames)
+    {
+        std::vector<uint8_t> file;
+        // Section header
+        appendNative<uint32_t>(file, 0x0A0D0D0A);
+        appendNative<uint32_t>(file, 28);
+        appendNative<uint32_t>(file, 0x1A2B3C4D);
+        appendNative<uint16_t>(file, 1);
+        appendNative<uint16_t>(file, 0);
+        appendNative<uint64_t>(file, ~uint64_t{0});
+        appendNative<uint32_t>(file, 28);
+        // Interface 0: Ethernet, microseconds. Interface 1: Ethernet, nanoseconds
+        for (uint8_t resolution : {6, 9})
+        {
+            appendNative<uint32_t>(file, 1);
+            appendNative<uint32_t>(file, 32);
+            appendNative<uint16_t>(file, 1);
+            appendNative<uint16_t>(file, 0);
+            appendNative<uint32_t>(file, 0);
+            appendNative<uint16_t>(file, 9);
+            appendNative<uint16_t>(file, 1);
+            file.insert(file.end(), {resolution, 0, 0, 0});
+            appendNative<uint32_t>(file, 0);
+            appendNative<uint32_t>(file, 32);
+        }
+        for (size_t i = 0; i < frames.size(); ++i)
+        {
+            const size_t padded = (frames[i].size() + 3) & ~size_t{3};
+            const auto blockLength = static_cast<uint32_t>(32 + padded);
+            const uint64_t timestamp = 1000 + i;
+            appendNative<uint32_t>(file, 6);
+            appendNative<uint32_t>(file, blockLength);
+            appendNative<uint32_t>(file, static_cast<uint32_t>(i % 2));
+            appendNative<uint32_t>(file, static_cast<uint32_t>(timestamp >> 32));
+            appendNative<uint32_t>(file, static_cast<uint32_t>(timestamp));
+            appendNative<uint32_t>(file, static_cast<uint32_t>(frames[i].size()));
+            appendNative<uint32_t>(file, static_cast<uint32_t>(frames[i].size()));
+            file.insert(file.end(), frames[i].begin(), frames[i].end());
+            file.resize(file.size() + padded - frames[i].size(), 0);
+            appendNative<uint32_t>(file, blockLength);
+        }
+        write(file);
+    }
+
+    void write(const std::vector<uint8_t>& file)
+    {
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+    }
+
+protected:
+    std::string path;
+    std::vector<Packet> packets;
+    std::vector<uint8_t> cmpFrame;
+    ASAM::CMP::Encoder encoder;
+    DataContext dataContext;
+};
+
+TEST_F(CaptureFileReaderFixture, Pcap)
+{
+    writePcap({createEthernetFrame(0x99FE, cmpFrame), createUdpFrame(1234, cmpFrame, true)}, false);
+
+    CaptureFileReader reader(path);
+    ASSERT_EQ(reader.getFormat(), CaptureFileReader::Format::pcap);
+
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.size, cmpFrame.size());
+    ASSERT_TRUE(std::equal(cmpFrame.begin(), cmpFrame.end(), frame.data));
+    ASSERT_EQ(frame.timestamp, 100 * 1000000000ull + 500000);
+
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.size, cmpFrame.size());
+    ASSERT_TRUE(std::equal(cmpFrame.begin(), cmpFrame.end(), frame.data));
+    ASSERT_EQ(frame.timestamp, 101 * 1000000000ull + 500000);
+
+    ASSERT_FALSE(reader.next(frame));
+    ASSERT_FALSE(reader.isTruncated());
+    ASSERT_EQ(reader.getStats().frames, 2u);
+}
+
+TEST_F(CaptureFileReaderFixture, PcapNanoseconds)
+{
+    writePcap({createEthernetFrame(0x99FE, cmpFrame)}, true);
+
+    CaptureFileReader reader(path);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.timestamp, 100 * 1000000000ull + 500);
+}
+
+TEST_F(CaptureFileReaderFixture, Pcapng)
+{
+    writePcapng({createEthernetFrame(0x99FE, cmpFrame), createUdpFrame(1234, cmpFrame)});
+
+    CaptureFileReader reader(path);
+    ASSERT_EQ(reader.getFormat(), CaptureFileReader::Format::pcapng);
+
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.interfaceIndex, 0u);
+    ASSERT_EQ(frame.timestamp, 1000u * 1000);
+    ASSERT_TRUE(std::equal(cmpFrame.begin(), cmpFrame.end(), frame.data));
+
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.interfaceIndex, 1u);
+    ASSERT_EQ(frame.timestamp, 1001u);
+    ASSERT_EQ(frame.size, cmpFrame.size());
+
+    ASSERT_FALSE(reader.next(frame));
+    ASSERT_FALSE(reader.isTruncated());
+}
+
+TEST_F(CaptureFileReaderFixture, Decode)
+{
+    writePcapng({createEthernetFrame(0x99FE, cmpFrame), createUdpFrame(1234, cmpFrame)});
+
+    CaptureFileReader reader(path);
+    ProtocolDecoder decoder;
+    size_t visited = 0;
+    auto count = reader.decode(decoder,
+                               [&visited, this](const Packet& packet)
+                               {
+                                   ASSERT_EQ(packet.getPayload(), packets[0].getPayload());
+                                   ++visited;
+                               });
+    ASSERT_EQ(count, 4u);
+    ASSERT_EQ(visited, 4u);
+}
+
+TEST_F(CaptureFileReaderFixture, UdpPortFilter)
+{
+    writePcap({createUdpFrame(1234, cmpFrame), createUdpFrame(5678, cmpFrame), createEthernetFrame(0x0806, {1, 2, 3})}, false);
+
+    CaptureFileReader reader(path);
+    reader.setUdpPort(5678);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.timestamp / 1000000000, 101u);
+    ASSERT_FALSE(reader.next(frame));
+    ASSERT_EQ(reader.getStats().records, 3u);
+    ASSERT_EQ(reader.getStats().skippedRecords, 2u);
+
+    reader.rewind();
+    reader.setUdpPort(0);
+    size_t frames = 0;
+    while (reader.next(frame))
+        ++frames;
+    ASSERT_EQ(frames, 2u);
+}
+
+TEST_F(CaptureFileReaderFixture, Truncated)
+{
+    writePcap({createEthernetFrame(0x99FE, cmpFrame), createEthernetFrame(0x99FE, cmpFrame)}, false);
+    std::ifstream input(path, std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    file.resize(file.size() - 5);
+    write(file);
+
+    CaptureFileReader reader(path);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_FALSE(reader.next(frame));
+    ASSERT_TRUE(reader.isTruncated());
+}
+
+TEST_F(CaptureFileReaderFixture, Streaming)
+{
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 100; ++i)
+        frames.push_back(i % 3 == 0 ? createUdpFrame(1234, cmpFrame) : createEthernetFrame(0x99FE, cmpFrame, i % 2 == 0));
+    writePcapng(frames);
+
+    // Blocks smaller than the records, records larger than the headroom are copied
+    AsyncFileSource::Options sourceOptions;
+    sourceOptions.path = path;
+    sourceOptions.blockSize = 100;
+    sourceOptions.queueDepth = 3;
+    sourceOptions.headroom = 64;
+    CaptureFileReader streamed(sourceOptions);
+    CaptureFileReader mapped(path);
+    ASSERT_EQ(streamed.getFormat(), CaptureFileReader::Format::pcapng);
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        CaptureFileReader::Frame expected;
+        CaptureFileReader::Frame frame;
+        while (mapped.next(expected))
+        {
+            ASSERT_TRUE(streamed.next(frame));
+            ASSERT_EQ(frame.timestamp, expected.timestamp);
+            ASSERT_EQ(frame.interfaceIndex, expected.interfaceIndex);
+            ASSERT_EQ(frame.size, expected.size);
+            ASSERT_TRUE(std::equal(frame.data, frame.data + frame.size, expected.data));
+        }
+        ASSERT_FALSE(streamed.next(frame));
+        ASSERT_FALSE(streamed.isTruncated());
+        ASSERT_EQ(streamed.getStats().frames, 100u);
+
+        streamed.rewind();
+        mapped.rewind();
+    }
+}
+
+TEST_F(CaptureFileReaderFixture, StreamingTruncated)
+{
+    writePcap({createEthernetFrame(0x99FE, cmpFrame), createEthernetFrame(0x99FE, cmpFrame)}, false);
+    std::ifstream input(path, std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+    file.resize(file.size() - 5);
+    write(file);
+
+    AsyncFileSource::Options sourceOptions;
+    sourceOptions.path = path;
+    sourceOptions.blockSize = 32;
+    CaptureFileReader reader(sourceOptions);
+    ASSERT_EQ(reader.getFormat(), CaptureFileReader::Format::pcap);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_TRUE(std::equal(cmpFrame.begin(), cmpFrame.end(), frame.data));
+    ASSERT_FALSE(reader.next(frame));
+    ASSERT_TRUE(reader.isTruncated());
+}
+
+TEST_F(CaptureFileReaderFixture, UnknownFormat)
+{
+    write({1, 2, 3, 4, 5, 6, 7, 8});
+    ASSERT_THROW(CaptureFileReader reader(path), std::runtime_error);
+}
+
+TEST_F(CaptureFileReaderFixture, ExtractPayloadIgnoresOtherTraffic)
+{
+    const uint8_t* payload;
+    size_t payloadSize;
+    auto tcpFrame = createUdpFrame(1234, cmpFrame);
+    tcpFrame[14 + 9] = 6;
+    ASSERT_FALSE(CaptureFileReader::extractPayload(tcpFrame.data(), tcpFrame.size(), 1, 0, payload, payloadSize));
+
+    auto fragment = createUdpFrame(1234, cmpFrame);
+    fragment[14 + 6] = 0x20;
+    ASSERT_FALSE(CaptureFileReader::extractPayload(fragment.data(), fragment.size(), 1, 0, payload, payloadSize));
+
+    auto udpFrame = createUdpFrame(1234, cmpFrame);
+    ASSERT_FALSE(CaptureFileReader::extractPayload(udpFrame.data(), udpFrame.size(), 147, 0, payload, payloadSize));
+    ASSERT_TRUE(CaptureFileReader::extractPayload(udpFrame.data() + 14, udpFrame.size() - 14, 101, 0, payload, payloadSize));
+    ASSERT_EQ(payloadSize, cmpFrame.size());
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <numeric>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_file_writer.h>
+#include <asam_cmp/encoder.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CaptureFileReader;
+using ASAM::CMP::CaptureFileWriter;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Packet;
+using ASAM::CMP::ProtocolDecoder;
+
+class CaptureFileWriterFixture : public ::testing::Test
+{
+public:
+    CaptureFileWriterFixture()
+    {
+        options.path = ::testing::TempDir() + "asam_cmp_writer.pcapng";
+        options.bufferSize = 4096;
+
+        std::vector<uint8_t> data(8);
+        std::iota(data.begin(), data.end(), uint8_t{});
+        CanPayload canPayload;
+        canPayload.setId(0x123);
+        canPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+
+        Packet packet;
+        packet.setInterfaceId(0x20);
+        packet.setPayload(canPayload);
+        packets = {packet, packet};
+
+        encoder.setDeviceId(3);
+        cmpFrames = encoder.encode(packets.begin(), packets.end(), dataContext);
+    }
+
+    ~CaptureFileWriterFixture() override
+    {
+        std::remove(options.path.c_str());
+        for (int index = 1; index < 10; ++index)
+            std::remove(path(index).c_str());
+    }
+
+protected:
+    std::string path(const int index) const
+    {
+        return ::testing::TempDir() + "asam_cmp_writer_" + std::to_string(index) + ".pcapng";
+    }
+
+    std::size_t countFrames(const std::string& filePath)
+    {
+        CaptureFileReader reader(filePath);
+        EXPECT_EQ(reader.getFormat(), CaptureFileReader::Format::pcapng);
+        CaptureFileReader::Frame frame;
+        std::size_t count = 0;
+        while (reader.next(frame))
+        {
+            EXPECT_EQ(frame.size, cmpFrames[0].size());
+            EXPECT_TRUE(std::equal(cmpFrames[0].begin(), cmpFrames[0].end(), frame.data));
+            ++count;
+        }
+        EXPECT_FALSE(reader.isTruncated());
+        return count;
+    }
+
+protected:
+    CaptureFileWriter::Options options;
+    ASAM::CMP::Encoder encoder;
+    DataContext dataContext{64, 1500};
+    std::vector<Packet> packets;
+    std::vector<std::vector<uint8_t>> cmpFrames;
+};
+
+TEST_F(CaptureFileWriterFixture, RoundTrip)
+{
+    {
+        CaptureFileWriter writer(options);
+        auto index = writer.addInterface("eth0");
+        ASSERT_EQ(index, 0u);
+        for (uint64_t timestamp = 0; timestamp < 1000; ++timestamp)
+            writer.writeCmpFrames(index, 1000000000000 + timestamp, cmpFrames);
+        writer.close();
+        ASSERT_EQ(writer.getStats().frames, 1000u);
+        ASSERT_EQ(writer.getStats().files, 1u);
+    }
+
+    CaptureFileReader reader(options.path);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.timestamp, 1000000000000u);
+
+    reader.rewind();
+    ProtocolDecoder decoder;
+    size_t visited = 0;
+    auto count = reader.decode(decoder,
+                               [&visited, this](const Packet& packet)
+                               {
+                                   ASSERT_EQ(packet.getPayload(), packets[0].getPayload());
+                                   ++visited;
+                               });
+    ASSERT_EQ(count, 2000u);
+    ASSERT_EQ(visited, 2000u);
+}
+
+TEST_F(CaptureFileWriterFixture, SynchronousFlush)
+{
+    options.backgroundFlush = false;
+    CaptureFileWriter writer(options);
+    writer.addInterface("eth0");
+    for (uint64_t timestamp = 0; timestamp < 100; ++timestamp)
+        writer.writeCmpFrames(0, timestamp, cmpFrames);
+    writer.flush();
+    ASSERT_EQ(countFrames(options.path), 100u);
+
+    writer.writeCmpFrames(0, 100, cmpFrames);
+    writer.close();
+    ASSERT_EQ(countFrames(options.path), 101u);
+}
+
+TEST_F(CaptureFileWriterFixture, BackgroundFlush)
+{
+    options.bufferCount = 2;
+    CaptureFileWriter writer(options);
+    writer.addInterface("eth0");
+    for (uint64_t timestamp = 0; timestamp < 500; ++timestamp)
+        writer.writeCmpFrames(0, timestamp, cmpFrames);
+    writer.flush();
+    ASSERT_EQ(countFrames(options.path), 500u);
+    writer.close();
+}
+
+TEST_F(CaptureFileWriterFixture, DirectIo)
+{
+    // File systems without O_DIRECT support fall back to buffered writes
+    options.directIo = true;
+    {
+        CaptureFileWriter writer(options);
+        writer.addInterface("eth0");
+        for (uint64_t timestamp = 0; timestamp < 300; ++timestamp)
+            writer.writeCmpFrames(0, timestamp, cmpFrames);
+    }
+    ASSERT_EQ(countFrames(options.path), 300u);
+}
+
+TEST_F(CaptureFileWriterFixture, AsyncIo)
+{
+    options.asyncIo = true;
+    options.bufferCount = 2;
+    options.rotateSize = 128 * 1024;
+    {
+        CaptureFileWriter writer(options);
+        writer.addInterface("eth0");
+        for (uint64_t timestamp = 0; timestamp < 500; ++timestamp)
+            writer.writeCmpFrames(0, timestamp, cmpFrames);
+        writer.flush();
+        ASSERT_EQ(countFrames(options.path), 500u);
+
+        for (uint64_t timestamp = 500; timestamp < 1500; ++timestamp)
+            writer.writeCmpFrames(0, timestamp, cmpFrames);
+        ASSERT_EQ(writer.getStats().files, 2u);
+    }
+
+    const std::size_t frames = countFrames(options.path) + countFrames(path(1));
+    ASSERT_EQ(frames, 1500u);
+}
+
+TEST_F(CaptureFileWriterFixture, RotateBySize)
+{
+    options.rotateSize = 2000;
+    {
+        CaptureFileWriter writer(options);
+        writer.addInterface("eth0");
+        for (uint64_t timestamp = 0; timestamp < 50; ++timestamp)
+            writer.writeCmpFrames(0, timestamp, cmpFrames);
+        writer.close();
+        ASSERT_GT(writer.getStats().files, 1u);
+        ASSERT_EQ(writer.getCurrentPath(), path(static_cast<int>(writer.getStats().files) - 1));
+    }
+
+    std::size_t frames = countFrames(options.path);
+    for (int index = 1; index < 10; ++index)
+    {
+        if (FILE* file = std::fopen(path(index).c_str(), "rb"))
+        {
+            std::fseek(file, 0, SEEK_END);
+            ASSERT_LE(std::ftell(file), 2000);
+            std::fclose(file);
+            frames += countFrames(path(index));
+        }
+    }
+    ASSERT_EQ(frames, 50u);
+}
+
+TEST_F(CaptureFileWriterFixture, RotateByTime)
+{
+    options.rotateInterval = 1000;
+    {
+        CaptureFileWriter writer(options);
+        writer.addInterface("eth0");
+        for (uint64_t timestamp = 0; timestamp < 30; ++timestamp)
+            writer.writeCmpFrames(0, timestamp * 100, cmpFrames);
+        writer.close();
+        ASSERT_EQ(writer.getStats().files, 3u);
+    }
+
+    ASSERT_EQ(countFrames(options.path), 10u);
+    ASSERT_EQ(countFrames(path(1)), 10u);
+    ASSERT_EQ(countFrames(path(2)), 10u);
+}
+
+TEST_F(CaptureFileWriterFixture, MultipleInterfaces)
+{
+    {
+        CaptureFileWriter writer(options);
+        writer.addInterface("eth0");
+        writer.writeCmpFrames(0, 1, cmpFrames);
+        auto index = writer.addInterface("eth1");
+        ASSERT_EQ(index, 1u);
+        writer.writeCmpFrames(index, 2, cmpFrames);
+        ASSERT_THROW(writer.writeCmpFrames(2, 3, cmpFrames), std::invalid_argument);
+    }
+
+    CaptureFileReader reader(options.path);
+    CaptureFileReader::Frame frame;
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.interfaceIndex, 0u);
+    ASSERT_TRUE(reader.next(frame));
+    ASSERT_EQ(frame.interfaceIndex, 1u);
+    ASSERT_EQ(frame.timestamp, 2u);
+    ASSERT_FALSE(reader.next(frame));
+}
+
+TEST_F(CaptureFileWriterFixture, WriteAfterClose)
+{
+    CaptureFileWriter writer(options);
+    writer.addInterface("eth0");
+    writer.close();
+    ASSERT_THROW(writer.writeCmpFrames(0, 0, cmpFrames), std::runtime_error);
+}
+
+TEST_F(CaptureFileWriterFixture, InvalidPath)
+{
+    options.path = ::testing::TempDir() + "missing_directory/capture.pcapng";
+    ASSERT_THROW(CaptureFileWriter writer(options), std::runtime_error);
+}
@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+#include <asam_cmp/concurrent_status.h>
+#include <asam_cmp/interface_payload.h>
+
+#include "create_message.h"
+
+using ASAM::CMP::ConcurrentStatus;
+using ASAM::CMP::InterfacePayload;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+using MessageType = ASAM::CMP::CmpHeader::MessageType;
+
+class ConcurrentStatusTest : public ::testing::Test
+{
+public:
+    ConcurrentStatusTest()
+    {
+        std::vector<uint8_t> data(dataSize);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+        auto payloadMsg = createCaptureModuleDataMessage("Device Description", "Serial Number", "Hardware Version", "Software Version", data);
+        auto cmDataMsg = createDataMessage(PayloadType::cmStatMsg, payloadMsg);
+        cmPacket = Packet{MessageType::status, cmDataMsg.data(), cmDataMsg.size()};
+        cmPacket.setDeviceId(deviceId);
+
+        payloadMsg = createInterfaceDataMessage(interfaceId, {1}, data);
+        auto dataMsg = createDataMessage(PayloadType::ifStatMsg, payloadMsg);
+        ifPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+        ifPacket.setDeviceId(deviceId);
+    }
+
+protected:
+    Packet createInterfacePacket(const uint16_t newDeviceId, const uint32_t newInterfaceId) const
+    {
+        Packet packet = ifPacket;
+        packet.setDeviceId(newDeviceId);
+        static_cast<InterfacePayload&>(packet.getPayload()).setInterfaceId(newInterfaceId);
+        return packet;
+    }
+
+protected:
+    static constexpr size_t dataSize = 32;
+    static constexpr uint16_t deviceId = 37;
+    static constexpr uint32_t interfaceId = 3;
+
+    Packet cmPacket;
+    Packet ifPacket;
+    ConcurrentStatus status;
+};
+
+TEST_F(ConcurrentStatusTest, Empty)
+{
+    auto snapshot = status.getSnapshot();
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), 0u);
+    ASSERT_EQ(snapshot->getEpoch(), 0u);
+}
+
+TEST_F(ConcurrentStatusTest, Update)
+{
+    status.update(ifPacket);
+    ASSERT_EQ(status.getSnapshot()->getDeviceStatusCount(), 0u);
+
+    status.update(cmPacket);
+    status.update(ifPacket);
+
+    auto snapshot = status.getSnapshot();
+    ASSERT_EQ(snapshot->getEpoch(), status.getEpoch());
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), 1u);
+    auto index = snapshot->getIndexByDeviceId(deviceId);
+    ASSERT_EQ(index, 0u);
+
+    const auto& device = snapshot->getDeviceStatus(index);
+    ASSERT_EQ(device.getPacket(), cmPacket);
+    ASSERT_EQ(device.getInterfaceStatusCount(), 1u);
+    ASSERT_EQ(device.getInterfaceStatus(device.getIndexByInterfaceId(interfaceId)).getPacket(), ifPacket);
+    ASSERT_EQ(device.getEpoch(), snapshot->getEpoch());
+}
+
+TEST_F(ConcurrentStatusTest, SnapshotsAreImmutable)
+{
+    status.update(cmPacket);
+    auto oldSnapshot = status.getSnapshot();
+
+    status.update(ifPacket);
+    Packet otherDevice = cmPacket;
+    otherDevice.setDeviceId(deviceId + 1);
+    status.update(std::move(otherDevice));
+
+    ASSERT_EQ(oldSnapshot->getDeviceStatusCount(), 1u);
+    ASSERT_EQ(oldSnapshot->getDeviceStatus(0).getInterfaceStatusCount(), 0u);
+
+    auto newSnapshot = status.getSnapshot();
+    ASSERT_GT(newSnapshot->getEpoch(), oldSnapshot->getEpoch());
+    ASSERT_EQ(newSnapshot->getDeviceStatusCount(), 2u);
+    ASSERT_EQ(newSnapshot->getDeviceStatus(0).getInterfaceStatusCount(), 1u);
+}
+
+TEST_F(ConcurrentStatusTest, UnchangedDevicesAreShared)
+{
+    status.update(cmPacket);
+    Packet otherDevice = cmPacket;
+    otherDevice.setDeviceId(deviceId + 1);
+    status.update(otherDevice);
+    auto oldSnapshot = status.getSnapshot();
+
+    status.update(ifPacket);
+    auto newSnapshot = status.getSnapshot();
+
+    auto otherIndex = newSnapshot->getIndexByDeviceId(deviceId + 1);
+    ASSERT_EQ(newSnapshot->getDeviceStatusPtr(otherIndex), oldSnapshot->getDeviceStatusPtr(otherIndex));
+    auto index = newSnapshot->getIndexByDeviceId(deviceId);
+    ASSERT_NE(newSnapshot->getDeviceStatusPtr(index), oldSnapshot->getDeviceStatusPtr(index));
+}
+
+TEST_F(ConcurrentStatusTest, ManyDevices)
+{
+    // More devices than fit into one chunk
+    constexpr uint16_t devicesCount = 100;
+    for (uint16_t id = 0; id < devicesCount; ++id)
+    {
+        cmPacket.setDeviceId(id);
+        status.update(cmPacket);
+        status.update(createInterfacePacket(id, interfaceId));
+    }
+    auto oldSnapshot = status.getSnapshot();
+
+    status.update(createInterfacePacket(50, interfaceId + 1));
+    status.removeDeviceById(10);
+    auto snapshot = status.getSnapshot();
+
+    ASSERT_EQ(oldSnapshot->getDeviceStatusCount(), devicesCount);
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), devicesCount - 1u);
+    ASSERT_EQ(snapshot->getIndexByDeviceId(10), snapshot->getDeviceStatusCount());
+    for (uint16_t id = 0; id < devicesCount; ++id)
+    {
+        if (id == 10)
+            continue;
+        const auto index = snapshot->getIndexByDeviceId(id);
+        ASSERT_LT(index, snapshot->getDeviceStatusCount());
+        ASSERT_EQ(snapshot->getDeviceStatus(index).getPacket().getDeviceId(), id);
+        ASSERT_EQ(snapshot->getDeviceStatus(index).getInterfaceStatusCount(), id == 50 ? 2u : 1u);
+    }
+    ASSERT_EQ(snapshot->getDeviceStatusPtr(snapshot->getIndexByDeviceId(80)), oldSnapshot->getDeviceStatusPtr(80));
+    ASSERT_EQ(oldSnapshot->getDeviceStatus(50).getInterfaceStatusCount(), 1u);
+}
+
+TEST_F(ConcurrentStatusTest, RemoveAndClear)
+{
+    for (uint16_t id = deviceId; id < deviceId + 3; ++id)
+    {
+        cmPacket.setDeviceId(id);
+        status.update(cmPacket);
+    }
+
+    status.removeDeviceById(deviceId);
+    auto snapshot = status.getSnapshot();
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), 2u);
+    ASSERT_EQ(snapshot->getIndexByDeviceId(deviceId), snapshot->getDeviceStatusCount());
+    ASSERT_EQ(snapshot->getDeviceStatus(snapshot->getIndexByDeviceId(deviceId + 2)).getPacket().getDeviceId(), deviceId + 2);
+
+    status.clear();
+    ASSERT_EQ(status.getSnapshot()->getDeviceStatusCount(), 0u);
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), 2u);
+}
+
+TEST_F(ConcurrentStatusTest, ConcurrentReaders)
+{
+    constexpr uint16_t devicesCount = 8;
+    constexpr uint32_t interfacesCount = 16;
+    constexpr int rounds = 20;
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+    auto reader = [&]()
+    {
+        uint64_t lastEpoch = 0;
+        while (!done.load())
+        {
+            auto snapshot = status.getSnapshot();
+            if (snapshot->getEpoch() < lastEpoch)
+                failed = true;
+            lastEpoch = snapshot->getEpoch();
+
+            for (size_t i = 0; i < snapshot->getDeviceStatusCount(); ++i)
+            {
+                const auto& device = snapshot->getDeviceStatus(i);
+                if (device.getEpoch() > snapshot->getEpoch() || snapshot->getIndexByDeviceId(device.getPacket().getDeviceId()) != i)
+                    failed = true;
+                for (size_t j = 0; j < device.getInterfaceStatusCount(); ++j)
+                {
+                    const auto& interfaceStatus = device.getInterfaceStatus(j);
+                    if (device.getIndexByInterfaceId(interfaceStatus.getInterfaceId()) != j ||
+                        interfaceStatus.getPacket().getDeviceId() != device.getPacket().getDeviceId())
+                        failed = true;
+                }
+            }
+        }
+    };
+
+    std::thread reader1(reader);
+    std::thread reader2(reader);
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (uint16_t id = 0; id < devicesCount; ++id)
+        {
+            cmPacket.setDeviceId(id);
+            status.update(cmPacket);
+            for (uint32_t interface = 0; interface < interfacesCount; ++interface)
+                status.update(createInterfacePacket(id, interface));
+        }
+    }
+    done = true;
+    reader1.join();
+    reader2.join();
+
+    ASSERT_FALSE(failed.load());
+    auto snapshot = status.getSnapshot();
+    ASSERT_EQ(snapshot->getDeviceStatusCount(), devicesCount);
+    ASSERT_EQ(snapshot->getDeviceStatus(0).getInterfaceStatusCount(), interfacesCount);
+    ASSERT_EQ(snapshot->getEpoch(), static_cast<uint64_t>(rounds) * devicesCount * (interfacesCount + 1));
+}
+
+TEST_F(ConcurrentStatusTest, MoreReadersThanSlots)
+{
+    constexpr size_t readersCount = ConcurrentStatus::readerSlotCount + 4;
+    constexpr int updates = 2000;
+
+    status.update(cmPacket);
+    std::atomic<bool> done{false};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for (size_t index = 0; index < readersCount; ++index)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                // Snapshots stay valid while the writer replaces and frees the published pointers
+                auto held = status.getSnapshot();
+                while (!done.load())
+                {
+                    auto snapshot = status.getSnapshot();
+                    if (snapshot->getEpoch() < held->getEpoch() || snapshot->getDeviceStatusCount() != 1)
+                        failed = true;
+                    held = std::move(snapshot);
+                }
+            });
+    }
+
+    for (int update = 0; update < updates; ++update)
+        status.update(ifPacket);
+    done = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    ASSERT_FALSE(failed.load());
+    ASSERT_EQ(status.getSnapshot()->getEpoch(), static_cast<uint64_t>(updates) + 1);
+}
@@ -171,6 +171,23 @@ TEST_F(DecoderFixture, Aggregation)
     ASSERT_EQ(packets[1]->getPayload().getType(), PayloadType::can);
 }
 
+TEST_F(DecoderFixture, AggregationIntoVector)
+{
+    dataMsg.reserve(dataMsg.size() * 2);
+    dataMsg.insert(dataMsg.end(), dataMsg.begin(), dataMsg.end());
+    cmpMsg = createCmpMessage(deviceId, CmpHeader::MessageType::data, streamId, dataMsg);
+
+    Decoder decoder;
+    std::vector<Packet> packets(1);
+    ASSERT_EQ(decoder.decode(cmpMsg.data(), cmpMsg.size(), packets), 2u);
+    ASSERT_EQ(packets.size(), 3u);
+    const auto expected = decoder.decode(cmpMsg.data(), cmpMsg.size());
+    ASSERT_EQ(packets[1], *expected[0]);
+    ASSERT_EQ(packets[2], *expected[1]);
+    ASSERT_EQ(packets[2].getDeviceId(), deviceId);
+    ASSERT_EQ(packets[2].getStreamId(), streamId);
+}
+
 TEST_F(DecoderFixture, AggregationInvalidData)
 {
     dataMsg.reserve(dataMsg.size() * 2);
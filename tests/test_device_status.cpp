@@ -147,3 +147,34 @@ TEST_F(DeviceStatusTest, NewInterfaceId)
     deviceStatus.update(packet);
     ASSERT_EQ(deviceStatus.getInterfaceStatusCount(), 2u);
 }
+
+TEST_F(DeviceStatusTest, RemoveInterfaceKeepsIndexes)
+{
+    for (uint32_t id = interfaceId; id < interfaceId + 4; ++id)
+    {
+        static_cast<InterfacePayload&>(ifPacket.getPayload()).setInterfaceId(id);
+        deviceStatus.update(ifPacket);
+    }
+
+    deviceStatus.removeInterfaceById(interfaceId + 1);
+    ASSERT_EQ(deviceStatus.getInterfaceStatusCount(), 3u);
+    ASSERT_EQ(deviceStatus.getIndexByInterfaceId(interfaceId + 1), deviceStatus.getInterfaceStatusCount());
+    for (uint32_t id : {interfaceId, interfaceId + 2, interfaceId + 3})
+    {
+        auto index = deviceStatus.getIndexByInterfaceId(id);
+        ASSERT_LT(index, deviceStatus.getInterfaceStatusCount());
+        ASSERT_EQ(deviceStatus.getInterfaceStatus(index).getInterfaceId(), id);
+    }
+}
+
+TEST_F(DeviceStatusTest, UpdateWithMovedPacket)
+{
+    Packet packet = ifPacket;
+    deviceStatus.update(std::move(packet));
+    ASSERT_EQ(deviceStatus.getInterfaceStatusCount(), 1u);
+    ASSERT_EQ(deviceStatus.getInterfaceStatus(0).getPacket(), ifPacket);
+
+    packet = cmPacket;
+    deviceStatus.update(std::move(packet));
+    ASSERT_EQ(deviceStatus.getPacket(), cmPacket);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+#include <asam_cmp/flat_index_map.h>
+
+using ASAM::CMP::FlatIndexMap;
+
+TEST(FlatIndexMapTest, Empty)
+{
+    FlatIndexMap<uint32_t> map;
+    ASSERT_EQ(map.size(), 0u);
+    ASSERT_EQ(map.find(5), FlatIndexMap<uint32_t>::npos);
+    map.erase(5);
+}
+
+TEST(FlatIndexMapTest, InsertFind)
+{
+    FlatIndexMap<uint16_t> map;
+    map.insert(10, 0);
+    map.insert(20, 1);
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.find(10), 0u);
+    ASSERT_EQ(map.find(20), 1u);
+    ASSERT_EQ(map.find(30), FlatIndexMap<uint16_t>::npos);
+
+    map.insert(10, 5);
+    ASSERT_EQ(map.size(), 2u);
+    ASSERT_EQ(map.find(10), 5u);
+}
+
+TEST(FlatIndexMapTest, Clear)
+{
+    FlatIndexMap<uint16_t> map;
+    map.insert(10, 0);
+    map.clear();
+    ASSERT_EQ(map.size(), 0u);
+    ASSERT_EQ(map.find(10), FlatIndexMap<uint16_t>::npos);
+    map.insert(10, 1);
+    ASSERT_EQ(map.find(10), 1u);
+}
+
+TEST(FlatIndexMapTest, Reserve)
+{
+    FlatIndexMap<uint32_t> map;
+    map.reserve(1000);
+    for (uint32_t key = 0; key < 1000; ++key)
+        map.insert(key, key);
+    ASSERT_EQ(map.size(), 1000u);
+    ASSERT_EQ(map.find(999), 999u);
+}
+
+// Mixes inserts and erases and compares with std::unordered_map, covers collisions and backward shifts
+TEST(FlatIndexMapTest, MatchesUnorderedMap)
+{
+    FlatIndexMap<uint32_t> map;
+    std::unordered_map<uint32_t, size_t> reference;
+
+    uint32_t state = 12345;
+    auto next = [&state]()
+    {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % 512;
+    };
+
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        const uint32_t key = next();
+        if (i % 3 == 0)
+        {
+            map.erase(key);
+            reference.erase(key);
+        }
+        else
+        {
+            map.insert(key, i);
+            reference[key] = i;
+        }
+    }
+
+    ASSERT_EQ(map.size(), reference.size());
+    for (uint32_t key = 0; key < 512; ++key)
+    {
+        auto it = reference.find(key);
+        ASSERT_EQ(map.find(key), it == reference.end() ? FlatIndexMap<uint32_t>::npos : it->second);
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/flexray_payload.h>
+
+#include "create_message.h"
+
+using ASAM::CMP::FlexRayPayload;
+using ASAM::CMP::Payload;
+using ASAM::CMP::PayloadType;
+
+class FlexRayPayloadTest : public ::testing::Test
+{
+public:
+    FlexRayPayloadTest()
+    {
+        data.resize(dataSize);
+        std::iota(data.begin(), data.end(), uint8_t{});
+        message = createFlexRayDataMessage(frameId, cycle, data);
+        payload = std::make_unique<FlexRayPayload>(message.data(), message.size());
+    }
+
+protected:
+    static constexpr size_t dataSize = 32;
+    static constexpr uint16_t frameId = 0x0123;
+    static constexpr uint8_t cycle = 17;
+
+protected:
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> message;
+    std::unique_ptr<FlexRayPayload> payload;
+    FlexRayPayload dcPayload;
+};
+
+TEST_F(FlexRayPayloadTest, HeaderSize)
+{
+    static_assert(sizeof(FlexRayPayload::Header) == 13, "Size of the header according to the standard");
+}
+
+TEST_F(FlexRayPayloadTest, DefaultConstructor)
+{
+    ASSERT_TRUE(dcPayload.isValid());
+}
+
+TEST_F(FlexRayPayloadTest, Copy)
+{
+    auto payloadCopy(*payload);
+    ASSERT_TRUE(*payload == payloadCopy);
+}
+
+TEST_F(FlexRayPayloadTest, Move)
+{
+    FlexRayPayload payloadChecker(*payload);
+    FlexRayPayload payloadCopy(std::move(*payload));
+
+    ASSERT_TRUE(payloadCopy == payloadChecker);
+    ASSERT_FALSE(payloadCopy == *payload);
+}
+
+TEST_F(FlexRayPayloadTest, Flags)
+{
+    constexpr FlexRayPayload::Flags syncFrame = FlexRayPayload::Flags::syncFrame;
+    constexpr FlexRayPayload::Flags startupFrame = FlexRayPayload::Flags::startupFrame;
+    constexpr FlexRayPayload::Flags nullFrame = FlexRayPayload::Flags::nullFrame;
+    uint16_t newFlags = to_underlying(syncFrame) | to_underlying(startupFrame);
+
+    payload->setFlags(newFlags);
+
+    ASSERT_EQ(payload->getFlags(), newFlags);
+    ASSERT_TRUE(payload->getFlag(syncFrame));
+    ASSERT_TRUE(payload->getFlag(startupFrame));
+    ASSERT_FALSE(payload->getFlag(nullFrame));
+
+    payload->setFlag(nullFrame, true);
+    payload->setFlag(syncFrame, false);
+    newFlags = to_underlying(startupFrame) | to_underlying(nullFrame);
+
+    ASSERT_EQ(payload->getFlags(), newFlags);
+    ASSERT_EQ(dcPayload.getFlags(), 0u);
+}
+
+TEST_F(FlexRayPayloadTest, Properties)
+{
+    ASSERT_EQ(payload->getType(), PayloadType::flexRay);
+    ASSERT_EQ(payload->getFrameId(), frameId);
+    ASSERT_EQ(payload->getCycle(), cycle);
+    ASSERT_EQ(payload->getPayloadLength(), dataSize);
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), payload->getData()));
+
+    ASSERT_EQ(dcPayload.getType(), PayloadType::flexRay);
+    ASSERT_EQ(dcPayload.getPayloadLength(), 0u);
+    ASSERT_EQ(dcPayload.getData(), nullptr);
+}
+
+TEST_F(FlexRayPayloadTest, Crc)
+{
+    payload->setHeaderCrc(0x07FF);
+    payload->setFrameCrc(0xABCDEF);
+
+    ASSERT_EQ(payload->getHeaderCrc(), 0x07FF);
+    ASSERT_EQ(payload->getFrameCrc(), 0xABCDEFu);
+    ASSERT_EQ(payload->getFrameId(), frameId);
+    ASSERT_EQ(payload->getCycle(), cycle);
+}
+
+TEST_F(FlexRayPayloadTest, SetData)
+{
+    constexpr uint8_t newDataSize = dataSize * 2;
+    std::vector<uint8_t> newData(newDataSize);
+    std::iota(newData.begin(), newData.end(), uint8_t{});
+    payload->setData(newData.data(), newDataSize);
+    ASSERT_EQ(payload->getPayloadLength(), newDataSize);
+    ASSERT_TRUE(std::equal(newData.begin(), newData.end(), payload->getData()));
+}
+
+TEST_F(FlexRayPayloadTest, IsValidPayload)
+{
+    ASSERT_TRUE(FlexRayPayload::isValidPayload(message.data(), message.size()));
+    ASSERT_FALSE(FlexRayPayload::isValidPayload(message.data(), message.size() - 1));
+
+    payload->setFlag(FlexRayPayload::Flags::crcFrameErr, true);
+    ASSERT_FALSE(FlexRayPayload::isValidPayload(payload->getRawPayload(), payload->getLength()));
+}
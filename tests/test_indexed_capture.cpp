@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/indexed_capture.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CaptureModulePayload;
+using ASAM::CMP::IndexedCaptureFormat;
+using ASAM::CMP::IndexedCaptureReader;
+using ASAM::CMP::IndexedCaptureWriter;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+
+class IndexedCaptureFixture : public ::testing::Test
+{
+public:
+    IndexedCaptureFixture()
+    {
+        options.path = ::testing::TempDir() + "asam_cmp_indexed.cidx";
+        options.blockSize = 1024;
+    }
+
+    ~IndexedCaptureFixture() override
+    {
+        std::remove(options.path.c_str());
+    }
+
+protected:
+    static Packet createCanPacket(const uint32_t interfaceId, const uint64_t timestamp, const uint16_t deviceId = 1)
+    {
+        const uint8_t data[] = {static_cast<uint8_t>(timestamp), 2, 3, 4};
+        CanPayload payload;
+        payload.setId(interfaceId);
+        payload.setData(data, sizeof(data));
+
+        Packet packet;
+        packet.setDeviceId(deviceId);
+        packet.setStreamId(5);
+        packet.setInterfaceId(interfaceId);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+    // 4 interfaces, one packet of each every 10 ns
+    void writeCapture(IndexedCaptureWriter& writer, const uint64_t count)
+    {
+        for (uint64_t timestamp = 0; timestamp < count * 10; timestamp += 10)
+            for (uint32_t interfaceId = 40; interfaceId < 44; ++interfaceId)
+                writer.write(createCanPacket(interfaceId, timestamp));
+    }
+
+protected:
+    IndexedCaptureWriter::Options options;
+};
+
+TEST_F(IndexedCaptureFixture, RoundTrip)
+{
+    std::vector<Packet> packets;
+    for (uint64_t timestamp = 0; timestamp < 100; ++timestamp)
+        packets.push_back(createCanPacket(7, timestamp));
+
+    {
+        IndexedCaptureWriter writer(options);
+        writer.write(packets.begin(), packets.end());
+        writer.close();
+        ASSERT_EQ(writer.getPacketCount(), 100u);
+        ASSERT_GT(writer.getBlockCount(), 1u);
+    }
+
+    IndexedCaptureReader reader(options.path);
+    ASSERT_TRUE(reader.isComplete());
+    ASSERT_EQ(reader.getPacketCount(), 100u);
+    ASSERT_EQ(reader.getBeginTime(), 0u);
+    ASSERT_EQ(reader.getEndTime(), 99u);
+
+    auto result = reader.query(IndexedCaptureReader::Query{});
+    ASSERT_EQ(result, packets);
+    ASSERT_EQ(result[0].getDeviceId(), 1u);
+    ASSERT_EQ(result[0].getStreamId(), 5u);
+}
+
+TEST_F(IndexedCaptureFixture, RangeQueryReadsOnlyMatchingBlocks)
+{
+    options.blockSize = 1024 * 1024;
+    options.blockDuration = 100;
+    {
+        IndexedCaptureWriter writer(options);
+        writeCapture(writer, 100);
+    }
+
+    IndexedCaptureReader reader(options.path);
+    ASSERT_EQ(reader.getBlockCount(), 10u);
+
+    IndexedCaptureReader::Query query;
+    query.interfaceIds = {42};
+    query.beginTime = 250;
+    query.endTime = 440;
+    std::vector<uint64_t> timestamps;
+    auto count = reader.query(query,
+                              [&timestamps](const Packet& packet)
+                              {
+                                  ASSERT_EQ(packet.getInterfaceId(), 42u);
+                                  timestamps.push_back(packet.getTimestamp());
+                              });
+    ASSERT_EQ(count, 20u);
+    ASSERT_EQ(timestamps.front(), 250u);
+    ASSERT_EQ(timestamps.back(), 440u);
+    ASSERT_EQ(reader.getStats().blocksRead, 3u);
+}
+
+TEST_F(IndexedCaptureFixture, PointQueryByKey)
+{
+    {
+        IndexedCaptureWriter writer(options);
+        for (uint64_t timestamp = 0; timestamp < 200; ++timestamp)
+            writer.write(createCanPacket(1, timestamp));
+        writer.write(createCanPacket(9, 200, 3));
+
+        CaptureModulePayload status;
+        status.setData("device", "serial", "hw", "sw", {});
+        Packet statusPacket;
+        statusPacket.setDeviceId(3);
+        statusPacket.setTimestamp(201);
+        statusPacket.setPayload(status);
+        writer.write(statusPacket);
+    }
+
+    IndexedCaptureReader reader(options.path);
+    IndexedCaptureReader::Query query;
+    query.deviceIds = {3};
+    query.payloadTypes = {PayloadType::cmStatMsg};
+    auto result = reader.query(query);
+    ASSERT_EQ(result.size(), 1u);
+    ASSERT_EQ(result[0].getPayload().getType(), PayloadType::cmStatMsg);
+    ASSERT_EQ(reader.getStats().blocksRead, 1u);
+
+    query.payloadTypes = {PayloadType::can};
+    result = reader.query(query);
+    ASSERT_EQ(result.size(), 1u);
+    ASSERT_EQ(result[0].getInterfaceId(), 9u);
+}
+
+TEST_F(IndexedCaptureFixture, ReadWhileWriting)
+{
+    IndexedCaptureWriter writer(options);
+    writeCapture(writer, 10);
+    writer.flushBlock();
+
+    IndexedCaptureReader reader(options.path);
+    ASSERT_FALSE(reader.isComplete());
+    ASSERT_EQ(reader.getPacketCount(), 40u);
+    ASSERT_FALSE(reader.refresh());
+
+    writeCapture(writer, 10);
+    writer.flushBlock();
+    ASSERT_TRUE(reader.refresh());
+    ASSERT_EQ(reader.getPacketCount(), 80u);
+
+    IndexedCaptureReader::Query query;
+    query.interfaceIds = {41};
+    ASSERT_EQ(reader.query(query).size(), 20u);
+
+    writer.close();
+    reader.refresh();
+    ASSERT_TRUE(reader.isComplete());
+    ASSERT_EQ(reader.getPacketCount(), 80u);
+}
+
+TEST_F(IndexedCaptureFixture, UnclosedFile)
+{
+    {
+        IndexedCaptureWriter writer(options);
+        writeCapture(writer, 50);
+        writer.flushBlock();
+
+        // Copy the file before the footer is written, with a partially written block at the end
+        std::ifstream source(options.path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+        bytes.insert(bytes.end(), {0x43, 0x42, 0x4C, 0x4B, 0x00, 0x10});
+        std::ofstream(options.path + ".copy", std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    IndexedCaptureReader reader(options.path + ".copy");
+    ASSERT_FALSE(reader.isComplete());
+    ASSERT_EQ(reader.getPacketCount(), 200u);
+    std::remove((options.path + ".copy").c_str());
+}
+
+TEST_F(IndexedCaptureFixture, InvalidFile)
+{
+    std::ofstream(options.path, std::ios::binary) << "not an indexed capture file";
+    ASSERT_THROW(IndexedCaptureReader reader(options.path), std::runtime_error);
+}
+
+TEST_F(IndexedCaptureFixture, CorruptedRecordSize)
+{
+    {
+        IndexedCaptureWriter writer(options);
+        writeCapture(writer, 10);
+    }
+
+    std::ifstream source(options.path, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+    IndexedCaptureFormat::BlockHeader blockHeader;
+    std::memcpy(&blockHeader, bytes.data() + sizeof(IndexedCaptureFormat::FileHeader), sizeof(blockHeader));
+    const std::size_t firstRecord =
+        sizeof(IndexedCaptureFormat::FileHeader) + sizeof(blockHeader) + blockHeader.keyCount * sizeof(IndexedCaptureFormat::IndexEntry);
+
+    // Smaller than the record header and past the end of the block
+    for (const uint32_t recordSize : {uint32_t{4}, blockHeader.blockSize})
+    {
+        auto corrupted = bytes;
+        std::memcpy(corrupted.data() + firstRecord, &recordSize, sizeof(recordSize));
+        std::ofstream(options.path, std::ios::binary).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+
+        IndexedCaptureReader reader(options.path);
+        ASSERT_THROW(reader.query(IndexedCaptureReader::Query{}), std::runtime_error);
+    }
+
+    // Payload length of the message header beyond the record, e.g. in the last record of the block.
+    // All records have the same size.
+    uint32_t recordSize = 0;
+    std::memcpy(&recordSize, bytes.data() + firstRecord, sizeof(recordSize));
+    const std::size_t lastRecord = firstRecord + (blockHeader.recordCount - 1) * recordSize;
+    ASAM::CMP::MessageHeader messageHeader;
+    std::memcpy(&messageHeader, bytes.data() + lastRecord + sizeof(IndexedCaptureFormat::RecordHeader), sizeof(messageHeader));
+    messageHeader.setPayloadLength(0xFFFF);
+    auto corrupted = bytes;
+    std::memcpy(corrupted.data() + lastRecord + sizeof(IndexedCaptureFormat::RecordHeader), &messageHeader, sizeof(messageHeader));
+    std::ofstream(options.path, std::ios::binary).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+
+    IndexedCaptureReader reader(options.path);
+    ASSERT_THROW(reader.query(IndexedCaptureReader::Query{}), std::runtime_error);
+}
+
+TEST_F(IndexedCaptureFixture, WriteAfterClose)
+{
+    IndexedCaptureWriter writer(options);
+    writer.close();
+    ASSERT_THROW(writer.write(createCanPacket(1, 0)), std::runtime_error);
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/concurrent_status.h>
+#include <asam_cmp/device_status.h>
+#include <asam_cmp/interface_rates.h>
+
+#include "create_message.h"
+
+using ASAM::CMP::CaptureModulePayload;
+using ASAM::CMP::ConcurrentStatus;
+using ASAM::CMP::DeviceStatus;
+using ASAM::CMP::InterfacePayload;
+using ASAM::CMP::InterfaceRates;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+using MessageType = ASAM::CMP::CmpHeader::MessageType;
+
+class InterfaceRatesTest : public ::testing::Test
+{
+public:
+    InterfaceRatesTest()
+    {
+        std::vector<uint8_t> data(dataSize);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+
+        auto payloadMsg = createInterfaceDataMessage(interfaceId, {1}, data);
+        auto dataMsg = createDataMessage(PayloadType::ifStatMsg, payloadMsg);
+        ifPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+        ifPacket.setDeviceId(deviceId);
+
+        payloadMsg = createCaptureModuleDataMessage("Device Description", "Serial Number", "Hardware Version", "Software Version", data);
+        dataMsg = createDataMessage(PayloadType::cmStatMsg, payloadMsg);
+        cmPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+        cmPacket.setDeviceId(deviceId);
+    }
+
+protected:
+    InterfacePayload& payload()
+    {
+        return static_cast<InterfacePayload&>(ifPacket.getPayload());
+    }
+
+    void setCounters(const uint32_t msgTotalRx, const uint32_t msgDroppedRx, const uint32_t errorsTotalRx, const uint64_t timestamp)
+    {
+        payload().setMsgTotalRx(msgTotalRx);
+        payload().setMsgDroppedRx(msgDroppedRx);
+        payload().setErrorsTotalRx(errorsTotalRx);
+        ifPacket.setTimestamp(timestamp);
+    }
+
+    void update(const uint32_t msgTotalRx, const uint32_t msgDroppedRx, const uint32_t errorsTotalRx, const uint64_t timestamp)
+    {
+        setCounters(msgTotalRx, msgDroppedRx, errorsTotalRx, timestamp);
+        rates.update(payload(), timestamp);
+    }
+
+    void setUptime(const uint64_t uptime)
+    {
+        static_cast<CaptureModulePayload&>(cmPacket.getPayload()).setUptime(uptime);
+    }
+
+protected:
+    static constexpr size_t dataSize = 32;
+    static constexpr uint16_t deviceId = 37;
+    static constexpr uint32_t interfaceId = 3;
+    static constexpr uint64_t second = 1'000'000'000;
+
+    Packet ifPacket;
+    Packet cmPacket;
+    InterfaceRates rates;
+};
+
+TEST_F(InterfaceRatesTest, NotValidAfterFirstMessage)
+{
+    update(100, 0, 0, second);
+    ASSERT_FALSE(rates.isValid());
+    ASSERT_EQ(rates.getWindowedDuration(), 0u);
+    ASSERT_EQ(rates.getWindowedRates().msgTotalRx, 0.0);
+}
+
+TEST_F(InterfaceRatesTest, ConstantRate)
+{
+    for (uint32_t i = 0; i < 10; ++i)
+        update(100 * i, 2 * i, i, second * (i + 1));
+
+    ASSERT_TRUE(rates.isValid());
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgTotalRx, 100.0);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgDroppedRx, 2.0);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().errorsTotalRx, 1.0);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgTotalTx, 0.0);
+
+    const auto windowed = rates.getWindowedRates();
+    ASSERT_DOUBLE_EQ(windowed.msgTotalRx, 100.0);
+    ASSERT_DOUBLE_EQ(windowed.msgDroppedRx, 2.0);
+    ASSERT_DOUBLE_EQ(windowed.errorsTotalRx, 1.0);
+    ASSERT_EQ(rates.getWindowedDuration(), 9 * second);
+}
+
+TEST_F(InterfaceRatesTest, CounterWrapAround)
+{
+    update(UINT32_MAX - 49, 0, 0, second);
+    update(50, 0, 0, 2 * second);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgTotalRx, 100.0);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 100.0);
+}
+
+TEST_F(InterfaceRatesTest, Ewma)
+{
+    rates.setTimeConstant(second);
+    update(0, 0, 0, 0);
+    update(100, 0, 0, second);
+    update(300, 0, 0, 2 * second);
+
+    const double alpha = 1.0 - std::exp(-1.0);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgTotalRx, 100.0 + alpha * 100.0);
+}
+
+TEST_F(InterfaceRatesTest, WindowDropsOldIntervals)
+{
+    rates.setWindow(2 * second);
+    update(0, 0, 0, 0);
+    update(1000, 0, 0, second);
+    update(1010, 0, 0, 2 * second);
+    update(1030, 0, 0, 3 * second);
+
+    ASSERT_EQ(rates.getWindowedDuration(), 2 * second);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 15.0);
+}
+
+TEST_F(InterfaceRatesTest, WindowKeepsLongInterval)
+{
+    rates.setWindow(second);
+    update(0, 0, 0, 0);
+    update(500, 0, 0, 5 * second);
+
+    ASSERT_EQ(rates.getWindowedDuration(), 5 * second);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 100.0);
+}
+
+TEST_F(InterfaceRatesTest, WindowIntervalCountIsLimited)
+{
+    rates.setWindow(UINT64_MAX);
+    for (uint32_t i = 0; i <= InterfaceRates::maxWindowIntervals + 10; ++i)
+        update(i, 0, 0, second * i);
+
+    ASSERT_EQ(rates.getWindowedDuration(), InterfaceRates::maxWindowIntervals * second);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 1.0);
+}
+
+TEST_F(InterfaceRatesTest, RepeatedMessageIgnored)
+{
+    update(0, 0, 0, 0);
+    update(100, 0, 0, second);
+    update(100, 0, 0, second);
+    ASSERT_DOUBLE_EQ(rates.getEwmaRates().msgTotalRx, 100.0);
+    ASSERT_EQ(rates.getWindowedDuration(), second);
+}
+
+TEST_F(InterfaceRatesTest, TimestampBackwardsStartsAgain)
+{
+    update(0, 0, 0, 10 * second);
+    update(100, 0, 0, 11 * second);
+    update(5, 0, 0, second);
+    update(105, 0, 0, 2 * second);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 100.0);
+}
+
+TEST_F(InterfaceRatesTest, Restart)
+{
+    update(0, 0, 0, 0);
+    update(1000, 0, 0, second);
+    rates.restart();
+    update(10, 0, 0, 2 * second);
+    update(110, 0, 0, 3 * second);
+
+    ASSERT_EQ(rates.getRestartCount(), 1u);
+    ASSERT_EQ(rates.getWindowedDuration(), 2 * second);
+    ASSERT_DOUBLE_EQ(rates.getWindowedRates().msgTotalRx, 550.0);
+}
+
+TEST_F(InterfaceRatesTest, Reset)
+{
+    update(0, 0, 0, 0);
+    update(1000, 0, 0, second);
+    rates.reset();
+    ASSERT_FALSE(rates.isValid());
+    ASSERT_EQ(rates.getWindowedDuration(), 0u);
+    ASSERT_EQ(rates.getEwmaRates().msgTotalRx, 0.0);
+}
+
+TEST_F(InterfaceRatesTest, InterfaceStatusRates)
+{
+    DeviceStatus deviceStatus;
+    setUptime(10 * second);
+    deviceStatus.update(cmPacket);
+
+    setCounters(0, 0, 0, second);
+    deviceStatus.update(ifPacket);
+    setCounters(100, 0, 0, 2 * second);
+    deviceStatus.update(ifPacket);
+
+    const auto& interfaceRates = deviceStatus.getInterfaceStatus(0).getRates();
+    ASSERT_DOUBLE_EQ(interfaceRates.getEwmaRates().msgTotalRx, 100.0);
+}
+
+TEST_F(InterfaceRatesTest, DeviceRestartDetectedFromUptime)
+{
+    DeviceStatus deviceStatus;
+    setUptime(10 * second);
+    deviceStatus.update(cmPacket);
+    setCounters(5000, 0, 0, second);
+    deviceStatus.update(ifPacket);
+
+    setUptime(second);
+    deviceStatus.update(cmPacket);
+    setCounters(10, 0, 0, 2 * second);
+    deviceStatus.update(ifPacket);
+    setCounters(20, 0, 0, 3 * second);
+    deviceStatus.update(ifPacket);
+
+    const auto& interfaceRates = deviceStatus.getInterfaceStatus(0).getRates();
+    ASSERT_EQ(interfaceRates.getRestartCount(), 1u);
+    ASSERT_DOUBLE_EQ(interfaceRates.getWindowedRates().msgTotalRx, 10.0);
+}
+
+TEST_F(InterfaceRatesTest, ConcurrentStatusKeepsRates)
+{
+    ConcurrentStatus status;
+    setUptime(10 * second);
+    status.update(cmPacket);
+    setCounters(5000, 0, 0, second);
+    status.update(ifPacket);
+    setCounters(5100, 0, 0, 2 * second);
+    status.update(ifPacket);
+
+    auto snapshot = status.getSnapshot();
+    ASSERT_DOUBLE_EQ(snapshot->getDeviceStatus(0).getInterfaceStatus(0).getRates().getEwmaRates().msgTotalRx, 100.0);
+
+    setUptime(second);
+    status.update(cmPacket);
+    setCounters(10, 0, 0, 3 * second);
+    status.update(ifPacket);
+
+    snapshot = status.getSnapshot();
+    const auto& interfaceRates = snapshot->getDeviceStatus(0).getInterfaceStatus(0).getRates();
+    ASSERT_EQ(interfaceRates.getRestartCount(), 1u);
+    ASSERT_DOUBLE_EQ(interfaceRates.getEwmaRates().msgTotalRx, 100.0);
+}
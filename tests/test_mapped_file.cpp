@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <numeric>
+
+#include <asam_cmp/mapped_file.h>
+
+using ASAM::CMP::MappedFile;
+
+class MappedFileFixture : public ::testing::Test
+{
+public:
+    MappedFileFixture()
+    {
+        path = ::testing::TempDir() + "asam_cmp_mapped_file.bin";
+        data.resize(100000);
+        std::iota(data.begin(), data.end(), uint8_t{});
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+
+    ~MappedFileFixture() override
+    {
+        std::remove(path.c_str());
+    }
+
+protected:
+    std::string path;
+    std::vector<uint8_t> data;
+};
+
+TEST_F(MappedFileFixture, Open)
+{
+    MappedFile file(path);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.getSize(), data.size());
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), file.getData()));
+}
+
+TEST_F(MappedFileFixture, MissingFile)
+{
+    ASSERT_THROW(MappedFile(path + ".missing"), std::runtime_error);
+}
+
+TEST_F(MappedFileFixture, EmptyFile)
+{
+    const auto emptyPath = path + ".empty";
+    std::ofstream(emptyPath, std::ios::binary).close();
+
+    MappedFile file(emptyPath);
+    ASSERT_TRUE(file.isOpen());
+    ASSERT_EQ(file.getSize(), 0u);
+    ASSERT_EQ(file.getData(), nullptr);
+    file.close();
+    std::remove(emptyPath.c_str());
+}
+
+TEST_F(MappedFileFixture, Move)
+{
+    MappedFile file(path);
+    MappedFile moved(std::move(file));
+    ASSERT_FALSE(file.isOpen());
+    ASSERT_TRUE(moved.isOpen());
+    ASSERT_EQ(moved.getSize(), data.size());
+
+    MappedFile assigned;
+    assigned = std::move(moved);
+    ASSERT_EQ(assigned.getSize(), data.size());
+    ASSERT_EQ(moved.getData(), nullptr);
+}
+
+TEST_F(MappedFileFixture, ReleasedPagesAreReadAgain)
+{
+    MappedFile file(path);
+    file.adviseSequential();
+    file.release(0, data.size());
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), file.getData()));
+}
@@ -0,0 +1,412 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/can_fd_payload.h>
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/mdf4_writer.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::CanFdPayload;
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CanPayloadBase;
+using ASAM::CMP::EthernetPayload;
+using ASAM::CMP::LinPayload;
+using ASAM::CMP::Mdf4Writer;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PacketBatch;
+using ASAM::CMP::Payload;
+using ASAM::CMP::PayloadType;
+
+class Mdf4WriterFixture : public ::testing::Test
+{
+public:
+    Mdf4WriterFixture()
+    {
+        options.path = ::testing::TempDir() + "asam_cmp_writer.mf4";
+        options.startTime = startTime;
+    }
+
+    ~Mdf4WriterFixture() override
+    {
+        std::remove(options.path.c_str());
+    }
+
+protected:
+    struct Block
+    {
+        std::string id;
+        std::vector<uint64_t> links;
+        const uint8_t* data{nullptr};
+        size_t size{0};
+    };
+
+    static Packet createPacket(const uint16_t deviceId, const uint32_t interfaceId, const uint64_t timestamp, const Payload& payload)
+    {
+        Packet packet;
+        packet.setDeviceId(deviceId);
+        packet.setInterfaceId(interfaceId);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+    static CanPayload createCanPayload(const uint32_t id, const uint8_t first)
+    {
+        const uint8_t data[] = {first, 2, 3, 4};
+        CanPayload payload;
+        payload.setId(id);
+        payload.setData(data, sizeof(data));
+        return payload;
+    }
+
+    void readFile()
+    {
+        std::ifstream stream(options.path, std::ios::binary);
+        file.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    Block getBlock(const uint64_t offset) const
+    {
+        EXPECT_EQ(offset % 8, 0u);
+        EXPECT_LE(offset + 24, file.size());
+
+        Block block;
+        uint64_t length = 0;
+        uint64_t linkCount = 0;
+        block.id.assign(reinterpret_cast<const char*>(file.data() + offset), 4);
+        memcpy(&length, file.data() + offset + 8, sizeof(length));
+        memcpy(&linkCount, file.data() + offset + 16, sizeof(linkCount));
+        block.links.resize(linkCount);
+        memcpy(block.links.data(), file.data() + offset + 24, linkCount * 8);
+        block.data = file.data() + offset + 24 + linkCount * 8;
+        block.size = length - 24 - linkCount * 8;
+        EXPECT_LE(offset + length, file.size());
+        return block;
+    }
+
+    std::string getText(const uint64_t offset) const
+    {
+        return offset == 0 ? std::string() : std::string(reinterpret_cast<const char*>(getBlock(offset).data));
+    }
+
+    std::vector<Block> getDataGroups() const
+    {
+        std::vector<Block> dataGroups;
+        for (uint64_t offset = getBlock(64).links[0]; offset != 0; offset = dataGroups.back().links[0])
+            dataGroups.push_back(getBlock(offset));
+        return dataGroups;
+    }
+
+    // Channel names of a list and its compositions
+    std::vector<std::string> getChannelNames(uint64_t offset) const
+    {
+        std::vector<std::string> names;
+        for (; offset != 0; offset = getBlock(offset).links[0])
+        {
+            const auto channel = getBlock(offset);
+            EXPECT_EQ(channel.id, "##CN");
+            names.push_back(getText(channel.links[2]));
+            const auto members = getChannelNames(channel.links[1]);
+            names.insert(names.end(), members.begin(), members.end());
+        }
+        return names;
+    }
+
+    template <typename T>
+    static T read(const uint8_t* data)
+    {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return value;
+    }
+
+protected:
+    static constexpr uint64_t startTime = 1000000000;
+
+    Mdf4Writer::Options options;
+    std::vector<uint8_t> file;
+};
+
+TEST_F(Mdf4WriterFixture, FileStructure)
+{
+    uint64_t fileBytes = 0;
+    {
+        Mdf4Writer writer(options);
+        ASSERT_TRUE(writer.write(createPacket(1, 10, startTime, createCanPayload(0x100, 1))));
+        writer.close();
+        ASSERT_EQ(writer.getChannelGroupCount(), 1u);
+        fileBytes = writer.getStats().fileBytes;
+    }
+
+    readFile();
+    ASSERT_EQ(file.size(), fileBytes);
+    ASSERT_EQ(memcmp(file.data(), "MDF     4.10    ", 16), 0);
+    ASSERT_EQ(read<uint16_t>(file.data() + 28), 410u);
+    ASSERT_EQ(read<uint16_t>(file.data() + 60), 0u);
+
+    const auto header = getBlock(64);
+    ASSERT_EQ(header.id, "##HD");
+    ASSERT_EQ(read<uint64_t>(header.data), startTime);
+    ASSERT_EQ(getBlock(header.links[1]).id, "##FH");
+
+    const auto dataGroups = getDataGroups();
+    ASSERT_EQ(dataGroups.size(), 1u);
+    const auto channelGroup = getBlock(dataGroups[0].links[1]);
+    ASSERT_EQ(channelGroup.id, "##CG");
+    ASSERT_EQ(getText(channelGroup.links[2]), "CAN1");
+    ASSERT_EQ(read<uint64_t>(channelGroup.data + 8), 1u);
+
+    const auto source = getBlock(channelGroup.links[3]);
+    ASSERT_EQ(source.id, "##SI");
+    ASSERT_EQ(getText(source.links[1]), "CMP device 1 interface 10");
+    // Bus source, CAN bus
+    ASSERT_EQ(source.data[0], 2u);
+    ASSERT_EQ(source.data[1], 2u);
+
+    const std::vector<std::string> names = {"Timestamp",
+                                            "CAN_DataFrame",
+                                            "CAN_DataFrame.BusChannel",
+                                            "CAN_DataFrame.ID",
+                                            "CAN_DataFrame.IDE",
+                                            "CAN_DataFrame.DLC",
+                                            "CAN_DataFrame.EDL",
+                                            "CAN_DataFrame.BRS",
+                                            "CAN_DataFrame.ESI",
+                                            "CAN_DataFrame.DataLength",
+                                            "CAN_DataFrame.DataBytes"};
+    ASSERT_EQ(getChannelNames(channelGroup.links[1]), names);
+}
+
+TEST_F(Mdf4WriterFixture, CanRecords)
+{
+    {
+        Mdf4Writer writer(options);
+        auto payload = createCanPayload(0x1ABCDEF, 7);
+        payload.setIde(true);
+        ASSERT_TRUE(writer.write(createPacket(1, 10, startTime + 500000000, payload)));
+
+        CanFdPayload fdPayload;
+        uint8_t data[64];
+        for (uint8_t index = 0; index < sizeof(data); ++index)
+            data[index] = index;
+        fdPayload.setId(0x7FF);
+        fdPayload.setData(data, sizeof(data));
+        fdPayload.setFlag(CanPayloadBase::Flags::brs, true);
+        ASSERT_TRUE(writer.write(createPacket(1, 10, startTime, fdPayload)));
+        ASSERT_EQ(writer.getChannelGroupCount(), 2u);
+    }
+
+    readFile();
+    const auto dataGroups = getDataGroups();
+    ASSERT_EQ(dataGroups.size(), 2u);
+
+    const auto canRecords = getBlock(dataGroups[0].links[2]);
+    ASSERT_EQ(canRecords.id, "##DT");
+    ASSERT_EQ(canRecords.size, 23u);
+    ASSERT_DOUBLE_EQ(read<double>(canRecords.data), 0.5);
+    ASSERT_EQ(canRecords.data[8], 1u);
+    ASSERT_EQ(read<uint32_t>(canRecords.data + 9), 0x1ABCDEFu | 0x80000000u);
+    ASSERT_EQ(canRecords.data[13], 4u);
+    ASSERT_EQ(canRecords.data[14], 4u);
+    ASSERT_EQ(canRecords.data[15], 7u);
+
+    // CAN FD frames have their own group with 64 data bytes on the same bus channel
+    const auto fdRecords = getBlock(dataGroups[1].links[2]);
+    ASSERT_EQ(fdRecords.size, 79u);
+    ASSERT_DOUBLE_EQ(read<double>(fdRecords.data), 0.0);
+    ASSERT_EQ(fdRecords.data[8], 1u);
+    ASSERT_EQ(fdRecords.data[13], 0x0Fu | 0x10u | 0x20u);
+    ASSERT_EQ(fdRecords.data[14], 64u);
+    ASSERT_EQ(fdRecords.data[15 + 63], 63u);
+}
+
+TEST_F(Mdf4WriterFixture, LinAndEthernet)
+{
+    std::vector<uint8_t> frame(20);
+    for (size_t index = 0; index < frame.size(); ++index)
+        frame[index] = static_cast<uint8_t>(index);
+
+    {
+        Mdf4Writer writer(options);
+        LinPayload linPayload;
+        const uint8_t linData[] = {9, 8};
+        linPayload.setLinId(0x21);
+        linPayload.setData(linData, sizeof(linData));
+        linPayload.setChecksum(0x5A);
+        ASSERT_TRUE(writer.write(createPacket(2, 3, startTime, linPayload)));
+
+        EthernetPayload ethernetPayload;
+        ethernetPayload.setData(frame.data(), frame.size());
+        ASSERT_TRUE(writer.write(createPacket(2, 4, startTime, ethernetPayload)));
+        ASSERT_TRUE(writer.write(createPacket(2, 4, startTime, ethernetPayload)));
+    }
+
+    readFile();
+    const auto dataGroups = getDataGroups();
+    ASSERT_EQ(dataGroups.size(), 2u);
+
+    const auto linRecords = getBlock(dataGroups[0].links[2]);
+    ASSERT_EQ(linRecords.size, 20u);
+    ASSERT_EQ(linRecords.data[9], 0x21u);
+    ASSERT_EQ(linRecords.data[10], 2u);
+    ASSERT_EQ(linRecords.data[11], 0x5Au);
+    ASSERT_EQ(linRecords.data[12], 9u);
+
+    const auto ethernetGroup = getBlock(dataGroups[1].links[1]);
+    ASSERT_EQ(getText(ethernetGroup.links[2]), "ETH1");
+    const auto ethernetRecords = getBlock(dataGroups[1].links[2]);
+    ASSERT_EQ(ethernetRecords.size, 2 * 33u);
+    ASSERT_EQ(ethernetRecords.data[9], 0u);
+    ASSERT_EQ(ethernetRecords.data[15], 6u);
+    ASSERT_EQ(ethernetRecords.data[21], 12u);
+    ASSERT_EQ(read<uint16_t>(ethernetRecords.data + 23), 6u);
+    ASSERT_EQ(read<uint64_t>(ethernetRecords.data + 25), 0u);
+    ASSERT_EQ(read<uint64_t>(ethernetRecords.data + 33 + 25), 10u);
+
+    // The DataBytes channel points to the signal data of the frames after the Ethernet header
+    uint64_t channel = getBlock(ethernetGroup.links[1]).links[0];
+    channel = getBlock(channel).links[1];
+    while (getText(getBlock(channel).links[2]) != "ETH_Frame.DataBytes")
+        channel = getBlock(channel).links[0];
+    const auto signalData = getBlock(getBlock(channel).links[5]);
+    ASSERT_EQ(signalData.id, "##SD");
+    ASSERT_EQ(signalData.size, 20u);
+    ASSERT_EQ(read<uint32_t>(signalData.data), 6u);
+    ASSERT_EQ(memcmp(signalData.data + 4, frame.data() + 14, 6), 0);
+}
+
+TEST_F(Mdf4WriterFixture, AnalogScaling)
+{
+    {
+        Mdf4Writer writer(options);
+        const int16_t samples[] = {0, 1, 2, 3};
+        AnalogPayload payload;
+        payload.setSamples(samples, 4);
+        payload.setSampleInterval(0.5f);
+        payload.setSampleScalar(0.25f);
+        payload.setSampleOffset(1.f);
+        payload.setUnit(AnalogPayload::Unit::volt);
+        ASSERT_TRUE(writer.write(createPacket(3, 7, startTime, payload)));
+        ASSERT_TRUE(writer.write(createPacket(3, 7, startTime + 2000000000, payload)));
+        ASSERT_EQ(writer.getChannelGroupCount(), 1u);
+
+        payload.setSampleScalar(2.f);
+        ASSERT_TRUE(writer.write(createPacket(3, 7, startTime + 4000000000, payload)));
+        ASSERT_EQ(writer.getChannelGroupCount(), 2u);
+        writer.close();
+        ASSERT_EQ(writer.getStats().samples, 12u);
+    }
+
+    readFile();
+    const auto dataGroups = getDataGroups();
+    ASSERT_EQ(dataGroups.size(), 2u);
+
+    const auto records = getBlock(dataGroups[0].links[2]);
+    ASSERT_EQ(records.size, 8 * 10u);
+    ASSERT_DOUBLE_EQ(read<double>(records.data + 3 * 10), 1.5);
+    ASSERT_DOUBLE_EQ(read<double>(records.data + 4 * 10), 2.0);
+    // Big-endian raw value 3
+    ASSERT_EQ(records.data[3 * 10 + 8], 0u);
+    ASSERT_EQ(records.data[3 * 10 + 9], 3u);
+
+    const auto value = getBlock(getBlock(getBlock(dataGroups[1].links[1]).links[1]).links[0]);
+    ASSERT_EQ(getText(value.links[6]), "V");
+    const auto conversion = getBlock(value.links[4]);
+    ASSERT_EQ(conversion.id, "##CC");
+    ASSERT_EQ(conversion.data[0], 1u);
+    ASSERT_DOUBLE_EQ(read<double>(conversion.data + 24), 1.0);
+    ASSERT_DOUBLE_EQ(read<double>(conversion.data + 32), 2.0);
+}
+
+TEST_F(Mdf4WriterFixture, DataList)
+{
+    options.blockSize = 4096;
+    {
+        Mdf4Writer writer(options);
+        for (uint64_t index = 0; index < 1000; ++index)
+            writer.write(createPacket(1, 10, startTime + index, createCanPayload(0x100, static_cast<uint8_t>(index))));
+        writer.close();
+        ASSERT_EQ(writer.getStats().frames, 1000u);
+        ASSERT_EQ(writer.getStats().blocks, 6u);
+    }
+
+    readFile();
+    const auto list = getBlock(getDataGroups()[0].links[2]);
+    ASSERT_EQ(list.id, "##DL");
+    ASSERT_EQ(read<uint32_t>(list.data + 4), 6u);
+    ASSERT_EQ(list.links.size(), 7u);
+
+    // Blocks hold whole records and the offsets count the data of the previous blocks
+    uint64_t offset = 0;
+    for (size_t index = 0; index < 6; ++index)
+    {
+        const auto block = getBlock(list.links[index + 1]);
+        ASSERT_EQ(block.id, "##DT");
+        ASSERT_EQ(block.size % 23, 0u);
+        ASSERT_EQ(read<uint64_t>(list.data + 8 + index * 8), offset);
+        offset += block.size;
+    }
+    ASSERT_EQ(offset, 1000 * 23u);
+}
+
+TEST_F(Mdf4WriterFixture, Compression)
+{
+    if (!Mdf4Writer::isCompressionSupported())
+        GTEST_SKIP() << "Built without zlib";
+
+    options.compress = true;
+    {
+        Mdf4Writer writer(options);
+        for (uint64_t index = 0; index < 1000; ++index)
+            writer.write(createPacket(1, 10, startTime + index * 1000, createCanPayload(0x100, 1)));
+        writer.close();
+        ASSERT_LT(writer.getStats().fileBytes, writer.getStats().dataBytes);
+    }
+
+    readFile();
+    const auto headerList = getBlock(getDataGroups()[0].links[2]);
+    ASSERT_EQ(headerList.id, "##HL");
+    // Transposition and deflate
+    ASSERT_EQ(headerList.data[2], 1u);
+
+    const auto list = getBlock(headerList.links[0]);
+    ASSERT_EQ(list.id, "##DL");
+    const auto block = getBlock(list.links[1]);
+    ASSERT_EQ(block.id, "##DZ");
+    ASSERT_EQ(memcmp(block.data, "DT", 2), 0);
+    ASSERT_EQ(read<uint32_t>(block.data + 4), 23u);
+    ASSERT_EQ(read<uint64_t>(block.data + 8), 1000 * 23u);
+}
+
+TEST_F(Mdf4WriterFixture, SkippedPayloads)
+{
+    Mdf4Writer writer(options);
+    const uint8_t data[] = {1, 2, 3, 4};
+
+    auto errorFrame = createCanPayload(0x100, 1);
+    errorFrame.setFlag(CanPayloadBase::Flags::crcErr, true);
+    ASSERT_FALSE(writer.write(createPacket(1, 10, startTime, errorFrame)));
+    ASSERT_FALSE(writer.write(createPacket(1, 10, startTime, Payload(PayloadType::flexRay, data, sizeof(data)))));
+
+    PacketBatch batch;
+    batch.append(createPacket(1, 10, startTime, createCanPayload(0x100, 1)));
+    batch.append(createPacket(1, 10, startTime, errorFrame));
+    batch.append(createPacket(1, 10, startTime, Payload(PayloadType::spi, data, sizeof(data))));
+    ASSERT_EQ(writer.write(batch), 1u);
+    ASSERT_EQ(writer.getChannelGroupCount(), 1u);
+
+    writer.close();
+    ASSERT_THROW(writer.write(createPacket(1, 10, startTime, createCanPayload(0x100, 1))), std::runtime_error);
+}
+
+TEST_F(Mdf4WriterFixture, InvalidPath)
+{
+    options.path = ::testing::TempDir() + "missing_directory/file.mf4";
+    ASSERT_THROW(Mdf4Writer writer(options), std::runtime_error);
+}
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/packet_batch.h>
+
+using ASAM::CMP::AnalogPayload;
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Decoder;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::EthernetPayload;
+using ASAM::CMP::LinPayload;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PacketBatch;
+using ASAM::CMP::PayloadType;
+
+class PacketBatchFixture : public ::testing::Test
+{
+public:
+    PacketBatchFixture()
+    {
+        const uint8_t data[] = {1, 2, 3, 4, 5, 6};
+
+        CanPayload canPayload;
+        canPayload.setId(0x123);
+        canPayload.setData(data, sizeof(data));
+        packets.push_back(createPacket(10, 100, canPayload));
+
+        LinPayload linPayload;
+        linPayload.setLinId(0x21);
+        linPayload.setParityBits(0x2);
+        linPayload.setData(data, 2);
+        packets.push_back(createPacket(11, 200, linPayload));
+
+        AnalogPayload analogPayload;
+        analogPayload.setUnit(AnalogPayload::Unit::volt);
+        const int16_t samples[] = {1, -1, 2};
+        analogPayload.setSamples(samples, 3);
+        packets.push_back(createPacket(12, 300, analogPayload));
+
+        canPayload.setId(0x456);
+        packets.push_back(createPacket(10, 400, canPayload));
+    }
+
+protected:
+    static Packet createPacket(const uint32_t interfaceId, const uint64_t timestamp, const ASAM::CMP::Payload& payload)
+    {
+        Packet packet;
+        packet.setInterfaceId(interfaceId);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+protected:
+    std::vector<Packet> packets;
+};
+
+TEST_F(PacketBatchFixture, Append)
+{
+    PacketBatch batch;
+    ASSERT_TRUE(batch.empty());
+    for (const auto& packet : packets)
+        batch.append(packet);
+
+    ASSERT_EQ(batch.size(), 4u);
+    ASSERT_EQ(batch.getTimestamps(), (std::vector<uint64_t>{100, 200, 300, 400}));
+    ASSERT_EQ(batch.getInterfaceIds(), (std::vector<uint32_t>{10, 11, 12, 10}));
+    ASSERT_EQ(batch.getPayloadTypes(),
+              (std::vector<uint16_t>{PayloadType::can, PayloadType::lin, PayloadType::analog, PayloadType::can}));
+    ASSERT_EQ(batch.getCanIds(), (std::vector<uint32_t>{0x123, 0, 0, 0x456}));
+    ASSERT_EQ(batch.getCanDlcs(), (std::vector<uint8_t>{6, 0, 0, 6}));
+    ASSERT_EQ(batch.getLinPids(), (std::vector<uint8_t>{0, 0xA1, 0, 0}));
+    ASSERT_EQ(batch.getAnalogUnits(), (std::vector<uint8_t>{0, 0, static_cast<uint8_t>(AnalogPayload::Unit::volt), 0}));
+    ASSERT_EQ(batch.getPayloadFlags(), (std::vector<uint16_t>{0, 0, 0, 0}));
+
+    ASSERT_EQ(batch.getPayloadOffsets().size(), 5u);
+    ASSERT_EQ(batch.getPayloadOffsets().back(), batch.getPayloadArena().size());
+    for (size_t index = 0; index < packets.size(); ++index)
+    {
+        ASSERT_EQ(batch.getPayloadLength(index), packets[index].getPayloadLength());
+        ASSERT_EQ(batch.getPacket(index), packets[index]);
+    }
+}
+
+TEST_F(PacketBatchFixture, Clear)
+{
+    PacketBatch batch;
+    batch.reserve(16, 1024);
+    batch.append(packets[0]);
+    batch.clear();
+    ASSERT_TRUE(batch.empty());
+    ASSERT_EQ(batch.getPayloadOffsets(), std::vector<uint64_t>{0});
+    ASSERT_TRUE(batch.getPayloadArena().empty());
+
+    batch.append(packets[1]);
+    ASSERT_EQ(batch.size(), 1u);
+    ASSERT_EQ(batch.getPacket(0), packets[1]);
+}
+
+TEST_F(PacketBatchFixture, Decode)
+{
+    Encoder encoder;
+    encoder.setDeviceId(7);
+    DataContext dataContext{64, 1500};
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+
+    Decoder packetDecoder;
+    Decoder batchDecoder;
+    PacketBatch batch;
+    std::vector<std::shared_ptr<Packet>> decoded;
+    for (const auto& frame : frames)
+    {
+        auto framePackets = packetDecoder.decode(frame.data(), frame.size());
+        decoded.insert(decoded.end(), framePackets.begin(), framePackets.end());
+        ASSERT_EQ(batchDecoder.decode(frame.data(), frame.size(), batch), framePackets.size());
+    }
+
+    ASSERT_EQ(batch.size(), packets.size());
+    ASSERT_EQ(batch.getDeviceIds(), (std::vector<uint16_t>{7, 7, 7, 7}));
+    for (size_t index = 0; index < batch.size(); ++index)
+        ASSERT_EQ(batch.getPacket(index), *decoded[index]);
+}
+
+TEST_F(PacketBatchFixture, DecodeSegmented)
+{
+    std::vector<uint8_t> data(3000);
+    std::iota(data.begin(), data.end(), uint8_t{});
+    EthernetPayload ethernetPayload;
+    ethernetPayload.setData(data.data(), static_cast<uint16_t>(data.size()));
+    std::vector<Packet> ethernetPackets{createPacket(20, 500, ethernetPayload)};
+
+    Encoder encoder;
+    DataContext dataContext{64, 1500};
+    auto frames = encoder.encode(ethernetPackets.begin(), ethernetPackets.end(), dataContext);
+    ASSERT_GT(frames.size(), 1u);
+
+    Decoder decoder;
+    PacketBatch batch;
+    size_t count = 0;
+    for (const auto& frame : frames)
+        count += decoder.decode(frame.data(), frame.size(), batch);
+
+    ASSERT_EQ(count, 1u);
+    ASSERT_EQ(batch.getPayloadTypes()[0], PayloadType::ethernet);
+    ASSERT_EQ(batch.getInterfaceIds()[0], 20u);
+    ASSERT_EQ(batch.getPayloadLength(0), ethernetPayload.getLength());
+}
+
+TEST_F(PacketBatchFixture, InvalidPayload)
+{
+    Encoder encoder;
+    DataContext dataContext{64, 1500};
+    auto frame = encoder.encode(packets.begin(), packets.begin() + 1, dataContext)[0];
+    // CAN data length (last byte of the CAN header) behind the end of the payload
+    frame[sizeof(ASAM::CMP::CmpHeader) + sizeof(ASAM::CMP::MessageHeader) + 15] = 60;
+
+    Decoder packetDecoder;
+    auto decoded = packetDecoder.decode(frame.data(), frame.size());
+    ASSERT_EQ(decoded.size(), 1u);
+
+    Decoder batchDecoder;
+    PacketBatch batch;
+    ASSERT_EQ(batchDecoder.decode(frame.data(), frame.size(), batch), 1u);
+    ASSERT_EQ(batch.getPayloadTypes()[0], PayloadType::can);
+    ASSERT_EQ(batch.getCanIds()[0], 0x123u);
+    ASSERT_EQ(batch.getPacket(0), *decoded[0]);
+    ASSERT_EQ(batch.getPacket(0).getPayload().getType(), PayloadType::invalid);
+}
+
+TEST_F(PacketBatchFixture, ErrorFlags)
+{
+    auto& canPayload = static_cast<CanPayload&>(packets[0].getPayload());
+    canPayload.setFlag(CanPayload::Flags::crcErr, true);
+    canPayload.setFlag(CanPayload::Flags::stuffErr, true);
+
+    Encoder encoder;
+    DataContext dataContext{64, 1500};
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+
+    Decoder decoder;
+    PacketBatch batch;
+    for (const auto& frame : frames)
+        decoder.decode(frame.data(), frame.size(), batch);
+
+    ASSERT_EQ(batch.size(), 4u);
+    ASSERT_EQ(batch.getPayloadTypes()[0], PayloadType::can);
+    ASSERT_EQ(batch.getCanIds()[0], 0x123u);
+
+    const auto& flags = batch.getPayloadFlags();
+    const auto crcErrors = std::count_if(flags.begin(),
+                                         flags.end(),
+                                         [](const uint16_t value) { return (value & static_cast<uint16_t>(CanPayload::Flags::crcErr)) != 0; });
+    ASSERT_EQ(crcErrors, 1);
+}
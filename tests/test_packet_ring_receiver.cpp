@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/packet_ring_receiver.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PacketRingReceiver;
+
+// Sends raw CMP frames on the loopback interface. Needs CAP_NET_RAW, the tests are skipped without it.
+class PacketRingReceiverFixture : public ::testing::Test
+{
+public:
+    PacketRingReceiverFixture()
+    {
+        fd = socket(AF_PACKET, SOCK_RAW, htons(0x99FE));
+        permitted = fd >= 0 || (errno != EPERM && errno != EACCES);
+    }
+
+    ~PacketRingReceiverFixture() override
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+
+protected:
+    void SetUp() override
+    {
+        if (!permitted)
+            GTEST_SKIP() << "Raw sockets need CAP_NET_RAW";
+        ASSERT_GE(fd, 0);
+        interfaceIndex = static_cast<int>(if_nametoindex("lo"));
+        ASSERT_NE(interfaceIndex, 0);
+    }
+
+    void send(const uint32_t count, const size_t minFrameSize = 0)
+    {
+        Encoder encoder;
+        encoder.setDeviceId(4);
+        for (uint32_t id = 0; id < count; ++id)
+        {
+            const uint8_t data[] = {static_cast<uint8_t>(id), 2, 3, 4};
+            CanPayload payload;
+            payload.setId(id);
+            payload.setData(data, sizeof(data));
+
+            Packet packet;
+            packet.setInterfaceId(5);
+            packet.setTimestamp(1000 + id);
+            packet.setPayload(payload);
+
+            for (const auto& cmpFrame : encoder.encode(packet, DataContext{minFrameSize, std::max<size_t>(minFrameSize, 1500)}))
+            {
+                std::vector<uint8_t> frame(14);
+                memset(frame.data(), 0xFF, 6);
+                frame[6] = 0x02;
+                frame[12] = 0x99;
+                frame[13] = 0xFE;
+                frame.insert(frame.end(), cmpFrame.begin(), cmpFrame.end());
+
+                sockaddr_ll address{};
+                address.sll_family = AF_PACKET;
+                address.sll_protocol = htons(0x99FE);
+                address.sll_ifindex = interfaceIndex;
+                address.sll_halen = 6;
+                memset(address.sll_addr, 0xFF, 6);
+                ASSERT_EQ(sendto(fd, frame.data(), frame.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address)),
+                          static_cast<ssize_t>(frame.size()));
+            }
+        }
+    }
+
+    void onBatch(const PacketRingReceiver::Batch& batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(batch.receiveTimes.size(), batch.packets.size());
+        for (size_t index = 0; index < batch.packets.size(); ++index)
+        {
+            // Other tests may send CMP frames on loopback at the same time
+            if (batch.packets.getDeviceIds()[index] == 4)
+                ids.push_back(batch.packets.getCanIds()[index]);
+        }
+        threadIndexes.insert(batch.threadIndex);
+    }
+
+    template <typename Predicate>
+    static bool waitFor(Predicate predicate)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!predicate())
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    bool waitForPackets(const size_t count)
+    {
+        return waitFor(
+            [this, count]()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                return ids.size() >= count;
+            });
+    }
+
+    static PacketRingReceiver::Options createOptions()
+    {
+        PacketRingReceiver::Options options;
+        options.interfaceName = "lo";
+        options.blockSize = 64 * 1024;
+        options.blockCount = 8;
+        options.blockTimeout = 1;
+        options.pollTimeout = 10;
+        return options;
+    }
+
+protected:
+    int fd{-1};
+    bool permitted{true};
+    int interfaceIndex{0};
+
+    std::mutex mutex;
+    std::vector<uint32_t> ids;
+    std::set<size_t> threadIndexes;
+};
+
+TEST_F(PacketRingReceiverFixture, Loopback)
+{
+    PacketRingReceiver receiver(createOptions(), [this](const PacketRingReceiver::Batch& batch) { onBatch(batch); });
+    receiver.start();
+
+    // More frames than fit into one block
+    send(2000);
+    ASSERT_TRUE(waitForPackets(2000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    receiver.stop();
+
+    // Outgoing frames are ignored, every frame is received once
+    ASSERT_EQ(ids.size(), 2000u);
+    for (uint32_t id = 0; id < ids.size(); ++id)
+        ASSERT_EQ(ids[id], id);
+
+    const auto stats = receiver.getStats();
+    ASSERT_GE(stats.frames, 2000u);
+    ASSERT_GE(stats.packets, 2000u);
+    ASSERT_GT(stats.blocks, 1u);
+    ASSERT_EQ(stats.truncated, 0u);
+}
+
+TEST_F(PacketRingReceiverFixture, Fanout)
+{
+    auto options = createOptions();
+    options.threadCount = 2;
+    options.fanoutMode = PacketRingReceiver::FanoutMode::loadBalance;
+    PacketRingReceiver receiver(options, [this](const PacketRingReceiver::Batch& batch) { onBatch(batch); });
+    receiver.start();
+
+    send(200);
+    ASSERT_TRUE(waitForPackets(200));
+    receiver.stop();
+
+    ASSERT_EQ(ids.size(), 200u);
+    ASSERT_EQ(threadIndexes, std::set<size_t>({0, 1}));
+}
+
+TEST_F(PacketRingReceiverFixture, Truncated)
+{
+    auto options = createOptions();
+    options.blockSize = 4096;
+    PacketRingReceiver receiver(options, [this](const PacketRingReceiver::Batch& batch) { onBatch(batch); });
+    receiver.start();
+
+    // The kernel caps the captured length of TPACKET_V3 frames by the block size
+    send(1, 8000);
+    ASSERT_TRUE(waitFor([&receiver]() { return receiver.getStats().truncated > 0; }));
+    receiver.stop();
+
+    ASSERT_TRUE(ids.empty());
+}
+
+TEST_F(PacketRingReceiverFixture, UnknownInterface)
+{
+    auto options = createOptions();
+    options.interfaceName = "asam_cmp_none";
+    ASSERT_THROW(PacketRingReceiver(options, [](const PacketRingReceiver::Batch&) {}), std::runtime_error);
+}
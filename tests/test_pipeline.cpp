@@ -0,0 +1,298 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/pipeline.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PacketBatch;
+using ASAM::CMP::PayloadType;
+using ASAM::CMP::Pipeline;
+
+class PipelineFixture : public ::testing::Test
+{
+protected:
+    // One CMP frame per CAN packet
+    std::vector<std::vector<uint8_t>> createFrames(const uint32_t count)
+    {
+        std::vector<std::vector<uint8_t>> frames;
+        for (uint32_t id = 0; id < count; ++id)
+        {
+            const uint8_t data[] = {static_cast<uint8_t>(id), 2, 3, 4};
+            CanPayload payload;
+            payload.setId(id);
+            payload.setData(data, sizeof(data));
+
+            Packet packet;
+            packet.setInterfaceId(5);
+            packet.setTimestamp(1000 + id);
+            packet.setPayload(payload);
+            for (auto& frame : encoder.encode(packet, DataContext{0, 64}))
+                frames.push_back(std::move(frame));
+        }
+        return frames;
+    }
+
+    static Pipeline::StageOptions createStageOptions(const std::string& name, const size_t threadCount = 1)
+    {
+        Pipeline::StageOptions options;
+        options.name = name;
+        options.threadCount = threadCount;
+        return options;
+    }
+
+    // Waits until the gate opens, so batches pile up in front of the stage
+    Pipeline::StageHandler createGatedStage()
+    {
+        return [this](Pipeline::Batch& batch)
+        {
+            while (!gateOpen)
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::lock_guard<std::mutex> lock(mutex);
+            sequences.push_back(batch.sequence);
+        };
+    }
+
+    bool pushEmpty(Pipeline& pipeline)
+    {
+        return pipeline.push(pipeline.acquireBatch());
+    }
+
+protected:
+    Encoder encoder;
+    std::mutex mutex;
+    std::vector<uint32_t> ids;
+    std::vector<uint64_t> sequences;
+    std::atomic<bool> gateOpen{false};
+};
+
+TEST_F(PipelineFixture, DecodeFilterConsume)
+{
+    Pipeline pipeline;
+    pipeline.addDecodeStage(createStageOptions("decode"));
+    pipeline.addFilterStage(createStageOptions("filter", 2),
+                            [](const PacketBatch& packets, const size_t index) { return packets.getCanIds()[index] % 2 == 0; });
+    pipeline.addPayloadStage(createStageOptions("can"),
+                             PayloadType::can,
+                             [this](const PacketBatch& packets, const size_t index)
+                             {
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 ids.push_back(packets.getCanIds()[index]);
+                             });
+    pipeline.addPayloadStage(createStageOptions("analog"),
+                             PayloadType::analog,
+                             [](const PacketBatch&, const size_t) { FAIL() << "No analog packets were pushed"; });
+    ASSERT_EQ(pipeline.getStageCount(), 4u);
+    pipeline.start();
+    ASSERT_TRUE(pipeline.isRunning());
+
+    const auto frames = createFrames(1000);
+    for (size_t begin = 0; begin < frames.size(); begin += 10)
+    {
+        auto batch = pipeline.acquireBatch();
+        for (size_t index = begin; index < begin + 10; ++index)
+            batch->addFrame(frames[index].data(), frames[index].size());
+        ASSERT_TRUE(pipeline.push(std::move(batch)));
+    }
+    pipeline.stop();
+    ASSERT_FALSE(pipeline.isRunning());
+
+    // The filter stage has two threads, so batches may arrive in any order
+    std::sort(ids.begin(), ids.end());
+    ASSERT_EQ(ids.size(), 500u);
+    for (uint32_t index = 0; index < ids.size(); ++index)
+        ASSERT_EQ(ids[index], index * 2);
+
+    const auto stats = pipeline.getStats();
+    ASSERT_EQ(stats.size(), 4u);
+    ASSERT_EQ(stats[0].name, "decode");
+    ASSERT_EQ(stats[0].batches, 100u);
+    ASSERT_EQ(stats[0].packets, 1000u);
+    ASSERT_EQ(stats[1].packets, 500u);
+    for (const auto& stageStats : stats)
+    {
+        ASSERT_EQ(stageStats.batches, 100u);
+        ASSERT_EQ(stageStats.droppedBatches, 0u);
+        ASSERT_EQ(stageStats.queueSize, 0u);
+        ASSERT_GE(stageStats.maxLatency, stageStats.maxProcessingTime);
+        ASSERT_GE(stageStats.latency, stageStats.processingTime);
+    }
+    ASSERT_GE(stats[3].maxLatency, stats[0].maxProcessingTime);
+}
+
+TEST_F(PipelineFixture, PacketsWithoutDecoding)
+{
+    Pipeline pipeline;
+    pipeline.addFilterStage(createStageOptions("filter"),
+                            [](const PacketBatch& packets, const size_t index) { return packets.getCanIds()[index] < 3; });
+    pipeline.addStage(createStageOptions("sink"),
+                      [this](Pipeline::Batch& batch)
+                      {
+                          for (const auto index : batch.selection)
+                              ids.push_back(batch.packets.getCanIds()[index]);
+                      });
+    pipeline.start();
+
+    // E.g. the batches of UdpReceiver or PacketRingReceiver
+    ASSERT_TRUE(pushEmpty(pipeline));
+    ASSERT_TRUE(pushEmpty(pipeline));
+    auto batch = pipeline.acquireBatch();
+    ASAM::CMP::Decoder decoder;
+    for (const auto& frame : createFrames(10))
+        decoder.decode(frame.data(), frame.size(), batch->packets);
+    batch->selectAll();
+    ASSERT_TRUE(pipeline.push(std::move(batch)));
+    pipeline.stop();
+
+    ASSERT_EQ(ids, std::vector<uint32_t>({0, 1, 2}));
+}
+
+TEST_F(PipelineFixture, Backpressure)
+{
+    Pipeline pipeline;
+    auto options = createStageOptions("slow");
+    options.queueCapacity = 2;
+    pipeline.addStage(options, createGatedStage());
+    pipeline.start();
+
+    // The producer is blocked by the full queue until the stage continues
+    std::thread producer(
+        [this, &pipeline]()
+        {
+            for (int index = 0; index < 20; ++index)
+                pushEmpty(pipeline);
+        });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(pipeline.getStats()[0].queueSize, 2u);
+    gateOpen = true;
+    producer.join();
+    pipeline.stop();
+
+    ASSERT_EQ(sequences.size(), 20u);
+    for (uint64_t index = 0; index < sequences.size(); ++index)
+        ASSERT_EQ(sequences[index], index);
+    ASSERT_EQ(pipeline.getStats()[0].droppedBatches, 0u);
+}
+
+TEST_F(PipelineFixture, DropNewest)
+{
+    Pipeline pipeline;
+    auto options = createStageOptions("slow");
+    options.queueCapacity = 2;
+    options.dropPolicy = Pipeline::DropPolicy::dropNewest;
+    pipeline.addStage(options, createGatedStage());
+    pipeline.start();
+
+    size_t dropped = 0;
+    for (int index = 0; index < 10; ++index)
+    {
+        if (!pushEmpty(pipeline))
+            ++dropped;
+    }
+    gateOpen = true;
+    pipeline.stop();
+
+    ASSERT_GE(dropped, 7u);
+    ASSERT_EQ(pipeline.getStats()[0].droppedBatches, dropped);
+    ASSERT_EQ(sequences.size() + dropped, 10u);
+    // The first batches were kept
+    ASSERT_EQ(sequences.front(), 0u);
+}
+
+TEST_F(PipelineFixture, DropOldest)
+{
+    Pipeline pipeline;
+    auto options = createStageOptions("slow");
+    options.queueCapacity = 2;
+    options.dropPolicy = Pipeline::DropPolicy::dropOldest;
+    pipeline.addStage(options, createGatedStage());
+    pipeline.start();
+
+    for (int index = 0; index < 10; ++index)
+        ASSERT_TRUE(pushEmpty(pipeline));
+    gateOpen = true;
+    pipeline.stop();
+
+    const auto dropped = pipeline.getStats()[0].droppedBatches;
+    ASSERT_GE(dropped, 7u);
+    ASSERT_EQ(sequences.size() + dropped, 10u);
+    // The last batches were kept
+    ASSERT_EQ(sequences.back(), 9u);
+    ASSERT_EQ(sequences[sequences.size() - 2], 8u);
+}
+
+TEST_F(PipelineFixture, HandlerError)
+{
+    Pipeline pipeline;
+    pipeline.addStage(createStageOptions("failing"),
+                      [](Pipeline::Batch& batch)
+                      {
+                          if (batch.sequence == 1)
+                              throw std::runtime_error("handler failed");
+                      });
+    pipeline.addStage(createStageOptions("sink"), [this](Pipeline::Batch& batch) { sequences.push_back(batch.sequence); });
+    pipeline.start();
+    for (int index = 0; index < 3; ++index)
+        pushEmpty(pipeline);
+
+    ASSERT_THROW(pipeline.stop(), std::runtime_error);
+    ASSERT_NO_THROW(pipeline.stop());
+    ASSERT_EQ(sequences, std::vector<uint64_t>({0, 2}));
+    ASSERT_EQ(pipeline.getStats()[0].errors, 1u);
+}
+
+TEST_F(PipelineFixture, UnknownHandlerError)
+{
+    Pipeline pipeline;
+    pipeline.addStage(createStageOptions("failing"), [](Pipeline::Batch&) { throw 42; });
+    pipeline.start();
+    pushEmpty(pipeline);
+
+    ASSERT_THROW(pipeline.stop(), std::runtime_error);
+    ASSERT_EQ(pipeline.getStats()[0].errors, 1u);
+}
+
+TEST_F(PipelineFixture, RecyclesBatches)
+{
+    Pipeline pipeline;
+    pipeline.addStage(createStageOptions("sink"), [](Pipeline::Batch&) {});
+    pipeline.start();
+
+    auto batch = pipeline.acquireBatch();
+    batch->addFrame("abc", 3);
+    const auto* address = batch.get();
+    pipeline.push(std::move(batch));
+    pipeline.stop();
+
+    batch = pipeline.acquireBatch();
+    ASSERT_EQ(batch.get(), address);
+    ASSERT_TRUE(batch->frameData.empty());
+    ASSERT_TRUE(batch->frameEnds.empty());
+}
+
+TEST_F(PipelineFixture, InvalidUse)
+{
+    Pipeline pipeline;
+    ASSERT_THROW(pipeline.start(), std::runtime_error);
+    ASSERT_THROW(pushEmpty(pipeline), std::runtime_error);
+
+    pipeline.addStage(createStageOptions("sink"), [](Pipeline::Batch&) {});
+    pipeline.start();
+    ASSERT_THROW(pipeline.addStage(createStageOptions("late"), [](Pipeline::Batch&) {}), std::runtime_error);
+    pipeline.stop();
+
+    // Stopped pipelines can be extended and started again
+    pipeline.addStage(createStageOptions("late"), [](Pipeline::Batch&) {});
+    pipeline.start();
+    ASSERT_TRUE(pushEmpty(pipeline));
+    pipeline.stop();
+    ASSERT_EQ(pipeline.getStats()[1].batches, 1u);
+}
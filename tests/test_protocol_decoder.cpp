@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/encoder.h>
+#include <asam_cmp/protocol_decoder.h>
+#include <asam_cmp/tecmp_encoder.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Packet;
+using ASAM::CMP::ProtocolDecoder;
+using Protocol = ASAM::CMP::ProtocolDecoder::Protocol;
+
+class ProtocolDecoderFixture : public ::testing::Test
+{
+public:
+    ProtocolDecoderFixture()
+    {
+        std::vector<uint8_t> data(8);
+        std::iota(data.begin(), data.end(), uint8_t{});
+
+        CanPayload canPayload;
+        canPayload.setId(0x123);
+        canPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+
+        packet.setDeviceId(5);
+        packet.setInterfaceId(0x20);
+        packet.setTimestamp(1000);
+        packet.setPayload(canPayload);
+
+        cmpEncoder.setDeviceId(5);
+        tecmpEncoder.setDeviceId(5);
+    }
+
+protected:
+    std::vector<uint8_t> encodeCmp(const size_t count = 1)
+    {
+        std::vector<Packet> packets(count, packet);
+        return cmpEncoder.encode(packets.begin(), packets.end(), dataContext)[0];
+    }
+
+    std::vector<uint8_t> encodeTecmp(const size_t count = 1)
+    {
+        std::vector<Packet> packets(count, packet);
+        return tecmpEncoder.encode(packets.begin(), packets.end(), dataContext)[0];
+    }
+
+protected:
+    Packet packet;
+    ASAM::CMP::Encoder cmpEncoder;
+    TECMP::Encoder tecmpEncoder;
+    DataContext dataContext;
+    ProtocolDecoder decoder;
+};
+
+TEST_F(ProtocolDecoderFixture, Classify)
+{
+    auto cmpFrame = encodeCmp();
+    auto tecmpFrame = encodeTecmp();
+    std::vector<uint8_t> zeros(64);
+
+    ASSERT_EQ(ProtocolDecoder::classify(cmpFrame.data(), cmpFrame.size()), Protocol::cmp);
+    ASSERT_EQ(ProtocolDecoder::classify(tecmpFrame.data(), tecmpFrame.size()), Protocol::tecmp);
+    ASSERT_EQ(ProtocolDecoder::classify(zeros.data(), zeros.size()), Protocol::unknown);
+    ASSERT_EQ(ProtocolDecoder::classify(cmpFrame.data(), 4), Protocol::unknown);
+    ASSERT_EQ(ProtocolDecoder::classify(tecmpFrame.data(), 12), Protocol::unknown);
+    ASSERT_EQ(ProtocolDecoder::classify(nullptr, 0), Protocol::unknown);
+
+    auto otherVersion = cmpFrame;
+    otherVersion[0] = ProtocolDecoder::cmpVersion + 1;
+    ASSERT_EQ(ProtocolDecoder::classify(otherVersion.data(), otherVersion.size()), Protocol::unknown);
+}
+
+TEST_F(ProtocolDecoderFixture, MixedFrames)
+{
+    auto cmpFrame = encodeCmp(2);
+    auto tecmpFrame = encodeTecmp(3);
+
+    const auto& cmpPackets = decoder.decode(cmpFrame.data(), cmpFrame.size());
+    ASSERT_EQ(decoder.getLastProtocol(), Protocol::cmp);
+    ASSERT_EQ(cmpPackets.size(), 2u);
+    ASSERT_EQ(cmpPackets[0].getPayload(), packet.getPayload());
+
+    const auto& tecmpPackets = decoder.decode(tecmpFrame.data(), tecmpFrame.size());
+    ASSERT_EQ(decoder.getLastProtocol(), Protocol::tecmp);
+    ASSERT_EQ(tecmpPackets.size(), 3u);
+    ASSERT_EQ(tecmpPackets[2], packet);
+
+    ASSERT_EQ(decoder.getStats(Protocol::cmp).frames, 1u);
+    ASSERT_EQ(decoder.getStats(Protocol::cmp).packets, 2u);
+    ASSERT_EQ(decoder.getStats(Protocol::cmp).bytes, cmpFrame.size());
+    ASSERT_EQ(decoder.getStats(Protocol::tecmp).frames, 1u);
+    ASSERT_EQ(decoder.getStats(Protocol::tecmp).packets, 3u);
+}
+
+TEST_F(ProtocolDecoderFixture, TecmpStateIsKept)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        auto tecmpFrame = encodeTecmp();
+        auto cmpFrame = encodeCmp();
+        decoder.decode(tecmpFrame.data(), tecmpFrame.size());
+        decoder.decode(cmpFrame.data(), cmpFrame.size());
+    }
+    // Skip one TECMP frame
+    encodeTecmp();
+    auto tecmpFrame = encodeTecmp();
+    decoder.decode(tecmpFrame.data(), tecmpFrame.size());
+
+    const auto& tecmpDecoder = decoder.getTecmpDecoder();
+    ASSERT_EQ(tecmpDecoder.getStats().frames, 4u);
+    ASSERT_EQ(tecmpDecoder.getStats().lostFrames, 1u);
+}
+
+TEST_F(ProtocolDecoderFixture, UnknownFrame)
+{
+    std::vector<uint8_t> zeros(64);
+    ASSERT_TRUE(decoder.decode(zeros.data(), zeros.size()).empty());
+    ASSERT_EQ(decoder.getLastProtocol(), Protocol::unknown);
+    ASSERT_EQ(decoder.getStats(Protocol::unknown).frames, 1u);
+    ASSERT_EQ(decoder.getStats(Protocol::unknown).bytes, 64u);
+}
+
+TEST_F(ProtocolDecoderFixture, Visitor)
+{
+    auto cmpFrame = encodeCmp(2);
+    auto tecmpFrame = encodeTecmp(3);
+
+    size_t visited = 0;
+    auto visitor = [&visited, this](const Packet& decoded)
+    {
+        ASSERT_EQ(decoded.getPayload(), packet.getPayload());
+        ++visited;
+    };
+    ASSERT_EQ(decoder.decode(cmpFrame.data(), cmpFrame.size(), visitor), 2u);
+    ASSERT_EQ(decoder.decode(tecmpFrame.data(), tecmpFrame.size(), visitor), 3u);
+    ASSERT_EQ(visited, 5u);
+}
+
+TEST_F(ProtocolDecoderFixture, Reset)
+{
+    auto tecmpFrame = encodeTecmp();
+    decoder.decode(tecmpFrame.data(), tecmpFrame.size());
+    decoder.reset();
+
+    ASSERT_EQ(decoder.getLastProtocol(), Protocol::unknown);
+    ASSERT_EQ(decoder.getStats(Protocol::tecmp).frames, 0u);
+    ASSERT_EQ(decoder.getTecmpDecoder().getStats().frames, 0u);
+}
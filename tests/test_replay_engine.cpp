@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <thread>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_file_writer.h>
+#include <asam_cmp/cmp_header.h>
+#include <asam_cmp/decoder.h>
+#include <asam_cmp/replay_engine.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::CaptureFileWriter;
+using ASAM::CMP::CmpHeader;
+using ASAM::CMP::Decoder;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::Packet;
+using ASAM::CMP::ReplayEngine;
+
+class ReplayEngineFixture : public ::testing::Test
+{
+protected:
+    static constexpr uint64_t millisecond = 1000000;
+
+    static Packet createPacket(const uint64_t timestamp, const uint32_t id, const uint16_t deviceId = 1, const uint8_t streamId = 1)
+    {
+        const uint8_t data[] = {static_cast<uint8_t>(id), 2, 3, 4};
+        CanPayload payload;
+        payload.setId(id);
+        payload.setData(data, sizeof(data));
+
+        Packet packet;
+        packet.setDeviceId(deviceId);
+        packet.setStreamId(streamId);
+        packet.setInterfaceId(3);
+        packet.setTimestamp(timestamp);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+    static std::vector<std::shared_ptr<Packet>> decode(const std::vector<std::vector<uint8_t>>& frames)
+    {
+        Decoder decoder;
+        std::vector<std::shared_ptr<Packet>> packets;
+        for (const auto& frame : frames)
+        {
+            auto decoded = decoder.decode(frame.data(), frame.size());
+            packets.insert(packets.end(), decoded.begin(), decoded.end());
+        }
+        return packets;
+    }
+};
+
+TEST_F(ReplayEngineFixture, EmptyRun)
+{
+    ReplayEngine engine;
+    size_t calls = 0;
+    engine.run([&calls](const std::vector<std::vector<uint8_t>>&) { ++calls; });
+
+    ASSERT_EQ(calls, 0u);
+    ASSERT_EQ(engine.getStats().packets, 0u);
+}
+
+TEST_F(ReplayEngineFixture, SortedByTimestamp)
+{
+    ReplayEngine::Options options;
+    options.speed = 0;
+    ReplayEngine engine(options);
+    for (uint32_t id : {4, 2, 5, 1, 3})
+        engine.addPacket(createPacket(id * millisecond, id));
+    ASSERT_EQ(engine.getPacketCount(), 5u);
+
+    std::vector<std::vector<uint8_t>> frames;
+    engine.run([&frames](const std::vector<std::vector<uint8_t>>& batch) { frames.insert(frames.end(), batch.begin(), batch.end()); });
+
+    auto packets = decode(frames);
+    ASSERT_EQ(packets.size(), 5u);
+    for (uint32_t index = 0; index < packets.size(); ++index)
+    {
+        ASSERT_EQ(packets[index]->getTimestamp(), (index + 1) * millisecond);
+        ASSERT_EQ(static_cast<const CanPayload&>(packets[index]->getPayload()).getId(), index + 1);
+        ASSERT_EQ(packets[index]->getDeviceId(), 1u);
+        ASSERT_EQ(packets[index]->getStreamId(), 1u);
+        ASSERT_EQ(packets[index]->getInterfaceId(), 3u);
+    }
+    ASSERT_EQ(engine.getStats().packets, 5u);
+    ASSERT_EQ(engine.getStats().frames, frames.size());
+}
+
+TEST_F(ReplayEngineFixture, AsFastAsPossible)
+{
+    ReplayEngine::Options options;
+    options.speed = 0;
+    options.maxBatchPackets = 100;
+    ReplayEngine engine(options);
+    for (uint32_t index = 0; index < 1000; ++index)
+        engine.addPacket(createPacket(index * 1000 * millisecond, index));
+
+    size_t calls = 0;
+    engine.run([&calls](const std::vector<std::vector<uint8_t>>&) { ++calls; });
+
+    const auto& stats = engine.getStats();
+    ASSERT_EQ(calls, 10u);
+    ASSERT_EQ(stats.batches, 10u);
+    ASSERT_EQ(stats.packets, 1000u);
+    ASSERT_LT(stats.duration, 1000 * millisecond);
+    ASSERT_EQ(stats.maxJitter, 0);
+}
+
+TEST_F(ReplayEngineFixture, Pacing)
+{
+    ReplayEngine engine;
+    for (uint32_t index = 0; index < 30; ++index)
+        engine.addPacket(createPacket(1000 * millisecond + index * millisecond, index));
+
+    std::vector<std::chrono::steady_clock::time_point> emitTimes;
+    engine.run([&emitTimes](const std::vector<std::vector<uint8_t>>&) { emitTimes.push_back(std::chrono::steady_clock::now()); });
+
+    const auto& stats = engine.getStats();
+    ASSERT_EQ(stats.packets, 30u);
+    ASSERT_EQ(stats.batches, 30u);
+    ASSERT_EQ(emitTimes.size(), 30u);
+    ASSERT_GE(emitTimes.back() - emitTimes.front(), std::chrono::milliseconds(28));
+    ASSERT_GE(stats.duration, 29 * millisecond);
+    ASSERT_GE(stats.minJitter, 0);
+    ASSERT_LE(stats.minJitter, stats.maxJitter);
+    ASSERT_LE(stats.p50Jitter, stats.p99Jitter);
+    ASSERT_LE(stats.p99Jitter, stats.p999Jitter);
+}
+
+TEST_F(ReplayEngineFixture, Speed)
+{
+    ReplayEngine::Options options;
+    options.speed = 10;
+    ReplayEngine engine(options);
+    for (uint32_t index = 0; index < 11; ++index)
+        engine.addPacket(createPacket(index * 10 * millisecond, index));
+
+    engine.run([](const std::vector<std::vector<uint8_t>>&) {});
+
+    const auto& stats = engine.getStats();
+    ASSERT_EQ(stats.packets, 11u);
+    ASSERT_GE(stats.duration, 10 * millisecond);
+    ASSERT_LT(stats.duration, 100 * millisecond);
+}
+
+TEST_F(ReplayEngineFixture, BatchWindow)
+{
+    ReplayEngine::Options options;
+    options.batchWindow = millisecond;
+    ReplayEngine engine(options);
+    for (uint32_t index = 0; index < 4; ++index)
+        engine.addPacket(createPacket(100000 * index, index));
+    engine.addPacket(createPacket(2 * millisecond, 4));
+
+    std::vector<size_t> batchPackets;
+    engine.run([&batchPackets](const std::vector<std::vector<uint8_t>>& frames) { batchPackets.push_back(decode(frames).size()); });
+
+    ASSERT_EQ(batchPackets, std::vector<size_t>({4, 1}));
+    ASSERT_EQ(engine.getStats().batches, 2u);
+    ASSERT_LT(engine.getStats().minJitter, 0);
+}
+
+TEST_F(ReplayEngineFixture, SequenceCounterPerStream)
+{
+    ReplayEngine::Options options;
+    options.speed = 0;
+    options.maxBatchPackets = 1;
+    ReplayEngine engine(options);
+    for (uint32_t index = 0; index < 6; ++index)
+        engine.addPacket(createPacket(index, index, 1, static_cast<uint8_t>(1 + index % 2)));
+
+    for (int run = 0; run < 2; ++run)
+    {
+        std::vector<std::pair<uint8_t, uint16_t>> counters;
+        engine.run(
+            [&counters](const std::vector<std::vector<uint8_t>>& frames)
+            {
+                for (const auto& frame : frames)
+                {
+                    const auto* header = reinterpret_cast<const CmpHeader*>(frame.data());
+                    counters.emplace_back(header->getStreamId(), header->getSequenceCounter());
+                }
+            });
+
+        const std::vector<std::pair<uint8_t, uint16_t>> expected = {{1, 1}, {2, 1}, {1, 2}, {2, 2}, {1, 3}, {2, 3}};
+        ASSERT_EQ(counters, expected);
+    }
+}
+
+TEST_F(ReplayEngineFixture, Stop)
+{
+    ReplayEngine engine;
+    for (uint32_t index = 0; index < 10; ++index)
+        engine.addPacket(createPacket(index * 1000 * millisecond, index));
+
+    std::thread stopper(
+        [&engine]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            engine.stop();
+        });
+    engine.run([](const std::vector<std::vector<uint8_t>>&) {});
+    stopper.join();
+
+    const auto& stats = engine.getStats();
+    ASSERT_EQ(stats.packets, 1u);
+    ASSERT_LT(stats.duration, 900 * millisecond);
+}
+
+TEST_F(ReplayEngineFixture, LoadCapture)
+{
+    const std::string path = ::testing::TempDir() + "asam_cmp_replay.pcapng";
+    {
+        CaptureFileWriter::Options writerOptions;
+        writerOptions.path = path;
+        CaptureFileWriter writer(writerOptions);
+        const auto interfaceIndex = writer.addInterface("eth0");
+
+        Encoder encoder;
+        encoder.setDeviceId(7);
+        encoder.setStreamId(2);
+        for (uint32_t index = 0; index < 3; ++index)
+        {
+            auto frames = encoder.encode(createPacket(index * millisecond, index, 7, 2), {});
+            writer.writeCmpFrames(interfaceIndex, index * millisecond, frames);
+        }
+        writer.close();
+    }
+
+    ReplayEngine::Options options;
+    options.speed = 0;
+    ReplayEngine engine(options);
+    ASSERT_EQ(engine.loadCapture(path), 3u);
+    ASSERT_EQ(engine.getPacketCount(), 3u);
+    std::remove(path.c_str());
+
+    std::vector<std::vector<uint8_t>> frames;
+    engine.run([&frames](const std::vector<std::vector<uint8_t>>& batch) { frames.insert(frames.end(), batch.begin(), batch.end()); });
+    auto packets = decode(frames);
+    ASSERT_EQ(packets.size(), 3u);
+    ASSERT_EQ(packets[2]->getDeviceId(), 7u);
+    ASSERT_EQ(packets[2]->getStreamId(), 2u);
+    ASSERT_EQ(packets[2]->getTimestamp(), 2 * millisecond);
+
+    engine.clear();
+    ASSERT_EQ(engine.getPacketCount(), 0u);
+}
+
+TEST_F(ReplayEngineFixture, LoadCaptureInvalidPath)
+{
+    ReplayEngine engine;
+    ASSERT_THROW(engine.loadCapture(::testing::TempDir() + "missing/asam_cmp_replay.pcapng"), std::runtime_error);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+
+#include <asam_cmp/sample_converter.h>
+
+using ASAM::CMP::SampleConverter;
+using ASAM::CMP::swapEndian;
+using InstructionSet = SampleConverter::InstructionSet;
+
+class SampleConverterTest : public ::testing::TestWithParam<InstructionSet>
+{
+public:
+    SampleConverterTest()
+    {
+        defaultInstructionSet = SampleConverter::getInstructionSet();
+    }
+
+    ~SampleConverterTest() override
+    {
+        SampleConverter::setInstructionSet(defaultInstructionSet);
+    }
+
+    void SetUp() override
+    {
+        if (!SampleConverter::setInstructionSet(GetParam()))
+            GTEST_SKIP() << "Instruction set is not supported";
+    }
+
+protected:
+    template <typename T>
+    static std::vector<uint8_t> toBigEndianBytes(const std::vector<T>& samples)
+    {
+        std::vector<uint8_t> bytes(samples.size() * sizeof(T));
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            auto value = swapEndian(static_cast<std::make_unsigned_t<T>>(samples[i]));
+            memcpy(bytes.data() + i * sizeof(T), &value, sizeof(T));
+        }
+        return bytes;
+    }
+
+    template <typename T>
+    static std::vector<T> createSamples(const size_t count)
+    {
+        std::vector<T> samples(count);
+        for (size_t i = 0; i < count; ++i)
+            samples[i] = static_cast<T>((i % 2 ? -1 : 1) * static_cast<int64_t>(i * 997 % std::numeric_limits<T>::max()));
+        samples[0] = std::numeric_limits<T>::min();
+        return samples;
+    }
+
+protected:
+    // Covers vector bodies and scalar tails of all kernels
+    static constexpr size_t samplesCount = 67;
+    static constexpr float scalar = 0.125f;
+    static constexpr float offset = -3.5f;
+
+    InstructionSet defaultInstructionSet;
+};
+
+TEST_P(SampleConverterTest, Int16ToFloat)
+{
+    auto samples = createSamples<int16_t>(samplesCount);
+    auto bytes = toBigEndianBytes(samples);
+
+    std::vector<float> values(samplesCount);
+    SampleConverter::int16ToFloat(bytes.data(), samplesCount, scalar, offset, values.data());
+    for (size_t i = 0; i < samplesCount; ++i)
+        ASSERT_FLOAT_EQ(values[i], samples[i] * scalar + offset);
+}
+
+TEST_P(SampleConverterTest, Int32ToFloat)
+{
+    auto samples = createSamples<int32_t>(samplesCount);
+    auto bytes = toBigEndianBytes(samples);
+
+    std::vector<float> values(samplesCount);
+    SampleConverter::int32ToFloat(bytes.data(), samplesCount, scalar, offset, values.data());
+    for (size_t i = 0; i < samplesCount; ++i)
+        ASSERT_FLOAT_EQ(values[i], static_cast<float>(samples[i]) * scalar + offset);
+}
+
+TEST_P(SampleConverterTest, Int16ToDouble)
+{
+    auto samples = createSamples<int16_t>(samplesCount);
+    auto bytes = toBigEndianBytes(samples);
+
+    std::vector<double> values(samplesCount);
+    SampleConverter::int16ToDouble(bytes.data(), samplesCount, scalar, offset, values.data());
+    for (size_t i = 0; i < samplesCount; ++i)
+        ASSERT_DOUBLE_EQ(values[i], samples[i] * double{scalar} + offset);
+}
+
+TEST_P(SampleConverterTest, Int32ToDouble)
+{
+    auto samples = createSamples<int32_t>(samplesCount);
+    auto bytes = toBigEndianBytes(samples);
+
+    std::vector<double> values(samplesCount);
+    SampleConverter::int32ToDouble(bytes.data(), samplesCount, scalar, offset, values.data());
+    for (size_t i = 0; i < samplesCount; ++i)
+        ASSERT_DOUBLE_EQ(values[i], samples[i] * double{scalar} + offset);
+}
+
+TEST_P(SampleConverterTest, Int16ToBigEndian)
+{
+    auto samples = createSamples<int16_t>(samplesCount);
+
+    std::vector<uint8_t> bytes(samplesCount * sizeof(int16_t));
+    SampleConverter::toBigEndian(samples.data(), samplesCount, bytes.data());
+    ASSERT_EQ(bytes, toBigEndianBytes(samples));
+}
+
+TEST_P(SampleConverterTest, Int32ToBigEndian)
+{
+    auto samples = createSamples<int32_t>(samplesCount);
+
+    std::vector<uint8_t> bytes(samplesCount * sizeof(int32_t));
+    SampleConverter::toBigEndian(samples.data(), samplesCount, bytes.data());
+    ASSERT_EQ(bytes, toBigEndianBytes(samples));
+}
+
+TEST_P(SampleConverterTest, Int16MinMaxSum)
+{
+    auto samples = createSamples<int16_t>(samplesCount);
+    auto bytes = toBigEndianBytes(samples);
+
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    int64_t sum = 10;
+    SampleConverter::int16MinMaxSum(bytes.data(), samplesCount, min, max, sum);
+    ASSERT_EQ(min, *std::min_element(samples.begin(), samples.end()));
+    ASSERT_EQ(max, *std::max_element(samples.begin(), samples.end()));
+    ASSERT_EQ(sum, std::accumulate(samples.begin(), samples.end(), int64_t{10}));
+}
+
+TEST_P(SampleConverterTest, Int32MinMaxSum)
+{
+    auto samples = createSamples<int32_t>(samplesCount);
+    samples[1] = std::numeric_limits<int32_t>::max();
+    auto bytes = toBigEndianBytes(samples);
+
+    int32_t min = INT32_MAX;
+    int32_t max = INT32_MIN;
+    int64_t sum = 0;
+    SampleConverter::int32MinMaxSum(bytes.data(), samplesCount, min, max, sum);
+    ASSERT_EQ(min, *std::min_element(samples.begin(), samples.end()));
+    ASSERT_EQ(max, *std::max_element(samples.begin(), samples.end()));
+    ASSERT_EQ(sum, std::accumulate(samples.begin(), samples.end(), int64_t{0}));
+}
+
+TEST_P(SampleConverterTest, MinMaxSumShortInput)
+{
+    auto samples = createSamples<int16_t>(3);
+    auto bytes = toBigEndianBytes(samples);
+
+    int32_t min = 0;
+    int32_t max = 0;
+    int64_t sum = 0;
+    SampleConverter::int16MinMaxSum(bytes.data(), samples.size(), min, max, sum);
+    ASSERT_EQ(min, std::numeric_limits<int16_t>::min());
+    ASSERT_EQ(max, *std::max_element(samples.begin(), samples.end()));
+    ASSERT_EQ(sum, std::accumulate(samples.begin(), samples.end(), int64_t{0}));
+}
+
+TEST_P(SampleConverterTest, MinMaxSumBuckets)
+{
+    auto samples16 = createSamples<int16_t>(samplesCount);
+    auto samples32 = createSamples<int32_t>(samplesCount);
+    auto bytes16 = toBigEndianBytes(samples16);
+    auto bytes32 = toBigEndianBytes(samples32);
+
+    // Buckets shorter than, equal to and longer than the vectors, the last bucket is shorter
+    for (const size_t bucketSize : {3u, 8u, 16u, 20u})
+    {
+        std::vector<SampleConverter::MinMaxSum> buckets16((samplesCount + bucketSize - 1) / bucketSize);
+        std::vector<SampleConverter::MinMaxSum> buckets32(buckets16.size());
+        SampleConverter::int16MinMaxSumBuckets(bytes16.data(), samplesCount, bucketSize, buckets16.data());
+        SampleConverter::int32MinMaxSumBuckets(bytes32.data(), samplesCount, bucketSize, buckets32.data());
+
+        for (size_t index = 0; index < buckets16.size(); ++index)
+        {
+            const auto begin = static_cast<std::ptrdiff_t>(index * bucketSize);
+            const auto end = static_cast<std::ptrdiff_t>(std::min(samplesCount, (index + 1) * bucketSize));
+            ASSERT_EQ(buckets16[index].min, *std::min_element(samples16.begin() + begin, samples16.begin() + end));
+            ASSERT_EQ(buckets16[index].max, *std::max_element(samples16.begin() + begin, samples16.begin() + end));
+            ASSERT_EQ(buckets16[index].sum, std::accumulate(samples16.begin() + begin, samples16.begin() + end, int64_t{0}));
+            ASSERT_EQ(buckets32[index].min, *std::min_element(samples32.begin() + begin, samples32.begin() + end));
+            ASSERT_EQ(buckets32[index].max, *std::max_element(samples32.begin() + begin, samples32.begin() + end));
+            ASSERT_EQ(buckets32[index].sum, std::accumulate(samples32.begin() + begin, samples32.begin() + end, int64_t{0}));
+        }
+    }
+}
+
+TEST_P(SampleConverterTest, ZeroCount)
+{
+    float value = 1.f;
+    SampleConverter::int16ToFloat(nullptr, 0, scalar, offset, &value);
+    ASSERT_EQ(value, 1.f);
+}
+
+INSTANTIATE_TEST_SUITE_P(InstructionSets,
+                         SampleConverterTest,
+                         ::testing::Values(InstructionSet::scalar, InstructionSet::sse2, InstructionSet::avx2, InstructionSet::neon));
+
+TEST(SampleConverterDispatch, ScalarIsAlwaysSupported)
+{
+    ASSERT_TRUE(SampleConverter::isSupported(InstructionSet::scalar));
+    ASSERT_TRUE(SampleConverter::isSupported(SampleConverter::getInstructionSet()));
+}
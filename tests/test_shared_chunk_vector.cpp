@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <asam_cmp/shared_chunk_vector.h>
+
+using ASAM::CMP::SharedChunkVector;
+
+constexpr size_t chunkSize = SharedChunkVector<int>::chunkSize;
+
+TEST(SharedChunkVectorTest, Empty)
+{
+    SharedChunkVector<int> vector;
+    ASSERT_TRUE(vector.empty());
+    ASSERT_EQ(vector.size(), 0u);
+}
+
+TEST(SharedChunkVectorTest, PushSetPop)
+{
+    SharedChunkVector<int> vector;
+    for (int value = 0; value < static_cast<int>(chunkSize * 2 + 5); ++value)
+        vector.pushBack(value);
+    ASSERT_EQ(vector.size(), chunkSize * 2 + 5);
+    for (size_t index = 0; index < vector.size(); ++index)
+        ASSERT_EQ(vector[index], static_cast<int>(index));
+
+    vector.set(chunkSize + 1, -1);
+    ASSERT_EQ(vector[chunkSize + 1], -1);
+    ASSERT_EQ(vector.back(), static_cast<int>(chunkSize * 2 + 4));
+
+    // Across the chunk border
+    for (size_t count = 0; count < 6; ++count)
+        vector.popBack();
+    ASSERT_EQ(vector.size(), chunkSize * 2 - 1);
+    ASSERT_EQ(vector.back(), static_cast<int>(chunkSize * 2 - 2));
+    vector.pushBack(100);
+    ASSERT_EQ(vector.back(), 100);
+
+    vector.clear();
+    ASSERT_TRUE(vector.empty());
+}
+
+TEST(SharedChunkVectorTest, CopiesAreIndependent)
+{
+    SharedChunkVector<int> original;
+    for (int value = 0; value < static_cast<int>(chunkSize * 3); ++value)
+        original.pushBack(value);
+
+    auto copy = original;
+    copy.set(0, -1);
+    copy.set(chunkSize * 2, -2);
+    copy.popBack();
+    copy.pushBack(-3);
+
+    ASSERT_EQ(original.size(), chunkSize * 3);
+    for (size_t index = 0; index < original.size(); ++index)
+        ASSERT_EQ(original[index], static_cast<int>(index));
+
+    ASSERT_EQ(copy[0], -1);
+    ASSERT_EQ(copy[chunkSize], static_cast<int>(chunkSize));
+    ASSERT_EQ(copy[chunkSize * 2], -2);
+    ASSERT_EQ(copy.back(), -3);
+}
+
+TEST(SharedChunkVectorTest, UnchangedChunksAreShared)
+{
+    SharedChunkVector<int> original;
+    for (int value = 0; value < static_cast<int>(chunkSize * 2); ++value)
+        original.pushBack(value);
+
+    auto copy = original;
+    copy.set(chunkSize, -1);
+    ASSERT_EQ(&copy[0], &original[0]);
+    ASSERT_NE(&copy[chunkSize], &original[chunkSize]);
+}
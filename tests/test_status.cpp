@@ -134,3 +134,53 @@ TEST_F(StatusTest, InterfaceStatusBeforDeviceStatus)
     ASSERT_EQ(status.getDeviceStatusCount(), 1u);
     ASSERT_EQ(status.getDeviceStatus(0).getInterfaceStatusCount(), 0u);
 }
+
+TEST_F(StatusTest, RemoveDeviceKeepsIndexes)
+{
+    for (uint16_t id = deviceId; id < deviceId + 4; ++id)
+    {
+        cmPacket.setDeviceId(id);
+        status.update(cmPacket);
+    }
+
+    status.removeDeviceById(deviceId);
+    ASSERT_EQ(status.getDeviceStatusCount(), 3u);
+    ASSERT_EQ(status.getIndexByDeviceId(deviceId), status.getDeviceStatusCount());
+    for (uint16_t id = deviceId + 1; id < deviceId + 4; ++id)
+    {
+        auto index = status.getIndexByDeviceId(id);
+        ASSERT_LT(index, status.getDeviceStatusCount());
+        ASSERT_EQ(status.getDeviceStatus(index).getPacket().getDeviceId(), id);
+    }
+
+    status.clear();
+    ASSERT_EQ(status.getIndexByDeviceId(deviceId + 1), 0u);
+}
+
+TEST_F(StatusTest, UpdateWithMovedPacket)
+{
+    Packet packet = cmPacket;
+    status.update(std::move(packet));
+    packet = ifPacket;
+    status.update(std::move(packet));
+
+    ASSERT_EQ(status.getDeviceStatusCount(), 1u);
+    ASSERT_EQ(status.getDeviceStatus(0).getPacket(), cmPacket);
+    ASSERT_EQ(status.getDeviceStatus(0).getInterfaceStatusCount(), 1u);
+    ASSERT_EQ(status.getDeviceStatus(0).getInterfaceStatus(0).getPacket(), ifPacket);
+}
+
+TEST_F(StatusTest, ManyDevices)
+{
+    constexpr uint16_t devicesCount = 300;
+    for (uint16_t id = 0; id < devicesCount; ++id)
+    {
+        cmPacket.setDeviceId(id * 7);
+        status.update(cmPacket);
+    }
+
+    ASSERT_EQ(status.getDeviceStatusCount(), devicesCount);
+    for (uint16_t id = 0; id < devicesCount; ++id)
+        ASSERT_EQ(status.getDeviceStatus(status.getIndexByDeviceId(id * 7)).getPacket().getDeviceId(), id * 7);
+    ASSERT_EQ(status.getIndexByDeviceId(1), status.getDeviceStatusCount());
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/status.h>
+
+#include "create_message.h"
+
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+using ASAM::CMP::Status;
+using ASAM::CMP::StatusChange;
+using MessageType = ASAM::CMP::CmpHeader::MessageType;
+using Type = StatusChange::Type;
+
+class StatusAgingTest : public ::testing::Test
+{
+public:
+    StatusAgingTest()
+    {
+        std::vector<uint8_t> data(dataSize);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+
+        auto payloadMsg = createCaptureModuleDataMessage("Device Description", "Serial Number", "Hardware Version", "Software Version", data);
+        auto dataMsg = createDataMessage(PayloadType::cmStatMsg, payloadMsg);
+        cmPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+
+        payloadMsg = createInterfaceDataMessage(interfaceId, {1}, data);
+        dataMsg = createDataMessage(PayloadType::ifStatMsg, payloadMsg);
+        ifPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+
+        status.subscribe([this](const StatusChange& change) { changes.push_back(change); });
+        status.setTimeToLive(timeToLive);
+    }
+
+protected:
+    void updateDevice(const uint16_t deviceId)
+    {
+        cmPacket.setDeviceId(deviceId);
+        status.update(cmPacket);
+    }
+
+    void updateInterface(const uint16_t deviceId, const uint32_t id)
+    {
+        ifPacket.setDeviceId(deviceId);
+        ifPacket.setInterfaceId(id);
+        static_cast<ASAM::CMP::InterfacePayload&>(ifPacket.getPayload()).setInterfaceId(id);
+        status.update(ifPacket);
+    }
+
+protected:
+    static constexpr size_t dataSize = 32;
+    static constexpr uint32_t interfaceId = 3;
+    static constexpr uint64_t timeToLive = 1000;
+
+    Packet cmPacket;
+    Packet ifPacket;
+    Status status;
+    std::vector<StatusChange> changes;
+};
+
+TEST_F(StatusAgingTest, DisabledByDefault)
+{
+    Status otherStatus;
+    ASSERT_EQ(otherStatus.getTimeToLive(), 0u);
+
+    cmPacket.setDeviceId(1);
+    otherStatus.update(cmPacket);
+    otherStatus.advanceTime(UINT64_MAX / 2);
+    ASSERT_EQ(otherStatus.getDeviceStatusCount(), 1u);
+}
+
+TEST_F(StatusAgingTest, LastSeen)
+{
+    status.advanceTime(100);
+    updateDevice(1);
+    updateInterface(1, interfaceId);
+    status.advanceTime(300);
+    updateInterface(1, interfaceId);
+
+    const auto& device = status.getDeviceStatus(0);
+    ASSERT_EQ(status.getTime(), 300u);
+    ASSERT_EQ(device.getLastSeen(), 300u);
+    ASSERT_EQ(device.getInterfaceStatus(0).getLastSeen(), 300u);
+}
+
+TEST_F(StatusAgingTest, SilentDeviceExpires)
+{
+    status.advanceTime(100);
+    updateDevice(1);
+    updateDevice(2);
+    changes.clear();
+
+    status.advanceTime(1000);
+    updateDevice(2);
+    status.advanceTime(1099);
+    ASSERT_EQ(status.getDeviceStatusCount(), 2u);
+
+    status.advanceTime(1100);
+    ASSERT_EQ(status.getDeviceStatusCount(), 1u);
+    ASSERT_EQ(status.getIndexByDeviceId(1), status.getDeviceStatusCount());
+    ASSERT_EQ(status.getDeviceStatus(0).getPacket().getDeviceId(), 2);
+
+    ASSERT_EQ(changes.size(), 1u);
+    ASSERT_EQ(changes[0].type, Type::deviceExpired);
+    ASSERT_EQ(changes[0].deviceId, 1);
+
+    status.advanceTime(2000);
+    ASSERT_EQ(status.getDeviceStatusCount(), 0u);
+}
+
+TEST_F(StatusAgingTest, ActiveDeviceStays)
+{
+    for (uint64_t now = 0; now < 10 * timeToLive; now += timeToLive / 2)
+    {
+        status.advanceTime(now);
+        updateDevice(1);
+    }
+    ASSERT_EQ(status.getDeviceStatusCount(), 1u);
+    ASSERT_TRUE(changes.size() == 1u && changes[0].type == Type::deviceAdded);
+}
+
+TEST_F(StatusAgingTest, SilentInterfaceExpires)
+{
+    updateDevice(1);
+    updateInterface(1, 10);
+    updateInterface(1, 20);
+    changes.clear();
+
+    status.advanceTime(500);
+    updateDevice(1);
+    updateInterface(1, 20);
+    status.advanceTime(1000);
+
+    const auto& device = status.getDeviceStatus(0);
+    ASSERT_EQ(device.getInterfaceStatusCount(), 1u);
+    ASSERT_EQ(device.getInterfaceStatus(0).getInterfaceId(), 20u);
+    ASSERT_EQ(changes.size(), 1u);
+    ASSERT_EQ(changes[0].type, Type::interfaceExpired);
+    ASSERT_EQ(changes[0].interfaceId, 10u);
+}
+
+TEST_F(StatusAgingTest, RemovedAndAddedAgainDeviceUsesNewTime)
+{
+    updateDevice(1);
+    status.advanceTime(900);
+    status.removeDeviceById(1);
+    updateDevice(1);
+
+    status.advanceTime(1500);
+    ASSERT_EQ(status.getDeviceStatusCount(), 1u);
+    status.advanceTime(1900);
+    ASSERT_EQ(status.getDeviceStatusCount(), 0u);
+}
+
+TEST_F(StatusAgingTest, EnableLater)
+{
+    Status otherStatus;
+    cmPacket.setDeviceId(1);
+    otherStatus.advanceTime(100);
+    otherStatus.update(cmPacket);
+    otherStatus.advanceTime(5000);
+
+    otherStatus.setTimeToLive(timeToLive);
+    otherStatus.advanceTime(5001);
+    ASSERT_EQ(otherStatus.getDeviceStatusCount(), 0u);
+}
+
+TEST_F(StatusAgingTest, TimeBackwardsIgnored)
+{
+    status.advanceTime(500);
+    updateDevice(1);
+    status.advanceTime(100);
+    ASSERT_EQ(status.getTime(), 500u);
+    ASSERT_EQ(status.getDeviceStatusCount(), 1u);
+}
+
+TEST_F(StatusAgingTest, ManyDevices)
+{
+    for (uint16_t id = 0; id < 1000; ++id)
+    {
+        status.advanceTime(id);
+        updateDevice(id);
+    }
+
+    status.advanceTime(1499);
+    ASSERT_EQ(status.getDeviceStatusCount(), 500u);
+    for (size_t i = 0; i < status.getDeviceStatusCount(); ++i)
+        ASSERT_GE(status.getDeviceStatus(i).getPacket().getDeviceId(), 500);
+
+    status.advanceTime(2000);
+    ASSERT_EQ(status.getDeviceStatusCount(), 0u);
+}
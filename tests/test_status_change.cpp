@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/interface_payload.h>
+#include <asam_cmp/status.h>
+
+#include "create_message.h"
+
+using ASAM::CMP::CaptureModulePayload;
+using ASAM::CMP::DeviceStatus;
+using ASAM::CMP::InterfacePayload;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+using ASAM::CMP::Status;
+using ASAM::CMP::StatusChange;
+using MessageType = ASAM::CMP::CmpHeader::MessageType;
+using Field = StatusChange::Field;
+using Type = StatusChange::Type;
+
+class StatusChangeTest : public ::testing::Test
+{
+public:
+    StatusChangeTest()
+    {
+        std::vector<uint8_t> data(dataSize);
+        std::iota(data.begin(), data.end(), uint8_t{0});
+        auto payloadMsg = createCaptureModuleDataMessage("Device Description", "Serial Number", "Hardware Version", "Software Version", data);
+        auto cmDataMsg = createDataMessage(PayloadType::cmStatMsg, payloadMsg);
+        cmPacket = Packet{MessageType::status, cmDataMsg.data(), cmDataMsg.size()};
+        cmPacket.setDeviceId(deviceId);
+
+        payloadMsg = createInterfaceDataMessage(interfaceId, {1}, data);
+        auto dataMsg = createDataMessage(PayloadType::ifStatMsg, payloadMsg);
+        ifPacket = Packet{MessageType::status, dataMsg.data(), dataMsg.size()};
+        ifPacket.setDeviceId(deviceId);
+
+        status.subscribe([this](const StatusChange& change) { changes.push_back(change); });
+    }
+
+protected:
+    InterfacePayload& interfacePayload()
+    {
+        return static_cast<InterfacePayload&>(ifPacket.getPayload());
+    }
+
+    CaptureModulePayload& captureModulePayload()
+    {
+        return static_cast<CaptureModulePayload&>(cmPacket.getPayload());
+    }
+
+protected:
+    static constexpr size_t dataSize = 32;
+    static constexpr uint16_t deviceId = 37;
+    static constexpr uint32_t interfaceId = 3;
+
+    Packet cmPacket;
+    Packet ifPacket;
+    Status status;
+    std::vector<StatusChange> changes;
+};
+
+TEST_F(StatusChangeTest, DeviceAndInterfaceAdded)
+{
+    status.update(cmPacket);
+    status.update(ifPacket);
+
+    ASSERT_EQ(changes.size(), 2u);
+    ASSERT_EQ(changes[0].type, Type::deviceAdded);
+    ASSERT_EQ(changes[0].deviceId, deviceId);
+    ASSERT_EQ(changes[1].type, Type::interfaceAdded);
+    ASSERT_EQ(changes[1].interfaceId, interfaceId);
+    ASSERT_EQ(changes[1].previous, nullptr);
+}
+
+TEST_F(StatusChangeTest, NoChangeNoEvent)
+{
+    status.update(cmPacket);
+    status.update(ifPacket);
+    changes.clear();
+
+    captureModulePayload().setUptime(1000);
+    status.update(cmPacket);
+    status.update(ifPacket);
+    ASSERT_TRUE(changes.empty());
+}
+
+TEST_F(StatusChangeTest, InterfaceStatusChanged)
+{
+    interfacePayload().setInterfaceStatus(InterfacePayload::InterfaceStatus::linkStatusUp);
+    status.update(cmPacket);
+    status.update(ifPacket);
+    changes.clear();
+
+    interfacePayload().setInterfaceStatus(InterfacePayload::InterfaceStatus::linkStatusDown);
+    status.update(ifPacket);
+
+    ASSERT_EQ(changes.size(), 1u);
+    ASSERT_EQ(changes[0].type, Type::interfaceChanged);
+    ASSERT_EQ(changes[0].fields, static_cast<uint32_t>(Field::interfaceStatus));
+}
+
+TEST_F(StatusChangeTest, CounterDeltas)
+{
+    interfacePayload().setMsgTotalRx(UINT32_MAX - 1);
+    interfacePayload().setErrorsTotalTx(10);
+    status.update(cmPacket);
+    status.update(ifPacket);
+    changes.clear();
+
+    interfacePayload().setMsgTotalRx(3);
+    interfacePayload().setErrorsTotalTx(12);
+    status.update(ifPacket);
+
+    ASSERT_EQ(changes.size(), 1u);
+    const auto& change = changes[0];
+    ASSERT_TRUE(change.hasField(Field::msgTotalRx));
+    ASSERT_TRUE(change.hasField(Field::errorsTotalTx));
+    ASSERT_FALSE(change.hasField(Field::msgTotalTx));
+    ASSERT_EQ(change.deltas.msgTotalRx, 5u);
+    ASSERT_EQ(change.deltas.errorsTotalTx, 2u);
+}
+
+TEST_F(StatusChangeTest, PacketsDuringCallback)
+{
+    status.update(cmPacket);
+    status.update(ifPacket);
+
+    Packet previous = ifPacket;
+    interfacePayload().setMsgDroppedRx(7);
+    bool called = false;
+    status.subscribe(
+        [&](const StatusChange& change)
+        {
+            called = true;
+            ASSERT_NE(change.previous, nullptr);
+            ASSERT_NE(change.current, nullptr);
+            ASSERT_EQ(*change.previous, previous);
+            ASSERT_EQ(*change.current, ifPacket);
+        });
+    status.update(ifPacket);
+    ASSERT_TRUE(called);
+}
+
+TEST_F(StatusChangeTest, GptpChanged)
+{
+    status.update(cmPacket);
+    changes.clear();
+
+    captureModulePayload().setGmIdentity(0x1122334455667788);
+    captureModulePayload().setDomainNumber(4);
+    status.update(std::move(cmPacket));
+
+    ASSERT_EQ(changes.size(), 1u);
+    ASSERT_EQ(changes[0].type, Type::deviceChanged);
+    ASSERT_EQ(changes[0].fields, static_cast<uint32_t>(Field::gmIdentity) | static_cast<uint32_t>(Field::domainNumber));
+    const auto& payload = static_cast<const CaptureModulePayload&>(status.getDeviceStatus(0).getPacket().getPayload());
+    ASSERT_EQ(payload.getGmIdentity(), 0x1122334455667788u);
+}
+
+TEST_F(StatusChangeTest, DeviceRemoved)
+{
+    status.update(cmPacket);
+    changes.clear();
+
+    status.removeDeviceById(deviceId);
+    ASSERT_EQ(changes.size(), 1u);
+    ASSERT_EQ(changes[0].type, Type::deviceRemoved);
+    ASSERT_EQ(changes[0].deviceId, deviceId);
+}
+
+TEST_F(StatusChangeTest, Unsubscribe)
+{
+    Status otherStatus;
+    size_t calls = 0;
+    auto id = otherStatus.subscribe([&calls](const StatusChange&) { ++calls; });
+    otherStatus.update(cmPacket);
+    otherStatus.unsubscribe(id);
+    otherStatus.update(ifPacket);
+    ASSERT_EQ(calls, 1u);
+}
+
+TEST_F(StatusChangeTest, DeviceStatusSubscription)
+{
+    DeviceStatus deviceStatus;
+    std::vector<StatusChange> deviceChanges;
+    deviceStatus.subscribe([&deviceChanges](const StatusChange& change) { deviceChanges.push_back(change); });
+
+    deviceStatus.update(cmPacket);
+    deviceStatus.update(ifPacket);
+    interfacePayload().setMsgTotalTx(1);
+    deviceStatus.update(ifPacket);
+    deviceStatus.removeInterfaceById(interfaceId);
+
+    ASSERT_EQ(deviceChanges.size(), 3u);
+    ASSERT_EQ(deviceChanges[0].type, Type::interfaceAdded);
+    ASSERT_EQ(deviceChanges[1].type, Type::interfaceChanged);
+    ASSERT_EQ(deviceChanges[1].deltas.msgTotalTx, 1u);
+    ASSERT_EQ(deviceChanges[2].type, Type::interfaceRemoved);
+}
@@ -1,8 +1,15 @@
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/analog_stream.h>
 #include <asam_cmp/can_fd_payload.h>
 #include <asam_cmp/can_payload.h>
 #include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
 #include <asam_cmp/interface_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/tecmp_converter.h>
 #include <asam_cmp/tecmp_decoder.h>
+#include <asam_cmp/tecmp_lin_payload.h>
 #include <gtest/gtest.h>
 
 using TECMP::Decoder;
@@ -101,3 +108,389 @@ TEST_F(TecmpDecoderFixture, DecodeCanFdPayload)
     auto data2 = *(reinterpret_cast<const double*>(payload.getData() + sizeof(double)));
     ASSERT_EQ(data2, 321.321);
 }
+
+class TecmpStatefulDecoderFixture : public ::testing::Test
+{
+protected:
+    static constexpr uint16_t eos = 0x0001;
+    static constexpr uint16_t sos = 0x0002;
+
+    static std::vector<uint8_t> createFrame(const uint8_t deviceId,
+                                            const uint16_t sequenceCounter,
+                                            const std::vector<uint8_t>& payload,
+                                            const uint16_t deviceFlags = 0,
+                                            const TECMP::CmpHeader::DataType dataType = TECMP::CmpHeader::DataType::can)
+    {
+        TECMP::CmpHeader header;
+        header.setDeviceId(deviceId);
+        header.setSequenceCounter(sequenceCounter);
+        header.setVersion(3);
+        header.setMessageType(TECMP::CmpHeader::MessageType::data);
+        header.setDataType(dataType);
+        header.setDeviceFlags(deviceFlags);
+        header.setInterfaceId(0x20);
+        header.setTimestamp(1000 + sequenceCounter);
+        header.setPayloadLength(static_cast<uint16_t>(payload.size()));
+
+        std::vector<uint8_t> frame(sizeof(header) + payload.size());
+        memcpy(frame.data(), &header, sizeof(header));
+        memcpy(frame.data() + sizeof(header), payload.data(), payload.size());
+        return frame;
+    }
+
+    static std::vector<uint8_t> createCanPayload(const uint8_t firstByte)
+    {
+        return {0x00, 0x00, 0x01, 0x23, 0x04, firstByte, 0x02, 0x03, 0x04};
+    }
+
+    std::vector<ASAM::CMP::Packet> decode(const std::vector<uint8_t>& frame)
+    {
+        const auto& packets = decoder.decode(frame.data(), frame.size());
+        return {packets.begin(), packets.end()};
+    }
+
+protected:
+    Decoder decoder;
+};
+
+TEST_F(TecmpStatefulDecoderFixture, DecodesLikeStatic)
+{
+    auto frame = createFrame(1, 0, createCanPayload(7));
+    auto expected = Decoder::Decode(frame.data(), frame.size());
+    auto packets = decode(frame);
+
+    ASSERT_EQ(packets.size(), 1u);
+    ASSERT_EQ(expected.size(), 1u);
+    ASSERT_EQ(packets[0], *expected[0]);
+
+    const auto& payload = static_cast<const ASAM::CMP::CanPayload&>(packets[0].getPayload());
+    ASSERT_EQ(payload.getId(), 0x123u);
+    ASSERT_EQ(payload.getData()[0], 7u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, InvalidFrame)
+{
+    std::vector<uint8_t> frame(10);
+    ASSERT_TRUE(decode(frame).empty());
+    ASSERT_EQ(decoder.getStats().frames, 1u);
+    ASSERT_EQ(decoder.getStats().invalidFrames, 1u);
+    ASSERT_EQ(decoder.getDeviceCount(), 0u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, BuffersReused)
+{
+    auto frame = createFrame(1, 0, createCanPayload(7));
+    const auto& first = decoder.decode(frame.data(), frame.size());
+    const auto* firstAddress = &first;
+    frame = createFrame(1, 1, createCanPayload(8));
+    const auto& second = decoder.decode(frame.data(), frame.size());
+    ASSERT_EQ(&second, firstAddress);
+    ASSERT_EQ(second.size(), 1u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, LostFrames)
+{
+    decode(createFrame(1, 10, createCanPayload(0)));
+    decode(createFrame(1, 11, createCanPayload(0)));
+    decode(createFrame(1, 14, createCanPayload(0)));
+    decode(createFrame(2, 500, createCanPayload(0)));
+
+    ASSERT_EQ(decoder.getStats().frames, 4u);
+    ASSERT_EQ(decoder.getStats().lostFrames, 2u);
+    ASSERT_EQ(decoder.getDeviceCount(), 2u);
+
+    auto index = decoder.getIndexByDeviceId(1);
+    ASSERT_EQ(decoder.getDeviceId(index), 1u);
+    ASSERT_EQ(decoder.getDeviceStats(index).frames, 3u);
+    ASSERT_EQ(decoder.getDeviceStats(index).lostFrames, 2u);
+    ASSERT_EQ(decoder.getDeviceStats(decoder.getIndexByDeviceId(2)).lostFrames, 0u);
+    ASSERT_EQ(decoder.getIndexByDeviceId(3), decoder.getDeviceCount());
+}
+
+TEST_F(TecmpStatefulDecoderFixture, SequenceCounterWrapAround)
+{
+    decode(createFrame(1, 0xFFFE, createCanPayload(0)));
+    decode(createFrame(1, 0xFFFF, createCanPayload(0)));
+    decode(createFrame(1, 0x0000, createCanPayload(0)));
+    decode(createFrame(1, 0x0002, createCanPayload(0)));
+
+    ASSERT_EQ(decoder.getStats().lostFrames, 1u);
+    ASSERT_EQ(decoder.getStats().sequenceErrors, 0u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, RepeatedFrame)
+{
+    decode(createFrame(1, 5, createCanPayload(0)));
+    decode(createFrame(1, 6, createCanPayload(0)));
+    decode(createFrame(1, 6, createCanPayload(0)));
+    decode(createFrame(1, 7, createCanPayload(0)));
+
+    ASSERT_EQ(decoder.getStats().sequenceErrors, 1u);
+    ASSERT_EQ(decoder.getStats().lostFrames, 0u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, SequenceCounterReset)
+{
+    for (uint16_t counter = 1000; counter < 1003; ++counter)
+        decode(createFrame(1, counter, createCanPayload(0)));
+    // The capture module restarts, the counter is adopted after a few consecutive frames
+    for (uint16_t counter = 0; counter < 5; ++counter)
+        ASSERT_EQ(decode(createFrame(1, counter, createCanPayload(0))).size(), 1u);
+    decode(createFrame(1, 7, createCanPayload(0)));
+
+    ASSERT_EQ(decoder.getStats().sequenceErrors, 3u);
+    ASSERT_EQ(decoder.getStats().sequenceResyncs, 1u);
+    // Loss is tracked again after the resync
+    ASSERT_EQ(decoder.getStats().lostFrames, 2u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, ReorderedFramesKeepCounter)
+{
+    decode(createFrame(1, 100, createCanPayload(0)));
+    decode(createFrame(1, 102, createCanPayload(0)));
+    decode(createFrame(1, 101, createCanPayload(0)));
+    decode(createFrame(1, 103, createCanPayload(0)));
+
+    ASSERT_EQ(decoder.getStats().lostFrames, 1u);
+    ASSERT_EQ(decoder.getStats().sequenceErrors, 1u);
+    ASSERT_EQ(decoder.getStats().sequenceResyncs, 0u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, Reassembly)
+{
+    auto payload = createCanPayload(9);
+    std::vector<uint8_t> first(payload.begin(), payload.begin() + 3);
+    std::vector<uint8_t> middle(payload.begin() + 3, payload.begin() + 6);
+    std::vector<uint8_t> last(payload.begin() + 6, payload.end());
+
+    ASSERT_TRUE(decode(createFrame(1, 0, first, sos)).empty());
+    ASSERT_TRUE(decode(createFrame(1, 1, middle)).empty());
+    auto packets = decode(createFrame(1, 2, last, eos));
+
+    ASSERT_EQ(packets.size(), 1u);
+    ASSERT_EQ(packets[0].getTimestamp(), 1000u);
+    const auto& canPayload = static_cast<const ASAM::CMP::CanPayload&>(packets[0].getPayload());
+    ASSERT_EQ(canPayload.getId(), 0x123u);
+    ASSERT_EQ(canPayload.getData()[0], 9u);
+
+    ASSERT_EQ(decoder.getStats().segments, 3u);
+    ASSERT_EQ(decoder.getStats().reassembledFrames, 1u);
+    ASSERT_EQ(decoder.getStats().reassemblyErrors, 0u);
+
+    // Unsegmented frames are decoded again after the last segment
+    ASSERT_EQ(decode(createFrame(1, 3, createCanPayload(1))).size(), 1u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, LostSegment)
+{
+    auto payload = createCanPayload(9);
+    std::vector<uint8_t> first(payload.begin(), payload.begin() + 3);
+    std::vector<uint8_t> middle(payload.begin() + 3, payload.begin() + 6);
+    std::vector<uint8_t> last(payload.begin() + 6, payload.end());
+
+    decode(createFrame(1, 0, first, sos));
+    ASSERT_TRUE(decode(createFrame(1, 2, last, eos)).empty());
+    ASSERT_EQ(decoder.getStats().lostFrames, 1u);
+    ASSERT_EQ(decoder.getStats().reassemblyErrors, 1u);
+    ASSERT_EQ(decoder.getStats().reassembledFrames, 0u);
+
+    ASSERT_EQ(decode(createFrame(1, 3, createCanPayload(1))).size(), 1u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, SegmentWithoutStart)
+{
+    auto payload = createCanPayload(9);
+    std::vector<uint8_t> last(payload.begin() + 6, payload.end());
+
+    ASSERT_TRUE(decode(createFrame(1, 0, last, eos)).empty());
+    ASSERT_EQ(decoder.getStats().reassemblyErrors, 1u);
+    ASSERT_EQ(decode(createFrame(1, 1, createCanPayload(1))).size(), 1u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, Reset)
+{
+    decode(createFrame(1, 0, createCanPayload(0)));
+    decoder.reset();
+    ASSERT_EQ(decoder.getStats().frames, 0u);
+    ASSERT_EQ(decoder.getDeviceCount(), 0u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, MultipleEntries)
+{
+    auto frame = createFrame(1, 0, createCanPayload(1));
+    // Second entry: interfaceId, timestamp, length, data flags and a CAN payload
+    const std::vector<uint8_t> secondEntry = {0x00, 0x00, 0x00, 0x21, 0, 0, 0, 0, 0, 0, 0x07, 0xD0, 0x00, 0x09, 0x00, 0x00,
+                                              0x00, 0x00, 0x04, 0x56, 0x04, 0x02, 0x02, 0x03, 0x04};
+    frame.insert(frame.end(), secondEntry.begin(), secondEntry.end());
+
+    auto packets = decode(frame);
+    ASSERT_EQ(packets.size(), 2u);
+    ASSERT_EQ(packets[1].getInterfaceId(), 0x21u);
+    ASSERT_EQ(packets[1].getTimestamp(), 2000u);
+    const auto& canPayload = static_cast<const ASAM::CMP::CanPayload&>(packets[1].getPayload());
+    ASSERT_EQ(canPayload.getId(), 0x456u);
+    ASSERT_EQ(canPayload.getData()[0], 2u);
+
+    ASSERT_EQ(Decoder::Decode(frame.data(), frame.size()).size(), 2u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, TruncatedEntryIsSkipped)
+{
+    auto payload = createCanPayload(1);
+    payload.resize(6);
+    payload[4] = 8;
+    ASSERT_TRUE(decode(createFrame(1, 0, payload)).empty());
+}
+
+TEST_F(TecmpStatefulDecoderFixture, LinEntryMatchesPayloadConversion)
+{
+    std::vector<uint8_t> linData = {0x21, 0x02, 0xAA, 0xBB, 0x5C};
+    auto frame = createFrame(1, 0, linData);
+    TECMP::CmpHeader header;
+    memcpy(&header, frame.data(), sizeof(header));
+    header.setDataType(TECMP::CmpHeader::DataType::lin);
+    memcpy(frame.data(), &header, sizeof(header));
+
+    auto legacy = TECMP::Converter::ConvertPacket(header, std::make_shared<TECMP::LinPayload>(linData.data(), linData.size()));
+    ASSERT_TRUE(legacy);
+
+    auto packets = decode(frame);
+    ASSERT_EQ(packets.size(), 1u);
+    ASSERT_EQ(packets[0], *legacy);
+    const auto& linPayload = static_cast<const ASAM::CMP::LinPayload&>(packets[0].getPayload());
+    ASSERT_EQ(linPayload.getLinId(), 0x21u);
+    ASSERT_EQ(linPayload.getChecksum(), 0x5Cu);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, EthernetEntry)
+{
+    std::vector<uint8_t> ethernetFrame(1500);
+    for (size_t i = 0; i < ethernetFrame.size(); ++i)
+        ethernetFrame[i] = static_cast<uint8_t>(i);
+
+    auto packets = decode(createFrame(1, 0, ethernetFrame, 0, TECMP::CmpHeader::DataType::ethernet));
+    ASSERT_EQ(packets.size(), 1u);
+    ASSERT_EQ(packets[0].getPayload().getType(), ASAM::CMP::PayloadType::ethernet);
+    const auto& ethernetPayload = static_cast<const ASAM::CMP::EthernetPayload&>(packets[0].getPayload());
+    ASSERT_EQ(ethernetPayload.getDataLength(), ethernetFrame.size());
+    ASSERT_TRUE(std::equal(ethernetFrame.begin(), ethernetFrame.end(), ethernetPayload.getData()));
+    ASSERT_FALSE(ethernetPayload.getFlag(ASAM::CMP::EthernetPayload::Flags::fcsErr));
+}
+
+TEST_F(TecmpStatefulDecoderFixture, EthernetEntryCrcError)
+{
+    std::vector<uint8_t> ethernetFrame(64, 0xAA);
+    auto frame = createFrame(1, 0, ethernetFrame, 0, TECMP::CmpHeader::DataType::ethernet);
+    // Data flags of the entry, CRC error
+    frame[sizeof(TECMP::CmpHeader) - 2] = 0x20;
+
+    auto packets = decode(frame);
+    ASSERT_EQ(packets.size(), 1u);
+    const auto& ethernetPayload = static_cast<const ASAM::CMP::EthernetPayload&>(packets[0].getPayload());
+    ASSERT_TRUE(ethernetPayload.getFlag(ASAM::CMP::EthernetPayload::Flags::fcsErr));
+}
+
+TEST_F(TecmpStatefulDecoderFixture, AnalogEntry)
+{
+    const std::vector<uint8_t> samples = {0x00, 0x01, 0xFF, 0xFE, 0x12, 0x34};
+
+    auto packets = decode(createFrame(1, 0, samples, 0, TECMP::CmpHeader::DataType::analog));
+    ASSERT_EQ(packets.size(), 1u);
+    const auto& analogPayload = static_cast<const ASAM::CMP::AnalogPayload&>(packets[0].getPayload());
+    ASSERT_EQ(analogPayload.getSampleDt(), ASAM::CMP::AnalogPayload::SampleDt::aInt16);
+    ASSERT_EQ(analogPayload.getSamplesCount(), 3u);
+    ASSERT_EQ(analogPayload.getSampleScalar(), 1.f);
+
+    std::vector<float> values(3);
+    analogPayload.toFloat(values.data());
+    ASSERT_EQ(values[0], 1.f);
+    ASSERT_EQ(values[1], -2.f);
+    ASSERT_EQ(values[2], 4660.f);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, FlexRayEntry)
+{
+    // cycle, frameId, dataLength, data, headerCrc, frameCrc
+    const std::vector<uint8_t> flexRayData = {0x05, 0x00, 0x2A, 0x04, 0x01, 0x02, 0x03, 0x04, 0x01, 0x23, 0xAB, 0xCD, 0xEF};
+    auto frame = createFrame(1, 0, flexRayData, 0, TECMP::CmpHeader::DataType::flexRay);
+    // Data flags of the entry, sync and startup frame
+    frame[sizeof(TECMP::CmpHeader) - 1] = 0x06;
+
+    auto packets = decode(frame);
+    ASSERT_EQ(packets.size(), 1u);
+    ASSERT_EQ(packets[0].getPayload().getType(), ASAM::CMP::PayloadType::flexRay);
+    const auto& flexRayPayload = static_cast<const ASAM::CMP::FlexRayPayload&>(packets[0].getPayload());
+    ASSERT_EQ(flexRayPayload.getCycle(), 5u);
+    ASSERT_EQ(flexRayPayload.getFrameId(), 0x2Au);
+    ASSERT_EQ(flexRayPayload.getPayloadLength(), 4u);
+    ASSERT_EQ(flexRayPayload.getData()[3], 0x04u);
+    ASSERT_EQ(flexRayPayload.getHeaderCrc(), 0x0123u);
+    ASSERT_EQ(flexRayPayload.getFrameCrc(), 0xABCDEFu);
+    ASSERT_TRUE(flexRayPayload.getFlag(ASAM::CMP::FlexRayPayload::Flags::syncFrame));
+    ASSERT_TRUE(flexRayPayload.getFlag(ASAM::CMP::FlexRayPayload::Flags::startupFrame));
+    ASSERT_FALSE(flexRayPayload.getFlag(ASAM::CMP::FlexRayPayload::Flags::nullFrame));
+
+    auto legacyPayload = std::make_shared<TECMP::Payload>(TECMP::PayloadType::flexRay, flexRayData.data(), flexRayData.size());
+    TECMP::CmpHeader header;
+    memcpy(&header, frame.data(), sizeof(header));
+    auto legacy = TECMP::Converter::ConvertPacket(header, legacyPayload);
+    ASSERT_TRUE(legacy);
+    ASSERT_EQ(static_cast<const ASAM::CMP::FlexRayPayload&>(legacy->getPayload()).getFrameId(), 0x2Au);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, TruncatedFlexRayEntryIsSkipped)
+{
+    const std::vector<uint8_t> flexRayData = {0x05, 0x00, 0x2A, 0x08, 0x01, 0x02};
+    ASSERT_TRUE(decode(createFrame(1, 0, flexRayData, 0, TECMP::CmpHeader::DataType::flexRay)).empty());
+}
+
+TEST_F(TecmpStatefulDecoderFixture, InvalidCanFdDataLengthIsSkipped)
+{
+    // CAN FD cannot encode 13 data bytes
+    std::vector<uint8_t> payload = {0x00, 0x00, 0x01, 0x23, 13};
+    payload.resize(payload.size() + 13, 0xAA);
+    auto frame = createFrame(1, 0, payload, 0, TECMP::CmpHeader::DataType::canFd);
+    ASSERT_TRUE(decode(frame).empty());
+
+    std::vector<ASAM::CMP::Packet> packets;
+    ASSERT_EQ(TECMP::Converter::ConvertFrame(frame.data(), frame.size(), packets), 0u);
+    ASSERT_TRUE(packets.empty());
+
+    // The next valid entry is converted
+    payload = {0x00, 0x00, 0x01, 0x23, 12};
+    payload.resize(payload.size() + 12, 0xAA);
+    ASSERT_EQ(decode(createFrame(1, 1, payload, 0, TECMP::CmpHeader::DataType::canFd)).size(), 1u);
+}
+
+TEST_F(TecmpStatefulDecoderFixture, AnalogEntriesFormContinuousStream)
+{
+    TECMP::Converter::Options options;
+    options.analogSampleInterval = 0.001f;
+    options.analogUnit = ASAM::CMP::AnalogPayload::Unit::volt;
+    Decoder analogDecoder(options);
+    ASAM::CMP::AnalogStream stream(1, 0x20);
+
+    // Three samples per entry, every entry starts 3 ms after the previous one
+    const std::vector<uint8_t> samples = {0x00, 0x01, 0x00, 0x02, 0x00, 0x03};
+    for (uint16_t index = 0; index < 3; ++index)
+    {
+        auto frame = createFrame(1, index, samples, 0, TECMP::CmpHeader::DataType::analog);
+        TECMP::CmpHeader header;
+        memcpy(&header, frame.data(), sizeof(header));
+        header.setTimestamp(1000000 + index * 3000000ull);
+        memcpy(frame.data(), &header, sizeof(header));
+
+        const auto& packets = analogDecoder.decode(frame.data(), frame.size());
+        ASSERT_EQ(packets.size(), 1u);
+        ASSERT_TRUE(stream.addPacket(packets[0]));
+    }
+
+    ASSERT_EQ(stream.getStats().packets, 3u);
+    ASSERT_EQ(stream.getStats().gaps, 0u);
+    ASSERT_EQ(stream.getBlocksCount(), 1u);
+    const auto& block = stream.getBlock(0);
+    ASSERT_EQ(block.getSize(), 9u);
+    ASSERT_EQ(block.getUnit(), ASAM::CMP::AnalogPayload::Unit::volt);
+    ASSERT_EQ(block.getTimestamp(), 1000000u);
+    ASSERT_EQ(block.getData()[8], 3.f);
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include <asam_cmp/analog_payload.h>
+#include <asam_cmp/can_fd_payload.h>
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/capture_module_payload.h>
+#include <asam_cmp/ethernet_payload.h>
+#include <asam_cmp/flexray_payload.h>
+#include <asam_cmp/interface_payload.h>
+#include <asam_cmp/lin_payload.h>
+#include <asam_cmp/tecmp_decoder.h>
+#include <asam_cmp/tecmp_encoder.h>
+
+using ASAM::CMP::DataContext;
+using ASAM::CMP::Packet;
+using ASAM::CMP::PayloadType;
+
+class TecmpEncoderFixture : public ::testing::Test
+{
+public:
+    TecmpEncoderFixture()
+    {
+        encoder.setDeviceId(deviceId);
+    }
+
+protected:
+    Packet createPacket(const uint32_t interfaceId, const uint64_t timestamp)
+    {
+        Packet packet;
+        packet.setDeviceId(deviceId);
+        packet.setInterfaceId(interfaceId);
+        packet.setTimestamp(timestamp);
+        return packet;
+    }
+
+    Packet createCanPacket(const uint32_t id, const uint8_t firstByte)
+    {
+        std::vector<uint8_t> data(8);
+        std::iota(data.begin(), data.end(), firstByte);
+
+        ASAM::CMP::CanPayload canPayload;
+        canPayload.setId(id);
+        canPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+        canPayload.setCrc(0x1234);
+
+        auto packet = createPacket(0x20, 1000 + id);
+        packet.setPayload(canPayload);
+        return packet;
+    }
+
+    Packet createEthernetPacket(const uint16_t size)
+    {
+        std::vector<uint8_t> data(size);
+        std::iota(data.begin(), data.end(), uint8_t{});
+
+        ASAM::CMP::EthernetPayload ethernetPayload;
+        ethernetPayload.setData(data.data(), size);
+
+        auto packet = createPacket(0x40, 5000);
+        packet.setPayload(ethernetPayload);
+        return packet;
+    }
+
+    std::vector<Packet> decode(const std::vector<std::vector<uint8_t>>& frames)
+    {
+        std::vector<Packet> packets;
+        for (const auto& frame : frames)
+        {
+            const auto& decoded = decoder.decode(frame.data(), frame.size());
+            packets.insert(packets.end(), decoded.begin(), decoded.end());
+        }
+        return packets;
+    }
+
+protected:
+    static constexpr uint8_t deviceId = 7;
+
+    TECMP::Encoder encoder;
+    TECMP::Decoder decoder;
+    DataContext dataContext;
+};
+
+TEST_F(TecmpEncoderFixture, CanRoundTrip)
+{
+    std::vector<Packet> packets = {createCanPacket(1, 10), createCanPacket(2, 20), createCanPacket(3, 30)};
+
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+    ASSERT_EQ(frames.size(), 1u);
+    ASSERT_EQ(frames[0].size(), TECMP::EntryReader::frameHeaderSize + 3 * (TECMP::EntryReader::entryHeaderSize + 16));
+
+    auto decoded = decode(frames);
+    ASSERT_EQ(decoded, packets);
+    ASSERT_EQ(decoder.getStats().lostFrames, 0u);
+}
+
+TEST_F(TecmpEncoderFixture, CanFdRoundTrip)
+{
+    std::vector<uint8_t> data(64);
+    std::iota(data.begin(), data.end(), uint8_t{});
+    ASAM::CMP::CanFdPayload canFdPayload;
+    canFdPayload.setId(0x321);
+    canFdPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+    canFdPayload.setCrc(0x0ABCDE);
+    auto packet = createPacket(0x21, 100);
+    packet.setPayload(canFdPayload);
+
+    auto decoded = decode(encoder.encode(packet, dataContext));
+    ASSERT_EQ(decoded.size(), 1u);
+    ASSERT_EQ(decoded[0], packet);
+}
+
+TEST_F(TecmpEncoderFixture, LinAndFlexRayRoundTrip)
+{
+    const std::vector<uint8_t> data = {1, 2, 3, 4};
+
+    ASAM::CMP::LinPayload linPayload;
+    linPayload.setLinId(0x21);
+    linPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+    linPayload.setChecksum(0x5C);
+    auto linPacket = createPacket(0x30, 200);
+    linPacket.setPayload(linPayload);
+
+    ASAM::CMP::FlexRayPayload flexRayPayload;
+    flexRayPayload.setFrameId(0x2A);
+    flexRayPayload.setCycle(5);
+    flexRayPayload.setData(data.data(), static_cast<uint8_t>(data.size()));
+    flexRayPayload.setHeaderCrc(0x123);
+    flexRayPayload.setFrameCrc(0xABCDEF);
+    flexRayPayload.setFlag(ASAM::CMP::FlexRayPayload::Flags::syncFrame, true);
+    auto flexRayPacket = createPacket(0x31, 300);
+    flexRayPacket.setPayload(flexRayPayload);
+
+    std::vector<Packet> packets = {linPacket, flexRayPacket};
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+    // Different data types are not mixed in one frame
+    ASSERT_EQ(frames.size(), 2u);
+
+    auto decoded = decode(frames);
+    ASSERT_EQ(decoded.size(), 2u);
+    const auto& decodedLin = static_cast<const ASAM::CMP::LinPayload&>(decoded[0].getPayload());
+    ASSERT_EQ(decodedLin.getLinId(), 0x21u);
+    ASSERT_EQ(decodedLin.getChecksum(), 0x5Cu);
+    ASSERT_TRUE(std::equal(data.begin(), data.end(), decodedLin.getData()));
+    ASSERT_EQ(decoded[1], flexRayPacket);
+}
+
+TEST_F(TecmpEncoderFixture, AnalogRoundTrip)
+{
+    const std::vector<int16_t> samples = {1, -2, 4660};
+    ASAM::CMP::AnalogPayload analogPayload;
+    analogPayload.setSamples(samples.data(), samples.size());
+    analogPayload.setSampleScalar(1.f);
+    auto packet = createPacket(0x50, 400);
+    packet.setPayload(analogPayload);
+
+    auto decoded = decode(encoder.encode(packet, dataContext));
+    ASSERT_EQ(decoded.size(), 1u);
+    ASSERT_EQ(decoded[0], packet);
+}
+
+TEST_F(TecmpEncoderFixture, EthernetRoundTrip)
+{
+    auto packet = createEthernetPacket(1400);
+    dataContext.maxBytesPerMessage = 1500;
+
+    auto frames = encoder.encode(packet, dataContext);
+    ASSERT_EQ(frames.size(), 1u);
+    auto decoded = decode(frames);
+    ASSERT_EQ(decoded.size(), 1u);
+    ASSERT_EQ(decoded[0], packet);
+}
+
+TEST_F(TecmpEncoderFixture, Segmentation)
+{
+    auto packet = createEthernetPacket(1400);
+    dataContext.maxBytesPerMessage = 528;
+
+    auto frames = encoder.encode(packet, dataContext);
+    ASSERT_EQ(frames.size(), 3u);
+
+    TECMP::CmpHeader header;
+    memcpy(&header, frames[0].data(), sizeof(header));
+    ASSERT_TRUE(header.isStartOfSegment());
+    ASSERT_FALSE(header.isEndOfSegment());
+    memcpy(&header, frames[2].data(), sizeof(header));
+    ASSERT_TRUE(header.isEndOfSegment());
+
+    auto decoded = decode(frames);
+    ASSERT_EQ(decoded.size(), 1u);
+    ASSERT_EQ(decoded[0], packet);
+    ASSERT_EQ(decoder.getStats().reassembledFrames, 1u);
+}
+
+TEST_F(TecmpEncoderFixture, SegmentedPacketGetsOwnFrames)
+{
+    std::vector<Packet> packets = {createCanPacket(1, 0), createEthernetPacket(1400), createCanPacket(2, 0)};
+    dataContext.maxBytesPerMessage = 528;
+
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+    ASSERT_EQ(frames.size(), 5u);
+    ASSERT_EQ(decode(frames), packets);
+}
+
+TEST_F(TecmpEncoderFixture, FramesAreFilled)
+{
+    std::vector<Packet> packets;
+    for (uint32_t i = 0; i < 10; ++i)
+        packets.push_back(createCanPacket(i, 0));
+    // Frame header and 4 CAN entries of 32 bytes
+    dataContext.maxBytesPerMessage = 12 + 4 * 32;
+
+    auto frames = encoder.encode(packets.begin(), packets.end(), dataContext);
+    ASSERT_EQ(frames.size(), 3u);
+    ASSERT_EQ(frames[0].size(), dataContext.maxBytesPerMessage);
+    ASSERT_EQ(frames[2].size(), 12u + 2 * 32);
+    ASSERT_EQ(decode(frames), packets);
+}
+
+TEST_F(TecmpEncoderFixture, StatusRoundTrip)
+{
+    ASAM::CMP::CaptureModulePayload cmPayload;
+    cmPayload.setData("", "12345", "v1.2", "v3.4.5", {});
+    auto cmPacket = createPacket(0, 600);
+    cmPacket.setPayload(cmPayload);
+
+    ASAM::CMP::InterfacePayload interfacePayload;
+    interfacePayload.setInterfaceId(0x20);
+    interfacePayload.setMsgTotalRx(100);
+    interfacePayload.setErrorsTotalRx(3);
+    auto interfacePacket = createPacket(0x20, 700);
+    interfacePacket.setPayload(interfacePayload);
+
+    std::vector<Packet> packets = {cmPacket, interfacePacket};
+    auto decoded = decode(encoder.encode(packets.begin(), packets.end(), dataContext));
+    ASSERT_EQ(decoded.size(), 2u);
+
+    ASSERT_EQ(decoded[0].getPayload().getType(), PayloadType::cmStatMsg);
+    const auto& decodedCm = static_cast<const ASAM::CMP::CaptureModulePayload&>(decoded[0].getPayload());
+    ASSERT_EQ(decodedCm.getSerialNumber(), "12345");
+    ASSERT_EQ(decodedCm.getHardwareVersion(), "v1.2");
+    ASSERT_EQ(decodedCm.getSoftwareVersion(), "v3.4.5");
+
+    ASSERT_EQ(decoded[1].getPayload().getType(), PayloadType::ifStatMsg);
+    const auto& decodedInterface = static_cast<const ASAM::CMP::InterfacePayload&>(decoded[1].getPayload());
+    ASSERT_EQ(decodedInterface.getInterfaceId(), 0x20u);
+    ASSERT_EQ(decodedInterface.getMsgTotalRx(), 100u);
+    ASSERT_EQ(decodedInterface.getErrorsTotalRx(), 3u);
+}
+
+TEST_F(TecmpEncoderFixture, SequenceCounter)
+{
+    auto packet = createCanPacket(1, 0);
+    encoder.encode(packet, dataContext);
+    encoder.encode(packet, dataContext);
+    ASSERT_EQ(encoder.getSequenceCounter(), 2u);
+
+    auto frames = encoder.encode(packet, dataContext);
+    TECMP::CmpHeader header;
+    memcpy(&header, frames[0].data(), sizeof(header));
+    ASSERT_EQ(header.getSequenceCounter(), 2u);
+    ASSERT_EQ(header.getDeviceId(), deviceId);
+
+    encoder.restart();
+    ASSERT_EQ(encoder.getSequenceCounter(), 0u);
+}
+
+TEST_F(TecmpEncoderFixture, PtrIterators)
+{
+    std::vector<std::shared_ptr<Packet>> packets = {std::make_shared<Packet>(createCanPacket(1, 0)),
+                                                    std::make_shared<Packet>(createCanPacket(2, 0))};
+    auto decoded = decode(encoder.encode(packets.begin(), packets.end(), dataContext));
+    ASSERT_EQ(decoded.size(), 2u);
+    ASSERT_EQ(decoded[1], *packets[1]);
+}
+
+TEST_F(TecmpEncoderFixture, UnsupportedPayloadIsSkipped)
+{
+    const std::vector<uint8_t> data = {1, 2, 3};
+    auto packet = createPacket(0, 0);
+    packet.setPayload(ASAM::CMP::Payload(PayloadType::digital, data.data(), data.size()));
+    ASSERT_TRUE(encoder.encode(packet, dataContext).empty());
+}
+
+TEST_F(TecmpEncoderFixture, TooSmallMessage)
+{
+    dataContext.maxBytesPerMessage = sizeof(TECMP::CmpHeader);
+    ASSERT_THROW(encoder.encode(createCanPacket(1, 0), dataContext), std::invalid_argument);
+}
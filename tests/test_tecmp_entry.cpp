@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include <asam_cmp/tecmp_entry.h>
+
+using TECMP::CmpHeader;
+using TECMP::EntryReader;
+using TECMP::EntryView;
+
+class TecmpEntryFixture : public ::testing::Test
+{
+protected:
+    struct Entry
+    {
+        uint32_t interfaceId;
+        uint64_t timestamp;
+        std::vector<uint8_t> data;
+    };
+
+    static void appendBigEndian(std::vector<uint8_t>& frame, const uint64_t value, const size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            frame.push_back(static_cast<uint8_t>(value >> (8 * (size - 1 - i))));
+    }
+
+    static std::vector<uint8_t> createFrame(const std::vector<Entry>& entries)
+    {
+        CmpHeader header;
+        header.setDeviceId(7);
+        header.setSequenceCounter(99);
+        header.setMessageType(CmpHeader::MessageType::data);
+        header.setDataType(CmpHeader::DataType::can);
+        header.setDeviceFlags(0x0008);
+
+        std::vector<uint8_t> frame(EntryReader::frameHeaderSize);
+        memcpy(frame.data(), &header, EntryReader::frameHeaderSize);
+        for (const auto& entry : entries)
+        {
+            appendBigEndian(frame, entry.interfaceId, 4);
+            appendBigEndian(frame, entry.timestamp, 8);
+            appendBigEndian(frame, entry.data.size(), 2);
+            appendBigEndian(frame, 0x1234, 2);
+            frame.insert(frame.end(), entry.data.begin(), entry.data.end());
+        }
+        return frame;
+    }
+};
+
+TEST_F(TecmpEntryFixture, TooShort)
+{
+    std::vector<uint8_t> frame(10);
+    EntryReader reader(frame.data(), frame.size());
+    EntryView entry;
+    ASSERT_FALSE(reader.isValid());
+    ASSERT_FALSE(reader.next(entry));
+}
+
+TEST_F(TecmpEntryFixture, SingleEntry)
+{
+    auto frame = createFrame({{0x20, 1000, {1, 2, 3}}});
+    EntryReader reader(frame.data(), frame.size());
+    ASSERT_TRUE(reader.isValid());
+    ASSERT_TRUE(reader.getHeader().isMultiFrame());
+
+    EntryView entry;
+    ASSERT_TRUE(reader.next(entry));
+    ASSERT_EQ(entry.deviceId, 7u);
+    ASSERT_EQ(entry.sequenceCounter, 99u);
+    ASSERT_EQ(entry.messageType, CmpHeader::MessageType::data);
+    ASSERT_EQ(entry.dataType, CmpHeader::DataType::can);
+    ASSERT_EQ(entry.deviceFlags, 0x0008u);
+    ASSERT_EQ(entry.interfaceId, 0x20u);
+    ASSERT_EQ(entry.timestamp, 1000u);
+    ASSERT_EQ(entry.dataFlags, 0x1234u);
+    ASSERT_EQ(entry.length, 3u);
+    ASSERT_EQ(entry.data, frame.data() + EntryReader::frameHeaderSize + EntryReader::entryHeaderSize);
+
+    ASSERT_FALSE(reader.next(entry));
+    ASSERT_FALSE(reader.isTruncated());
+}
+
+TEST_F(TecmpEntryFixture, MultipleEntries)
+{
+    auto frame = createFrame({{1, 10, {1}}, {2, 20, {}}, {3, 30, {3, 3, 3}}});
+    EntryReader reader(frame.data(), frame.size());
+
+    std::vector<EntryView> entries;
+    EntryView entry;
+    while (reader.next(entry))
+        entries.push_back(entry);
+
+    ASSERT_EQ(entries.size(), 3u);
+    for (uint32_t i = 0; i < entries.size(); ++i)
+    {
+        ASSERT_EQ(entries[i].interfaceId, i + 1);
+        ASSERT_EQ(entries[i].timestamp, 10u * (i + 1));
+    }
+    ASSERT_EQ(entries[1].length, 0u);
+    ASSERT_EQ(entries[2].length, 3u);
+    ASSERT_EQ(entries[2].data[2], 3u);
+}
+
+TEST_F(TecmpEntryFixture, TruncatedEntry)
+{
+    auto frame = createFrame({{1, 10, {1, 2}}, {2, 20, {1, 2, 3, 4}}});
+    frame.resize(frame.size() - 1);
+    EntryReader reader(frame.data(), frame.size());
+
+    EntryView entry;
+    ASSERT_TRUE(reader.next(entry));
+    ASSERT_FALSE(reader.next(entry));
+    ASSERT_TRUE(reader.isTruncated());
+}
@@ -72,4 +72,22 @@ TEST_F(TecmpHeaderFixture, DataType)
 TEST_F(TecmpHeaderFixture, DeviceFlags)
 {
     ASSERT_TRUE(TestSetterGetter(&CmpHeader::setDeviceFlags, &CmpHeader::getDeviceFlags, uint16_t{55}));
+}
+
+TEST_F(TecmpHeaderFixture, DeviceFlagBits)
+{
+    CmpHeader header;
+    ASSERT_FALSE(header.isEndOfSegment() || header.isStartOfSegment() || header.isSpy() || header.isMultiFrame() || header.isDeviceOverflow());
+
+    header.setDeviceFlags(0x0001);
+    ASSERT_TRUE(header.isEndOfSegment());
+    header.setDeviceFlags(0x0002);
+    ASSERT_TRUE(header.isStartOfSegment());
+    ASSERT_FALSE(header.isEndOfSegment());
+    header.setDeviceFlags(0x0004);
+    ASSERT_TRUE(header.isSpy());
+    header.setDeviceFlags(0x0008);
+    ASSERT_TRUE(header.isMultiFrame());
+    header.setDeviceFlags(0x8000);
+    ASSERT_TRUE(header.isDeviceOverflow());
 }
\ No newline at end of file
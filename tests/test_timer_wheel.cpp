@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <asam_cmp/timer_wheel.h>
+
+using ASAM::CMP::TimerWheel;
+
+TEST(TimerWheelTest, Empty)
+{
+    TimerWheel wheel(10, 8);
+    ASSERT_EQ(wheel.size(), 0u);
+    ASSERT_EQ(wheel.getGranularity(), 10u);
+    ASSERT_EQ(wheel.getSlotCount(), 8u);
+
+    bool called = false;
+    wheel.advance(1000,
+                  [&called](const TimerWheel::Timer&)
+                  {
+                      called = true;
+                      return TimerWheel::done;
+                  });
+    ASSERT_FALSE(called);
+}
+
+TEST(TimerWheelTest, SlotCountRoundedUp)
+{
+    TimerWheel wheel(1, 100);
+    ASSERT_EQ(wheel.getSlotCount(), 128u);
+}
+
+TEST(TimerWheelTest, FiresWhenDue)
+{
+    TimerWheel wheel(10, 8);
+    wheel.schedule(1, 11, 25);
+    wheel.schedule(2, 12, 45);
+    ASSERT_EQ(wheel.size(), 2u);
+
+    std::vector<uint64_t> fired;
+    auto handler = [&fired](const TimerWheel::Timer& timer)
+    {
+        fired.push_back(timer.key);
+        return TimerWheel::done;
+    };
+
+    wheel.advance(24, handler);
+    ASSERT_TRUE(fired.empty());
+
+    wheel.advance(25, handler);
+    ASSERT_EQ(fired, std::vector<uint64_t>({1}));
+    ASSERT_EQ(wheel.size(), 1u);
+
+    wheel.advance(100, handler);
+    ASSERT_EQ(fired, std::vector<uint64_t>({1, 2}));
+    ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, ExpiryBeyondOneRotation)
+{
+    TimerWheel wheel(10, 4);
+    wheel.schedule(1, 1, 105);
+
+    size_t calls = 0;
+    auto handler = [&calls](const TimerWheel::Timer&)
+    {
+        ++calls;
+        return TimerWheel::done;
+    };
+
+    for (uint64_t now = 0; now < 105; now += 5)
+        wheel.advance(now, handler);
+    ASSERT_EQ(calls, 0u);
+    ASSERT_EQ(wheel.size(), 1u);
+
+    wheel.advance(105, handler);
+    ASSERT_EQ(calls, 1u);
+}
+
+TEST(TimerWheelTest, LargeJumpVisitsAllSlots)
+{
+    TimerWheel wheel(1, 8);
+    for (uint64_t key = 0; key < 20; ++key)
+        wheel.schedule(key, key, key);
+
+    size_t calls = 0;
+    wheel.advance(1000,
+                  [&calls](const TimerWheel::Timer&)
+                  {
+                      ++calls;
+                      return TimerWheel::done;
+                  });
+    ASSERT_EQ(calls, 20u);
+    ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, Reschedule)
+{
+    TimerWheel wheel(10, 8);
+    wheel.schedule(7, 3, 20);
+
+    std::vector<uint64_t> expiries;
+    auto handler = [&expiries](const TimerWheel::Timer& timer)
+    {
+        expiries.push_back(timer.expiry);
+        return timer.expiry < 60 ? timer.expiry + 20 : TimerWheel::done;
+    };
+
+    for (uint64_t now = 0; now <= 100; ++now)
+        wheel.advance(now, handler);
+    ASSERT_EQ(expiries, std::vector<uint64_t>({20, 40, 60}));
+    ASSERT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, TimerKeepsKeyAndTicket)
+{
+    TimerWheel wheel;
+    wheel.schedule(42, 99, 5);
+
+    TimerWheel::Timer fired;
+    wheel.advance(5,
+                  [&fired](const TimerWheel::Timer& timer)
+                  {
+                      fired = timer;
+                      return TimerWheel::done;
+                  });
+    ASSERT_EQ(fired.key, 42u);
+    ASSERT_EQ(fired.ticket, 99u);
+    ASSERT_EQ(fired.expiry, 5u);
+}
+
+TEST(TimerWheelTest, PastExpiryFiresOnNextAdvance)
+{
+    TimerWheel wheel(10, 8);
+    wheel.advance(500, [](const TimerWheel::Timer&) { return TimerWheel::done; });
+    wheel.schedule(1, 1, 100);
+
+    size_t calls = 0;
+    wheel.advance(500,
+                  [&calls](const TimerWheel::Timer&)
+                  {
+                      ++calls;
+                      return TimerWheel::done;
+                  });
+    ASSERT_EQ(calls, 1u);
+}
+
+TEST(TimerWheelTest, TimeBackwardsIgnored)
+{
+    TimerWheel wheel(10, 8);
+    wheel.schedule(1, 1, 100);
+    wheel.advance(50, [](const TimerWheel::Timer&) { return TimerWheel::done; });
+
+    size_t calls = 0;
+    wheel.advance(10,
+                  [&calls](const TimerWheel::Timer&)
+                  {
+                      ++calls;
+                      return TimerWheel::done;
+                  });
+    ASSERT_EQ(calls, 0u);
+    ASSERT_EQ(wheel.size(), 1u);
+}
+
+TEST(TimerWheelTest, Clear)
+{
+    TimerWheel wheel(10, 8);
+    wheel.schedule(1, 1, 10);
+    wheel.schedule(2, 2, 20);
+    wheel.clear();
+    ASSERT_EQ(wheel.size(), 0u);
+}
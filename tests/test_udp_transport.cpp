@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <asam_cmp/can_payload.h>
+#include <asam_cmp/udp_transport.h>
+
+using ASAM::CMP::CanPayload;
+using ASAM::CMP::Encoder;
+using ASAM::CMP::Packet;
+using ASAM::CMP::UdpReceiver;
+using ASAM::CMP::UdpSender;
+
+class UdpTransportFixture : public ::testing::Test
+{
+protected:
+    static Packet createPacket(const uint32_t id)
+    {
+        const uint8_t data[] = {static_cast<uint8_t>(id), 2, 3, 4};
+        CanPayload payload;
+        payload.setId(id);
+        payload.setData(data, sizeof(data));
+
+        Packet packet;
+        packet.setInterfaceId(5);
+        packet.setTimestamp(1000 + id);
+        packet.setPayload(payload);
+        return packet;
+    }
+
+    static std::vector<Packet> createPackets(const uint32_t count)
+    {
+        std::vector<Packet> packets;
+        for (uint32_t id = 0; id < count; ++id)
+            packets.push_back(createPacket(id));
+        return packets;
+    }
+
+    // Collects the CAN ids of all received packets
+    void onBatch(const UdpReceiver::Batch& batch)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(batch.receiveTimes.size(), batch.packets.size());
+        for (size_t index = 0; index < batch.packets.size(); ++index)
+        {
+            ids.push_back(batch.packets.getCanIds()[index]);
+            receiveTimes.push_back(batch.receiveTimes[index]);
+        }
+        threadIndexes.insert(batch.threadIndex);
+    }
+
+    bool waitForPackets(const size_t count)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ids.size() >= count)
+                    return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+
+    UdpReceiver::Options createReceiverOptions() const
+    {
+        UdpReceiver::Options options;
+        options.address = "127.0.0.1";
+        options.receiveBufferSize = 4 * 1024 * 1024;
+        options.pollTimeout = 10;
+        return options;
+    }
+
+protected:
+    std::mutex mutex;
+    std::vector<uint32_t> ids;
+    std::vector<uint64_t> receiveTimes;
+    std::set<size_t> threadIndexes;
+};
+
+TEST_F(UdpTransportFixture, Loopback)
+{
+    UdpReceiver receiver(createReceiverOptions(), [this](const UdpReceiver::Batch& batch) { onBatch(batch); });
+    ASSERT_NE(receiver.getPort(), 0u);
+    receiver.start();
+
+    UdpSender::Options senderOptions;
+    senderOptions.port = receiver.getPort();
+    senderOptions.batchSize = 16;
+    // One packet per frame
+    senderOptions.dataContext.maxBytesPerMessage = 64;
+    UdpSender sender(senderOptions);
+
+    Encoder encoder;
+    encoder.setDeviceId(3);
+    const auto packets = createPackets(100);
+    sender.send(encoder, packets.begin(), packets.end());
+    ASSERT_EQ(sender.getStats().datagrams, 100u);
+    ASSERT_GE(sender.getStats().calls, 7u);
+
+    const auto sendTime = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    ASSERT_TRUE(waitForPackets(100));
+    receiver.stop();
+
+    std::vector<uint32_t> expected(100);
+    for (uint32_t id = 0; id < expected.size(); ++id)
+        expected[id] = id;
+    ASSERT_EQ(ids, expected);
+    for (const auto time : receiveTimes)
+    {
+        ASSERT_LE(time, sendTime + 60000000000);
+        ASSERT_GE(time + 60000000000, sendTime);
+    }
+
+    const auto stats = receiver.getStats();
+    ASSERT_EQ(stats.datagrams, 100u);
+    ASSERT_EQ(stats.packets, 100u);
+    ASSERT_EQ(stats.bytes, sender.getStats().bytes);
+    ASSERT_GE(stats.batches, 1u);
+    ASSERT_EQ(stats.truncated, 0u);
+}
+
+TEST_F(UdpTransportFixture, ClockTimestamps)
+{
+    auto options = createReceiverOptions();
+    options.kernelTimestamps = false;
+    UdpReceiver receiver(options, [this](const UdpReceiver::Batch& batch) { onBatch(batch); });
+
+    UdpSender::Options senderOptions;
+    senderOptions.port = receiver.getPort();
+    UdpSender sender(senderOptions);
+    Encoder encoder;
+    const auto packets = createPackets(10);
+    sender.send(encoder, packets.begin(), packets.end());
+
+    // Datagrams sent before start wait in the socket
+    receiver.start();
+    ASSERT_TRUE(waitForPackets(10));
+    receiver.stop();
+
+    ASSERT_EQ(ids.size(), 10u);
+    ASSERT_EQ(receiveTimes.size(), 10u);
+    ASSERT_GT(receiveTimes.front(), 0u);
+}
+
+TEST_F(UdpTransportFixture, ReusePortFanOut)
+{
+    auto options = createReceiverOptions();
+    options.threadCount = 4;
+    UdpReceiver receiver(options, [this](const UdpReceiver::Batch& batch) { onBatch(batch); });
+    receiver.start();
+
+    // Every sender has its own source port, the kernel spreads them over the sockets
+    const auto packets = createPackets(50);
+    for (int index = 0; index < 16; ++index)
+    {
+        UdpSender::Options senderOptions;
+        senderOptions.port = receiver.getPort();
+        UdpSender sender(senderOptions);
+        Encoder encoder;
+        sender.send(encoder, packets.begin(), packets.end());
+    }
+
+    ASSERT_TRUE(waitForPackets(16 * 50));
+    receiver.stop();
+
+    ASSERT_EQ(ids.size(), 16u * 50u);
+    ASSERT_EQ(receiver.getStats().packets, 16u * 50u);
+    ASSERT_GT(threadIndexes.size(), 1u);
+    for (const auto threadIndex : threadIndexes)
+        ASSERT_LT(threadIndex, 4u);
+}
+
+TEST_F(UdpTransportFixture, Truncated)
+{
+    auto options = createReceiverOptions();
+    options.maxDatagramSize = 16;
+    UdpReceiver receiver(options, [this](const UdpReceiver::Batch& batch) { onBatch(batch); });
+    receiver.start();
+
+    UdpSender::Options senderOptions;
+    senderOptions.port = receiver.getPort();
+    UdpSender sender(senderOptions);
+    Encoder encoder;
+    const auto packets = createPackets(1);
+    sender.send(encoder, packets.begin(), packets.end());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (receiver.getStats().truncated == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    receiver.stop();
+
+    ASSERT_EQ(receiver.getStats().truncated, 1u);
+    ASSERT_EQ(receiver.getStats().packets, 0u);
+    ASSERT_TRUE(ids.empty());
+}
+
+TEST_F(UdpTransportFixture, HandlerError)
+{
+    UdpReceiver receiver(createReceiverOptions(), [](const UdpReceiver::Batch&) { throw std::runtime_error("handler failed"); });
+    receiver.start();
+
+    UdpSender::Options senderOptions;
+    senderOptions.port = receiver.getPort();
+    UdpSender sender(senderOptions);
+    Encoder encoder;
+    const auto packets = createPackets(1);
+    sender.send(encoder, packets.begin(), packets.end());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (receiver.getStats().packets == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    ASSERT_THROW(receiver.stop(), std::runtime_error);
+    ASSERT_NO_THROW(receiver.stop());
+}
+
+TEST_F(UdpTransportFixture, InvalidAddress)
+{
+    auto options = createReceiverOptions();
+    options.address = "localhost";
+    ASSERT_THROW(UdpReceiver(options, [](const UdpReceiver::Batch&) {}), std::invalid_argument);
+
+    UdpSender::Options senderOptions;
+    senderOptions.address = "256.0.0.1";
+    ASSERT_THROW(UdpSender sender(senderOptions), std::invalid_argument);
+}